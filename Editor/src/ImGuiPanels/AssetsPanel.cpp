@@ -295,7 +295,7 @@ void AssetsPanel::displayFileList() {
                     ImGui::Separator();
                 } else {
                     // File-specific actions
-                    if (item.name.find(".gltf") != std::string::npos) { 
+                    if (item.name.find(".gltf") != std::string::npos || item.name.find(".glb") != std::string::npos) { 
                         if (ImGui::MenuItem("Open in Editor")) {
                             Rapture::GE_INFO("Open File action for: {0}", item.path);
                             // Add open file implementation here
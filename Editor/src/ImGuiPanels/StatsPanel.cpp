@@ -2,6 +2,9 @@
 //#include "Debug/Profiler.h"
 //#include "Debug/GPUProfiler.h"
 #include "Debug/TracyProfiler.h"
+#include "Buffers/BufferPools.h"
+#include "Buffers/BufferUploadQueue.h"
+#include "Textures/Texture.h"
 #include <imgui.h>
 #include <imgui_internal.h> // For advanced ImGui functions
 #include <array>
@@ -95,6 +98,10 @@ void StatsPanel::render(float timestep) {
             m_activeTab = TabType::Overview;
             ImGui::EndTabItem();
         }
+        if (ImGui::BeginTabItem("Memory")) {
+            m_activeTab = TabType::Memory;
+            ImGui::EndTabItem();
+        }
         if (ImGui::BeginTabItem("Tracy")) {
             m_activeTab = TabType::Tracy;
             ImGui::EndTabItem();
@@ -105,6 +112,7 @@ void StatsPanel::render(float timestep) {
     // Render active tab content
     switch (m_activeTab) {
         case TabType::Overview: renderOverviewTab(); break;
+        case TabType::Memory:   renderMemoryTab();   break;
         case TabType::Tracy:    renderTracyTab();    break;
     }
     
@@ -144,7 +152,7 @@ void StatsPanel::renderOverviewTab() {
         ImGui::NextColumn();
         
         // Basic memory usage
-        ImGui::Text("Total Memory:");
+        ImGui::Text("GPU Memory:");
         ImGui::NextColumn();
         float memoryMB = m_totalMemoryUsage / (1024.0f * 1024.0f);
         renderColoredValue(memoryMB, MEMORY_WARNING_MB, MEMORY_ERROR_MB, "%s", true, formatMemory(m_totalMemoryUsage).c_str());
@@ -180,6 +188,104 @@ void StatsPanel::renderOverviewTab() {
     }
 }
 
+void StatsPanel::renderMemoryTab() {
+    if (ImGui::CollapsingHeader("Summary", ImGuiTreeNodeFlags_DefaultOpen)) {
+        ImGui::Columns(2, "memory_summary_columns", false);
+
+        ImGui::Text("Mesh Pools (used / capacity):");
+        ImGui::NextColumn();
+        ImGui::Text("%s / %s", formatMemory(m_meshMemoryUsage).c_str(), formatMemory(m_bufferPoolStats.totalCapacityBytes).c_str());
+        ImGui::NextColumn();
+
+        ImGui::Text("Mesh Allocations:");
+        ImGui::NextColumn();
+        ImGui::Text("%zu in %zu VAOs", m_bufferPoolStats.totalAllocationCount, m_bufferPoolStats.vaoCount);
+        ImGui::NextColumn();
+
+        ImGui::Text("Pending Uploads:");
+        ImGui::NextColumn();
+        ImGui::Text("%s", formatMemory(m_pendingUploadBytes).c_str());
+        ImGui::NextColumn();
+
+        ImGui::Text("Textures:");
+        ImGui::NextColumn();
+        ImGui::Text("%s in %zu textures", formatMemory(m_textureMemoryUsage).c_str(), m_textureMemoryStats.textureCount);
+        ImGui::NextColumn();
+
+        ImGui::Columns(1);
+    }
+
+    if (ImGui::CollapsingHeader("Buffer Pool Pages", ImGuiTreeNodeFlags_DefaultOpen)) {
+        if (m_bufferPoolStats.pages.empty()) {
+            ImGui::TextDisabled("No buffer pools allocated");
+        }
+        else if (ImGui::BeginTable("pool_pages", 8, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchProp)) {
+            ImGui::TableSetupColumn("VAO");
+            ImGui::TableSetupColumn("Type");
+            ImGui::TableSetupColumn("Capacity");
+            ImGui::TableSetupColumn("Used");
+            ImGui::TableSetupColumn("Free");
+            ImGui::TableSetupColumn("Largest Free");
+            ImGui::TableSetupColumn("Fragmentation");
+            ImGui::TableSetupColumn("Allocs / Free Blocks");
+            ImGui::TableHeadersRow();
+
+            for (const auto& page : m_bufferPoolStats.pages) {
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn(); ImGui::Text("%u", page.vaoID);
+                ImGui::TableNextColumn(); ImGui::Text("%s", page.bufferType == Rapture::BufferType::Vertex ? "Vertex" : (page.indexType == 0x1403 /* GL_UNSIGNED_SHORT */ ? "Index u16" : "Index u32"));
+                ImGui::TableNextColumn(); ImGui::Text("%s", formatMemory(page.capacityBytes).c_str());
+
+                ImGui::TableNextColumn();
+                float usage = page.capacityBytes > 0 ? (float)page.usedBytes / (float)page.capacityBytes : 0.0f;
+                ImGui::ProgressBar(usage, ImVec2(-1, 0), formatMemory(page.usedBytes).c_str());
+
+                ImGui::TableNextColumn(); ImGui::Text("%s", formatMemory(page.freeBytes).c_str());
+                ImGui::TableNextColumn(); ImGui::Text("%s", formatMemory(page.largestFreeBlockBytes).c_str());
+                ImGui::TableNextColumn(); renderColoredValue(page.fragmentation() * 100.0f, FRAGMENTATION_WARNING * 100.0f, FRAGMENTATION_ERROR * 100.0f, "%.1f %%");
+                ImGui::TableNextColumn(); ImGui::Text("%zu / %zu", page.allocationCount, page.freeBlockCount);
+            }
+            ImGui::EndTable();
+        }
+    }
+
+    if (ImGui::CollapsingHeader("Texture Memory", ImGuiTreeNodeFlags_DefaultOpen)) {
+        ImGui::Text("By Format");
+        ImGui::Indent();
+        for (const auto& [format, bytes] : m_textureMemoryStats.bytesPerFormat) {
+            if (bytes == 0) continue;
+            ImGui::Text("%-8s %s", format.c_str(), formatMemory(bytes).c_str());
+        }
+        ImGui::Unindent();
+
+        ImGui::Text("By Mip Level");
+        ImGui::Indent();
+        for (size_t level = 0; level < m_textureMemoryStats.bytesPerMipLevel.size(); ++level) {
+            size_t bytes = m_textureMemoryStats.bytesPerMipLevel[level];
+            if (bytes == 0) continue;
+            float share = m_textureMemoryUsage > 0 ? (float)bytes / (float)m_textureMemoryUsage : 0.0f;
+            ImGui::Text("Mip %-2zu", level);
+            ImGui::SameLine();
+            ImGui::ProgressBar(share, ImVec2(-1, 0), formatMemory(bytes).c_str());
+        }
+        ImGui::Unindent();
+    }
+
+    if (ImGui::CollapsingHeader("Texture Decoding", ImGuiTreeNodeFlags_DefaultOpen)) {
+        const Rapture::TextureDecodeStats& decode = m_textureDecodeStats;
+        float queueShare = decode.queueCapacity > 0 ? (float)decode.queueDepth / (float)decode.queueCapacity : 0.0f;
+        ImGui::Text("Queue");
+        ImGui::SameLine();
+        ImGui::ProgressBar(queueShare, ImVec2(-1, 0), (std::to_string(decode.queueDepth) + " / " + std::to_string(decode.queueCapacity)).c_str());
+        ImGui::Text("Peak queue depth: %zu", decode.peakQueueDepth);
+        ImGui::Text("Overflow: %zu waiting (%llu total)", decode.overflowDepth, (unsigned long long)decode.overflowedRequests);
+        ImGui::Text("Decoding: %zu of %zu slots", decode.activeDecodes, decode.maxConcurrentDecodes);
+        ImGui::Text("Decoded: %llu textures, %s (%llu failed)", (unsigned long long)decode.texturesDecoded,
+            formatMemory(decode.bytesDecoded).c_str(), (unsigned long long)decode.decodeFailures);
+        ImGui::Text("Throughput: %.1f textures/s, %.1f MB/s", decode.texturesPerSecond, decode.megabytesPerSecond);
+    }
+}
+
 void StatsPanel::renderHistoryGraph(const std::array<float, 100>& history, const char* label, float maxValue) {
     // Find the maximum value for scaling if not provided
     if (maxValue <= 0.0f) {
@@ -502,11 +608,15 @@ void StatsPanel::updateCachedData() {
     m_frameTimeHistory[m_frameTimeHistoryIndex] = m_lastFrameTimeMs;
     m_frameTimeHistoryIndex = (m_frameTimeHistoryIndex + 1) % m_frameTimeHistory.size();
     
-    // Use placeholder values for memory stats, etc. since we don't have the old profilers
-    // In a real implementation, these would be retrieved from actual system APIs
-    m_totalMemoryUsage = 768 * 1024 * 1024;  // Example: 768 MB
-    m_textureMemoryUsage = 384 * 1024 * 1024;  // Example: 384 MB
-    m_meshMemoryUsage = 256 * 1024 * 1024;  // Example: 256 MB
+    // Memory stats come from the engine's own tracking, pools count their full capacity since it is committed on the GPU
+    m_bufferPoolStats = Rapture::BufferPoolManager::getInstance().getPoolStats();
+    m_textureMemoryStats = Rapture::TextureLibrary::getMemoryStats();
+    m_textureDecodeStats = Rapture::TextureLibrary::getDecodeStats();
+    m_pendingUploadBytes = Rapture::BufferUploadQueue::getPendingUploadBytes();
+
+    m_meshMemoryUsage = m_bufferPoolStats.totalUsedBytes;
+    m_textureMemoryUsage = m_textureMemoryStats.totalBytes;
+    m_totalMemoryUsage = m_bufferPoolStats.totalCapacityBytes + m_textureMemoryUsage;
     
     m_drawCalls = 1250;  // Example value
     m_triangleCount = 250000;  // Example value
@@ -7,6 +7,8 @@
 #include <unordered_map>
 #include <set>
 #include "../../Engine/src/Debug/TracyProfiler.h"
+#include "../../Engine/src/Buffers/BufferPools.h"
+#include "../../Engine/src/Textures/Texture.h"
 
 class StatsPanel {
 public:
@@ -19,6 +21,7 @@ private:
     // Tabs
     enum class TabType {
         Overview,
+        Memory,
         Tracy
     };
     TabType m_activeTab = TabType::Overview;
@@ -26,6 +29,7 @@ private:
     // Cached data for performance
     void updateCachedData();
     void renderOverviewTab();
+    void renderMemoryTab();
     void renderTracyTab();
     
     // Helpers for sections
@@ -52,10 +56,14 @@ private:
     int m_batchCount = 0;
     int m_shaderBinds = 0;
     
-    // Memory stats (placeholder values)
+    // Memory stats (tracked GPU memory, not process memory)
     size_t m_totalMemoryUsage = 0;
     size_t m_textureMemoryUsage = 0;
     size_t m_meshMemoryUsage = 0;
+    size_t m_pendingUploadBytes = 0;
+    Rapture::BufferPoolStats m_bufferPoolStats;
+    Rapture::TextureMemoryStats m_textureMemoryStats;
+    Rapture::TextureDecodeStats m_textureDecodeStats;
     
     // Tracy-specific data
     bool m_tracyEnabled = false;
@@ -74,6 +82,8 @@ private:
     static constexpr float FRAMETIME_ERROR_MS = 33.0f;    // ~30 FPS
     static constexpr float MEMORY_WARNING_MB = 1024.0f;   // 1 GB
     static constexpr float MEMORY_ERROR_MB = 1536.0f;     // 1.5 GB
+    static constexpr float FRAGMENTATION_WARNING = 0.3f;
+    static constexpr float FRAGMENTATION_ERROR = 0.6f;
     static constexpr int DRAWCALL_WARNING = 1000;
     static constexpr int DRAWCALL_ERROR = 2000;
     static constexpr float IM_PI = 3.14159265358979323846f;
@@ -1,5 +1,6 @@
 #include "ViewportPanel.h"
 #include "Logger/Log.h"
+#include "Renderer/RenderThread.h"
 
 
 void ViewportPanel::renderSceneViewport(TestLayer* testLayer) {
@@ -18,10 +19,12 @@ void ViewportPanel::renderSceneViewport(TestLayer* testLayer) {
         // Check if viewport size changed and resize the framebuffer if needed
         if (viewportPanelSize.x != lastSize.x || viewportPanelSize.y != lastSize.y || firstTime) {
             if (viewportPanelSize.x > 0 && viewportPanelSize.y > 0) {
-                // Update framebuffer size to match viewport
-                testLayer->getFramebuffer()->resize(
-                    static_cast<unsigned int>(viewportPanelSize.x), 
-                    static_cast<unsigned int>(viewportPanelSize.y));
+                // Update framebuffer size to match viewport, on the render thread that owns the framebuffer object
+                Rapture::RenderThread::submit([framebuffer = testLayer->getFramebuffer(),
+                    width = static_cast<unsigned int>(viewportPanelSize.x),
+                    height = static_cast<unsigned int>(viewportPanelSize.y)]() {
+                    framebuffer->resize(width, height);
+                });
             }
             lastSize = viewportPanelSize;
             firstTime = false;
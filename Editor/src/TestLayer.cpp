@@ -15,6 +15,8 @@
 #include "Textures/Texture.h"
 #include "Debug/Profiler.h"
 #include "Renderer/Raycast.h"
+#include "Renderer/RenderThread.h"
+#include "Scenes/Systems/AnimationSystem.h"
 
 void TestLayer::setSelectedEntity(Rapture::Entity entity)
 {
@@ -178,6 +180,9 @@ void TestLayer::onUpdate(float ts)
 	// Update the camera controller
 	CameraController::update(ts);
 
+    // Pose every skinned model, the renderer uploads the palettes when it submits the scene
+    Rapture::AnimationSystem::update(m_activeScene.get(), timeInSeconds);
+
     if (Rapture::Input::isMouseBtnPressed(0))
     {
         m_wasMouseBtnPressedLastFrame = true;
@@ -278,8 +283,8 @@ void TestLayer::onUpdate(float ts)
     }
     
 
-	// Bind the framebuffer to render the scene to a texture
-	m_framebuffer->bind();
+	// Bind the framebuffer to render the scene to a texture, recorded like the draws so it stays in order with them
+	Rapture::RenderThread::submit([framebuffer = m_framebuffer]() { framebuffer->bind(); });
 	
 
 	// Render the scene to the framebuffer
@@ -291,7 +296,7 @@ void TestLayer::onUpdate(float ts)
     }
 
 	// Unbind the framebuffer to return to the default framebuffer
-	m_framebuffer->unBind();
+	Rapture::RenderThread::submit([framebuffer = m_framebuffer]() { framebuffer->unBind(); });
 }
 
 void TestLayer::onEvent(Rapture::Event& event)
@@ -0,0 +1,236 @@
+#include "AnimationClip.h"
+
+#include <algorithm>
+
+#include "AnimationCompression.h"
+#include "../Debug/TracyProfiler.h"
+
+namespace Rapture {
+
+    namespace {
+
+        inline glm::vec3 loadVec3(const float* v) { return glm::vec3(v[0], v[1], v[2]); }
+
+        // glTF stores quaternions as xyzw, glm::quat takes wxyz
+        inline glm::quat loadQuat(const float* v) { return glm::quat(v[3], v[0], v[1], v[2]); }
+
+        // Finds the key interval containing time, t receives the position inside it.
+        // Works on float seconds as well as on quantized key times, as long as time is in the same units
+        template<typename T>
+        inline size_t findKey(const T* times, size_t count, float time, float& t) {
+            if (time <= static_cast<float>(times[0])) {
+                t = 0.0f;
+                return 0;
+            }
+            if (time >= static_cast<float>(times[count - 1])) {
+                t = 1.0f;
+                return count > 1 ? count - 2 : 0;
+            }
+
+            size_t next = static_cast<size_t>(std::upper_bound(times, times + count, time,
+                [](float value, T key) { return value < static_cast<float>(key); }) - times);
+            size_t key = next - 1;
+            float span = static_cast<float>(times[next]) - static_cast<float>(times[key]);
+            t = span > 0.0f ? (time - static_cast<float>(times[key])) / span : 0.0f;
+            return key;
+        }
+
+        // Hermite spline between two cubic spline keys, see the glTF spec appendix on interpolation
+        inline void sampleCubic(const float* values, size_t key, size_t components, float t, float span, float* out) {
+            size_t stride = components * 3;
+            const float* v0 = values + key * stride + components;           // value of key
+            const float* b0 = values + key * stride + components * 2;       // out-tangent of key
+            const float* a1 = values + (key + 1) * stride;                  // in-tangent of key + 1
+            const float* v1 = values + (key + 1) * stride + components;     // value of key + 1
+
+            float t2 = t * t;
+            float t3 = t2 * t;
+            float h00 = 2.0f * t3 - 3.0f * t2 + 1.0f;
+            float h10 = (t3 - 2.0f * t2 + t) * span;
+            float h01 = -2.0f * t3 + 3.0f * t2;
+            float h11 = (t3 - t2) * span;
+
+            for (size_t c = 0; c < components; c++) {
+                out[c] = h00 * v0[c] + h10 * b0[c] + h01 * v1[c] + h11 * a1[c];
+            }
+        }
+
+        inline void applySample(JointPose& jointPose, AnimationPath path, const float* sampled) {
+            switch (path) {
+            case AnimationPath::Translation: jointPose.translation = loadVec3(sampled); break;
+            case AnimationPath::Rotation:    jointPose.rotation = glm::normalize(loadQuat(sampled)); break;
+            case AnimationPath::Scale:       jointPose.scale = loadVec3(sampled); break;
+            }
+        }
+
+    }
+
+    AnimationClip::AnimationClip(const std::string& name, std::vector<AnimationChannel>&& channels)
+        : m_name(name), m_channels(std::move(channels))
+    {
+        for (const auto& channel : m_channels) {
+            if (!channel.times.empty()) {
+                m_duration = std::max(m_duration, channel.times.back());
+            }
+        }
+    }
+
+    AnimationClip::AnimationClip(const std::string& name, CompressedClipData&& compressed)
+        : m_name(name), m_compressed(std::move(compressed)), m_isCompressed(true)
+    {
+        m_duration = m_compressed.duration;
+    }
+
+    size_t AnimationClip::getMemoryUsage() const
+    {
+        if (!m_isCompressed) {
+            return AnimationCompression::getRawSize(m_channels);
+        }
+        return m_compressed.tracks.size() * sizeof(CompressedTrack) +
+            m_compressed.times.size() * sizeof(uint16_t) +
+            m_compressed.quantizedValues.size() * sizeof(uint16_t) +
+            m_compressed.floatValues.size() * sizeof(float);
+    }
+
+    void AnimationClip::sample(float time, const Skeleton& skeleton, JointPose* pose) const
+    {
+        RAPTURE_PROFILE_FUNCTION();
+
+        std::copy(skeleton.restPose.begin(), skeleton.restPose.end(), pose);
+
+        if (m_isCompressed) {
+            sampleCompressed(time, skeleton, pose);
+        }
+        else {
+            sampleChannels(time, skeleton, pose);
+        }
+    }
+
+    void AnimationClip::sampleChannels(float time, const Skeleton& skeleton, JointPose* pose) const
+    {
+        for (const AnimationChannel& channel : m_channels) {
+            if (channel.times.empty() || channel.joint >= skeleton.getJointCount()) {
+                continue;
+            }
+
+            size_t components = channel.getComponentCount();
+            float t = 0.0f;
+            size_t key = findKey(channel.times.data(), channel.times.size(), time, t);
+            bool singleKey = channel.times.size() == 1;
+
+            float sampled[4];
+            switch (channel.interpolation) {
+            case AnimationInterpolation::Step: {
+                const float* v = channel.values.data() + (t >= 1.0f && !singleKey ? key + 1 : key) * components;
+                std::copy(v, v + components, sampled);
+                break;
+            }
+            case AnimationInterpolation::CubicSpline: {
+                if (singleKey) {
+                    const float* v = channel.values.data() + components;
+                    std::copy(v, v + components, sampled);
+                }
+                else {
+                    float span = channel.times[key + 1] - channel.times[key];
+                    sampleCubic(channel.values.data(), key, components, t, span, sampled);
+                }
+                break;
+            }
+            case AnimationInterpolation::Linear: {
+                const float* v0 = channel.values.data() + key * components;
+                const float* v1 = singleKey ? v0 : v0 + components;
+                if (channel.path == AnimationPath::Rotation) {
+                    glm::quat q = glm::slerp(loadQuat(v0), loadQuat(v1), t);
+                    sampled[0] = q.x; sampled[1] = q.y; sampled[2] = q.z; sampled[3] = q.w;
+                }
+                else {
+                    for (size_t c = 0; c < components; c++) {
+                        sampled[c] = v0[c] + (v1[c] - v0[c]) * t;
+                    }
+                }
+                break;
+            }
+            }
+
+            applySample(pose[channel.joint], channel.path, sampled);
+        }
+    }
+
+    void AnimationClip::sampleCompressed(float time, const Skeleton& skeleton, JointPose* pose) const
+    {
+        // Key times are stored in 1/65535ths of the duration, so the search runs on the quantized time
+        float quantizedTime = m_duration > 0.0f ? std::clamp(time / m_duration, 0.0f, 1.0f) * AnimationCompression::QUANTIZED_RANGE : 0.0f;
+        float secondsPerStep = m_duration / AnimationCompression::QUANTIZED_RANGE;
+
+        const uint16_t* times = m_compressed.times.data();
+        const uint16_t* quantizedValues = m_compressed.quantizedValues.data();
+        const float* floatValues = m_compressed.floatValues.data();
+
+        for (const CompressedTrack& track : m_compressed.tracks) {
+            if (track.joint >= skeleton.getJointCount()) {
+                continue;
+            }
+
+            const uint16_t* trackTimes = times + track.timeOffset;
+            float t = 0.0f;
+            size_t key = findKey(trackTimes, track.keyCount, quantizedTime, t);
+            bool singleKey = track.keyCount == 1;
+            size_t next = singleKey ? key : key + 1;
+            JointPose& jointPose = pose[track.joint];
+
+            // Cubic spline tracks keep their floats, only their times are quantized
+            if (track.format == AnimationKeyFormat::Float) {
+                size_t components = track.getComponentCount();
+                const float* values = floatValues + track.valueOffset;
+                float sampled[4];
+                if (singleKey) {
+                    std::copy(values + components, values + components * 2, sampled);
+                }
+                else {
+                    float span = (static_cast<float>(trackTimes[key + 1]) - static_cast<float>(trackTimes[key])) * secondsPerStep;
+                    sampleCubic(values, key, components, t, span, sampled);
+                }
+                applySample(jointPose, track.path, sampled);
+                continue;
+            }
+
+            const uint16_t* words = quantizedValues + track.valueOffset;
+            if (track.interpolation == AnimationInterpolation::Step) {
+                key = t >= 1.0f ? next : key;
+                next = key;
+            }
+
+            if (track.path == AnimationPath::Rotation) {
+                glm::quat a = AnimationCompression::decodeRotation(words + key * 3);
+                if (next == key || t <= 0.0f) {
+                    jointPose.rotation = a;
+                    continue;
+                }
+
+                // Keys are close enough after reduction for nlerp, which key reduction also measured its error against.
+                // Smallest-three may flip the sign of a key, so take the short way round
+                glm::quat b = AnimationCompression::decodeRotation(words + next * 3);
+                if (glm::dot(a, b) < 0.0f) {
+                    b = -b;
+                }
+                jointPose.rotation = glm::normalize(a * (1.0f - t) + b * t);
+            }
+            else {
+                glm::vec3 a = AnimationCompression::decodeVector(words + key * 3, track.rangeMin, track.rangeScale);
+                glm::vec3 value = a;
+                if (next != key && t > 0.0f) {
+                    glm::vec3 b = AnimationCompression::decodeVector(words + next * 3, track.rangeMin, track.rangeScale);
+                    value = a + (b - a) * t;
+                }
+
+                if (track.path == AnimationPath::Translation) {
+                    jointPose.translation = value;
+                }
+                else {
+                    jointPose.scale = value;
+                }
+            }
+        }
+    }
+
+}
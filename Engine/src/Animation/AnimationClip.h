@@ -0,0 +1,104 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "Skeleton.h"
+
+namespace Rapture {
+
+    enum class AnimationPath : uint8_t {
+        Translation,
+        Rotation,
+        Scale
+    };
+
+    enum class AnimationInterpolation : uint8_t {
+        Linear,
+        Step,
+        CubicSpline
+    };
+
+    // Keys of one joint property. Values hold 3 (translation, scale) or 4 (rotation, xyzw) floats per key,
+    // cubic spline keys store in-tangent, value and out-tangent one after the other
+    struct AnimationChannel {
+        uint32_t joint = 0;
+        AnimationPath path = AnimationPath::Translation;
+        AnimationInterpolation interpolation = AnimationInterpolation::Linear;
+        std::vector<float> times;
+        std::vector<float> values;
+
+        size_t getComponentCount() const { return path == AnimationPath::Rotation ? 4 : 3; }
+    };
+
+    enum class AnimationKeyFormat : uint8_t {
+        Float,          // exact floats, used for cubic spline keys whose tangents don't quantize well
+        Quantized       // 3 words per key, smallest-three rotations or range relative translation and scale
+    };
+
+    // One channel after compression, its keys live in the clip's shared pools
+    struct CompressedTrack {
+        uint32_t joint = 0;
+        AnimationPath path = AnimationPath::Translation;
+        AnimationInterpolation interpolation = AnimationInterpolation::Linear;
+        AnimationKeyFormat format = AnimationKeyFormat::Quantized;
+        uint32_t keyCount = 0;
+        uint32_t timeOffset = 0;        // into CompressedClipData::times
+        uint32_t valueOffset = 0;       // into quantizedValues or floatValues, depending on the format
+
+        // Quantized translation and scale decode to rangeMin + word * rangeScale
+        glm::vec3 rangeMin = glm::vec3(0.0f);
+        glm::vec3 rangeScale = glm::vec3(0.0f);
+
+        size_t getComponentCount() const { return path == AnimationPath::Rotation ? 4 : 3; }
+    };
+
+    // Keys of a whole clip, the tracks sorted by joint and their keys packed back to back in track order,
+    // so sampling walks every pool front to back
+    struct CompressedClipData {
+        std::vector<CompressedTrack> tracks;
+        std::vector<uint16_t> times;            // key times in 1/65535ths of the duration
+        std::vector<uint16_t> quantizedValues;
+        std::vector<float> floatValues;
+        float duration = 0.0f;
+    };
+
+    // Animation of one skeleton, immutable after import and shared between every animator playing it
+    class AnimationClip {
+    public:
+        AnimationClip(const std::string& name, std::vector<AnimationChannel>&& channels);
+        AnimationClip(const std::string& name, CompressedClipData&& compressed);
+
+        /**
+         * @brief Sample every channel at the given time on top of the rest pose
+         *
+         * @param time Time in seconds, clamped to the clip
+         * @param skeleton Skeleton the clip was imported for
+         * @param pose Receives one local pose per joint, must hold skeleton.getJointCount() entries
+         */
+        void sample(float time, const Skeleton& skeleton, JointPose* pose) const;
+
+        const std::string& getName() const { return m_name; }
+        float getDuration() const { return m_duration; }
+        bool isCompressed() const { return m_isCompressed; }
+
+        // Raw channels, empty for compressed clips
+        const std::vector<AnimationChannel>& getChannels() const { return m_channels; }
+
+        // Bytes held by the keys, for import statistics
+        size_t getMemoryUsage() const;
+
+    private:
+        void sampleChannels(float time, const Skeleton& skeleton, JointPose* pose) const;
+        void sampleCompressed(float time, const Skeleton& skeleton, JointPose* pose) const;
+
+    private:
+        std::string m_name;
+        std::vector<AnimationChannel> m_channels;
+        CompressedClipData m_compressed;
+        bool m_isCompressed = false;
+        float m_duration = 0.0f;
+    };
+
+}
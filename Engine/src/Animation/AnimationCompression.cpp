@@ -0,0 +1,245 @@
+#include "AnimationCompression.h"
+
+#include <cstring>
+#include <limits>
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include "../Debug/TracyProfiler.h"
+
+namespace Rapture {
+
+    namespace AnimationCompression {
+
+        namespace {
+
+            // Longest run of keys one linear segment may replace, bounds the quadratic segment test on long static tracks
+            constexpr size_t MAX_REDUCTION_SPAN = 256;
+
+            // Angle between two rotations for quaternions, largest component difference otherwise
+            inline float keyError(const float* a, const float* b, size_t components, bool isRotation) {
+                if (isRotation) {
+                    float dot = std::abs(a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3]);
+                    return 2.0f * std::acos(std::min(dot, 1.0f));
+                }
+
+                float error = 0.0f;
+                for (size_t c = 0; c < components; c++) {
+                    error = std::max(error, std::abs(a[c] - b[c]));
+                }
+                return error;
+            }
+
+            // Same interpolation the compressed sampler uses, nlerp along the short way for rotations
+            inline void interpolateKey(const float* a, const float* b, size_t components, bool isRotation, float t, float* out) {
+                if (!isRotation) {
+                    for (size_t c = 0; c < components; c++) {
+                        out[c] = a[c] + (b[c] - a[c]) * t;
+                    }
+                    return;
+                }
+
+                float sign = (a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3]) < 0.0f ? -1.0f : 1.0f;
+                float lengthSquared = 0.0f;
+                for (size_t c = 0; c < 4; c++) {
+                    out[c] = a[c] + (b[c] * sign - a[c]) * t;
+                    lengthSquared += out[c] * out[c];
+                }
+                float inverseLength = lengthSquared > 0.0f ? 1.0f / std::sqrt(lengthSquared) : 0.0f;
+                for (size_t c = 0; c < 4; c++) {
+                    out[c] *= inverseLength;
+                }
+            }
+
+            float getTolerance(AnimationPath path, const AnimationCompressionSettings& settings) {
+                switch (path) {
+                case AnimationPath::Translation: return settings.translationTolerance;
+                case AnimationPath::Rotation:    return settings.rotationTolerance;
+                case AnimationPath::Scale:       return settings.scaleTolerance;
+                }
+                return 0.0f;
+            }
+
+            // A single remaining key that matches the rest pose animates nothing
+            bool matchesRestPose(const AnimationChannel& channel, const JointPose& rest, float tolerance) {
+                const float* value = channel.values.data();
+                switch (channel.path) {
+                case AnimationPath::Translation: {
+                    float restValue[3] = { rest.translation.x, rest.translation.y, rest.translation.z };
+                    return keyError(value, restValue, 3, false) <= tolerance;
+                }
+                case AnimationPath::Rotation: {
+                    float restValue[4] = { rest.rotation.x, rest.rotation.y, rest.rotation.z, rest.rotation.w };
+                    return keyError(value, restValue, 4, true) <= tolerance;
+                }
+                case AnimationPath::Scale: {
+                    float restValue[3] = { rest.scale.x, rest.scale.y, rest.scale.z };
+                    return keyError(value, restValue, 3, false) <= tolerance;
+                }
+                }
+                return false;
+            }
+
+        }
+
+        void reduceKeys(AnimationChannel& channel, float tolerance)
+        {
+            size_t keyCount = channel.times.size();
+            size_t components = channel.getComponentCount();
+            if (keyCount < 2 || channel.interpolation == AnimationInterpolation::CubicSpline ||
+                channel.values.size() != keyCount * components) {
+                return;
+            }
+
+            bool isRotation = channel.path == AnimationPath::Rotation;
+            auto value = [&channel, components](size_t key) { return channel.values.data() + key * components; };
+
+            std::vector<size_t> kept;
+            kept.push_back(0);
+
+            if (channel.interpolation == AnimationInterpolation::Step) {
+                // A step key that repeats the last kept value changes nothing
+                for (size_t key = 1; key + 1 < keyCount; key++) {
+                    if (keyError(value(key), value(kept.back()), components, isRotation) > tolerance) {
+                        kept.push_back(key);
+                    }
+                }
+            }
+            else {
+                // Grow each segment until interpolating over it misses one of the keys it would replace
+                size_t start = 0;
+                float interpolated[4];
+                for (size_t end = 2; end < keyCount; end++) {
+                    bool fits = end - start <= MAX_REDUCTION_SPAN;
+                    float span = channel.times[end] - channel.times[start];
+                    for (size_t key = start + 1; key < end && fits; key++) {
+                        float t = span > 0.0f ? (channel.times[key] - channel.times[start]) / span : 0.0f;
+                        interpolateKey(value(start), value(end), components, isRotation, t, interpolated);
+                        fits = keyError(interpolated, value(key), components, isRotation) <= tolerance;
+                    }
+
+                    if (!fits) {
+                        kept.push_back(end - 1);
+                        start = end - 1;
+                    }
+                }
+            }
+
+            // The last key stays, it ends the track. A constant track collapses to its first key
+            if (kept.size() == 1 && keyError(value(0), value(keyCount - 1), components, isRotation) <= tolerance) {
+                channel.times.resize(1);
+                channel.values.resize(components);
+                return;
+            }
+            kept.push_back(keyCount - 1);
+
+            for (size_t i = 0; i < kept.size(); i++) {
+                channel.times[i] = channel.times[kept[i]];
+                std::memmove(value(i), value(kept[i]), components * sizeof(float));
+            }
+            channel.times.resize(kept.size());
+            channel.values.resize(kept.size() * components);
+        }
+
+        CompressedClipData compress(std::vector<AnimationChannel>& channels, const Skeleton& skeleton, const AnimationCompressionSettings& settings)
+        {
+            RAPTURE_PROFILE_FUNCTION();
+
+            CompressedClipData data;
+
+            // The duration comes from the raw keys, reduction may not shorten the clip
+            for (const AnimationChannel& channel : channels) {
+                if (!channel.times.empty()) {
+                    data.duration = std::max(data.duration, channel.times.back());
+                }
+            }
+
+            // Tracks in joint order, so sampling writes the pose front to back as well
+            std::stable_sort(channels.begin(), channels.end(), [](const AnimationChannel& a, const AnimationChannel& b) {
+                return a.joint != b.joint ? a.joint < b.joint : a.path < b.path;
+            });
+
+            for (AnimationChannel& channel : channels) {
+                if (channel.times.empty() || channel.joint >= skeleton.getJointCount()) {
+                    continue;
+                }
+
+                float tolerance = getTolerance(channel.path, settings);
+                reduceKeys(channel, tolerance);
+
+                bool isCubic = channel.interpolation == AnimationInterpolation::CubicSpline;
+                if (!isCubic && channel.times.size() == 1 && matchesRestPose(channel, skeleton.restPose[channel.joint], tolerance)) {
+                    continue;
+                }
+
+                CompressedTrack& track = data.tracks.emplace_back();
+                track.joint = channel.joint;
+                track.path = channel.path;
+                track.interpolation = channel.interpolation;
+                track.keyCount = static_cast<uint32_t>(channel.times.size());
+                track.timeOffset = static_cast<uint32_t>(data.times.size());
+
+                for (float time : channel.times) {
+                    float normalized = data.duration > 0.0f ? std::clamp(time / data.duration, 0.0f, 1.0f) : 0.0f;
+                    data.times.push_back(static_cast<uint16_t>(std::lround(normalized * QUANTIZED_RANGE)));
+                }
+
+                // Tangents can be far outside the value range, so cubic keys stay exact
+                if (isCubic) {
+                    track.format = AnimationKeyFormat::Float;
+                    track.valueOffset = static_cast<uint32_t>(data.floatValues.size());
+                    data.floatValues.insert(data.floatValues.end(), channel.values.begin(), channel.values.end());
+                    continue;
+                }
+
+                track.format = AnimationKeyFormat::Quantized;
+                track.valueOffset = static_cast<uint32_t>(data.quantizedValues.size());
+                size_t components = channel.getComponentCount();
+                size_t firstWord = data.quantizedValues.size();
+                data.quantizedValues.resize(firstWord + channel.times.size() * 3);
+                uint16_t* words = data.quantizedValues.data() + firstWord;
+
+                if (channel.path == AnimationPath::Rotation) {
+                    for (size_t key = 0; key < channel.times.size(); key++) {
+                        const float* v = channel.values.data() + key * components;
+                        encodeRotation(glm::normalize(glm::quat(v[3], v[0], v[1], v[2])), words + key * 3);
+                    }
+                    continue;
+                }
+
+                // Translation and scale are quantized to the track's own range, which is far tighter than the clip's
+                glm::vec3 rangeMin(std::numeric_limits<float>::max());
+                glm::vec3 rangeMax(std::numeric_limits<float>::lowest());
+                for (size_t key = 0; key < channel.times.size(); key++) {
+                    glm::vec3 v = glm::make_vec3(channel.values.data() + key * components);
+                    rangeMin = glm::min(rangeMin, v);
+                    rangeMax = glm::max(rangeMax, v);
+                }
+                glm::vec3 extent = rangeMax - rangeMin;
+                track.rangeMin = rangeMin;
+                track.rangeScale = extent / QUANTIZED_RANGE;
+
+                for (size_t key = 0; key < channel.times.size(); key++) {
+                    const float* v = channel.values.data() + key * components;
+                    for (int c = 0; c < 3; c++) {
+                        float normalized = extent[c] > 0.0f ? (v[c] - rangeMin[c]) / extent[c] : 0.0f;
+                        words[key * 3 + c] = static_cast<uint16_t>(std::lround(std::clamp(normalized, 0.0f, 1.0f) * QUANTIZED_RANGE));
+                    }
+                }
+            }
+
+            return data;
+        }
+
+        size_t getRawSize(const std::vector<AnimationChannel>& channels)
+        {
+            size_t bytes = 0;
+            for (const AnimationChannel& channel : channels) {
+                bytes += sizeof(AnimationChannel) + (channel.times.size() + channel.values.size()) * sizeof(float);
+            }
+            return bytes;
+        }
+
+    }
+
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "AnimationClip.h"
+
+namespace Rapture {
+
+    // Largest error key reduction may introduce per track, checked at the original key times
+    struct AnimationCompressionSettings {
+        bool enabled = true;
+        float translationTolerance = 0.0005f;   // model units
+        float rotationTolerance = 0.001f;       // radians
+        float scaleTolerance = 0.0005f;
+    };
+
+    namespace AnimationCompression {
+
+        constexpr float QUANTIZED_RANGE = 65535.0f;
+
+        // The three smallest components of a unit quaternion lie in [-1/sqrt(2), 1/sqrt(2)]
+        constexpr float SMALLEST_THREE_RANGE = 0.70710678f;
+        constexpr float SMALLEST_THREE_STEPS = 32767.0f;
+
+        /**
+         * @brief Pack a unit quaternion into 48 bits, three 15 bit components and the index of the dropped one
+         *
+         * The dropped (largest) component is made positive, so the decoded quaternion may be the negated input.
+         *
+         * @param q Unit quaternion
+         * @param out Receives 3 words, the index is split over the top bits of the first two
+         */
+        inline void encodeRotation(const glm::quat& q, uint16_t* out) {
+            float components[4] = { q.x, q.y, q.z, q.w };
+
+            int largest = 0;
+            for (int i = 1; i < 4; i++) {
+                if (std::abs(components[i]) > std::abs(components[largest])) {
+                    largest = i;
+                }
+            }
+            float sign = components[largest] < 0.0f ? -1.0f : 1.0f;
+
+            int word = 0;
+            for (int i = 0; i < 4; i++) {
+                if (i == largest) {
+                    continue;
+                }
+                float normalized = std::clamp(components[i] * sign / SMALLEST_THREE_RANGE, -1.0f, 1.0f) * 0.5f + 0.5f;
+                out[word++] = static_cast<uint16_t>(std::lround(normalized * SMALLEST_THREE_STEPS));
+            }
+            out[0] |= static_cast<uint16_t>((largest & 1) << 15);
+            out[1] |= static_cast<uint16_t>((largest >> 1) << 15);
+        }
+
+        inline glm::quat decodeRotation(const uint16_t* in) {
+            int largest = (in[0] >> 15) | ((in[1] >> 15) << 1);
+
+            float components[4];
+            float sumSquares = 0.0f;
+            int word = 0;
+            for (int i = 0; i < 4; i++) {
+                if (i == largest) {
+                    continue;
+                }
+                float normalized = static_cast<float>(in[word++] & 0x7FFF) / SMALLEST_THREE_STEPS;
+                components[i] = (normalized * 2.0f - 1.0f) * SMALLEST_THREE_RANGE;
+                sumSquares += components[i] * components[i];
+            }
+            components[largest] = std::sqrt(std::max(0.0f, 1.0f - sumSquares));
+
+            return glm::quat(components[3], components[0], components[1], components[2]);
+        }
+
+        inline glm::vec3 decodeVector(const uint16_t* in, const glm::vec3& rangeMin, const glm::vec3& rangeScale) {
+            return rangeMin + glm::vec3(in[0], in[1], in[2]) * rangeScale;
+        }
+
+        /**
+         * @brief Drop the keys the track's interpolation reproduces within tolerance
+         *
+         * Linear tracks keep the keys that bound a segment, step tracks drop repeated values,
+         * cubic spline tracks are left alone since their tangents depend on every key.
+         *
+         * @param channel Channel to reduce in place
+         * @param tolerance Largest error allowed at any removed key, in the channel's units
+         */
+        void reduceKeys(AnimationChannel& channel, float tolerance);
+
+        /**
+         * @brief Reduce, quantize and pack the channels of one clip
+         *
+         * Tracks that reduce to a single key equal to the rest pose are dropped, the rest pose already covers them.
+         *
+         * @param channels Raw channels, reduced in place
+         * @param skeleton Skeleton the clip animates
+         * @param settings Tolerances for key reduction
+         * @return The packed clip data
+         */
+        CompressedClipData compress(std::vector<AnimationChannel>& channels, const Skeleton& skeleton, const AnimationCompressionSettings& settings);
+
+        // Bytes the raw channels occupy, for comparing against the compressed clip
+        size_t getRawSize(const std::vector<AnimationChannel>& channels);
+
+    }
+
+}
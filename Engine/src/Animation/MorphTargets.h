@@ -0,0 +1,85 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include "SkinningMath.h"
+
+namespace Rapture {
+
+    // Deltas smaller than this in every component are dropped on import, they can't move a vertex visibly
+    constexpr float MORPH_DELTA_EPSILON = 1e-6f;
+
+    // Sparse deltas of one target: entries [firstEntry, firstEntry + entryCount) of the set
+    struct MorphTarget {
+        std::string name;
+        uint32_t firstEntry = 0;
+        uint32_t entryCount = 0;
+    };
+
+    // Blend shapes of one primitive, immutable after import and shared by every entity drawing the primitive.
+    // Only the vertices a target actually moves are stored, every entry is a vertex index and a pair of vec4
+    // (position delta, normal delta) so the blend can add whole registers without unpacking
+    struct MorphTargetSet {
+        uint32_t vertexCount = 0;
+        std::vector<MorphTarget> targets;
+        std::vector<uint32_t> vertices;
+        std::vector<glm::vec4> deltas;      // 2 per entry
+
+        size_t getTargetCount() const { return targets.size(); }
+
+        // Index of the target with the given name, -1 if there is none
+        int32_t findTarget(const std::string& name) const {
+            for (size_t i = 0; i < targets.size(); i++) {
+                if (targets[i].name == name) {
+                    return static_cast<int32_t>(i);
+                }
+            }
+            return -1;
+        }
+    };
+
+    namespace MorphTargetBlend {
+
+        /**
+         * @brief Add one weighted target onto dense per-vertex deltas, touching only the vertices it moves
+         *
+         * @param set Set the target belongs to
+         * @param target Index of the target
+         * @param weight Weight of the target, callers skip zero weights
+         * @param out Two vec4 (position, normal) per vertex of the set
+         */
+        inline void accumulate(const MorphTargetSet& set, size_t target, float weight, glm::vec4* out) {
+            const MorphTarget& range = set.targets[target];
+            // Targets that move nothing keep their slot, their firstEntry may be one past the last entry
+            if (range.entryCount == 0) {
+                return;
+            }
+            const uint32_t* vertices = set.vertices.data() + range.firstEntry;
+            const float* deltas = reinterpret_cast<const float*>(set.deltas.data() + static_cast<size_t>(range.firstEntry) * 2);
+
+#if RAPTURE_SKINNING_SSE
+            __m128 w = _mm_set1_ps(weight);
+            for (uint32_t i = 0; i < range.entryCount; i++) {
+                float* dst = &out[static_cast<size_t>(vertices[i]) * 2].x;
+                const float* src = deltas + static_cast<size_t>(i) * 8;
+                _mm_storeu_ps(dst, _mm_add_ps(_mm_loadu_ps(dst), _mm_mul_ps(w, _mm_loadu_ps(src))));
+                _mm_storeu_ps(dst + 4, _mm_add_ps(_mm_loadu_ps(dst + 4), _mm_mul_ps(w, _mm_loadu_ps(src + 4))));
+            }
+#else
+            for (uint32_t i = 0; i < range.entryCount; i++) {
+                float* dst = &out[static_cast<size_t>(vertices[i]) * 2].x;
+                const float* src = deltas + static_cast<size_t>(i) * 8;
+                for (int c = 0; c < 8; c++) {
+                    dst[c] += weight * src[c];
+                }
+            }
+#endif
+        }
+
+    }
+
+}
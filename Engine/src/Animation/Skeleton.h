@@ -0,0 +1,36 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+namespace Rapture {
+
+    // Local transform of one joint, kept as TRS so clips can override components independently
+    struct JointPose {
+        glm::vec3 translation = glm::vec3(0.0f);
+        glm::quat rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+        glm::vec3 scale = glm::vec3(1.0f);
+    };
+
+    // Joint hierarchy of a skin. Joints stay in the order the skin lists them, since that is what
+    // the JOINTS_0 attribute indexes, and evaluationOrder visits every parent before its children.
+    // Immutable after import, so every instance of a model shares one.
+    struct Skeleton {
+        std::string name;
+        std::vector<std::string> jointNames;
+        std::vector<int32_t> parents;                   // -1 for root joints
+        std::vector<uint32_t> evaluationOrder;
+        std::vector<glm::mat4> inverseBindMatrices;
+        std::vector<JointPose> restPose;                // pose of joints no channel animates
+
+        // Static transform above each root joint (its non-joint ancestors), identity for the other joints
+        std::vector<glm::mat4> rootTransforms;
+
+        size_t getJointCount() const { return parents.size(); }
+    };
+
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "Skeleton.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define RAPTURE_SKINNING_SSE 1
+    #include <xmmintrin.h>
+#else
+    #define RAPTURE_SKINNING_SSE 0
+#endif
+
+namespace Rapture {
+
+    namespace SkinningMath {
+
+        // out = a * b for column major 4x4 matrices, out may alias neither input
+        inline void multiply(const glm::mat4& a, const glm::mat4& b, glm::mat4& out) {
+#if RAPTURE_SKINNING_SSE
+            const float* pa = &a[0][0];
+            const float* pb = &b[0][0];
+            float* po = &out[0][0];
+
+            __m128 a0 = _mm_loadu_ps(pa);
+            __m128 a1 = _mm_loadu_ps(pa + 4);
+            __m128 a2 = _mm_loadu_ps(pa + 8);
+            __m128 a3 = _mm_loadu_ps(pa + 12);
+
+            // Column i of the result is a's columns weighted by the entries of b's column i
+            for (int i = 0; i < 4; i++) {
+                __m128 r = _mm_mul_ps(a0, _mm_set1_ps(pb[i * 4 + 0]));
+                r = _mm_add_ps(r, _mm_mul_ps(a1, _mm_set1_ps(pb[i * 4 + 1])));
+                r = _mm_add_ps(r, _mm_mul_ps(a2, _mm_set1_ps(pb[i * 4 + 2])));
+                r = _mm_add_ps(r, _mm_mul_ps(a3, _mm_set1_ps(pb[i * 4 + 3])));
+                _mm_storeu_ps(po + i * 4, r);
+            }
+#else
+            out = a * b;
+#endif
+        }
+
+        // Builds translation * rotation * scale without going through three full matrix products
+        inline glm::mat4 composeTRS(const JointPose& pose) {
+            glm::mat3 rotation = glm::mat3_cast(pose.rotation);
+            glm::mat4 result(1.0f);
+            result[0] = glm::vec4(rotation[0] * pose.scale.x, 0.0f);
+            result[1] = glm::vec4(rotation[1] * pose.scale.y, 0.0f);
+            result[2] = glm::vec4(rotation[2] * pose.scale.z, 0.0f);
+            result[3] = glm::vec4(pose.translation, 1.0f);
+            return result;
+        }
+
+        /**
+         * @brief Turn local joint poses into skinning matrices (model space joint * inverse bind)
+         *
+         * @param skeleton Joint hierarchy the pose belongs to
+         * @param pose One local pose per joint
+         * @param modelSpace Scratch space for one matrix per joint
+         * @param palette Receives one skinning matrix per joint
+         */
+        inline void buildPalette(const Skeleton& skeleton, const JointPose* pose, glm::mat4* modelSpace, glm::mat4* palette) {
+            for (uint32_t joint : skeleton.evaluationOrder) {
+                glm::mat4 local = composeTRS(pose[joint]);
+                int32_t parent = skeleton.parents[joint];
+                multiply(parent >= 0 ? modelSpace[parent] : skeleton.rootTransforms[joint], local, modelSpace[joint]);
+            }
+
+            size_t jointCount = skeleton.getJointCount();
+            for (size_t joint = 0; joint < jointCount; joint++) {
+                multiply(modelSpace[joint], skeleton.inverseBindMatrices[joint], palette[joint]);
+            }
+        }
+
+    }
+
+}
@@ -3,6 +3,7 @@
 #include "Buffers.h"
 #include "glad/glad.h"
 #include <vector>
+#include <cstring>
 #include <unordered_map>
 #include "VertexArray.h"
 
@@ -39,17 +40,17 @@ namespace Rapture {
         /**
          * @brief Convert non-interleaved vertex data to interleaved format
          * 
-         * @param attributes Map of attribute names to their data
+         * @param attributes Map of attribute semantics to their data
          * @param vertexCount Number of vertices
          * @return std::vector<unsigned char> Interleaved vertex data
          */
         inline std::vector<unsigned char> convertToInterleaved(
-            const std::unordered_map<std::string, std::vector<unsigned char>>& attributes,
+            const std::unordered_map<VertexAttributeSemantic, std::vector<unsigned char>>& attributes,
             size_t vertexCount) 
         {
             // Calculate vertex size
             size_t vertexSize = 0;
-            for (const auto& [name, data] : attributes) {
+            for (const auto& [semantic, data] : attributes) {
                 vertexSize += data.size() / vertexCount;
             }
 
@@ -60,7 +61,7 @@ namespace Rapture {
             for (size_t vertexIndex = 0; vertexIndex < vertexCount; vertexIndex++) {
                 size_t outputOffset = vertexIndex * vertexSize;
                 
-                for (const auto& [name, data] : attributes) {
+                for (const auto& [semantic, data] : attributes) {
                     size_t attributeSize = data.size() / vertexCount;
                     size_t inputOffset = vertexIndex * attributeSize;
                     
@@ -84,38 +85,38 @@ namespace Rapture {
          * @param interleavedData Interleaved vertex data
          * @param layout Buffer layout containing attribute information
          * @param vertexCount Number of vertices
-         * @return std::unordered_map<std::string, std::vector<unsigned char>> Map of attribute names to their data
+         * @return std::unordered_map<VertexAttributeSemantic, std::vector<unsigned char>> Map of attribute semantics to their data
          */
-        inline std::unordered_map<std::string, std::vector<unsigned char>> convertToNonInterleaved(
+        inline std::unordered_map<VertexAttributeSemantic, std::vector<unsigned char>> convertToNonInterleaved(
             const std::vector<unsigned char>& interleavedData,
             const BufferLayout& layout,
             size_t vertexCount)
         {
-            std::unordered_map<std::string, std::vector<unsigned char>> result;
+            std::unordered_map<VertexAttributeSemantic, std::vector<unsigned char>> result;
             
-            if (!layout.isInterleaved || layout.vertexSize == 0) {
+            if (!layout.isInterleaved() || layout.getVertexSize() == 0) {
                 GE_CORE_ERROR("convertToNonInterleaved: Layout must be interleaved with valid vertex size");
                 return result;
             }
 
             // Initialize output buffers for each attribute
-            for (const auto& attrib : layout.buffer_attribs) {
+            for (const auto& attrib : layout.getAttributes()) {
                 size_t attributeSize = attrib.getSizeInBytes();
-                result[attrib.name].resize(attributeSize * vertexCount);
+                result[attrib.semantic].resize(attributeSize * vertexCount);
             }
 
             // Extract each attribute into its own buffer
             for (size_t vertexIndex = 0; vertexIndex < vertexCount; vertexIndex++) {
-                size_t inputOffset = vertexIndex * layout.vertexSize;
+                size_t inputOffset = vertexIndex * layout.getVertexSize();
                 
-                for (const auto& attrib : layout.buffer_attribs) {
+                for (const auto& attrib : layout.getAttributes()) {
                     size_t attributeSize = attrib.getSizeInBytes();
                     size_t attributeOffset = attrib.offset;
                     size_t outputOffset = vertexIndex * attributeSize;
                     
                     // Copy this attribute's data for this vertex
                     std::memcpy(
-                        result[attrib.name].data() + outputOffset,
+                        result[attrib.semantic].data() + outputOffset,
                         interleavedData.data() + inputOffset + attributeOffset,
                         attributeSize
                     );
@@ -133,10 +134,135 @@ namespace Rapture {
          */
         inline BufferLayout createInterleavedLayout(const std::vector<BufferAttribute>& attributes) {
             BufferLayout layout;
-            layout.isInterleaved = true;
-            layout.buffer_attribs = attributes;
+            layout.setInterleaved(true);
+            layout.setAttributes(attributes);
             layout.updateOffsets(); // This will calculate offsets and vertex size
             return layout;
         }
+
+        /**
+         * @brief Copy a fixed size element count times between two strided arrays
+         *
+         * The size is a template parameter so each memcpy compiles to a few vector loads and stores.
+         */
+        template<size_t ElementSize>
+        inline void copyStridedFixed(unsigned char* dst, size_t dstStride, const unsigned char* src, size_t srcStride, size_t count) {
+            for (size_t i = 0; i < count; i++) {
+                std::memcpy(dst, src, ElementSize);
+                dst += dstStride;
+                src += srcStride;
+            }
+        }
+
+        /**
+         * @brief Copy count elements between two strided arrays, e.g. from a glTF buffer view into an interleaved vertex buffer
+         *
+         * Common attribute sizes are dispatched to copyStridedFixed, tightly packed data on both sides is one memcpy.
+         *
+         * @param dst Destination of the first element
+         * @param dstStride Bytes between consecutive destination elements
+         * @param src Source of the first element
+         * @param srcStride Bytes between consecutive source elements
+         * @param elementSize Bytes copied per element
+         * @param count Number of elements
+         */
+        inline void copyStrided(unsigned char* dst, size_t dstStride, const unsigned char* src, size_t srcStride, size_t elementSize, size_t count) {
+            if (dstStride == elementSize && srcStride == elementSize) {
+                std::memcpy(dst, src, elementSize * count);
+                return;
+            }
+
+            switch (elementSize) {
+                case 4:  copyStridedFixed<4>(dst, dstStride, src, srcStride, count); break;   // e.g. normalized u8 vec4, f32 scalar
+                case 8:  copyStridedFixed<8>(dst, dstStride, src, srcStride, count); break;   // f32 vec2
+                case 12: copyStridedFixed<12>(dst, dstStride, src, srcStride, count); break;  // f32 vec3
+                case 16: copyStridedFixed<16>(dst, dstStride, src, srcStride, count); break;  // f32 vec4
+                default:
+                    for (size_t i = 0; i < count; i++) {
+                        std::memcpy(dst + i * dstStride, src + i * srcStride, elementSize);
+                    }
+                    break;
+            }
+        }
+
+        /**
+         * @brief Size in bytes of a single index
+         */
+        inline size_t getIndexSize(unsigned int indexType) {
+            switch (indexType) {
+                case GL_UNSIGNED_BYTE:  return 1;
+                case GL_UNSIGNED_SHORT: return 2;
+                case GL_UNSIGNED_INT:   return 4;
+                default:                return 0;
+            }
+        }
+
+        /**
+         * @brief Index type a mesh with vertexCount vertices is stored with
+         *
+         * u8 is poorly supported by hardware and u32 doubles the memory of most meshes, so u16 is
+         * used whenever every index fits. 0xFFFF is kept free since it is the primitive restart index.
+         */
+        inline unsigned int chooseIndexType(size_t vertexCount) {
+            return vertexCount <= 0xFFFF ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+        }
+
+        /**
+         * @brief Vertices in the vertex data of a layout, counted in the position stream when it has one
+         */
+        inline size_t getVertexCount(const BufferLayout& layout, size_t vertexDataSize, size_t positionDataSize) {
+            if (layout.hasPositionStream()) {
+                return layout.getPositionStride() > 0 ? positionDataSize / layout.getPositionStride() : 0;
+            }
+            return layout.getVertexSize() > 0 ? vertexDataSize / layout.getVertexSize() : 0;
+        }
+
+        /**
+         * @brief Rewrite indices with another index type, usually the one chooseIndexType picked
+         *
+         * @param indexData Raw index data, replaced by the converted data on success
+         * @param indexCount Number of indices in indexData
+         * @param indexType GL index type of indexData, updated on success
+         * @param targetType GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+         * @return true if the data was converted, false if it already had the type, is too short or an index doesn't fit.
+         *         u16 data is never widened
+         */
+        inline bool convertIndices(std::vector<unsigned char>& indexData, size_t indexCount, unsigned int& indexType, unsigned int targetType) {
+            size_t sourceSize = getIndexSize(indexType);
+            if (indexType == targetType || indexCount == 0 || sourceSize == 0 ||
+                (targetType != GL_UNSIGNED_SHORT && targetType != GL_UNSIGNED_INT) ||
+                indexData.size() < indexCount * sourceSize) {
+                return false;
+            }
+            // u16 data already fits the GPU well, widening it would only cost memory
+            if (indexType == GL_UNSIGNED_SHORT && targetType == GL_UNSIGNED_INT) {
+                return false;
+            }
+
+            std::vector<unsigned char> converted(indexCount * getIndexSize(targetType));
+            for (size_t i = 0; i < indexCount; i++) {
+                uint32_t index = 0;
+                switch (indexType) {
+                    case GL_UNSIGNED_BYTE:  index = indexData[i]; break;
+                    case GL_UNSIGNED_SHORT: { uint16_t v; std::memcpy(&v, indexData.data() + i * 2, 2); index = v; break; }
+                    default:                std::memcpy(&index, indexData.data() + i * 4, 4); break;
+                }
+
+                if (targetType == GL_UNSIGNED_SHORT) {
+                    if (index >= 0xFFFF) {
+                        return false;
+                    }
+                    uint16_t narrowed = static_cast<uint16_t>(index);
+                    std::memcpy(converted.data() + i * 2, &narrowed, 2);
+                }
+                else {
+                    std::memcpy(converted.data() + i * 4, &index, 4);
+                }
+            }
+
+            indexData = std::move(converted);
+            indexType = targetType;
+            return true;
+        }
     }
 } // namespace Rapture
\ No newline at end of file
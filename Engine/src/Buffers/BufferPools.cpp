@@ -7,6 +7,8 @@
 #include "OpenGLBuffers/VertexBuffers/OpenGLVertexBuffer.h"
 #include "OpenGLBuffers/IndexBuffers/OpenGLIndexBuffer.h"
 #include "VertexArray.h"
+#include "BufferConversionHelpers.h"
+#include "../Renderer/RenderThread.h"
 
 namespace Rapture {
 
@@ -30,7 +32,8 @@ namespace Rapture {
     void BufferPoolManager::shutdown() {
         if (s_instance) {
             s_instance->m_vaoToBufferAllocationsMap.clear();
-            s_instance->m_layoutToVAOMap.clear();
+            s_instance->m_poolKeyToVAOMap.clear();
+            s_instance->m_vaoToPositionVAOMap.clear();
             s_instance.reset();
             GE_CORE_INFO("BufferPoolManager shutdown");
         }
@@ -57,22 +60,68 @@ namespace Rapture {
         const void* vertexData, size_t vertexDataSize,
         const void* indexData, size_t indexDataSize, size_t indexCount,
         unsigned int indexType)
+    {
+        if (layout.hasPositionStream()) {
+            GE_CORE_ERROR("BufferPoolManager::allocateMeshData: Layouts with a separate position stream have to be uploaded through the BufferUploadQueue");
+            return MeshBufferData();
+        }
+
+        // Store u16 whenever the vertex count allows it, halves the index memory of most meshes
+        unsigned int targetIndexType = BufferConversionHelpers::chooseIndexType(BufferConversionHelpers::getVertexCount(layout, vertexDataSize, 0));
+        std::vector<unsigned char> convertedIndices;
+        if (indexType != targetIndexType && indexData != nullptr) {
+            convertedIndices.assign(static_cast<const unsigned char*>(indexData), static_cast<const unsigned char*>(indexData) + indexDataSize);
+            if (BufferConversionHelpers::convertIndices(convertedIndices, indexCount, indexType, targetIndexType)) {
+                indexData = convertedIndices.data();
+                indexDataSize = convertedIndices.size();
+            }
+        }
+
+        MeshBufferData meshData = reserveMeshData(layout, vertexDataSize, indexDataSize, indexCount, indexType);
+
+        if (!meshData.vao) {
+            return meshData;
+        }
+
+        meshData.vao->getVertexBuffer()->setData(vertexData, vertexDataSize, meshData.vertexAllocation->offsetBytes);
+        meshData.vao->getIndexBuffer()->setData(indexData, indexDataSize, meshData.indexAllocation->offsetBytes);
+
+        return meshData;
+    }
+
+    MeshBufferData BufferPoolManager::reserveMeshData(
+        const BufferLayout& layout,
+        size_t vertexDataSize, size_t indexDataSize, size_t indexCount,
+        unsigned int indexType)
     {
         std::lock_guard<std::mutex> lock(m_mutex);
         
         MeshBufferData meshData;
+
+        if (indexType != GL_UNSIGNED_SHORT && indexType != GL_UNSIGNED_INT) {
+            GE_CORE_ERROR("BufferPoolManager: Unsupported index type {0}, indices should be u16 or u32", indexType);
+            return meshData;
+        }
+
+        // Round the sizes so every range starts aligned: whole vertices for the base vertex, 4 bytes for the index offset
+        size_t vertexStride = layout.getVertexSize() > 0 ? layout.getVertexSize() : 1;
+        size_t alignedVertexDataSize = ((vertexDataSize + vertexStride - 1) / vertexStride) * vertexStride;
+        size_t alignedIndexDataSize = (indexDataSize + INDEX_ALLOCATION_ALIGNMENT - 1) & ~(INDEX_ALLOCATION_ALIGNMENT - 1);
         
-        // Find or create a vertex array with the given buffer layout
-        auto vao = findOrCreateVertexArray(layout, vertexDataSize, indexDataSize, indexType);
+        // Find or create a vertex array with the given buffer layout and index type
+        auto vao = findOrCreateVertexArray(layout, alignedVertexDataSize, alignedIndexDataSize, indexType);
 
         // allocate the vertex data
-        auto vertexAllocation = allocateBuffer(vao, BufferType::Vertex, vertexDataSize);
+        auto vertexAllocation = allocateBuffer(vao, BufferType::Vertex, alignedVertexDataSize);
         // allocate the index data
-        auto indexAllocation = allocateBuffer(vao, BufferType::Index, indexDataSize);
+        auto indexAllocation = allocateBuffer(vao, BufferType::Index, alignedIndexDataSize);
 
 
         if (!vertexAllocation || !indexAllocation) {
             GE_CORE_ERROR("Failed to allocate vertex or index buffer");
+            // give back whichever half did succeed, it would leak otherwise
+            if (vertexAllocation) vertexAllocation->isAllocated = false;
+            if (indexAllocation) indexAllocation->isAllocated = false;
             return meshData;
         }
 
@@ -81,12 +130,14 @@ namespace Rapture {
         meshData.indexAllocation = indexAllocation;
         meshData.indexType = indexType;
         meshData.indexCount = indexCount;
-        meshData.vertexOffsetInVertices = vertexAllocation->offsetBytes / vao->getBufferLayout().vertexSize;
+        meshData.vertexOffsetInVertices = vertexAllocation->offsetBytes / vao->getBufferLayout().getVertexSize();
 
-        vao->getVertexBuffer()->setData(vertexData, vertexDataSize, vertexAllocation->offsetBytes);
-        vao->getIndexBuffer()->setData(indexData, indexDataSize, indexAllocation->offsetBytes);
+        // The position range follows the vertex range, there is no separate allocator for it
+        if (vao->getPositionBuffer()) {
+            meshData.positionVAO = m_vaoToPositionVAOMap[vao->getID()];
+            meshData.positionOffsetBytes = meshData.vertexOffsetInVertices * vao->getBufferLayout().getPositionStride();
+        }
 
-        
         return meshData;
     }
 
@@ -153,18 +204,93 @@ namespace Rapture {
     void BufferPoolManager::freeMeshData(MeshBufferData& meshData) {
         std::lock_guard<std::mutex> lock(m_mutex);
 
-        meshData.vertexAllocation->isAllocated = false;
-        meshData.indexAllocation->isAllocated = false;
+        // meshes that never finished uploading have no allocations
+        if (meshData.vertexAllocation) {
+            meshData.vertexAllocation->isAllocated = false;
+        }
+        if (meshData.indexAllocation) {
+            meshData.indexAllocation->isAllocated = false;
+        }
+    }
+
+    BufferPoolStats BufferPoolManager::getPoolStats() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        BufferPoolStats stats;
+        stats.vaoCount = m_vaoToBufferAllocationsMap.size();
+
+        // the low half of the pool key is the index type
+        std::unordered_map<unsigned int, unsigned int> vaoIndexTypes;
+        std::unordered_map<unsigned int, std::shared_ptr<VertexArray>> vaos;
+        for (auto& [poolKey, vao] : m_poolKeyToVAOMap) {
+            vaoIndexTypes[vao->getID()] = static_cast<unsigned int>(poolKey & 0xFFFFFFFF);
+            vaos[vao->getID()] = vao;
+        }
+
+        for (auto& [vaoId, allocations] : m_vaoToBufferAllocationsMap) {
+            // every vao owns exactly one vertex and one index page
+            BufferPoolPageStats vertexPage;
+            BufferPoolPageStats indexPage;
+            vertexPage.vaoID = vaoId;
+            vertexPage.bufferType = BufferType::Vertex;
+            indexPage.vaoID = vaoId;
+            indexPage.bufferType = BufferType::Index;
+            indexPage.indexType = vaoIndexTypes[vaoId];
+
+            for (auto& allocation : allocations) {
+                BufferPoolPageStats& page = allocation->bufferType == BufferType::Vertex ? vertexPage : indexPage;
+                page.capacityBytes += allocation->sizeBytes;
+
+                if (allocation->isAllocated) {
+                    page.usedBytes += allocation->sizeBytes;
+                    page.allocationCount++;
+                } else {
+                    page.freeBytes += allocation->sizeBytes;
+                    page.largestFreeBlockBytes = std::max(page.largestFreeBlockBytes, allocation->sizeBytes);
+                    page.freeBlockCount++;
+                }
+            }
+
+            // the position page mirrors the vertex page, scaled from the attribute stride to the position stride
+            BufferPoolPageStats positionPage;
+            auto vaoIt = vaos.find(vaoId);
+            if (vaoIt != vaos.end() && vaoIt->second->getPositionBuffer()) {
+                const BufferLayout& layout = vaoIt->second->getBufferLayout();
+                auto toPositionBytes = [&layout](size_t vertexBytes) { return vertexBytes / layout.getVertexSize() * layout.getPositionStride(); };
+
+                positionPage = vertexPage;
+                positionPage.isPositionStream = true;
+                positionPage.capacityBytes = toPositionBytes(vertexPage.capacityBytes);
+                positionPage.usedBytes = toPositionBytes(vertexPage.usedBytes);
+                positionPage.freeBytes = toPositionBytes(vertexPage.freeBytes);
+                positionPage.largestFreeBlockBytes = toPositionBytes(vertexPage.largestFreeBlockBytes);
+                positionPage.allocationCount = 0; // already counted in the vertex page
+            }
+
+            for (auto& page : { vertexPage, positionPage, indexPage }) {
+                if (page.capacityBytes == 0) {
+                    continue;
+                }
+                stats.totalCapacityBytes += page.capacityBytes;
+                stats.totalUsedBytes += page.usedBytes;
+                stats.totalAllocationCount += page.allocationCount;
+                stats.pages.push_back(page);
+            }
+        }
+
+        return stats;
     }
 
     // guarantees a usable VAO
     std::shared_ptr<VertexArray> BufferPoolManager::findOrCreateVertexArray(const BufferLayout& layout, size_t vertexDataSize, size_t indexDataSize, unsigned int indexType) {
-        // Hash the layout to use as a key
-        size_t layoutHash = layout.hash();
+        // Interned layouts are keyed by id, anything else gets interned here once
+        uint32_t layoutID = layout.isInterned() ? layout.getLayoutID() : BufferLayout(layout).intern();
         
-        // Check if we already have a VAO for this layout
-        auto it = m_layoutToVAOMap.find(layoutHash);
-        if (it != m_layoutToVAOMap.end() && it->second) {
+        uint64_t poolKey = makePoolKey(layoutID, indexType);
+        
+        // Check if we already have a VAO for this layout and index width
+        auto it = m_poolKeyToVAOMap.find(poolKey);
+        if (it != m_poolKeyToVAOMap.end() && it->second) {
             auto vao = it->second;
             unsigned int vaoId = vao->getID();
             if (vaoId == 0) {
@@ -196,6 +322,12 @@ namespace Rapture {
             }
         }
 
+        // VAOs aren't shared between contexts, one created on another thread can't be bound by the render thread
+        if (RenderThread::isRunning() && !RenderThread::isRenderThread()) {
+            GE_CORE_ERROR("BufferPoolManager: New VAOs have to be created on the render thread while it runs");
+            return nullptr;
+        }
+
         // Create a new VAO for this layout
         auto vao = std::make_shared<VertexArray>();
         if (!vao) {
@@ -213,17 +345,46 @@ namespace Rapture {
         size_t indexPoolSize;
         calculateNewBufferPairSize(vertexDataSize, indexDataSize, vertexPoolSize, indexPoolSize);
 
-        GE_CORE_INFO("BufferPoolManager: Creating new VAO with vertex pool size: {0}MB and index pool size: {1}MB", vertexPoolSize/1024.0f/1024.0f, indexPoolSize/1024.0f/1024.0f);
+        GE_CORE_INFO("BufferPoolManager: Creating new VAO with vertex pool size: {0}MB and {1} index pool size: {2}MB", vertexPoolSize/1024.0f/1024.0f, indexType == GL_UNSIGNED_SHORT ? "u16" : "u32", indexPoolSize/1024.0f/1024.0f);
 
         auto vertexBuffer = std::make_shared<VertexBuffer>(vertexPoolSize);
         auto indexBuffer = std::make_shared<IndexBuffer>(indexPoolSize, indexType);
 
+        const BufferLayout& internedLayout = BufferLayout::getInterned(layoutID);
+
         vao->setVertexBuffer(vertexBuffer);
         vao->setIndexBuffer(indexBuffer);
-        vao->setBufferLayout(layout);
+
+        if (internedLayout.hasPositionStream()) {
+            // Sized so every vertex slot in the attribute pool has a matching position slot
+            size_t positionPoolSize = (vertexPoolSize / internedLayout.getVertexSize()) * internedLayout.getPositionStride();
+            auto positionBuffer = std::make_shared<VertexBuffer>(positionPoolSize);
+            vao->setPositionBuffer(positionBuffer);
+
+            // Second VAO over the same position and index buffers, reading nothing but positions
+            BufferLayout positionLayout;
+            positionLayout.setInterleaved(true);
+            positionLayout.setPositionStream(true, 0);
+            for (const auto& attrib : internedLayout.getAttributes()) {
+                if (internedLayout.isInPositionStream(attrib)) {
+                    positionLayout.addAttribute(attrib);
+                }
+            }
+            positionLayout.calculateVertexSize();
+
+            auto positionVAO = std::make_shared<VertexArray>();
+            positionVAO->setPositionBuffer(positionBuffer);
+            positionVAO->setIndexBuffer(indexBuffer);
+            positionVAO->setBufferLayout(positionLayout);
+            m_vaoToPositionVAOMap[vaoId] = positionVAO;
+
+            GE_CORE_INFO("BufferPoolManager: VAO uses a separate position stream of {0}MB", positionPoolSize/1024.0f/1024.0f);
+        }
+
+        vao->setBufferLayout(internedLayout);
         
         // Store it in the maps
-        m_layoutToVAOMap[layout.hash()] = vao;
+        m_poolKeyToVAOMap[poolKey] = vao;
         m_vaoToBufferAllocationsMap[vaoId].push_back(std::make_shared<BufferAllocation>(0, vertexPoolSize, false, BufferType::Vertex, BufferUsage::Static));
         m_vaoToBufferAllocationsMap[vaoId].push_back(std::make_shared<BufferAllocation>(0, indexPoolSize, false, BufferType::Index, BufferUsage::Static));
         
@@ -30,6 +30,8 @@ namespace Rapture {
 
     constexpr float NEXT_BUFFER_SIZE_THRESHOLD = 0.15f; // 15% threshold for increasing buffer size
 
+    constexpr size_t INDEX_ALLOCATION_ALIGNMENT = 4;    // index ranges start on 4 bytes, valid offsets for u16 and u32 draws
+
 
     // Struct to represent an allocation within a buffer pool
     // TODOl should probably be split in 2 classes, becaus buffertype and usage will be duplicated a lot
@@ -50,6 +52,12 @@ namespace Rapture {
 
     };
 
+    // Which vertex streams a pass reads
+    enum class VertexStreamMode {
+        AllAttributes,      // regular shading
+        PositionOnly        // depth pre-pass, shadows, picking, occlusion
+    };
+
     // Struct to store mesh buffer data references
     struct MeshBufferData {
         std::shared_ptr<VertexArray> vao;     // Reference to the VAO
@@ -59,6 +67,16 @@ namespace Rapture {
         unsigned int indexType;               // GL_UNSIGNED_SHORT, GL_UNSIGNED_INT, etc.
         size_t vertexOffsetInVertices;
 
+        // Only set when the layout has a separate position stream. The position range is kept in lockstep with the
+        // vertex range (same vertex offset), so the same base vertex and index range work for both VAOs
+        std::shared_ptr<VertexArray> positionVAO = nullptr;
+        size_t positionOffsetBytes = 0;
+
+        // VAO to bind for a pass, falls back to the full VAO when the mesh has no position stream
+        const std::shared_ptr<VertexArray>& getVAO(VertexStreamMode mode) const {
+            return (mode == VertexStreamMode::PositionOnly && positionVAO) ? positionVAO : vao;
+        }
+
         MeshBufferData(
             std::shared_ptr<BufferAllocation> vertexAllocation=nullptr, 
             std::shared_ptr<BufferAllocation> indexAllocation=nullptr, 
@@ -82,6 +100,34 @@ namespace Rapture {
         }
     };
 
+    // Snapshot of a single pool page (one VBO or IBO owned by a pool VAO)
+    struct BufferPoolPageStats {
+        unsigned int vaoID = 0;
+        BufferType bufferType = BufferType::Vertex;
+        unsigned int indexType = 0;        // GL_UNSIGNED_SHORT or GL_UNSIGNED_INT for index pages
+        bool isPositionStream = false;     // vertex page holding the separate position stream
+        size_t capacityBytes = 0;
+        size_t usedBytes = 0;
+        size_t freeBytes = 0;
+        size_t largestFreeBlockBytes = 0;
+        size_t allocationCount = 0;        // blocks currently handed out to meshes
+        size_t freeBlockCount = 0;
+
+        // 0 when all free memory is one block, approaching 1 when it is scattered in small pieces
+        float fragmentation() const {
+            return freeBytes > 0 ? 1.0f - (float)largestFreeBlockBytes / (float)freeBytes : 0.0f;
+        }
+    };
+
+    // Snapshot of all pools, cheap enough to take every few frames for the editor
+    struct BufferPoolStats {
+        std::vector<BufferPoolPageStats> pages;
+        size_t totalCapacityBytes = 0;
+        size_t totalUsedBytes = 0;
+        size_t totalAllocationCount = 0;
+        size_t vaoCount = 0;
+    };
+
     // Manager class for all buffer pools
     class BufferPoolManager {
     public:
@@ -98,10 +144,10 @@ namespace Rapture {
         static BufferPoolManager& getInstance();
 
         void printBufferAllocations() {
-            for (auto& [i, vao] : m_layoutToVAOMap) {
+            for (auto& [poolKey, vao] : m_poolKeyToVAOMap) {
                 GE_CORE_INFO("BufferPoolManager:: vao: {0}", vao->getID());
                 vao->getBufferLayout().print();
-                GE_CORE_INFO("BufferPoolManager:: buffrlayour hash: {0}", vao->getBufferLayout().hash());
+                GE_CORE_INFO("BufferPoolManager:: buffer layout id: {0}", vao->getBufferLayout().getLayoutID());
                 auto& allocations = m_vaoToBufferAllocationsMap[vao->getID()];
                 for (auto& allocation : allocations) {
                     allocation->print();
@@ -109,6 +155,9 @@ namespace Rapture {
             }
         }
         
+        // Capacity, usage and fragmentation per pool page
+        BufferPoolStats getPoolStats();
+        
         // Allocate mesh data in buffer pools
         MeshBufferData allocateMeshData(
             const BufferLayout& layout,
@@ -116,6 +165,13 @@ namespace Rapture {
             const void* indexData, size_t indexDataSize, size_t indexCount,
             unsigned int indexType
         );
+
+        // Reserve pool ranges without filling them, the caller uploads the data later (see BufferUploadQueue)
+        MeshBufferData reserveMeshData(
+            const BufferLayout& layout,
+            size_t vertexDataSize, size_t indexDataSize, size_t indexCount,
+            unsigned int indexType
+        );
         
         // Free mesh data from buffer pools
         void freeMeshData(MeshBufferData& meshData);
@@ -125,7 +181,10 @@ namespace Rapture {
         BufferPoolManager(const BufferPoolManager&) = delete;
         BufferPoolManager& operator=(const BufferPoolManager&) = delete;
         
-        // Find or create a vertex array for a specific buffer layout
+        // Pools are split by vertex layout and index width, a VAO can only have one element buffer
+        static uint64_t makePoolKey(uint32_t layoutID, unsigned int indexType) { return ((uint64_t)layoutID << 32) | indexType; }
+
+        // Find or create a vertex array for a specific buffer layout and index type
         std::shared_ptr<VertexArray> findOrCreateVertexArray(const BufferLayout& layout, size_t vertexDataSize, size_t indexDataSize, unsigned int indexType);
         
         std::shared_ptr<BufferAllocation> allocateBuffer(std::shared_ptr<VertexArray> vao, BufferType type, size_t size);
@@ -143,8 +202,11 @@ namespace Rapture {
         // potential issue in the future is that when the buffers inside of a vao are full
         // a new vao will be created, and the old one will be overwritten, while we would still like access because space can be cleared
         // however, with a large enogh initial buffer, we can avoid this case for now, until the system works
-        std::unordered_map<size_t, std::shared_ptr<VertexArray>> m_layoutToVAOMap;
+        std::unordered_map<uint64_t, std::shared_ptr<VertexArray>> m_poolKeyToVAOMap;   // keyed by makePoolKey(layout id, index type)
 
         std::unordered_map<unsigned int, std::vector<std::shared_ptr<BufferAllocation>>> m_vaoToBufferAllocationsMap;
+
+        // Position-only VAO per pool VAO, only for layouts with a separate position stream
+        std::unordered_map<unsigned int, std::shared_ptr<VertexArray>> m_vaoToPositionVAOMap;
     };
 }
\ No newline at end of file
@@ -0,0 +1,256 @@
+#include "BufferUploadQueue.h"
+#include "BufferPools.h"
+#include "BufferConversionHelpers.h"
+#include "../Mesh/Mesh.h"
+#include "../Jobs/JobSystem.h"
+#include "../Renderer/RenderThread.h"
+#include "../Logger/Log.h"
+#include "../Debug/TracyProfiler.h"
+
+#include <chrono>
+#include <algorithm>
+
+namespace Rapture {
+
+    std::mutex BufferUploadQueue::s_queueMutex;
+    std::deque<MeshUploadRequest> BufferUploadQueue::s_pendingUploads;
+    std::unique_ptr<MeshUploadRequest> BufferUploadQueue::s_activeUpload = nullptr;
+    std::atomic<size_t> BufferUploadQueue::s_pendingBytes(0);
+    size_t BufferUploadQueue::s_bytesPerFrame = DEFAULT_UPLOAD_BYTES_PER_FRAME;
+    float BufferUploadQueue::s_msPerFrame = DEFAULT_UPLOAD_MS_PER_FRAME;
+    std::mutex BufferUploadQueue::s_drainMutex;
+    std::condition_variable BufferUploadQueue::s_drainCondition;
+    std::thread::id BufferUploadQueue::s_glThreadId;
+    std::atomic<bool> BufferUploadQueue::s_isRunning(false);
+
+    void BufferUploadQueue::init(size_t bytesPerFrame, float msPerFrame)
+    {
+        setFrameBudget(bytesPerFrame, msPerFrame);
+
+        // init runs on the GL thread, the same one that calls processUploads
+        s_glThreadId = std::this_thread::get_id();
+        s_isRunning = true;
+        GE_CORE_INFO("BufferUploadQueue: Initialized with a budget of {0}MB / {1}ms per frame", s_bytesPerFrame / 1024.0f / 1024.0f, s_msPerFrame);
+    }
+
+    void BufferUploadQueue::shutdown()
+    {
+        // Nothing drains the queue anymore, release every throttled loader
+        {
+            std::lock_guard<std::mutex> drainLock(s_drainMutex);
+            s_isRunning = false;
+        }
+        s_drainCondition.notify_all();
+
+        // Every dropped request still hears about it, so loaders don't wait for a mesh that never arrives
+        std::vector<std::function<void(bool)>> droppedCallbacks;
+        {
+            std::lock_guard<std::mutex> lock(s_queueMutex);
+
+            if (!s_pendingUploads.empty() || s_activeUpload) {
+                GE_CORE_WARN("BufferUploadQueue: Dropping {0} pending mesh uploads on shutdown", s_pendingUploads.size() + (s_activeUpload ? 1 : 0));
+            }
+
+            if (s_activeUpload && s_activeUpload->callback) {
+                droppedCallbacks.push_back(std::move(s_activeUpload->callback));
+            }
+            for (MeshUploadRequest& request : s_pendingUploads) {
+                if (request.callback) {
+                    droppedCallbacks.push_back(std::move(request.callback));
+                }
+            }
+
+            s_pendingUploads.clear();
+            s_activeUpload.reset();
+            s_pendingBytes = 0;
+        }
+
+        // Outside the lock, a callback may enqueue again, which now fails right away
+        for (std::function<void(bool)>& callback : droppedCallbacks) {
+            callback(false);
+        }
+
+        GE_CORE_INFO("BufferUploadQueue: Shutdown");
+    }
+
+    void BufferUploadQueue::enqueueMeshUpload(MeshUploadRequest&& request)
+    {
+        if (!request.mesh) {
+            GE_CORE_ERROR("BufferUploadQueue: Cannot enqueue upload for null mesh");
+            if (request.callback) {
+                request.callback(false);
+            }
+            return;
+        }
+
+        // Nothing would ever upload it
+        if (!s_isRunning) {
+            GE_CORE_WARN("BufferUploadQueue: Not running, dropping mesh upload");
+            if (request.callback) {
+                request.callback(false);
+            }
+            return;
+        }
+
+        // Convert on the calling thread, it is CPU work the GL thread shouldn't pay for.
+        // Borrowed data is read only, it was converted before it was stored
+        if (!request.indexData.isBorrowed()) {
+            size_t vertexCount = BufferConversionHelpers::getVertexCount(request.layout, request.vertexData.size(), request.positionData.size());
+            BufferConversionHelpers::convertIndices(request.indexData.owned, request.indexCount, request.indexType,
+                BufferConversionHelpers::chooseIndexType(vertexCount));
+        }
+
+        s_pendingBytes += request.totalBytes();
+
+        std::lock_guard<std::mutex> lock(s_queueMutex);
+        s_pendingUploads.push_back(std::move(request));
+    }
+
+    void BufferUploadQueue::processUploads()
+    {
+        RAPTURE_PROFILE_FUNCTION();
+
+        auto frameStart = std::chrono::high_resolution_clock::now();
+        size_t budgetBytes = s_bytesPerFrame;
+
+        while (budgetBytes > 0) {
+            // Pick up the next request if nothing is carried over from the previous frame
+            if (!s_activeUpload) {
+                std::lock_guard<std::mutex> lock(s_queueMutex);
+                if (s_pendingUploads.empty()) {
+                    break;
+                }
+                s_activeUpload = std::make_unique<MeshUploadRequest>(std::move(s_pendingUploads.front()));
+                s_pendingUploads.pop_front();
+            }
+
+            if (!uploadChunk(*s_activeUpload, budgetBytes)) {
+                finishActiveUpload(false);
+            }
+            else if (s_activeUpload->isComplete()) {
+                finishActiveUpload(true);
+            }
+
+            float elapsedMs = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - frameStart).count();
+            if (elapsedMs >= s_msPerFrame) {
+                break;
+            }
+        }
+
+        if (budgetBytes < s_bytesPerFrame) {
+            s_drainCondition.notify_all();
+        }
+    }
+
+    void BufferUploadQueue::setGLThread()
+    {
+        s_glThreadId = std::this_thread::get_id();
+    }
+
+    void BufferUploadQueue::waitForPendingBytes(size_t maxPendingBytes, const std::function<bool()>& shouldStop)
+    {
+        if (std::this_thread::get_id() == s_glThreadId) {
+            return;
+        }
+
+        RAPTURE_PROFILE_FUNCTION();
+
+        std::unique_lock<std::mutex> lock(s_drainMutex);
+        while (s_isRunning && s_pendingBytes > maxPendingBytes) {
+            if (shouldStop && shouldStop()) {
+                return;
+            }
+            // Bounded, so shouldStop is polled even while no frame is drawn
+            s_drainCondition.wait_for(lock, std::chrono::milliseconds(10));
+        }
+    }
+
+    bool BufferUploadQueue::uploadChunk(MeshUploadRequest& request, size_t& budgetBytes)
+    {
+        // Reserve the pool ranges the first time the request is touched, this is where VAOs get created
+        if (!request.isReserved) {
+            if (!request.mesh->reserveMeshData(request.layout, request.vertexData.size(), request.indexData.size(), request.indexCount, request.indexType)) {
+                GE_CORE_ERROR("BufferUploadQueue: Failed to reserve pool memory for mesh upload");
+                return false;
+            }
+            request.isReserved = true;
+        }
+
+        MeshBufferData& meshData = request.mesh->getMeshData();
+
+        size_t vertexBytes = std::min(budgetBytes, request.vertexData.size() - request.vertexBytesUploaded);
+        if (vertexBytes > 0) {
+            meshData.vao->getVertexBuffer()->setData(
+                request.vertexData.data() + request.vertexBytesUploaded,
+                vertexBytes,
+                meshData.vertexAllocation->offsetBytes + request.vertexBytesUploaded);
+            request.vertexBytesUploaded += vertexBytes;
+            budgetBytes -= vertexBytes;
+            s_pendingBytes -= vertexBytes;
+        }
+
+        size_t positionBytes = std::min(budgetBytes, request.positionData.size() - request.positionBytesUploaded);
+        if (positionBytes > 0) {
+            if (!meshData.vao->getPositionBuffer()) {
+                GE_CORE_ERROR("BufferUploadQueue: Mesh has position data but its pool has no position stream");
+                return false;
+            }
+            meshData.vao->getPositionBuffer()->setData(
+                request.positionData.data() + request.positionBytesUploaded,
+                positionBytes,
+                meshData.positionOffsetBytes + request.positionBytesUploaded);
+            request.positionBytesUploaded += positionBytes;
+            budgetBytes -= positionBytes;
+            s_pendingBytes -= positionBytes;
+        }
+
+        size_t indexBytes = std::min(budgetBytes, request.indexData.size() - request.indexBytesUploaded);
+        if (indexBytes > 0) {
+            meshData.vao->getIndexBuffer()->setData(
+                request.indexData.data() + request.indexBytesUploaded,
+                indexBytes,
+                meshData.indexAllocation->offsetBytes + request.indexBytesUploaded);
+            request.indexBytesUploaded += indexBytes;
+            budgetBytes -= indexBytes;
+            s_pendingBytes -= indexBytes;
+        }
+
+        return true;
+    }
+
+    void BufferUploadQueue::finishActiveUpload(bool success)
+    {
+        // Whatever was not uploaded will never be, so stop counting it as pending
+        s_pendingBytes -= s_activeUpload->totalBytes() - s_activeUpload->uploadedBytes();
+
+        auto callback = std::move(s_activeUpload->callback);
+        s_activeUpload.reset();
+
+        if (!callback) {
+            return;
+        }
+
+        // Callbacks update entities, which belong to the main thread even while a render thread does the uploads.
+        // Draws recorded after the callback are replayed after this upload, so the mesh is resident by then
+        if (RenderThread::isRenderThread()) {
+            JobSystem::scheduleOnMainThread([callback = std::move(callback), success]() { callback(success); });
+        }
+        else {
+            callback(success);
+        }
+    }
+
+    void BufferUploadQueue::setFrameBudget(size_t bytesPerFrame, float msPerFrame)
+    {
+        // Always allow some progress, otherwise a zero budget would stall every load
+        s_bytesPerFrame = std::max<size_t>(bytesPerFrame, 64 * 1024);
+        s_msPerFrame = std::max(msPerFrame, 0.1f);
+    }
+
+    size_t BufferUploadQueue::getPendingUploadCount()
+    {
+        std::lock_guard<std::mutex> lock(s_queueMutex);
+        return s_pendingUploads.size() + (s_activeUpload ? 1 : 0);
+    }
+
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <memory>
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <condition_variable>
+
+#include "VertexArray.h"
+
+namespace Rapture {
+
+    class Mesh;
+
+    // Per-frame limits for draining the upload queue on the GL thread
+    constexpr size_t DEFAULT_UPLOAD_BYTES_PER_FRAME = 8 * 1024 * 1024;  // 8 MB copied per frame at most
+    constexpr float DEFAULT_UPLOAD_MS_PER_FRAME = 2.0f;                 // 2 ms spent per frame at most
+
+    // Bytes waiting for upload, either owned or borrowed from memory the request keeps alive (e.g. a mapped mesh cache)
+    struct StagedBytes {
+        std::vector<unsigned char> owned;
+        const unsigned char* borrowed = nullptr;
+        size_t borrowedSize = 0;
+
+        StagedBytes() = default;
+        StagedBytes(std::vector<unsigned char>&& bytes) : owned(std::move(bytes)) {}
+
+        static StagedBytes borrow(const unsigned char* data, size_t size) {
+            StagedBytes bytes;
+            bytes.borrowed = data;
+            bytes.borrowedSize = size;
+            return bytes;
+        }
+
+        bool isBorrowed() const { return borrowed != nullptr; }
+        const unsigned char* data() const { return borrowed ? borrowed : owned.data(); }
+        size_t size() const { return borrowed ? borrowedSize : owned.size(); }
+    };
+
+    // Mesh data staged in CPU memory by a loader thread, waiting to be copied into the buffer pools
+    struct MeshUploadRequest {
+        std::shared_ptr<Mesh> mesh;
+        BufferLayout layout;
+        StagedBytes vertexData;
+        StagedBytes positionData;                           // only for layouts with a separate position stream
+        StagedBytes indexData;
+        size_t indexCount = 0;
+        unsigned int indexType = 0;                         // GL_UNSIGNED_SHORT, GL_UNSIGNED_INT, etc.
+        std::function<void(bool)> callback = nullptr;       // called on the main thread once the mesh is resident (or failed)
+        std::shared_ptr<const void> keepAlive = nullptr;    // owner of any borrowed bytes, released once the upload finishes
+
+        // Upload progress, only touched by the GL thread
+        bool isReserved = false;
+        size_t vertexBytesUploaded = 0;
+        size_t positionBytesUploaded = 0;
+        size_t indexBytesUploaded = 0;
+
+        size_t totalBytes() const { return vertexData.size() + positionData.size() + indexData.size(); }
+        size_t uploadedBytes() const { return vertexBytesUploaded + positionBytesUploaded + indexBytesUploaded; }
+        bool isComplete() const { return uploadedBytes() == totalBytes(); }
+    };
+
+    // Queue that lets loader threads hand mesh data to the GL thread without touching GL themselves.
+    // Loader threads only stage and enqueue; the GL thread reserves the pool ranges (creating VAOs when needed)
+    // and copies the staged bytes in chunks, so a single frame never uploads more than its budget.
+    class BufferUploadQueue {
+    public:
+        static void init(size_t bytesPerFrame = DEFAULT_UPLOAD_BYTES_PER_FRAME, float msPerFrame = DEFAULT_UPLOAD_MS_PER_FRAME);
+        // Main thread, drops the queued uploads and calls their callbacks with false
+        static void shutdown();
+
+        // Thread safe, never touches GL. Fails right away (callback(false)) when the queue isn't running
+        static void enqueueMeshUpload(MeshUploadRequest&& request);
+
+        // GL thread only, call once per frame
+        static void processUploads();
+
+        // Make the calling thread the one that drains the queue, e.g. a render thread that took over the context
+        static void setGLThread();
+
+        static void setFrameBudget(size_t bytesPerFrame, float msPerFrame);
+
+        static size_t getPendingUploadCount();
+        static size_t getPendingUploadBytes() { return s_pendingBytes; }
+
+        // Blocks until at most maxPendingBytes wait for upload, so a loader thread can't stage data faster than the
+        // GL thread drains it. Returns right away on the GL thread, which would wait on itself, and after shutdown.
+        // shouldStop is polled while waiting, e.g. to give up on a cancelled load
+        static void waitForPendingBytes(size_t maxPendingBytes, const std::function<bool()>& shouldStop = nullptr);
+
+    private:
+        // Copies as much of the request as the remaining budget allows, returns false if the request failed
+        static bool uploadChunk(MeshUploadRequest& request, size_t& budgetBytes);
+
+        static void finishActiveUpload(bool success);
+
+    private:
+        static std::mutex s_queueMutex;
+        static std::deque<MeshUploadRequest> s_pendingUploads;
+
+        // Request that is partially uploaded, carried over between frames (GL thread only)
+        static std::unique_ptr<MeshUploadRequest> s_activeUpload;
+
+        static std::atomic<size_t> s_pendingBytes;
+
+        // Wakes loader threads throttled by waitForPendingBytes once a frame has drained some bytes
+        static std::mutex s_drainMutex;
+        static std::condition_variable s_drainCondition;
+        static std::thread::id s_glThreadId;
+        static std::atomic<bool> s_isRunning;
+
+        static size_t s_bytesPerFrame;
+        static float s_msPerFrame;
+    };
+
+}
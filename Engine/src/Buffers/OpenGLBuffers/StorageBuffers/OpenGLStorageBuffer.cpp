@@ -13,7 +13,8 @@ namespace Rapture {
 		if (GLCapabilities::hasBufferStorage()) {
 			// Create buffer with immutable storage
 			glCreateBuffers(1, &m_rendererId);
-			GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_READ_BIT;
+			// GL_DYNAMIC_STORAGE_BIT so setData can update the immutable storage, as with the uniform buffers
+			GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_READ_BIT | GL_DYNAMIC_STORAGE_BIT;
 			if (usage == BufferUsage::Stream) {
 				flags |= GL_MAP_PERSISTENT_BIT;
 			}
@@ -5,16 +5,6 @@
 
 namespace Rapture {
 
-	// Constants for attribute locations (kept from original code for compatibility)
-	#define POSITION_ATTRIB_PTR 0
-	#define NORMAL_ATTRIB_PTR 1
-	#define TEXCOORD_0_ATTRIB_PTR 2
-	#define TEXCOORD_1_ATTRIB_PTR 3
-	#define JOINTS_0_ATTRIB_PTR 4
-	#define WEIGTHS_0_ATTRIB_PTR 5
-	#define TANGENT_ATTRIB_PTR 6
-	#define TRANSFORM_ATTRIB_PTR 7 // mat4
-
 	VertexArray::VertexArray()
 		: m_vertexBuffer(nullptr), m_indexBuffer(nullptr)
 	{
@@ -56,193 +46,85 @@ namespace Rapture {
 		}
 	}
 
-	void VertexArray::setAttribLayout(BufferAttribute& el)
+	void VertexArray::setAttribLayout(const BufferAttribute& el)
 	{
-		GLuint size = 1;
-		GLuint componentStride = 1;
-
-		if (el.type == "SCALAR") size = 1;
-		else if (el.type == "VEC2") size = 2;
-		else if (el.type == "VEC3") size = 3;
-		else if (el.type == "VEC4") size = 4;
-		else if (el.type == "MAT4") size = 16;
-		else GE_CORE_ERROR("VertexArray: Invalid Buffer Attribute Type: '{0}'", el.type);
+		GLint size = (GLint)getComponentCount(el.type);
+		GLuint componentStride = (GLuint)getComponentSize(el.componentType);
+		int location = getAttributeLocation(el.semantic);
 
-		switch (el.componentType)
-		{
-		case GL_BYTE: case GL_UNSIGNED_BYTE: componentStride = 1; break;
-		case GL_UNSIGNED_SHORT: case GL_SHORT: componentStride = 2; break;
-		case GL_FLOAT: case GL_UNSIGNED_INT: componentStride = 4; break;
+		if (location < 0) {
+			GE_CORE_WARN("VertexArray: Attribute '{0}' has no shader location, skipping", semanticToString(el.semantic));
+			return;
 		}
 
 		// Calculate stride based on layout type
 		GLsizei stride;
 		size_t attributeOffset = el.offset;
 		
-		if (m_buffer_layout.isInterleaved) {
+		// Attributes in the position stream read from their own buffer, padded to positionStride (quantized positions)
+		bool inPositionStream = m_buffer_layout.isInPositionStream(el);
+		const std::shared_ptr<VertexBuffer>& sourceBuffer = inPositionStream ? m_positionBuffer : m_vertexBuffer;
+		
+		if (inPositionStream) {
+			stride = m_buffer_layout.getPositionStride() > 0 ? (GLsizei)m_buffer_layout.getPositionStride() : componentStride * size;
+		} else if (m_buffer_layout.isInterleaved()) {
 			// For interleaved format (PNTPNTPNT...), stride is the size of a complete vertex
-			stride = (GLsizei)m_buffer_layout.vertexSize;
+			stride = (GLsizei)m_buffer_layout.getVertexSize();
 		} else {
 			// For non-interleaved format (PPP...NNN...TTT...), stride is just the size of this component
 			stride = componentStride * size;
 		}
 
-		if (m_vertexBuffer == nullptr) {
-			GE_CORE_ERROR("VertexArray: Cannot set attribute layout without a vertex buffer");
+		if (sourceBuffer == nullptr) {
+			GE_CORE_ERROR("VertexArray: Cannot set attribute layout for '{0}' without a {1} buffer", 
+				semanticToString(el.semantic), inPositionStream ? "position" : "vertex");
 			return;
 		}
 
-		if (GLCapabilities::hasDSA()) {
-			// Use DSA for setting up attributes
-			if (el.name == "POSITION") {
-				glEnableVertexArrayAttrib(m_rendererId, POSITION_ATTRIB_PTR);
-				glVertexArrayAttribBinding(m_rendererId, POSITION_ATTRIB_PTR, POSITION_ATTRIB_PTR);
-				glVertexArrayAttribFormat(m_rendererId, POSITION_ATTRIB_PTR, size,
-					(GLenum)el.componentType, GL_FALSE, 0);
-				glVertexArrayVertexBuffer(m_rendererId, POSITION_ATTRIB_PTR, m_vertexBuffer->getID(), 
-                     attributeOffset, stride);
-				
-			} else if (el.name == "NORMAL") {
-				glEnableVertexArrayAttrib(m_rendererId, NORMAL_ATTRIB_PTR);
-				glVertexArrayAttribBinding(m_rendererId, NORMAL_ATTRIB_PTR, NORMAL_ATTRIB_PTR);
-				glVertexArrayAttribFormat(m_rendererId, NORMAL_ATTRIB_PTR, size, 
-					(GLenum)el.componentType, GL_FALSE, 0);
-				glVertexArrayVertexBuffer(m_rendererId, NORMAL_ATTRIB_PTR, m_vertexBuffer->getID(), 
-                     attributeOffset, stride);
-
-			} else if (el.name == "TEXCOORD_0") {
-				glEnableVertexArrayAttrib(m_rendererId, TEXCOORD_0_ATTRIB_PTR);
-				glVertexArrayAttribBinding(m_rendererId, TEXCOORD_0_ATTRIB_PTR, TEXCOORD_0_ATTRIB_PTR);
-				glVertexArrayAttribFormat(m_rendererId, TEXCOORD_0_ATTRIB_PTR, size, 
-					(GLenum)el.componentType, GL_FALSE, 0);
-				glVertexArrayVertexBuffer(m_rendererId, TEXCOORD_0_ATTRIB_PTR, m_vertexBuffer->getID(), 
-                     attributeOffset, stride);
+		GLboolean normalized = el.normalized ? GL_TRUE : GL_FALSE;
 
-			} else if (el.name == "TRANSFORM_MAT") {
+		if (GLCapabilities::hasDSA()) {
+			// Use DSA for setting up attributes, every attribute gets the binding point equal to its location
+			if (el.semantic == VertexAttributeSemantic::TransformMat) {
 				// Handle matrix attribute (instanced)
 				for (int i = 0; i < 4; i++) {
-					glEnableVertexArrayAttrib(m_rendererId, TRANSFORM_ATTRIB_PTR + i);
-					glVertexArrayAttribBinding(m_rendererId, TRANSFORM_ATTRIB_PTR + i, TRANSFORM_ATTRIB_PTR);
-					glVertexArrayAttribFormat(m_rendererId, TRANSFORM_ATTRIB_PTR + i, 4, 
+					glEnableVertexArrayAttrib(m_rendererId, location + i);
+					glVertexArrayAttribBinding(m_rendererId, location + i, location);
+					glVertexArrayAttribFormat(m_rendererId, location + i, 4, 
 						GL_FLOAT, GL_FALSE, i * sizeof(glm::vec4));
 				}
-				glVertexArrayBindingDivisor(m_rendererId, TRANSFORM_ATTRIB_PTR, 1);
-				glVertexArrayVertexBuffer(m_rendererId, TRANSFORM_ATTRIB_PTR, m_vertexBuffer->getID(), 
-                     attributeOffset, stride);
-
-			} else if (el.name == "TANGENT") {
-				glEnableVertexArrayAttrib(m_rendererId, TANGENT_ATTRIB_PTR);
-				glVertexArrayAttribBinding(m_rendererId, TANGENT_ATTRIB_PTR, TANGENT_ATTRIB_PTR);
-				glVertexArrayAttribFormat(m_rendererId, TANGENT_ATTRIB_PTR, size, 
-					(GLenum)el.componentType, GL_FALSE, 0);
-				glVertexArrayVertexBuffer(m_rendererId, TANGENT_ATTRIB_PTR, m_vertexBuffer->getID(), 
-                     attributeOffset, stride);
-
-			} else if (el.name == "JOINTS_0") {
-				glEnableVertexArrayAttrib(m_rendererId, JOINTS_0_ATTRIB_PTR);
-				glVertexArrayAttribBinding(m_rendererId, JOINTS_0_ATTRIB_PTR, JOINTS_0_ATTRIB_PTR);
-				glVertexArrayAttribFormat(m_rendererId, JOINTS_0_ATTRIB_PTR, size, 
-					(GLenum)el.componentType, GL_FALSE, 0);
-				glVertexArrayVertexBuffer(m_rendererId, JOINTS_0_ATTRIB_PTR, m_vertexBuffer->getID(), 
-                     attributeOffset, stride);
-
-			} else if (el.name == "WEIGHTS_0") {
-				glEnableVertexArrayAttrib(m_rendererId, WEIGTHS_0_ATTRIB_PTR);
-				glVertexArrayAttribBinding(m_rendererId, WEIGTHS_0_ATTRIB_PTR, WEIGTHS_0_ATTRIB_PTR);
-				glVertexArrayAttribFormat(m_rendererId, WEIGTHS_0_ATTRIB_PTR, size, 
-					(GLenum)el.componentType, GL_FALSE, 0);
-				glVertexArrayVertexBuffer(m_rendererId, WEIGTHS_0_ATTRIB_PTR, m_vertexBuffer->getID(), 
-                    attributeOffset, stride);
+				glVertexArrayBindingDivisor(m_rendererId, location, 1);
+			} else {
+				glEnableVertexArrayAttrib(m_rendererId, location);
+				glVertexArrayAttribBinding(m_rendererId, location, location);
+				glVertexArrayAttribFormat(m_rendererId, location, size,
+					(GLenum)el.componentType, normalized, 0);
 			}
+			glVertexArrayVertexBuffer(m_rendererId, location, sourceBuffer->getID(), 
+                 attributeOffset, stride);
 		} else {
 			// For non-DSA fallback
 			glBindVertexArray(m_rendererId);
-			m_vertexBuffer->bind();
+			sourceBuffer->bind();
 
-			if (el.name == "POSITION") {
-				glEnableVertexAttribArray(POSITION_ATTRIB_PTR);
-				glVertexAttribPointer(POSITION_ATTRIB_PTR,
-					size,
-					(GLenum)el.componentType,
-					GL_FALSE,
-					stride,
-					(const void*)(attributeOffset));
-			} else if (el.name == "NORMAL") {
-				glEnableVertexAttribArray(NORMAL_ATTRIB_PTR);
-				glVertexAttribPointer(NORMAL_ATTRIB_PTR,
-					size,
-					(GLenum)el.componentType,
-					GL_FALSE,
-					stride,
-					(const void*)(attributeOffset));
-			} else if (el.name == "TEXCOORD_0") {
-				glEnableVertexAttribArray(TEXCOORD_0_ATTRIB_PTR);
-				glVertexAttribPointer(TEXCOORD_0_ATTRIB_PTR,
-					size,
-					(GLenum)el.componentType,
-					GL_FALSE,
-					stride,
-					(const void*)(attributeOffset));
-			} else if (el.name == "TRANSFORM_MAT") {
+			if (el.semantic == VertexAttributeSemantic::TransformMat) {
 				// Handle matrix attribute (instanced)
-				glEnableVertexAttribArray(TRANSFORM_ATTRIB_PTR);
-				glVertexAttribPointer(TRANSFORM_ATTRIB_PTR,
-					4,
-					GL_FLOAT,
-					GL_FALSE,
-					sizeof(glm::mat4),
-					(const void*)(attributeOffset));
-
-				glEnableVertexAttribArray(TRANSFORM_ATTRIB_PTR+1);
-				glVertexAttribPointer(TRANSFORM_ATTRIB_PTR+1,
-					4,
-					GL_FLOAT,
-					GL_FALSE,
-					sizeof(glm::mat4),
-					(const void*)(attributeOffset + sizeof(glm::vec4)));
-
-				glEnableVertexAttribArray(TRANSFORM_ATTRIB_PTR + 2);
-				glVertexAttribPointer(TRANSFORM_ATTRIB_PTR + 2,
-					4,
-					GL_FLOAT,
-					GL_FALSE,
-					sizeof(glm::mat4),
-					(const void*)(attributeOffset + (2 * sizeof(glm::vec4))));
-
-				glEnableVertexAttribArray(TRANSFORM_ATTRIB_PTR + 3);
-				glVertexAttribPointer(TRANSFORM_ATTRIB_PTR + 3,
-					4,
-					GL_FLOAT,
-					GL_FALSE,
-					sizeof(glm::mat4),
-					(const void*)(attributeOffset + (3 * sizeof(glm::vec4))));
-					
-				glVertexAttribDivisor(TRANSFORM_ATTRIB_PTR, 1);
-				glVertexAttribDivisor(TRANSFORM_ATTRIB_PTR+1, 1);
-				glVertexAttribDivisor(TRANSFORM_ATTRIB_PTR+2, 1);
-				glVertexAttribDivisor(TRANSFORM_ATTRIB_PTR+3, 1);
-			} else if (el.name == "TANGENT") {
-				glEnableVertexAttribArray(TANGENT_ATTRIB_PTR);
-				glVertexAttribPointer(TANGENT_ATTRIB_PTR,
-					size,
-					(GLenum)el.componentType,
-					GL_FALSE,
-					stride,
-					(const void*)(attributeOffset));
-			} else if (el.name == "JOINTS_0") {
-				glEnableVertexAttribArray(JOINTS_0_ATTRIB_PTR);
-				glVertexAttribPointer(JOINTS_0_ATTRIB_PTR,
-					size,
-					(GLenum)el.componentType,
-					GL_FALSE,
-					stride,
-					(const void*)(attributeOffset));
-			} else if (el.name == "WEIGHTS_0") {
-				glEnableVertexAttribArray(WEIGTHS_0_ATTRIB_PTR);
-				glVertexAttribPointer(WEIGTHS_0_ATTRIB_PTR,
+				for (int i = 0; i < 4; i++) {
+					glEnableVertexAttribArray(location + i);
+					glVertexAttribPointer(location + i,
+						4,
+						GL_FLOAT,
+						GL_FALSE,
+						sizeof(glm::mat4),
+						(const void*)(attributeOffset + (i * sizeof(glm::vec4))));
+					glVertexAttribDivisor(location + i, 1);
+				}
+			} else {
+				glEnableVertexAttribArray(location);
+				glVertexAttribPointer(location,
 					size,
 					(GLenum)el.componentType,
-					GL_FALSE,
+					normalized,
 					stride,
 					(const void*)(attributeOffset));
 			}
@@ -256,14 +138,14 @@ namespace Rapture {
 		m_buffer_layout = el;
 		
 		// If interleaved, ensure the vertex size is calculated
-		if (m_buffer_layout.isInterleaved && m_buffer_layout.vertexSize == 0) {
+		if (m_buffer_layout.isInterleaved() && m_buffer_layout.getVertexSize() == 0) {
 			m_buffer_layout.calculateVertexSize();
 		}
 		
 		// For each attribute, set up the layout
-		for (int i = 0; i < el.buffer_attribs.size(); i++)
+		for (size_t i = 0; i < el.getAttributes().size(); i++)
 		{
-			setAttribLayout(const_cast<BufferAttribute&>(el.buffer_attribs[i]));
+			setAttribLayout(el.getAttributes()[i]);
 		}
 		
 	}
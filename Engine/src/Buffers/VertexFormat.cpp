@@ -0,0 +1,57 @@
+#include "VertexFormat.h"
+
+#include <mutex>
+#include <deque>
+#include <unordered_map>
+
+namespace Rapture {
+
+	// Interned layouts, id N lives at index N-1. A deque keeps references stable while it grows
+	static std::mutex s_layoutRegistryMutex;
+	static std::deque<BufferLayout> s_internedLayouts;
+	static std::unordered_map<size_t, std::vector<uint32_t>> s_layoutIDsByHash;
+
+	uint32_t BufferLayout::intern()
+	{
+		if (m_layoutID != 0) {
+			return m_layoutID;
+		}
+
+		if (m_isInterleaved && m_vertexSize == 0) {
+			calculateVertexSize();
+		}
+
+		size_t layoutHash = hash();
+
+		std::lock_guard<std::mutex> lock(s_layoutRegistryMutex);
+
+		// the hash only narrows it down, a full compare decides
+		auto& candidates = s_layoutIDsByHash[layoutHash];
+		for (uint32_t candidateID : candidates) {
+			if (s_internedLayouts[candidateID - 1] == *this) {
+				m_layoutID = candidateID;
+				return m_layoutID;
+			}
+		}
+
+		s_internedLayouts.push_back(*this);
+		m_layoutID = static_cast<uint32_t>(s_internedLayouts.size());
+		s_internedLayouts.back().m_layoutID = m_layoutID;
+		candidates.push_back(m_layoutID);
+
+		return m_layoutID;
+	}
+
+	const BufferLayout& BufferLayout::getInterned(uint32_t layoutID)
+	{
+		std::lock_guard<std::mutex> lock(s_layoutRegistryMutex);
+
+		if (layoutID == 0 || layoutID > s_internedLayouts.size()) {
+			GE_CORE_ERROR("BufferLayout: No interned layout with id {0}", layoutID);
+			static const BufferLayout s_emptyLayout;
+			return s_emptyLayout;
+		}
+		return s_internedLayouts[layoutID - 1];
+	}
+
+}
@@ -0,0 +1,409 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+#include "../Logger/Log.h"
+
+namespace Rapture {
+
+	// What an attribute means to the shaders, each semantic has a fixed attribute location
+	enum class VertexAttributeSemantic : uint8_t {
+		Position,
+		Normal,
+		TexCoord0,
+		TexCoord1,
+		Joints0,
+		Weights0,
+		Tangent,
+		TransformMat,   // per-instance mat4
+		Color0,
+		Unknown
+	};
+
+	// Number of components per attribute, matches the glTF accessor types
+	enum class VertexAttributeType : uint8_t {
+		Scalar,
+		Vec2,
+		Vec3,
+		Vec4,
+		Mat4
+	};
+
+	// GL component types, kept as raw values so this header doesn't pull in glad
+	constexpr unsigned int VERTEX_COMPONENT_BYTE = 0x1400;
+	constexpr unsigned int VERTEX_COMPONENT_UNSIGNED_BYTE = 0x1401;
+	constexpr unsigned int VERTEX_COMPONENT_SHORT = 0x1402;
+	constexpr unsigned int VERTEX_COMPONENT_UNSIGNED_SHORT = 0x1403;
+	constexpr unsigned int VERTEX_COMPONENT_UNSIGNED_INT = 0x1405;
+	constexpr unsigned int VERTEX_COMPONENT_FLOAT = 0x1406;
+
+	constexpr size_t getComponentCount(VertexAttributeType type) {
+		switch (type) {
+			case VertexAttributeType::Scalar: return 1;
+			case VertexAttributeType::Vec2:   return 2;
+			case VertexAttributeType::Vec3:   return 3;
+			case VertexAttributeType::Vec4:   return 4;
+			case VertexAttributeType::Mat4:   return 16;
+		}
+		return 1;
+	}
+
+	constexpr size_t getComponentSize(unsigned int componentType) {
+		switch (componentType) {
+			case 0x1400: case 0x1401: return 1; // BYTE, UNSIGNED_BYTE
+			case 0x1402: case 0x1403: return 2; // SHORT, UNSIGNED_SHORT
+			case 0x1404: case 0x1405: case 0x1406: return 4; // INT, UNSIGNED_INT, FLOAT
+		}
+		return 1;
+	}
+
+	// Reads one component as float, following the GL rules for normalized integers (KHR_mesh_quantization data)
+	inline float readComponentAsFloat(const unsigned char* src, unsigned int componentType, bool normalized) {
+		switch (componentType) {
+			case VERTEX_COMPONENT_BYTE:           { int8_t v; std::memcpy(&v, src, 1); return normalized ? std::max(v / 127.0f, -1.0f) : (float)v; }
+			case VERTEX_COMPONENT_UNSIGNED_BYTE:  { uint8_t v = *src; return normalized ? v / 255.0f : (float)v; }
+			case VERTEX_COMPONENT_SHORT:          { int16_t v; std::memcpy(&v, src, 2); return normalized ? std::max(v / 32767.0f, -1.0f) : (float)v; }
+			case VERTEX_COMPONENT_UNSIGNED_SHORT: { uint16_t v; std::memcpy(&v, src, 2); return normalized ? v / 65535.0f : (float)v; }
+			case VERTEX_COMPONENT_UNSIGNED_INT:   { uint32_t v; std::memcpy(&v, src, 4); return (float)v; }
+			default:                              { float v; std::memcpy(&v, src, 4); return v; }
+		}
+	}
+
+	// Attribute location in the shaders, -1 when the semantic is not bound
+	constexpr int getAttributeLocation(VertexAttributeSemantic semantic) {
+		switch (semantic) {
+			case VertexAttributeSemantic::Position:     return 0;
+			case VertexAttributeSemantic::Normal:       return 1;
+			case VertexAttributeSemantic::TexCoord0:    return 2;
+			case VertexAttributeSemantic::TexCoord1:    return 3;
+			case VertexAttributeSemantic::Joints0:      return 4;
+			case VertexAttributeSemantic::Weights0:     return 5;
+			case VertexAttributeSemantic::Tangent:      return 6;
+			case VertexAttributeSemantic::TransformMat: return 7; // takes 7-10
+			default: return -1;
+		}
+	}
+
+	// String conversions, only meant for file loaders and debug output, never for the bind path
+	inline VertexAttributeSemantic semanticFromString(std::string_view name) {
+		if (name == "POSITION")      return VertexAttributeSemantic::Position;
+		if (name == "NORMAL")        return VertexAttributeSemantic::Normal;
+		if (name == "TEXCOORD_0")    return VertexAttributeSemantic::TexCoord0;
+		if (name == "TEXCOORD_1")    return VertexAttributeSemantic::TexCoord1;
+		if (name == "JOINTS_0")      return VertexAttributeSemantic::Joints0;
+		if (name == "WEIGHTS_0")     return VertexAttributeSemantic::Weights0;
+		if (name == "TANGENT")       return VertexAttributeSemantic::Tangent;
+		if (name == "TRANSFORM_MAT") return VertexAttributeSemantic::TransformMat;
+		if (name == "COLOR_0")       return VertexAttributeSemantic::Color0;
+		return VertexAttributeSemantic::Unknown;
+	}
+
+	inline VertexAttributeType typeFromString(std::string_view type) {
+		if (type == "VEC2") return VertexAttributeType::Vec2;
+		if (type == "VEC3") return VertexAttributeType::Vec3;
+		if (type == "VEC4") return VertexAttributeType::Vec4;
+		if (type == "MAT4") return VertexAttributeType::Mat4;
+		return VertexAttributeType::Scalar;
+	}
+
+	constexpr const char* semanticToString(VertexAttributeSemantic semantic) {
+		switch (semantic) {
+			case VertexAttributeSemantic::Position:     return "POSITION";
+			case VertexAttributeSemantic::Normal:       return "NORMAL";
+			case VertexAttributeSemantic::TexCoord0:    return "TEXCOORD_0";
+			case VertexAttributeSemantic::TexCoord1:    return "TEXCOORD_1";
+			case VertexAttributeSemantic::Joints0:      return "JOINTS_0";
+			case VertexAttributeSemantic::Weights0:     return "WEIGHTS_0";
+			case VertexAttributeSemantic::Tangent:      return "TANGENT";
+			case VertexAttributeSemantic::TransformMat: return "TRANSFORM_MAT";
+			case VertexAttributeSemantic::Color0:       return "COLOR_0";
+			default: return "UNKNOWN";
+		}
+	}
+
+	constexpr const char* typeToString(VertexAttributeType type) {
+		switch (type) {
+			case VertexAttributeType::Scalar: return "SCALAR";
+			case VertexAttributeType::Vec2:   return "VEC2";
+			case VertexAttributeType::Vec3:   return "VEC3";
+			case VertexAttributeType::Vec4:   return "VEC4";
+			case VertexAttributeType::Mat4:   return "MAT4";
+		}
+		return "SCALAR";
+	}
+
+
+	struct BufferAttribute
+	{
+		VertexAttributeSemantic semantic = VertexAttributeSemantic::Unknown;
+		unsigned int componentType = VERTEX_COMPONENT_FLOAT; // GL_FLOAT, GL_INT, ...
+		VertexAttributeType type = VertexAttributeType::Scalar;
+		size_t offset = 0;         // Byte offset from the start of the vertex or attribute array
+		bool normalized = false;   // Integer data is mapped to [0,1] / [-1,1] (quantized attributes)
+
+		// Calculate size in bytes for this attribute
+		constexpr size_t getSizeInBytes() const {
+			return getComponentCount(type) * getComponentSize(componentType);
+		}
+
+		constexpr bool operator==(const BufferAttribute& other) const
+		{
+			return (other.semantic == semantic &&
+				other.offset == offset &&
+				other.componentType == componentType &&
+				other.type == type &&
+				other.normalized == normalized);
+		}
+
+		constexpr bool operator!=(const BufferAttribute& other) const
+		{
+			return !(*this == other);
+		}
+	};
+
+	// Description of the vertex data of a mesh. The fields are only changed through the member functions,
+	// which drop the interned id, so an interned layout always matches its id and comparing two is one integer compare
+	struct BufferLayout
+	{
+	public:
+		const std::vector<BufferAttribute>& getAttributes() const { return m_attributes; }
+		bool isInterleaved() const { return m_isInterleaved; }
+		size_t getVertexSize() const { return m_vertexSize; }
+		bool hasPositionStream() const { return m_hasPositionStream; }
+		size_t getPositionStride() const { return m_positionStride; }
+		uint32_t getLayoutID() const { return m_layoutID; }
+
+		void addAttribute(const BufferAttribute& attrib) { m_layoutID = 0; m_attributes.push_back(attrib); }
+		void setAttributes(std::vector<BufferAttribute> attributes) { m_layoutID = 0; m_attributes = std::move(attributes); }
+		void setInterleaved(bool interleaved) { m_layoutID = 0; m_isInterleaved = interleaved; }
+		void setVertexSize(size_t vertexSize) { m_layoutID = 0; m_vertexSize = vertexSize; }
+		void setPositionStream(bool hasPositionStream, size_t positionStride) {
+			m_layoutID = 0;
+			m_hasPositionStream = hasPositionStream;
+			m_positionStride = positionStride;
+		}
+
+		// Calculate the total vertex size for interleaved format
+		void calculateVertexSize() {
+			m_layoutID = 0;
+			m_vertexSize = 0;
+			for (const auto& attrib : m_attributes) {
+				if (isInPositionStream(attrib)) {
+					m_positionStride = attrib.getSizeInBytes();
+					continue;
+				}
+				m_vertexSize += attrib.getSizeInBytes();
+			}
+		}
+
+		bool isInPositionStream(const BufferAttribute& attrib) const {
+			return m_hasPositionStream && attrib.semantic == VertexAttributeSemantic::Position;
+		}
+
+		// Get an attribute by semantic. The caller may change it, so the layout counts as not interned anymore
+		BufferAttribute& getAttribute(VertexAttributeSemantic semantic)
+		{
+			m_layoutID = 0;
+			for (size_t i = 0; i < m_attributes.size(); i++)
+			{
+				if (m_attributes[i].semantic == semantic)
+				{
+					return m_attributes[i];
+				}
+			}
+			GE_CORE_ERROR("Attribute not found: {0}", semanticToString(semantic));
+            return m_attributes[0];
+		}
+
+		bool hasAttribute(VertexAttributeSemantic semantic) const
+		{
+			for (const auto& attrib : m_attributes) {
+				if (attrib.semantic == semantic) return true;
+			}
+			return false;
+		}
+
+		// Update offsets based on layout type (interleaved or not)
+		void updateOffsets() {
+			m_layoutID = 0;
+			if (m_isInterleaved) {
+				// For interleaved format, offsets are relative to the start of each vertex
+				size_t currentOffset = 0;
+				for (auto& attrib : m_attributes) {
+					if (isInPositionStream(attrib)) {
+						attrib.offset = 0;
+						m_positionStride = attrib.getSizeInBytes();
+						continue;
+					}
+					attrib.offset = currentOffset;
+					currentOffset += attrib.getSizeInBytes();
+				}
+				m_vertexSize = currentOffset;
+			}
+		}
+
+		// Looks the layout up in the global registry (adding it if new) and stores the id.
+		// Only needs to happen once per layout, after that comparing layouts is comparing ids
+		uint32_t intern();
+
+		bool isInterned() const { return m_layoutID != 0; }
+
+		// Returns the registered layout for an id
+		static const BufferLayout& getInterned(uint32_t layoutID);
+
+		bool operator==(const BufferLayout& other) const
+		{
+			if (m_layoutID != 0 && other.m_layoutID != 0)
+				return m_layoutID == other.m_layoutID;
+
+			if (other.m_attributes.size() != m_attributes.size() ||
+			    other.m_isInterleaved != m_isInterleaved ||
+			    other.m_vertexSize != m_vertexSize ||
+			    other.m_hasPositionStream != m_hasPositionStream ||
+			    other.m_positionStride != m_positionStride)
+				return false;
+
+			for (size_t i = 0; i < m_attributes.size(); i++)
+			{
+				if (m_attributes[i] != other.m_attributes[i]) return false;
+			}
+			return true;
+		}
+
+        size_t hash() const {
+            size_t hash = 0;
+            for (const auto& attrib : m_attributes) {
+                // Combine the attribute properties, all of them are small integers
+                size_t attribHash = (size_t)attrib.semantic ^
+                            ((size_t)attrib.componentType << 4) ^
+                            ((size_t)attrib.type << 20) ^
+                            ((size_t)attrib.normalized << 23) ^
+                            (attrib.offset << 24);
+                hash ^= attribHash + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+            }
+            // Add interleaved flag to the hash
+            hash ^= (size_t)m_isInterleaved + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+            hash ^= ((size_t)m_hasPositionStream | (m_positionStride << 1)) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+            hash ^= m_vertexSize + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+            return hash;
+        }
+
+
+		void print() const
+		{
+			GE_CORE_TRACE("Buffer Layout {0}: {1}", m_layoutID, m_isInterleaved ? "Interleaved" : "Non-interleaved");
+			GE_CORE_TRACE("Vertex size: {0} bytes", m_vertexSize);
+			if (m_hasPositionStream) {
+				GE_CORE_TRACE("Separate position stream: {0} bytes per vertex", m_positionStride);
+			}
+			for (size_t i = 0; i < m_attributes.size(); i++)
+			{
+				GE_CORE_TRACE("'{0}': {1}, {2}{3}, offset: {4}, size: {5}",
+					semanticToString(m_attributes[i].semantic),
+					m_attributes[i].componentType,
+					typeToString(m_attributes[i].type),
+					m_attributes[i].normalized ? " (normalized)" : "",
+					m_attributes[i].offset,
+					m_attributes[i].getSizeInBytes());
+			}
+		}
+
+	private:
+		std::vector<BufferAttribute> m_attributes;
+		bool m_isInterleaved = false;     // Whether vertex data is interleaved (PNTPNT...) or not (PPP...NNN...TTT...)
+		size_t m_vertexSize = 0;          // Total size of a vertex in bytes (used for interleaved format)
+		uint32_t m_layoutID = 0;          // Interned id, equal ids mean equal layouts. 0 until intern() is called
+
+		// Position lives in its own stream (PPP... next to NTNTNT...), so passes that only need positions don't
+		// fetch the other attributes. m_vertexSize is then the stride of the attribute stream only, and m_positionStride
+		// the stride of the position stream (padded to 4 bytes for quantized positions)
+		bool m_hasPositionStream = false;
+		size_t m_positionStride = 0;
+	};
+
+
+	// Compile-time description of one attribute in a vertex format
+	struct VertexAttributeDesc {
+		VertexAttributeSemantic semantic;
+		unsigned int componentType;
+		VertexAttributeType type;
+		bool normalized = false;
+
+		constexpr size_t getSizeInBytes() const {
+			return getComponentCount(type) * getComponentSize(componentType);
+		}
+	};
+
+	// Interleaved vertex format known at compile time, attributes are packed in the given order.
+	// Use layout() to get the matching (already interned) BufferLayout.
+	template<VertexAttributeDesc... Attribs>
+	struct VertexFormat {
+		static constexpr size_t attributeCount = sizeof...(Attribs);
+		static constexpr std::array<VertexAttributeDesc, attributeCount> attributes = { Attribs... };
+		static constexpr size_t stride = (Attribs.getSizeInBytes() + ... + 0);
+
+		static constexpr size_t offsetOf(VertexAttributeSemantic semantic) {
+			size_t offset = 0;
+			for (const auto& attrib : attributes) {
+				if (attrib.semantic == semantic) return offset;
+				offset += attrib.getSizeInBytes();
+			}
+			return stride;
+		}
+
+		static constexpr bool has(VertexAttributeSemantic semantic) {
+			return offsetOf(semantic) != stride;
+		}
+
+		static const BufferLayout& layout() {
+			static const BufferLayout s_layout = []() {
+				BufferLayout layout;
+				layout.setInterleaved(true);
+				size_t offset = 0;
+				for (const auto& attrib : attributes) {
+					layout.addAttribute({ attrib.semantic, attrib.componentType, attrib.type, offset, attrib.normalized });
+					offset += attrib.getSizeInBytes();
+				}
+				layout.setVertexSize(stride);
+				layout.intern();
+				return layout;
+			}();
+			return s_layout;
+		}
+	};
+
+	// Common attribute descriptions
+	namespace VertexAttributes {
+		constexpr VertexAttributeDesc PositionF3  { VertexAttributeSemantic::Position,  VERTEX_COMPONENT_FLOAT, VertexAttributeType::Vec3 };
+		constexpr VertexAttributeDesc NormalF3    { VertexAttributeSemantic::Normal,    VERTEX_COMPONENT_FLOAT, VertexAttributeType::Vec3 };
+		constexpr VertexAttributeDesc TexCoord0F2 { VertexAttributeSemantic::TexCoord0, VERTEX_COMPONENT_FLOAT, VertexAttributeType::Vec2 };
+		constexpr VertexAttributeDesc TangentF4   { VertexAttributeSemantic::Tangent,   VERTEX_COMPONENT_FLOAT, VertexAttributeType::Vec4 };
+
+		// Quantized, padded to 4 bytes so every attribute stays aligned
+		constexpr VertexAttributeDesc PositionS16x4   { VertexAttributeSemantic::Position,  VERTEX_COMPONENT_SHORT,          VertexAttributeType::Vec4, true };
+		constexpr VertexAttributeDesc NormalS8x4      { VertexAttributeSemantic::Normal,    VERTEX_COMPONENT_BYTE,           VertexAttributeType::Vec4, true };
+		constexpr VertexAttributeDesc TexCoord0U16x2  { VertexAttributeSemantic::TexCoord0, VERTEX_COMPONENT_UNSIGNED_SHORT, VertexAttributeType::Vec2, true };
+		constexpr VertexAttributeDesc TangentS8x4     { VertexAttributeSemantic::Tangent,   VERTEX_COMPONENT_BYTE,           VertexAttributeType::Vec4, true };
+	}
+
+	using VertexFormatP    = VertexFormat<VertexAttributes::PositionF3>;
+	using VertexFormatPN   = VertexFormat<VertexAttributes::PositionF3, VertexAttributes::NormalF3>;
+	using VertexFormatPNT  = VertexFormat<VertexAttributes::PositionF3, VertexAttributes::NormalF3, VertexAttributes::TexCoord0F2>;
+	using VertexFormatPNTT = VertexFormat<VertexAttributes::PositionF3, VertexAttributes::NormalF3, VertexAttributes::TexCoord0F2, VertexAttributes::TangentF4>;
+
+	// Float positions keep full precision, the rest is quantized
+	using VertexFormatPNT_Q  = VertexFormat<VertexAttributes::PositionF3, VertexAttributes::NormalS8x4, VertexAttributes::TexCoord0U16x2>;
+	using VertexFormatPNTT_Q = VertexFormat<VertexAttributes::PositionF3, VertexAttributes::NormalS8x4, VertexAttributes::TexCoord0U16x2, VertexAttributes::TangentS8x4>;
+
+	static_assert(VertexFormatPNT::stride == 32, "PNT should be 32 bytes");
+	static_assert(VertexFormatPNTT::stride == 48, "PNTT should be 48 bytes");
+	static_assert(VertexFormatPNT_Q::stride == 20, "quantized PNT should be 20 bytes");
+	static_assert(VertexFormatPNTT_Q::offsetOf(VertexAttributeSemantic::Tangent) == 20, "tangent follows the texcoords");
+
+}
@@ -0,0 +1,93 @@
+#include "AssetTasks.h"
+
+#include <atomic>
+#include <utility>
+
+namespace Rapture {
+
+    namespace AssetTasks {
+
+        namespace {
+
+            // Awaits a loader's completion callback. The callback may run before await_suspend returns (cache hits,
+            // errors), whichever of the two arrives second decides: a late callback resumes the coroutine,
+            // a late await_suspend just doesn't suspend
+            template<typename T>
+            struct CallbackAwaiter {
+                ResumeOn resumeOn;
+                T result{};
+                std::coroutine_handle<> handle;
+                std::atomic<bool> hasArrived{ false };
+
+                explicit CallbackAwaiter(ResumeOn where) : resumeOn(where) {}
+
+                void complete(T value) {
+                    result = std::move(value);
+                    if (hasArrived.exchange(true, std::memory_order_acq_rel)) {
+                        TaskDetail::resume(handle, resumeOn);
+                    }
+                }
+
+                // After starting the load, returns whether the coroutine stays suspended. A load that already
+                // finished continues right here, unless this isn't the thread the caller asked for
+                bool suspend() {
+                    if (!hasArrived.exchange(true, std::memory_order_acq_rel)) {
+                        return true;
+                    }
+                    bool isOnRequestedThread = resumeOn == ResumeOn::MainThread ? JobSystem::isMainThread() : JobSystem::isWorkerThread();
+                    if (isOnRequestedThread) {
+                        return false;
+                    }
+                    TaskDetail::resume(handle, resumeOn);
+                    return true;
+                }
+
+                bool await_ready() const noexcept { return false; }
+                T await_resume() { return std::move(result); }
+            };
+
+            struct ModelLoadAwaiter : CallbackAwaiter<bool> {
+                std::string path;
+                std::shared_ptr<Scene> targetScene;
+                bool isAbsolute;
+                float priority;
+
+                ModelLoadAwaiter(std::string modelPath, std::shared_ptr<Scene> scene, ResumeOn where, bool absolute, float loadPriority)
+                    : CallbackAwaiter(where), path(std::move(modelPath)), targetScene(std::move(scene)), isAbsolute(absolute), priority(loadPriority) {}
+
+                bool await_suspend(std::coroutine_handle<> awaiting) {
+                    handle = awaiting;
+                    ModelLoader::getInstance().loadModel(path, targetScene, [this](bool success) { complete(success); },
+                        isAbsolute, priority);
+                    return suspend();
+                }
+            };
+
+            struct TextureLoadAwaiter : CallbackAwaiter<std::shared_ptr<Texture2D>> {
+                std::string path;
+
+                TextureLoadAwaiter(std::string texturePath, ResumeOn where)
+                    : CallbackAwaiter(where), path(std::move(texturePath)) {}
+
+                bool await_suspend(std::coroutine_handle<> awaiting) {
+                    handle = awaiting;
+                    TextureLibrary::loadAsync(path, [this](std::shared_ptr<Texture2D> texture) { complete(std::move(texture)); });
+                    return suspend();
+                }
+            };
+
+        }
+
+        Task<bool> loadModel(std::string path, std::shared_ptr<Scene> targetScene, ResumeOn resumeOn, bool isAbsolute, float priority)
+        {
+            co_return co_await ModelLoadAwaiter(std::move(path), std::move(targetScene), resumeOn, isAbsolute, priority);
+        }
+
+        Task<std::shared_ptr<Texture2D>> loadTexture(std::string path, ResumeOn resumeOn)
+        {
+            co_return co_await TextureLoadAwaiter(std::move(path), resumeOn);
+        }
+
+    }
+
+}
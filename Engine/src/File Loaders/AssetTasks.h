@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string>
+#include <memory>
+
+#include "ModelLoader.h"
+#include "../Jobs/Task.h"
+#include "../Scenes/Scene.h"
+#include "../Textures/Texture.h"
+
+namespace Rapture {
+
+    /**
+     * Awaitable versions of the asset loaders, for chains of dependent loads written as one coroutine:
+     *
+     *     Task<> loadLevel(std::shared_ptr<Scene> scene) {
+     *         bool loaded = co_await AssetTasks::loadModel("Sponza/Sponza.gltf", scene);
+     *         std::vector<Task<std::shared_ptr<Texture2D>>> textures;
+     *         for (const std::string& path : decalPaths) textures.push_back(AssetTasks::loadTexture(path));
+     *         auto decals = co_await whenAll(std::move(textures));     // decoded side by side
+     *         ...                                                      // back on the main thread, build materials
+     *     }
+     *     loadLevel(scene).detach();
+     *
+     * The loads themselves run on the JobSystem as before, only the continuation is scheduled by the task.
+     */
+    namespace AssetTasks {
+
+        // Load a model through the ModelLoader, true once it is in the scene. Prefab hits finish right away
+        Task<bool> loadModel(std::string path, std::shared_ptr<Scene> targetScene,
+            ResumeOn resumeOn = ResumeOn::MainThread, bool isAbsolute = false, float priority = MODEL_LOAD_PRIORITY_DEFAULT);
+
+        // Load a texture through the TextureLibrary, finishes once its pixels are uploaded, nullptr if it can't be loaded
+        Task<std::shared_ptr<Texture2D>> loadTexture(std::string path, ResumeOn resumeOn = ResumeOn::MainThread);
+
+    }
+
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <string_view>
+#include <cstdint>
+
+namespace Rapture {
+
+    namespace Base64 {
+
+        constexpr uint8_t INVALID_CHAR = 0xFF;
+
+        // Maps an ASCII character to its 6 bit value, INVALID_CHAR for anything outside the alphabet
+        inline const std::array<uint8_t, 256>& getDecodeTable() {
+            static const std::array<uint8_t, 256> table = [] {
+                std::array<uint8_t, 256> t{};
+                t.fill(INVALID_CHAR);
+                const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+                for (uint8_t i = 0; i < 64; i++) {
+                    t[static_cast<unsigned char>(alphabet[i])] = i;
+                }
+                return t;
+            }();
+            return table;
+        }
+
+        /**
+         * @brief Decode base64 text into bytes
+         *
+         * The main loop decodes 8 characters into 6 bytes per iteration with a single validity check,
+         * so the common case is a straight run of table lookups, shifts and stores.
+         *
+         * @param encoded Base64 text, trailing '=' padding is optional
+         * @param out Decoded bytes, resized to fit
+         * @return false if the text contains characters outside the base64 alphabet or has an invalid length
+         */
+        inline bool decode(std::string_view encoded, std::vector<unsigned char>& out) {
+            const auto& table = getDecodeTable();
+
+            size_t length = encoded.size();
+            while (length > 0 && encoded[length - 1] == '=') {
+                length--;
+            }
+
+            size_t remainder = length % 4;
+            if (remainder == 1) {
+                out.clear();
+                return false;
+            }
+
+            out.resize(length / 4 * 3 + (remainder ? remainder - 1 : 0));
+
+            const unsigned char* src = reinterpret_cast<const unsigned char*>(encoded.data());
+            unsigned char* dst = out.data();
+            size_t i = 0;
+
+            // Two 4 character groups at a time
+            for (; i + 8 <= length; i += 8, dst += 6) {
+                uint8_t v0 = table[src[i + 0]], v1 = table[src[i + 1]], v2 = table[src[i + 2]], v3 = table[src[i + 3]];
+                uint8_t v4 = table[src[i + 4]], v5 = table[src[i + 5]], v6 = table[src[i + 6]], v7 = table[src[i + 7]];
+
+                // Valid values never have the top bits set, so one OR covers all 8 characters
+                if ((v0 | v1 | v2 | v3 | v4 | v5 | v6 | v7) & 0xC0) {
+                    out.clear();
+                    return false;
+                }
+
+                uint32_t a = (uint32_t(v0) << 18) | (uint32_t(v1) << 12) | (uint32_t(v2) << 6) | v3;
+                uint32_t b = (uint32_t(v4) << 18) | (uint32_t(v5) << 12) | (uint32_t(v6) << 6) | v7;
+
+                dst[0] = uint8_t(a >> 16); dst[1] = uint8_t(a >> 8); dst[2] = uint8_t(a);
+                dst[3] = uint8_t(b >> 16); dst[4] = uint8_t(b >> 8); dst[5] = uint8_t(b);
+            }
+
+            // Leftover characters, at most 7
+            uint32_t accumulator = 0;
+            int bits = 0;
+            for (; i < length; i++) {
+                uint8_t v = table[src[i]];
+                if (v == INVALID_CHAR) {
+                    out.clear();
+                    return false;
+                }
+                accumulator = (accumulator << 6) | v;
+                bits += 6;
+                if (bits >= 8) {
+                    bits -= 8;
+                    *dst++ = uint8_t(accumulator >> bits);
+                }
+            }
+
+            return true;
+        }
+
+    }
+
+}
@@ -0,0 +1,175 @@
+#include "MappedFile.h"
+#include "../Logger/Log.h"
+
+#include <utility>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Rapture {
+
+    MappedFile::~MappedFile()
+    {
+        close();
+    }
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept
+    {
+        *this = std::move(other);
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+    {
+        if (this != &other) {
+            close();
+
+            m_data = std::exchange(other.m_data, nullptr);
+            m_size = std::exchange(other.m_size, 0);
+#ifdef _WIN32
+            m_fileHandle = std::exchange(other.m_fileHandle, nullptr);
+            m_mappingHandle = std::exchange(other.m_mappingHandle, nullptr);
+#else
+            m_fd = std::exchange(other.m_fd, -1);
+#endif
+        }
+        return *this;
+    }
+
+#ifdef _WIN32
+    bool MappedFile::open(const std::string& path)
+    {
+        close();
+
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            GE_CORE_ERROR("MappedFile: Couldn't open file '{}'", path);
+            return false;
+        }
+
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+            GE_CORE_ERROR("MappedFile: File '{}' is empty or its size couldn't be read", path);
+            CloseHandle(file);
+            return false;
+        }
+
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping) {
+            GE_CORE_ERROR("MappedFile: Couldn't create a mapping for '{}'", path);
+            CloseHandle(file);
+            return false;
+        }
+
+        void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (!view) {
+            GE_CORE_ERROR("MappedFile: Couldn't map a view of '{}'", path);
+            CloseHandle(mapping);
+            CloseHandle(file);
+            return false;
+        }
+
+        m_fileHandle = file;
+        m_mappingHandle = mapping;
+        m_data = static_cast<const unsigned char*>(view);
+        m_size = static_cast<size_t>(fileSize.QuadPart);
+        return true;
+    }
+
+    void MappedFile::close()
+    {
+        if (m_data) {
+            UnmapViewOfFile(m_data);
+        }
+        if (m_mappingHandle) {
+            CloseHandle(m_mappingHandle);
+        }
+        if (m_fileHandle) {
+            CloseHandle(m_fileHandle);
+        }
+
+        m_data = nullptr;
+        m_size = 0;
+        m_fileHandle = nullptr;
+        m_mappingHandle = nullptr;
+    }
+#else
+    bool MappedFile::open(const std::string& path)
+    {
+        close();
+
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            GE_CORE_ERROR("MappedFile: Couldn't open file '{}'", path);
+            return false;
+        }
+
+        struct stat fileStat;
+        if (fstat(fd, &fileStat) != 0 || fileStat.st_size == 0) {
+            GE_CORE_ERROR("MappedFile: File '{}' is empty or its size couldn't be read", path);
+            ::close(fd);
+            return false;
+        }
+
+        void* view = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (view == MAP_FAILED) {
+            GE_CORE_ERROR("MappedFile: Couldn't map '{}'", path);
+            ::close(fd);
+            return false;
+        }
+
+        m_fd = fd;
+        m_data = static_cast<const unsigned char*>(view);
+        m_size = static_cast<size_t>(fileStat.st_size);
+        return true;
+    }
+
+    void MappedFile::close()
+    {
+        if (m_data) {
+            munmap(const_cast<unsigned char*>(m_data), m_size);
+        }
+        if (m_fd >= 0) {
+            ::close(m_fd);
+        }
+
+        m_data = nullptr;
+        m_size = 0;
+        m_fd = -1;
+    }
+#endif
+
+    void MappedFile::evict(const unsigned char* begin, size_t size) const
+    {
+        if (!m_data || begin < m_data || begin + size > m_data + m_size) {
+            return;
+        }
+
+#ifdef _WIN32
+        SYSTEM_INFO systemInfo;
+        GetSystemInfo(&systemInfo);
+        uintptr_t pageSize = systemInfo.dwPageSize;
+#else
+        uintptr_t pageSize = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+#endif
+        uintptr_t first = (reinterpret_cast<uintptr_t>(begin) + pageSize - 1) & ~(pageSize - 1);
+        uintptr_t last = (reinterpret_cast<uintptr_t>(begin) + size) & ~(pageSize - 1);
+        if (first >= last) {
+            return;
+        }
+
+#ifdef _WIN32
+        // Unlocking pages that were never locked removes them from the working set
+        VirtualUnlock(reinterpret_cast<void*>(first), last - first);
+#else
+        // The mapping is private and never written, so dropped pages are simply read from the file again
+        madvise(reinterpret_cast<void*>(first), last - first, MADV_DONTNEED);
+#endif
+    }
+
+}
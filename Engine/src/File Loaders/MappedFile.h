@@ -0,0 +1,45 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+
+namespace Rapture {
+
+    // Read-only memory mapping of a whole file.
+    // The OS pages the file in on demand, so large binary payloads can be read without copying them into memory first.
+    class MappedFile {
+    public:
+        MappedFile() = default;
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+
+        // Maps the file at path, unmapping any previously mapped file first
+        bool open(const std::string& path);
+        void close();
+
+        bool isOpen() const { return m_data != nullptr; }
+        const unsigned char* data() const { return m_data; }
+        size_t size() const { return m_size; }
+
+        // Drop the pages of a range from the working set once it has been read. Nothing is lost, the OS reads them
+        // from the file again if they are touched later. Only pages entirely inside the range are dropped
+        void evict(const unsigned char* begin, size_t size) const;
+
+    private:
+        const unsigned char* m_data = nullptr;
+        size_t m_size = 0;
+
+#ifdef _WIN32
+        void* m_fileHandle = nullptr;
+        void* m_mappingHandle = nullptr;
+#else
+        int m_fd = -1;
+#endif
+    };
+
+}
@@ -0,0 +1,66 @@
+#include "MemoryStats.h"
+
+#ifdef _WIN32
+#include <Windows.h>
+#include <Psapi.h>
+#else
+#include <cstdio>
+#include <unistd.h>
+#include <sys/resource.h>
+#endif
+
+namespace Rapture {
+
+    namespace MemoryStats {
+
+#ifdef _WIN32
+        size_t getPeakWorkingSet()
+        {
+            PROCESS_MEMORY_COUNTERS counters;
+            if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+                return 0;
+            }
+            return counters.PeakWorkingSetSize;
+        }
+
+        size_t getWorkingSet()
+        {
+            PROCESS_MEMORY_COUNTERS counters;
+            if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+                return 0;
+            }
+            return counters.WorkingSetSize;
+        }
+#else
+        size_t getPeakWorkingSet()
+        {
+            struct rusage usage;
+            if (getrusage(RUSAGE_SELF, &usage) != 0) {
+                return 0;
+            }
+#ifdef __APPLE__
+            return static_cast<size_t>(usage.ru_maxrss);
+#else
+            // Linux reports kilobytes
+            return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+        }
+
+        size_t getWorkingSet()
+        {
+            // Second field of statm is the resident page count
+            FILE* statm = std::fopen("/proc/self/statm", "r");
+            if (!statm) {
+                return 0;
+            }
+            unsigned long totalPages = 0;
+            unsigned long residentPages = 0;
+            int fields = std::fscanf(statm, "%lu %lu", &totalPages, &residentPages);
+            std::fclose(statm);
+            return fields == 2 ? static_cast<size_t>(residentPages) * static_cast<size_t>(sysconf(_SC_PAGESIZE)) : 0;
+        }
+#endif
+
+    }
+
+}
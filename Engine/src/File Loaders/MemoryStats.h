@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstddef>
+
+namespace Rapture {
+
+    namespace MemoryStats {
+
+        // Largest resident set of the process so far in bytes, 0 where the platform doesn't report it
+        size_t getPeakWorkingSet();
+
+        // Resident set of the process right now in bytes, 0 where the platform doesn't report it
+        size_t getWorkingSet();
+
+    }
+
+}
@@ -0,0 +1,423 @@
+#include "MeshCache.h"
+#include "../Logger/Log.h"
+#include "../Debug/TracyProfiler.h"
+
+#include <fstream>
+#include <filesystem>
+#include <cstring>
+
+namespace Rapture {
+
+    bool MeshCache::s_enabled = true;
+
+    namespace {
+
+        constexpr uint32_t MESH_CACHE_MAGIC = 0x48534D52; // "RMSH"
+        constexpr size_t MESH_CACHE_BLOB_ALIGNMENT = 16;
+
+        // Fixed size records, written as is. Everything is little endian like the platforms we ship on
+        struct CacheHeader {
+            uint32_t magic;
+            uint32_t version;
+            uint64_t settingsHash;
+            uint32_t dependencyCount;
+            uint32_t primitiveCount;
+            uint32_t entityCount;
+            uint32_t reserved;
+        };
+
+        struct CacheAttribute {
+            uint32_t componentType;
+            uint32_t offset;
+            uint8_t semantic;
+            uint8_t type;
+            uint8_t normalized;
+            uint8_t padding;
+        };
+
+        struct CacheBlob {
+            uint64_t offset;
+            uint64_t size;
+        };
+
+        struct CachePrimitive {
+            uint32_t attributeCount;
+            uint32_t vertexSize;
+            uint32_t positionStride;
+            uint32_t hasPositionStream;
+            uint32_t indexCount;
+            uint32_t indexType;
+            CacheBlob vertexData;
+            CacheBlob positionData;
+            CacheBlob indexData;
+            float boundsMin[3];
+            float boundsMax[3];
+            uint32_t hasBounds;
+            uint32_t padding;
+        };
+
+        struct CacheEntity {
+            int32_t parent;
+            int32_t primitive;
+            int32_t material;
+            uint32_t padding;
+            float transform[16];
+        };
+
+        class CacheWriter {
+        public:
+            explicit CacheWriter(std::ofstream& stream) : m_stream(stream) {}
+
+            template<typename T>
+            void write(const T& value) { writeBytes(&value, sizeof(T)); }
+
+            void writeString(const std::string& value) {
+                write(static_cast<uint32_t>(value.size()));
+                writeBytes(value.data(), value.size());
+            }
+
+            void writeBytes(const void* data, size_t size) {
+                m_stream.write(static_cast<const char*>(data), size);
+                m_offset += size;
+            }
+
+            void align(size_t alignment) {
+                static const char zeros[MESH_CACHE_BLOB_ALIGNMENT] = {};
+                size_t padding = (alignment - m_offset % alignment) % alignment;
+                writeBytes(zeros, padding);
+            }
+
+            size_t offset() const { return m_offset; }
+
+        private:
+            std::ofstream& m_stream;
+            size_t m_offset = 0;
+        };
+
+        class CacheReader {
+        public:
+            CacheReader(const unsigned char* data, size_t size) : m_data(data), m_size(size) {}
+
+            template<typename T>
+            bool read(T& value) {
+                if (m_offset + sizeof(T) > m_size) {
+                    return false;
+                }
+                std::memcpy(&value, m_data + m_offset, sizeof(T));
+                m_offset += sizeof(T);
+                return true;
+            }
+
+            bool readString(std::string& value) {
+                uint32_t length = 0;
+                if (!read(length) || length > m_size - m_offset) {
+                    return false;
+                }
+                value.assign(reinterpret_cast<const char*>(m_data + m_offset), length);
+                m_offset += length;
+                return true;
+            }
+
+            // Bytes not read yet
+            size_t remaining() const { return m_size - m_offset; }
+
+            // Bulk data is not copied, it is only checked to lie inside the mapping.
+            // Written so that a corrupt offset or size can't wrap around the check
+            const unsigned char* blob(const CacheBlob& blob) const {
+                if (blob.size == 0 || blob.offset > m_size || blob.size > m_size - blob.offset) {
+                    return nullptr;
+                }
+                return m_data + blob.offset;
+            }
+
+        private:
+            const unsigned char* m_data;
+            size_t m_size;
+            size_t m_offset = 0;
+        };
+
+    }
+
+    std::string MeshCache::getCachePath(const std::string& sourcePath)
+    {
+        return sourcePath + MESH_CACHE_EXTENSION;
+    }
+
+    bool MeshCache::getFileStamp(const std::string& path, uint64_t& size, int64_t& writeTime)
+    {
+        std::error_code error;
+        size = std::filesystem::file_size(path, error);
+        if (error) {
+            return false;
+        }
+        writeTime = std::filesystem::last_write_time(path, error).time_since_epoch().count();
+        return !error;
+    }
+
+    bool MeshCache::write(const std::string& cachePath, const BakedModel& model)
+    {
+        RAPTURE_PROFILE_FUNCTION();
+
+        // Written to a temporary file first, so a crash never leaves a truncated cache that looks valid
+        std::string tempPath = cachePath + ".tmp";
+        std::ofstream stream(tempPath, std::ios::binary | std::ios::trunc);
+        if (!stream) {
+            GE_CORE_WARN("MeshCache: Couldn't create cache file '{}'", tempPath);
+            return false;
+        }
+
+        CacheWriter writer(stream);
+
+        CacheHeader header{};
+        header.magic = MESH_CACHE_MAGIC;
+        header.version = MESH_CACHE_VERSION;
+        header.settingsHash = model.settingsHash;
+        header.dependencyCount = static_cast<uint32_t>(model.dependencies.size());
+        header.primitiveCount = static_cast<uint32_t>(model.primitives.size());
+        header.entityCount = static_cast<uint32_t>(model.entities.size());
+        writer.write(header);
+
+        for (const auto& dependency : model.dependencies) {
+            uint64_t size = 0;
+            int64_t writeTime = 0;
+            if (!getFileStamp(dependency, size, writeTime)) {
+                GE_CORE_WARN("MeshCache: Couldn't stat dependency '{}', not caching", dependency);
+                stream.close();
+                std::filesystem::remove(tempPath);
+                return false;
+            }
+            writer.writeString(dependency);
+            writer.write(size);
+            writer.write(writeTime);
+        }
+
+        writer.writeString(model.materialJSON);
+
+        // Blob offsets are known up front: all tables come first, then the 16 byte aligned blobs in primitive order
+        size_t tableSize = 0;
+        for (const auto& primitive : model.primitives) {
+            tableSize += sizeof(CachePrimitive) + primitive.layout.getAttributes().size() * sizeof(CacheAttribute);
+        }
+        for (const auto& entity : model.entities) {
+            tableSize += sizeof(CacheEntity) + sizeof(uint32_t) + entity.name.size();
+        }
+
+        size_t blobOffset = writer.offset() + tableSize;
+        auto placeBlob = [&blobOffset](size_t size) {
+            blobOffset = (blobOffset + MESH_CACHE_BLOB_ALIGNMENT - 1) / MESH_CACHE_BLOB_ALIGNMENT * MESH_CACHE_BLOB_ALIGNMENT;
+            CacheBlob blob{ blobOffset, size };
+            blobOffset += size;
+            return blob;
+        };
+
+        for (const auto& primitive : model.primitives) {
+            const BufferLayout& layout = primitive.layout;
+
+            CachePrimitive record{};
+            record.attributeCount = static_cast<uint32_t>(layout.getAttributes().size());
+            record.vertexSize = static_cast<uint32_t>(layout.getVertexSize());
+            record.positionStride = static_cast<uint32_t>(layout.getPositionStride());
+            record.hasPositionStream = layout.hasPositionStream();
+            record.indexCount = primitive.indexCount;
+            record.indexType = primitive.indexType;
+            record.vertexData = placeBlob(primitive.vertexDataSize);
+            record.positionData = placeBlob(primitive.positionDataSize);
+            record.indexData = placeBlob(primitive.indexDataSize);
+            record.hasBounds = primitive.localBoundingBox.isValid();
+            if (record.hasBounds) {
+                glm::vec3 boundsMin = primitive.localBoundingBox.getMin();
+                glm::vec3 boundsMax = primitive.localBoundingBox.getMax();
+                std::memcpy(record.boundsMin, &boundsMin, sizeof(record.boundsMin));
+                std::memcpy(record.boundsMax, &boundsMax, sizeof(record.boundsMax));
+            }
+            writer.write(record);
+
+            for (const auto& attrib : layout.getAttributes()) {
+                CacheAttribute attribRecord{};
+                attribRecord.componentType = attrib.componentType;
+                attribRecord.offset = static_cast<uint32_t>(attrib.offset);
+                attribRecord.semantic = static_cast<uint8_t>(attrib.semantic);
+                attribRecord.type = static_cast<uint8_t>(attrib.type);
+                attribRecord.normalized = attrib.normalized;
+                writer.write(attribRecord);
+            }
+        }
+
+        for (const auto& entity : model.entities) {
+            CacheEntity record{};
+            record.parent = entity.parent;
+            record.primitive = entity.primitive;
+            record.material = entity.material;
+            std::memcpy(record.transform, &entity.transform[0][0], sizeof(record.transform));
+            writer.write(record);
+            writer.writeString(entity.name);
+        }
+
+        for (const auto& primitive : model.primitives) {
+            for (auto [data, size] : { std::pair{ primitive.vertexData, primitive.vertexDataSize },
+                                       std::pair{ primitive.positionData, primitive.positionDataSize },
+                                       std::pair{ primitive.indexData, primitive.indexDataSize } }) {
+                writer.align(MESH_CACHE_BLOB_ALIGNMENT);
+                writer.writeBytes(data, size);
+            }
+        }
+
+        stream.close();
+        if (!stream) {
+            GE_CORE_WARN("MeshCache: Failed writing cache file '{}'", tempPath);
+            std::filesystem::remove(tempPath);
+            return false;
+        }
+
+        std::error_code error;
+        std::filesystem::rename(tempPath, cachePath, error);
+        if (error) {
+            GE_CORE_WARN("MeshCache: Couldn't move cache file into place '{}': {}", cachePath, error.message());
+            std::filesystem::remove(tempPath, error);
+            return false;
+        }
+
+        GE_CORE_INFO("MeshCache: Wrote '{}' ({} primitives, {:.2f}MB)", cachePath, model.primitives.size(), writer.offset() / 1024.0f / 1024.0f);
+        return true;
+    }
+
+    bool MeshCache::read(const std::string& cachePath, uint64_t settingsHash, BakedModel& model)
+    {
+        RAPTURE_PROFILE_FUNCTION();
+
+        if (!std::filesystem::exists(cachePath)) {
+            return false;
+        }
+
+        auto mapping = std::make_shared<MappedFile>();
+        if (!mapping->open(cachePath)) {
+            return false;
+        }
+
+        CacheReader reader(mapping->data(), mapping->size());
+
+        CacheHeader header{};
+        if (!reader.read(header) || header.magic != MESH_CACHE_MAGIC) {
+            GE_CORE_WARN("MeshCache: '{}' is not a mesh cache", cachePath);
+            return false;
+        }
+        if (header.version != MESH_CACHE_VERSION || header.settingsHash != settingsHash) {
+            GE_CORE_INFO("MeshCache: '{}' was built with another version or import settings, rebuilding", cachePath);
+            return false;
+        }
+
+        // Any change to a source file invalidates the whole cache
+        for (uint32_t i = 0; i < header.dependencyCount; i++) {
+            std::string dependency;
+            uint64_t cachedSize = 0;
+            int64_t cachedWriteTime = 0;
+            if (!reader.readString(dependency) || !reader.read(cachedSize) || !reader.read(cachedWriteTime)) {
+                GE_CORE_WARN("MeshCache: '{}' is truncated", cachePath);
+                return false;
+            }
+
+            uint64_t size = 0;
+            int64_t writeTime = 0;
+            if (!getFileStamp(dependency, size, writeTime) || size != cachedSize || writeTime != cachedWriteTime) {
+                GE_CORE_INFO("MeshCache: '{}' changed since '{}' was built, rebuilding", dependency, cachePath);
+                return false;
+            }
+            model.dependencies.push_back(std::move(dependency));
+        }
+
+        if (!reader.readString(model.materialJSON)) {
+            GE_CORE_WARN("MeshCache: '{}' is truncated", cachePath);
+            return false;
+        }
+
+        // Every primitive has a record in the file, a corrupt count can't make us allocate more than the file holds
+        if (header.primitiveCount > reader.remaining() / sizeof(CachePrimitive)) {
+            GE_CORE_WARN("MeshCache: '{}' claims {} primitives, more than the file can hold", cachePath, header.primitiveCount);
+            return false;
+        }
+        model.primitives.resize(header.primitiveCount);
+        for (auto& primitive : model.primitives) {
+            CachePrimitive record{};
+            if (!reader.read(record)) {
+                GE_CORE_WARN("MeshCache: '{}' is truncated", cachePath);
+                return false;
+            }
+
+            BufferLayout& layout = primitive.layout;
+            layout.setInterleaved(true);
+            layout.setVertexSize(record.vertexSize);
+            layout.setPositionStream(record.hasPositionStream != 0, record.positionStride);
+            for (uint32_t a = 0; a < record.attributeCount; a++) {
+                CacheAttribute attribRecord{};
+                if (!reader.read(attribRecord)) {
+                    GE_CORE_WARN("MeshCache: '{}' is truncated", cachePath);
+                    return false;
+                }
+                BufferAttribute attrib;
+                attrib.semantic = static_cast<VertexAttributeSemantic>(attribRecord.semantic);
+                attrib.componentType = attribRecord.componentType;
+                attrib.type = static_cast<VertexAttributeType>(attribRecord.type);
+                attrib.offset = attribRecord.offset;
+                attrib.normalized = attribRecord.normalized != 0;
+                layout.addAttribute(attrib);
+            }
+            // Layout ids are only stable within a run, so the layout is stored in full and interned again
+            layout.intern();
+
+            primitive.vertexData = reader.blob(record.vertexData);
+            primitive.vertexDataSize = record.vertexData.size;
+            primitive.positionData = reader.blob(record.positionData);
+            primitive.positionDataSize = record.positionData.size;
+            primitive.indexData = reader.blob(record.indexData);
+            primitive.indexDataSize = record.indexData.size;
+            primitive.indexCount = record.indexCount;
+            primitive.indexType = record.indexType;
+
+            if ((record.vertexData.size && !primitive.vertexData) ||
+                (record.positionData.size && !primitive.positionData) ||
+                (record.indexData.size && !primitive.indexData)) {
+                GE_CORE_WARN("MeshCache: '{}' has data outside the file", cachePath);
+                return false;
+            }
+
+            if (record.hasBounds) {
+                glm::vec3 boundsMin, boundsMax;
+                std::memcpy(&boundsMin, record.boundsMin, sizeof(record.boundsMin));
+                std::memcpy(&boundsMax, record.boundsMax, sizeof(record.boundsMax));
+                primitive.localBoundingBox = BoundingBox(boundsMin, boundsMax);
+            }
+        }
+
+        if (header.entityCount > reader.remaining() / sizeof(CacheEntity)) {
+            GE_CORE_WARN("MeshCache: '{}' claims {} entities, more than the file can hold", cachePath, header.entityCount);
+            return false;
+        }
+        model.entities.resize(header.entityCount);
+        for (size_t entityIndex = 0; entityIndex < model.entities.size(); entityIndex++) {
+            BakedEntity& entity = model.entities[entityIndex];
+            CacheEntity record{};
+            if (!reader.read(record) || !reader.readString(entity.name)) {
+                GE_CORE_WARN("MeshCache: '{}' is truncated", cachePath);
+                return false;
+            }
+            entity.parent = record.parent;
+            entity.primitive = record.primitive;
+            entity.material = record.material;
+            std::memcpy(&entity.transform[0][0], record.transform, sizeof(record.transform));
+
+            // -1 marks a root and an entity without a primitive, any other index has to be in range.
+            // Parents are written before their children, the loader relies on that
+            bool isPrimitiveValid = entity.primitive == -1 || (entity.primitive >= 0 && entity.primitive < (int32_t)model.primitives.size());
+            bool isParentValid = entity.parent == -1 || (entity.parent >= 0 && static_cast<size_t>(entity.parent) < entityIndex);
+            if (!isPrimitiveValid || !isParentValid) {
+                GE_CORE_WARN("MeshCache: '{}' has invalid entity references", cachePath);
+                return false;
+            }
+        }
+
+        model.settingsHash = header.settingsHash;
+        model.mapping = std::move(mapping);
+        return true;
+    }
+
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include "../Buffers/VertexFormat.h"
+#include "../Scenes/Components/BoundingBox.h"
+#include "MappedFile.h"
+
+namespace Rapture {
+
+    // Bump whenever the file layout or the decoded data changes, older caches are then rebuilt
+    constexpr uint32_t MESH_CACHE_VERSION = 3;
+    constexpr const char* MESH_CACHE_EXTENSION = ".rmesh";
+
+    // Final, upload ready data of one primitive
+    struct BakedPrimitive {
+        BufferLayout layout;
+        const unsigned char* vertexData = nullptr;
+        size_t vertexDataSize = 0;
+        const unsigned char* positionData = nullptr;   // only for layouts with a separate position stream
+        size_t positionDataSize = 0;
+        const unsigned char* indexData = nullptr;
+        size_t indexDataSize = 0;
+        uint32_t indexCount = 0;
+        uint32_t indexType = 0;
+        BoundingBox localBoundingBox;
+    };
+
+    // One entity of the imported hierarchy, entities are stored parents first
+    struct BakedEntity {
+        std::string name;
+        int32_t parent = -1;            // index into BakedModel::entities
+        glm::mat4 transform = glm::mat4(1.0f);
+        int32_t primitive = -1;         // index into BakedModel::primitives
+        int32_t material = -1;          // index into the materials of materialJSON
+    };
+
+    // Everything an import produces, with the bulk data referenced rather than owned.
+    // When read from disk the pointers point into the mapping, which is kept alive by the model.
+    struct BakedModel {
+        std::vector<std::string> dependencies;      // source files, a change to any of them invalidates the cache
+        uint64_t settingsHash = 0;
+        std::string materialJSON;                   // glTF materials, textures, images and samplers sections
+        std::vector<BakedPrimitive> primitives;
+        std::vector<BakedEntity> entities;
+
+        std::shared_ptr<MappedFile> mapping;
+    };
+
+    // Versioned binary cache of imported models, stored next to the source as <source>.rmesh.
+    // Bulk data is 16 byte aligned so it can be uploaded straight out of the mapping.
+    class MeshCache {
+    public:
+        static std::string getCachePath(const std::string& sourcePath);
+
+        // Writes the model, returns false (and leaves no partial file) on failure
+        static bool write(const std::string& cachePath, const BakedModel& model);
+
+        // Maps the cache and checks version, settings and that no dependency changed since it was written
+        static bool read(const std::string& cachePath, uint64_t settingsHash, BakedModel& model);
+
+        static void setEnabled(bool enabled) { s_enabled = enabled; }
+        static bool isEnabled() { return s_enabled; }
+
+    private:
+        // Size and last write time of a file, cheap enough to check on every load even for huge sources
+        static bool getFileStamp(const std::string& path, uint64_t& size, int64_t& writeTime);
+
+    private:
+        static bool s_enabled;
+    };
+
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+
+namespace Rapture {
+
+    // Live state of one model load, shared between whoever requested it and the loader doing the work.
+    // The counters are written from the loader's decode threads, so readers only ever see a snapshot.
+    struct ModelLoadProgress {
+        std::atomic<bool> cancelled{ false };
+
+        std::atomic<size_t> primitivesTotal{ 0 };
+        std::atomic<size_t> primitivesDecoded{ 0 };
+        std::atomic<size_t> bytesDecoded{ 0 };
+        std::atomic<size_t> peakStagingBytes{ 0 };     // decoded data waiting for the GPU at the worst point, set once the load ends
+
+        // Called after every decoded primitive and at the end of each load stage.
+        // Runs on the loader's threads, possibly several at once, so it must be thread safe and cheap
+        std::function<void(const ModelLoadProgress&)> callback = nullptr;
+
+        void cancel() { cancelled.store(true, std::memory_order_relaxed); }
+        bool isCancelled() const { return cancelled.load(std::memory_order_relaxed); }
+
+        // Fraction of primitives decoded, 0 until the primitive count is known
+        float getFraction() const {
+            size_t total = primitivesTotal.load(std::memory_order_relaxed);
+            return total > 0 ? static_cast<float>(primitivesDecoded.load(std::memory_order_relaxed)) / static_cast<float>(total) : 0.0f;
+        }
+    };
+
+}
@@ -29,7 +29,7 @@ ModelLoader::~ModelLoader()
     }
 }
 
-void ModelLoader::init(unsigned int numThreads)
+void ModelLoader::init(unsigned int maxConcurrentLoads)
 {
     std::lock_guard<std::mutex> lock(m_queueMutex);
     
@@ -42,18 +42,15 @@ void ModelLoader::init(unsigned int numThreads)
         GE_CORE_ERROR("ModelLoader: Cannot initialize while shutting down!");
         return;
     }
-    
-    GE_CORE_INFO("ModelLoader: Initializing with {0} worker threads", numThreads);
-    
-    // Ensure at least one thread
-    numThreads = std::max(1u, numThreads);
-    
-    // Start worker threads
-    for (unsigned int i = 0; i < numThreads; ++i) {
-        m_workerThreads.emplace_back(&ModelLoader::workerFunction, this);
-        GE_CORE_INFO("ModelLoader: Started worker thread {0}", i + 1);
+
+    if (!JobSystem::isInitialized()) {
+        GE_CORE_WARN("ModelLoader: JobSystem not initialized, models will load synchronously on the calling thread");
     }
     
+    // Ensure at least one load at a time
+    m_maxConcurrentLoads = std::max(1u, maxConcurrentLoads);
+    GE_CORE_INFO("ModelLoader: Initializing with up to {0} concurrent loads", m_maxConcurrentLoads);
+    
     m_initialized = true;
     GE_CORE_INFO("ModelLoader: Initialized successfully");
 }
@@ -88,21 +85,27 @@ void ModelLoader::shutdown()
     
     // Only proceed if we were initialized
     if (wasInitialized) {
-        // Notify all waiting threads
-        m_queueCondition.notify_all();
-        
+        // Running loads stop at their next primitive instead of finishing work nobody will use
+        {
+            std::lock_guard<std::mutex> lock(m_queueMutex);
+            for (auto& [modelID, request] : m_activeLoads) {
+                request.progress->cancel();
+            }
+        }
+
         // Log active operations
         size_t activeOps = m_activeLoadCount.load();
         if (activeOps > 0) {
             GE_CORE_WARN("ModelLoader: Shutting down with {0} active loading operations", activeOps);
         }
         
-        // Join all worker threads
-        for (auto& thread : m_workerThreads) {
-            if (thread.joinable()) {
-                thread.join();
-            }
+        // Jobs that haven't started see the flag and return, running ones stop at their next primitive
+        std::vector<JobHandle> loadJobs;
+        {
+            std::lock_guard<std::mutex> lock(m_queueMutex);
+            loadJobs.swap(m_loadJobs);
         }
+        JobSystem::wait(loadJobs);
         
         // Clear containers
         {
@@ -110,17 +113,17 @@ void ModelLoader::shutdown()
             std::lock_guard<std::mutex> statusLock(m_statusMutex);
             
             // Call callbacks for any remaining requests with failure
-            while (!m_loadQueue.empty()) {
-                auto request = m_loadQueue.front();
-                m_loadQueue.pop();
-                
+            for (auto& request : m_loadQueue) {
                 if (request.callback) {
                     GE_CORE_WARN("ModelLoader: Canceling queued model load '{0}' due to shutdown", request.path);
                     request.callback(false);
                 }
             }
+            m_loadQueue.clear();
+            m_activeLoads.clear();
+            m_prefabs.clear();
             
-            m_workerThreads.clear();
+            m_pendingLoadJobs = 0;
             m_modelLoadStatus.clear();
             m_activeLoadCount = 0;
         }
@@ -133,7 +136,9 @@ std::string ModelLoader::loadModel(
     const std::string& path, 
     std::shared_ptr<Scene> targetScene, 
     std::function<void(bool)> callback,
-    bool isAbsolute)
+    bool isAbsolute,
+    float priority,
+    std::function<void(const ModelLoadProgress&)> progressCallback)
 {
     if (!m_initialized) {
         GE_CORE_ERROR("ModelLoader: Cannot load model, loader not initialized!");
@@ -161,6 +166,27 @@ std::string ModelLoader::loadModel(
     
     // Generate a unique model ID
     std::string modelID = generateModelID(path);
+
+    // A model loaded before is cloned from its prefab, there is nothing left to do on a worker.
+    // The clone waits for the frame boundary like a merged load, loadModel may be called mid-frame or off the main thread
+    std::shared_ptr<ModelPrefab> readyPrefab = isPrefabCacheEnabled() ? getReadyPrefab(path) : nullptr;
+    if (readyPrefab) {
+        ModelLoadRequest request;
+        request.path = path;
+        request.modelID = modelID;
+        request.targetScene = targetScene;
+        request.callback = callback;
+        request.prefab = readyPrefab;
+
+        StagingScene::runAtFrameBoundary([this, request]() {
+            bool success = request.prefab->instantiate(request.targetScene.get()).isValid();
+            recordLoadResult(request, success);
+            if (request.callback) {
+                request.callback(success);
+            }
+        });
+        return modelID;
+    }
     
     // Create a model load request
     ModelLoadRequest request;
@@ -169,6 +195,9 @@ std::string ModelLoader::loadModel(
     request.targetScene = targetScene;
     request.callback = callback;
     request.isAbsolute = isAbsolute;
+    request.priority = priority;
+    request.progress = std::make_shared<ModelLoadProgress>();
+    request.progress->callback = progressCallback;
     
     // Add the request to the queue
     {
@@ -183,17 +212,31 @@ std::string ModelLoader::loadModel(
             return "";
         }
         
-        m_loadQueue.push(request);
+        if (m_prefabCacheEnabled) {
+            auto prefab = m_prefabs.find(path);
+            if (prefab == m_prefabs.end()) {
+                // First load of this path, every later load is cloned from what it creates
+                request.prefab = std::make_shared<ModelPrefab>(path);
+                request.buildsPrefab = true;
+                m_prefabs[path] = request.prefab;
+            }
+            else {
+                // Already being loaded, wait for that load instead of reading the file a second time
+                request.prefab = prefab->second;
+            }
+        }
+
+        request.sequence = m_nextSequence++;
+        m_loadQueue.push_back(request);
         
         // Add to tracking map
         std::lock_guard<std::mutex> statusLock(m_statusMutex);
         m_modelLoadStatus[modelID] = false;
     }
     
-    GE_CORE_INFO("ModelLoader: Queued model '{0}' with ID '{1}'", path, modelID);
+    GE_CORE_INFO("ModelLoader: Queued model '{0}' with ID '{1}' at priority {2}", path, modelID, priority);
     
-    // Notify a worker thread
-    m_queueCondition.notify_one();
+    scheduleLoads();
     
     return modelID;
 }
@@ -221,6 +264,238 @@ size_t ModelLoader::getActiveLoadCount() const
     return m_activeLoadCount;
 }
 
+bool ModelLoader::cancelLoad(const std::string& modelID)
+{
+    std::function<void(bool)> callback = nullptr;
+    std::string path;
+
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+
+        // A running load only gets flagged, its worker cleans up and calls the callback
+        auto active = m_activeLoads.find(modelID);
+        if (active != m_activeLoads.end()) {
+            active->second.progress->cancel();
+            GE_CORE_INFO("ModelLoader: Cancelling running load of '{0}'", active->second.path);
+            return true;
+        }
+
+        auto queued = std::find_if(m_loadQueue.begin(), m_loadQueue.end(),
+            [&modelID](const ModelLoadRequest& request) { return request.modelID == modelID; });
+        if (queued == m_loadQueue.end()) {
+            return false;
+        }
+
+        queued->progress->cancel();
+        callback = std::move(queued->callback);
+        path = queued->path;
+        ModelLoadRequest cancelled = std::move(*queued);
+        m_loadQueue.erase(queued);
+
+        if (cancelled.buildsPrefab) {
+            handOffPrefab(cancelled);
+        }
+
+        std::lock_guard<std::mutex> statusLock(m_statusMutex);
+        m_modelLoadStatus.erase(modelID);
+    }
+
+    GE_CORE_INFO("ModelLoader: Cancelled queued load of '{0}'", path);
+
+    // A load waiting on the cancelled one's prefab may have taken over building it
+    scheduleLoads();
+
+    // Called outside the lock, the callback may well queue another load
+    if (callback) {
+        callback(false);
+    }
+    return true;
+}
+
+bool ModelLoader::setPriority(const std::string& modelID, float priority)
+{
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+
+    for (auto& request : m_loadQueue) {
+        if (request.modelID == modelID) {
+            request.priority = priority;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ModelLoader::reprioritize(const std::function<float(const ModelLoadInfo&)>& priorityFunction)
+{
+    if (!priorityFunction) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+
+    for (auto& request : m_loadQueue) {
+        request.priority = priorityFunction(makeLoadInfo(request, ModelLoadState::Queued));
+    }
+}
+
+std::vector<ModelLoadInfo> ModelLoader::getInFlightLoads() const
+{
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+
+    std::vector<ModelLoadInfo> loads;
+    loads.reserve(m_activeLoads.size() + m_loadQueue.size());
+    for (const auto& [modelID, request] : m_activeLoads) {
+        loads.push_back(makeLoadInfo(request, ModelLoadState::Loading));
+    }
+    for (const auto& request : m_loadQueue) {
+        loads.push_back(makeLoadInfo(request, ModelLoadState::Queued));
+    }
+    return loads;
+}
+
+bool ModelLoader::getLoadInfo(const std::string& modelID, ModelLoadInfo& info) const
+{
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+
+    auto active = m_activeLoads.find(modelID);
+    if (active != m_activeLoads.end()) {
+        info = makeLoadInfo(active->second, ModelLoadState::Loading);
+        return true;
+    }
+
+    for (const auto& request : m_loadQueue) {
+        if (request.modelID == modelID) {
+            info = makeLoadInfo(request, ModelLoadState::Queued);
+            return true;
+        }
+    }
+    return false;
+}
+
+ModelLoadRequest ModelLoader::popHighestPriority()
+{
+    auto best = std::find_if(m_loadQueue.begin(), m_loadQueue.end(), isRunnable);
+    for (auto it = std::next(best); it != m_loadQueue.end(); ++it) {
+        if (!isRunnable(*it)) {
+            continue;
+        }
+        if (it->priority > best->priority || (it->priority == best->priority && it->sequence < best->sequence)) {
+            best = it;
+        }
+    }
+
+    ModelLoadRequest request = std::move(*best);
+    // Order doesn't matter, so swap with the back instead of shifting everything after it
+    *best = std::move(m_loadQueue.back());
+    m_loadQueue.pop_back();
+    return request;
+}
+
+bool ModelLoader::isRunnable(const ModelLoadRequest& request)
+{
+    return !request.prefab || request.buildsPrefab || request.prefab->isReady();
+}
+
+bool ModelLoader::hasRunnableRequest() const
+{
+    return std::any_of(m_loadQueue.begin(), m_loadQueue.end(), isRunnable);
+}
+
+std::shared_ptr<ModelPrefab> ModelLoader::getReadyPrefab(const std::string& path) const
+{
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+
+    auto prefab = m_prefabs.find(path);
+    if (prefab == m_prefabs.end() || !prefab->second->isReady()) {
+        return nullptr;
+    }
+    return prefab->second;
+}
+
+void ModelLoader::handOffPrefab(const ModelLoadRequest& request)
+{
+    auto prefab = m_prefabs.find(request.path);
+    if (prefab != m_prefabs.end() && prefab->second == request.prefab) {
+        m_prefabs.erase(prefab);
+    }
+
+    std::shared_ptr<ModelPrefab> replacement;
+    for (auto& waiting : m_loadQueue) {
+        if (waiting.prefab != request.prefab) {
+            continue;
+        }
+        if (!replacement) {
+            replacement = std::make_shared<ModelPrefab>(request.path);
+            m_prefabs[request.path] = replacement;
+            waiting.buildsPrefab = true;
+        }
+        waiting.prefab = replacement;
+    }
+}
+
+Entity ModelLoader::instantiateModel(const std::string& path, std::shared_ptr<Scene> targetScene, const glm::mat4& transform)
+{
+    std::vector<Entity> roots = instantiateModel(path, targetScene, std::vector<glm::mat4>{ transform });
+    return roots.empty() ? Entity() : roots.front();
+}
+
+std::vector<Entity> ModelLoader::instantiateModel(const std::string& path, std::shared_ptr<Scene> targetScene, const std::vector<glm::mat4>& transforms)
+{
+    if (!targetScene) {
+        GE_CORE_ERROR("ModelLoader: Cannot instantiate model, target scene is null!");
+        return {};
+    }
+
+    std::shared_ptr<ModelPrefab> prefab = getReadyPrefab(path);
+    if (!prefab) {
+        GE_CORE_ERROR("ModelLoader: Cannot instantiate model '{0}', it hasn't finished loading", path);
+        return {};
+    }
+
+    return prefab->instantiate(targetScene.get(), transforms);
+}
+
+bool ModelLoader::isPrefabReady(const std::string& path) const
+{
+    return getReadyPrefab(path) != nullptr;
+}
+
+void ModelLoader::setPrefabCacheEnabled(bool enabled)
+{
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    m_prefabCacheEnabled = enabled;
+}
+
+bool ModelLoader::isPrefabCacheEnabled() const
+{
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    return m_prefabCacheEnabled;
+}
+
+void ModelLoader::clearPrefabCache()
+{
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+
+    // Prefabs still being built stay, queued loads are waiting on them
+    for (auto it = m_prefabs.begin(); it != m_prefabs.end();) {
+        it = it->second->isReady() ? m_prefabs.erase(it) : std::next(it);
+    }
+}
+
+ModelLoadInfo ModelLoader::makeLoadInfo(const ModelLoadRequest& request, ModelLoadState state)
+{
+    ModelLoadInfo info;
+    info.modelID = request.modelID;
+    info.path = request.path;
+    info.state = request.progress->isCancelled() ? ModelLoadState::Cancelled : state;
+    info.priority = request.priority;
+    info.primitivesTotal = request.progress->primitivesTotal;
+    info.primitivesDecoded = request.progress->primitivesDecoded;
+    info.bytesDecoded = request.progress->bytesDecoded;
+    info.peakStagingBytes = request.progress->peakStagingBytes;
+    return info;
+}
+
 std::string ModelLoader::generateModelID(const std::string& path)
 {
     // Create a unique ID based on path and a random component
@@ -249,85 +524,155 @@ std::string ModelLoader::generateModelID(const std::string& path)
     return ss.str();
 }
 
-void ModelLoader::workerFunction()
+void ModelLoader::scheduleLoads()
 {
-    GE_CORE_INFO("ModelLoader: Worker thread started");
+    size_t jobCount = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        if (!m_initialized || m_shuttingDown) {
+            return;
+        }
+
+        m_loadJobs.erase(std::remove_if(m_loadJobs.begin(), m_loadJobs.end(),
+            [](const JobHandle& job) { return job->isDone(); }), m_loadJobs.end());
+
+        // Every scheduled job takes one runnable request once it starts
+        size_t busySlots = m_pendingLoadJobs + m_activeLoads.size();
+        size_t freeSlots = busySlots < m_maxConcurrentLoads ? m_maxConcurrentLoads - busySlots : 0;
+        size_t runnable = static_cast<size_t>(std::count_if(m_loadQueue.begin(), m_loadQueue.end(), isRunnable));
+        size_t uncovered = runnable > m_pendingLoadJobs ? runnable - m_pendingLoadJobs : 0;
+
+        jobCount = std::min(freeSlots, uncovered);
+        m_pendingLoadJobs += jobCount;
+    }
+
+    // Scheduled outside the lock, the job runs inline when the JobSystem isn't running
+    for (size_t i = 0; i < jobCount; i++) {
+        JobHandle job = JobSystem::schedule([this]() { runNextLoad(); }, JobPriority::Low);
+
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        if (!job->isDone()) {
+            m_loadJobs.push_back(job);
+        }
+    }
+}
+
+void ModelLoader::runNextLoad()
+{
+    ModelLoadRequest request;
+
+    // Get the most important request
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        m_pendingLoadJobs--;
+
+        if (m_shuttingDown || !hasRunnableRequest()) {
+            return;
+        }
+
+        request = popHighestPriority();
+        m_activeLoads[request.modelID] = request;
+        m_activeLoadCount++;
+    }
+
+    GE_CORE_INFO("ModelLoader: Loading model '{0}' with ID '{1}'", request.path, request.modelID);
     
-    while (!m_shuttingDown) {
-        ModelLoadRequest request;
-        bool hasRequest = false;
-        
-        // Get a request from the queue
-        {
-            std::unique_lock<std::mutex> lock(m_queueMutex);
-            
-            // Wait for a request or shutdown signal
-            m_queueCondition.wait(lock, [this] {
-                return !m_loadQueue.empty() || m_shuttingDown;
-            });
-            
-            // Check if we're shutting down
-            if (m_shuttingDown) {
-                break;
-            }
-            
-            // Get the request
-            if (!m_loadQueue.empty()) {
-                request = m_loadQueue.front();
-                m_loadQueue.pop();
-                hasRequest = true;
-                m_activeLoadCount++;
+    bool success = false;
+    bool isMergePending = false;
+    
+    try {
+        // Nothing a load builds is visible before the frame boundary that merges it into the target scene
+        std::shared_ptr<StagingScene> staging;
+
+        if (request.prefab && !request.buildsPrefab) {
+            // Another load of the same path finished while this one waited, it is cloned straight into the scene
+            success = true;
+        }
+        else {
+            // Create a glTF loader and load the model into a private scene
+            staging = std::make_shared<StagingScene>(request.targetScene);
+            glTF2Loader loader(staging->getScene());
+            loader.setStagingScene(staging);
+            loader.setProgress(request.progress);
+            if (request.buildsPrefab) {
+                loader.setPrefab(request.prefab);
             }
+            success = loader.loadModel(request.path, request.isAbsolute);
         }
         
-        // Process the request
-        if (hasRequest) {
-            GE_CORE_INFO("ModelLoader: Loading model '{0}' with ID '{1}'", request.path, request.modelID);
-            
-            bool success = false;
-            
-            try {
-                // Create a glTF loader and load the model
-                glTF2Loader loader(request.targetScene);
-                success = loader.loadModel(request.path, request.isAbsolute);
-                
-                // Check if we're shutting down
-                if (m_shuttingDown) {
-                    // Abandoning process due to shutdown
-                    GE_CORE_WARN("ModelLoader: Abandoning model '{0}' processing due to shutdown", request.path);
-                    success = false;
-                } else {
-                    // Update the model load status
-                    {
-                        std::lock_guard<std::mutex> lock(m_statusMutex);
-                        m_modelLoadStatus[request.modelID] = success;
-                    }
-                    
-                    if (success) {
-                        GE_CORE_INFO("ModelLoader: Successfully loaded model '{0}' with ID '{1}'", 
-                                    request.path, request.modelID);
-                    } else {
-                        GE_CORE_ERROR("ModelLoader: Failed to load model '{0}' with ID '{1}'", 
-                                     request.path, request.modelID);
-                    }
+        // Check if we're shutting down
+        if (m_shuttingDown) {
+            // Abandoning process due to shutdown
+            GE_CORE_WARN("ModelLoader: Abandoning model '{0}' processing due to shutdown", request.path);
+            success = false;
+        } else if (!success && request.progress->isCancelled()) {
+            // A cancel that arrives after the last check lets the load finish normally
+            GE_CORE_INFO("ModelLoader: Load of model '{0}' with ID '{1}' was cancelled", request.path, request.modelID);
+            success = false;
+
+            std::lock_guard<std::mutex> lock(m_statusMutex);
+            m_modelLoadStatus.erase(request.modelID);
+        } else if (success) {
+            // The status and the callback follow the merge, a model counts as loaded once it is in the scene
+            auto finish = [this, request](bool isInScene) {
+                recordLoadResult(request, isInScene);
+                if (request.callback) {
+                    request.callback(isInScene);
                 }
+            };
+            if (staging) {
+                StagingScene::submit(staging, [finish]() { finish(true); });
             }
-            catch (const std::exception& e) {
-                GE_CORE_ERROR("ModelLoader: Exception while loading model '{0}': {1}", 
-                             request.path, e.what());
-                success = false;
-            }
-            
-            // Call the callback if provided
-            if (request.callback) {
-                request.callback(success);
+            else {
+                StagingScene::runAtFrameBoundary([finish, request]() {
+                    finish(request.prefab->instantiate(request.targetScene.get()).isValid());
+                });
             }
-            
-            m_activeLoadCount--;
+            isMergePending = true;
+        } else {
+            recordLoadResult(request, false);
+        }
+    }
+    catch (const std::exception& e) {
+        GE_CORE_ERROR("ModelLoader: Exception while loading model '{0}': {1}", 
+                     request.path, e.what());
+        success = false;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        m_activeLoads.erase(request.modelID);
+
+        if (request.buildsPrefab && !request.prefab->isReady()) {
+            handOffPrefab(request);
         }
     }
+
+    // Call the callback if provided, a merged load calls it from the frame boundary instead
+    if (request.callback && !isMergePending) {
+        request.callback(success);
+    }
     
-    GE_CORE_INFO("ModelLoader: Worker thread stopped");
+    m_activeLoadCount--;
+
+    // The slot is free again, and loads waiting on this one's prefab may be runnable now
+    scheduleLoads();
+}
+
+void ModelLoader::recordLoadResult(const ModelLoadRequest& request, bool success)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_statusMutex);
+        m_modelLoadStatus[request.modelID] = success;
+    }
+
+    if (success) {
+        GE_CORE_INFO("ModelLoader: Successfully loaded model '{0}' with ID '{1}'", 
+                    request.path, request.modelID);
+    } else {
+        GE_CORE_ERROR("ModelLoader: Failed to load model '{0}' with ID '{1}'", 
+                     request.path, request.modelID);
+    }
 }
 
 } // namespace Rapture 
\ No newline at end of file
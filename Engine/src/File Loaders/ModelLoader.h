@@ -2,18 +2,33 @@
 
 #include <string>
 #include <memory>
-#include <queue>
+#include <vector>
 #include <mutex>
-#include <thread>
 #include <atomic>
 #include <functional>
-#include <condition_variable>
 #include <unordered_map>
 #include "../Scenes/Scene.h"
+#include "../Scenes/StagingScene.h"
+#include "../Jobs/JobSystem.h"
 #include "glTF/glTF2Loader.h"
+#include "ModelLoadProgress.h"
+#include "ModelPrefab.h"
 
 namespace Rapture {
 
+    // Higher priorities load first, requests of equal priority load in the order they were queued
+    constexpr float MODEL_LOAD_PRIORITY_PREFETCH = 0.0f;
+    constexpr float MODEL_LOAD_PRIORITY_DEFAULT = 50.0f;
+    constexpr float MODEL_LOAD_PRIORITY_VISIBLE = 100.0f;
+
+    enum class ModelLoadState {
+        Queued,
+        Loading,
+        Loaded,
+        Failed,
+        Cancelled
+    };
+
     // Struct to hold model loading request data
     struct ModelLoadRequest {
         std::string path;
@@ -21,6 +36,26 @@ namespace Rapture {
         std::shared_ptr<Scene> targetScene;
         std::function<void(bool)> callback;
         bool isAbsolute;
+        float priority = MODEL_LOAD_PRIORITY_DEFAULT;
+        uint64_t sequence = 0;                          // queue order, breaks priority ties
+        std::shared_ptr<ModelLoadProgress> progress;    // shared with the glTF2Loader doing the work
+
+        // Prefab of the path, null with the prefab cache disabled. The first load of a path builds it,
+        // later loads queued while it is still loading wait for it and are cloned from it
+        std::shared_ptr<ModelPrefab> prefab;
+        bool buildsPrefab = false;
+    };
+
+    // Snapshot of a queued or running load
+    struct ModelLoadInfo {
+        std::string modelID;
+        std::string path;
+        ModelLoadState state = ModelLoadState::Queued;
+        float priority = MODEL_LOAD_PRIORITY_DEFAULT;
+        size_t primitivesTotal = 0;
+        size_t primitivesDecoded = 0;
+        size_t bytesDecoded = 0;
+        size_t peakStagingBytes = 0;
     };
 
     class ModelLoader {
@@ -32,18 +67,58 @@ namespace Rapture {
         // Get the singleton instance
         static ModelLoader& getInstance();
 
-        // Initialize the loader with a specific number of worker threads
-        void init(unsigned int numThreads = 1);
+        // Initialize the loader. Loads run as low priority jobs on the JobSystem, at most maxConcurrentLoads at once
+        void init(unsigned int maxConcurrentLoads = 1);
         
-        // Shutdown the loader and stop all threads
+        // Shutdown the loader, cancels running loads and waits for their jobs
         void shutdown();
 
-        // Queue a model to be loaded asynchronously
+        // Queue a model to be loaded asynchronously. It is built into a staging scene and merged into the
+        // target scene at a frame boundary, the callback runs on the main thread right after the merge
+        // (failed and cancelled loads call it on the loading thread)
         // Returns a unique ID for the model being loaded
+        // progressCallback runs on the loader threads, see ModelLoadProgress::callback
         std::string loadModel(const std::string& path, 
                            std::shared_ptr<Scene> targetScene, 
                            std::function<void(bool)> callback = nullptr,
-                           bool isAbsolute = false);
+                           bool isAbsolute = false,
+                           float priority = MODEL_LOAD_PRIORITY_DEFAULT,
+                           std::function<void(const ModelLoadProgress&)> progressCallback = nullptr);
+
+        // Clone a model that has been loaded before into a scene, no file or GPU work is done.
+        // Returns the root of the copy, or an invalid entity if the model hasn't finished loading once yet
+        Entity instantiateModel(const std::string& path, std::shared_ptr<Scene> targetScene, const glm::mat4& transform = glm::mat4(1.0f));
+
+        // Same for many copies at once, returns the root of every copy
+        std::vector<Entity> instantiateModel(const std::string& path, std::shared_ptr<Scene> targetScene, const std::vector<glm::mat4>& transforms);
+
+        // Check if a model has been loaded once and can be instantiated
+        bool isPrefabReady(const std::string& path) const;
+
+        // Clone later loads of an already loaded path from its prefab instead of loading it again, on by default.
+        // Copies share meshes and materials with the first load, so editing one material changes every copy
+        void setPrefabCacheEnabled(bool enabled);
+        bool isPrefabCacheEnabled() const;
+
+        // Forget every prefab, later loads read their files again. Existing copies keep their meshes and materials
+        void clearPrefabCache();
+
+        // Cancel a load. Queued loads are dropped right away, running loads stop at the next primitive
+        // and remove what they created. The completion callback is called with false in both cases.
+        // Returns false if the model isn't queued or loading
+        bool cancelLoad(const std::string& modelID);
+
+        // Change the priority of a queued load, returns false if it isn't queued anymore
+        bool setPriority(const std::string& modelID, float priority);
+
+        // Recompute the priority of every queued load, e.g. from the distance to the camera after it moved
+        void reprioritize(const std::function<float(const ModelLoadInfo&)>& priorityFunction);
+
+        // Snapshot of every queued and running load
+        std::vector<ModelLoadInfo> getInFlightLoads() const;
+
+        // Snapshot of one load, returns false if the model isn't queued or loading
+        bool getLoadInfo(const std::string& modelID, ModelLoadInfo& info) const;
         
         // Check if a specific model is loaded
         bool isModelLoaded(const std::string& modelID) const;
@@ -67,26 +142,58 @@ namespace Rapture {
         // Private destructor
         ~ModelLoader();
         
-        // Worker thread function
-        void workerFunction();
+        // Job that runs the highest priority runnable request, one is scheduled per free load slot
+        void runNextLoad();
+
+        // Schedule load jobs until every slot is busy or every runnable request has a job coming for it.
+        // Takes the queue mutex itself, jobs may run inline when the JobSystem isn't running
+        void scheduleLoads();
         
         // Generate a unique ID for a model
         std::string generateModelID(const std::string& path);
 
+        // Remove and return the highest priority runnable request, the queue mutex must be held and one must be runnable
+        ModelLoadRequest popHighestPriority();
+
+        // Loads waiting for another load to build their prefab can't run yet, the queue mutex must be held
+        static bool isRunnable(const ModelLoadRequest& request);
+        bool hasRunnableRequest() const;
+
+        // Prefab of a path if it has been captured, null otherwise
+        std::shared_ptr<ModelPrefab> getReadyPrefab(const std::string& path) const;
+
+        // The load building a prefab failed or was cancelled, the first queued load waiting on it builds a new one.
+        // The queue mutex must be held
+        void handOffPrefab(const ModelLoadRequest& request);
+
+        static ModelLoadInfo makeLoadInfo(const ModelLoadRequest& request, ModelLoadState state);
+
+        // Update the load status of a finished request and log the outcome
+        void recordLoadResult(const ModelLoadRequest& request, bool success);
+
     private:
-        // Queue of model loading requests
-        std::queue<ModelLoadRequest> m_loadQueue;
+        // Queued model loading requests, unordered, workers pick the highest priority one.
+        // Small enough that a linear scan beats keeping a heap consistent across reprioritization
+        std::vector<ModelLoadRequest> m_loadQueue;
+        uint64_t m_nextSequence = 0;
+
+        // Requests that a worker is currently loading, keyed by model ID (guarded by m_queueMutex)
+        std::unordered_map<std::string, ModelLoadRequest> m_activeLoads;
+
+        // Prefabs keyed by the path they were loaded from, including ones still being built (guarded by m_queueMutex)
+        std::unordered_map<std::string, std::shared_ptr<ModelPrefab>> m_prefabs;
+        bool m_prefabCacheEnabled = true;
         
         // Mutex for thread-safe queue operations
         mutable std::mutex m_queueMutex;
         
-        // Condition variable for worker threads
-        std::condition_variable m_queueCondition;
-        
-        // Worker threads
-        std::vector<std::thread> m_workerThreads;
+        // Load jobs on the JobSystem. Scheduled jobs pick their request only once they start,
+        // so priority changes up to that point still count (guarded by m_queueMutex)
+        unsigned int m_maxConcurrentLoads = 1;
+        size_t m_pendingLoadJobs = 0;
+        std::vector<JobHandle> m_loadJobs;
         
-        // Flag to signal worker threads to stop
+        // Flag to signal load jobs to stop
         std::atomic<bool> m_shuttingDown;
         
         // Map to track loading status of models
@@ -0,0 +1,222 @@
+#include "ModelPrefab.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+#include "../Logger/Log.h"
+#include "../Debug/TracyProfiler.h"
+
+namespace Rapture {
+
+    ModelPrefab::ModelPrefab(const std::string& path)
+        : m_path(path)
+    {
+        size_t nameStart = path.find_last_of("/\\");
+        m_name = nameStart == std::string::npos ? path : path.substr(nameStart + 1);
+    }
+
+    void ModelPrefab::capture(const std::vector<Entity>& entities)
+    {
+        RAPTURE_PROFILE_FUNCTION();
+
+        if (isReady()) {
+            GE_CORE_WARN("ModelPrefab: '{}' has already been captured", m_path);
+            return;
+        }
+
+        std::unordered_map<uint32_t, int32_t> indexOfEntity;
+        indexOfEntity.reserve(entities.size());
+
+        for (Entity entity : entities) {
+            if (!entity.isValid() || !entity.hasComponent<TransformComponent>()) {
+                continue;
+            }
+
+            PrefabEntity& entry = m_entities.emplace_back();
+            entry.name = entity.getComponent<TagComponent>().tag;
+            entry.transform = entity.getComponent<TransformComponent>().transformMatrix();
+
+            if (auto* nodeComp = entity.tryGetComponent<EntityNodeComponent>(); nodeComp && nodeComp->entity_node) {
+                if (std::shared_ptr<EntityNode> parentNode = nodeComp->entity_node->getParent()) {
+                    auto parent = indexOfEntity.find(parentNode->getEntity()->getID());
+                    if (parent != indexOfEntity.end()) {
+                        entry.parent = parent->second;
+                    }
+                }
+            }
+
+            if (auto* meshComp = entity.tryGetComponent<MeshComponent>()) {
+                entry.mesh = meshComp->mesh;
+            }
+            if (auto* materialComp = entity.tryGetComponent<MaterialComponent>()) {
+                entry.material = materialComp->material;
+            }
+            if (auto* boundingBoxComp = entity.tryGetComponent<BoundingBoxComponent>()) {
+                entry.localBoundingBox = boundingBoxComp->localBoundingBox;
+            }
+            if (auto* animatorComp = entity.tryGetComponent<AnimatorComponent>()) {
+                entry.animator = *animatorComp;
+                entry.animator->time = 0.0f;
+                entry.animator->paletteOffset = -1;
+            }
+            if (auto* morphComp = entity.tryGetComponent<MorphTargetComponent>()) {
+                entry.morphTargets = *morphComp;
+                entry.morphTargets->deltaOffset = -1;
+            }
+
+            indexOfEntity[entity.getID()] = static_cast<int32_t>(m_entities.size() - 1);
+        }
+
+        // Animators are created after the meshes they drive, so skins are resolved once every entity has an index
+        size_t entry = 0;
+        for (Entity entity : entities) {
+            if (!entity.isValid() || !entity.hasComponent<TransformComponent>()) {
+                continue;
+            }
+            if (auto* skinComp = entity.tryGetComponent<SkinComponent>()) {
+                auto animator = indexOfEntity.find(static_cast<uint32_t>(skinComp->animator));
+                if (animator != indexOfEntity.end()) {
+                    m_entities[entry].skinAnimator = animator->second;
+                }
+            }
+            entry++;
+        }
+
+        m_isReady.store(true, std::memory_order_release);
+
+        GE_CORE_INFO("ModelPrefab: Captured '{}' with {} entities", m_path, m_entities.size());
+    }
+
+    std::vector<Entity> ModelPrefab::instantiate(Scene* scene, const std::vector<glm::mat4>& transforms)
+    {
+        RAPTURE_PROFILE_FUNCTION();
+
+        std::vector<Entity> roots;
+        if (!scene) {
+            GE_CORE_ERROR("ModelPrefab: Cannot instantiate '{}', scene is null", m_path);
+            return roots;
+        }
+        if (!isReady()) {
+            GE_CORE_ERROR("ModelPrefab: Cannot instantiate '{}' before it has been captured", m_path);
+            return roots;
+        }
+        if (transforms.empty()) {
+            return roots;
+        }
+
+        entt::registry& registry = scene->getRegistry();
+        size_t entitiesPerCopy = m_entities.size() + 1;
+        size_t entityCount = entitiesPerCopy * transforms.size();
+
+        size_t meshCount = 0;
+        for (const PrefabEntity& entry : m_entities) {
+            meshCount += entry.mesh ? 1 : 0;
+        }
+
+        std::vector<entt::entity> handles(entityCount);
+        registry.create(handles.begin(), handles.end());
+
+        registry.storage<TagComponent>().reserve(registry.storage<TagComponent>().size() + entityCount);
+        registry.storage<TransformComponent>().reserve(registry.storage<TransformComponent>().size() + entityCount);
+        registry.storage<EntityNodeComponent>().reserve(registry.storage<EntityNodeComponent>().size() + entityCount);
+        registry.storage<MeshComponent>().reserve(registry.storage<MeshComponent>().size() + meshCount * transforms.size());
+        registry.storage<MaterialComponent>().reserve(registry.storage<MaterialComponent>().size() + meshCount * transforms.size());
+
+        // Held for the whole batch, so an upload finishing half way can't miss a copy that is about to wait on it
+        std::lock_guard<std::mutex> lock(m_uploadMutex);
+
+        std::vector<std::shared_ptr<EntityNode>> nodes(entitiesPerCopy);
+        roots.reserve(transforms.size());
+
+        for (size_t copy = 0; copy < transforms.size(); copy++) {
+            const glm::mat4& copyTransform = transforms[copy];
+            const entt::entity* copyHandles = handles.data() + copy * entitiesPerCopy;
+
+            Entity root(copyHandles[0], scene);
+            registry.emplace<TagComponent>(copyHandles[0], m_name);
+            registry.emplace<TransformComponent>(copyHandles[0], copyTransform);
+            nodes[0] = registry.emplace<EntityNodeComponent>(copyHandles[0], root).entity_node;
+
+            for (size_t i = 0; i < m_entities.size(); i++) {
+                const PrefabEntity& entry = m_entities[i];
+                entt::entity handle = copyHandles[i + 1];
+                Entity entity(handle, scene);
+
+                registry.emplace<TagComponent>(handle, entry.name);
+                registry.emplace<TransformComponent>(handle, copyTransform * entry.transform);
+
+                std::shared_ptr<EntityNode>& parentNode = nodes[entry.parent >= 0 ? entry.parent + 1 : 0];
+                nodes[i + 1] = registry.emplace<EntityNodeComponent>(handle, entity, parentNode).entity_node;
+                parentNode->addChild(nodes[i + 1]);
+
+                if (entry.mesh && !m_failedMeshes.count(entry.mesh.get())) {
+                    MeshComponent& meshComp = registry.emplace<MeshComponent>(handle, entry.mesh);
+                    if (!m_residentMeshes.count(entry.mesh.get())) {
+                        meshComp.isLoading = true;
+                        m_waitingEntities.push_back(entity);
+                    }
+                }
+                if (entry.material) {
+                    registry.emplace<MaterialComponent>(handle, entry.material);
+                }
+                if (entry.localBoundingBox) {
+                    registry.emplace<BoundingBoxComponent>(handle, *entry.localBoundingBox);
+                }
+                if (entry.animator) {
+                    registry.emplace<AnimatorComponent>(handle, *entry.animator);
+                }
+                if (entry.skinAnimator >= 0) {
+                    registry.emplace<SkinComponent>(handle, copyHandles[entry.skinAnimator + 1]);
+                }
+                if (entry.morphTargets) {
+                    registry.emplace<MorphTargetComponent>(handle, *entry.morphTargets);
+                }
+            }
+
+            roots.push_back(root);
+        }
+
+        return roots;
+    }
+
+    Entity ModelPrefab::instantiate(Scene* scene, const glm::mat4& transform)
+    {
+        std::vector<Entity> roots = instantiate(scene, std::vector<glm::mat4>{ transform });
+        return roots.empty() ? Entity() : roots.front();
+    }
+
+    void ModelPrefab::onMeshUploaded(const std::shared_ptr<Mesh>& mesh, bool success)
+    {
+        std::lock_guard<std::mutex> lock(m_uploadMutex);
+
+        if (success) {
+            m_residentMeshes.insert(mesh.get());
+        }
+        else {
+            m_failedMeshes.insert(mesh.get());
+        }
+
+        // Same outcome as for the entities of the original load
+        auto waiting = std::remove_if(m_waitingEntities.begin(), m_waitingEntities.end(), [&mesh, success](Entity& entity) {
+            if (!entity.isValid()) {
+                return true;
+            }
+            auto* meshComp = entity.tryGetComponent<MeshComponent>();
+            if (!meshComp) {
+                return true;
+            }
+            if (meshComp->mesh != mesh) {
+                return false;
+            }
+            if (success) {
+                meshComp->isLoading = false;
+            }
+            else {
+                entity.tryRemoveComponent<MeshComponent>();
+            }
+            return true;
+        });
+        m_waitingEntities.erase(waiting, m_waitingEntities.end());
+    }
+
+}
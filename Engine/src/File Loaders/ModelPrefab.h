@@ -0,0 +1,95 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <optional>
+#include <unordered_set>
+
+#include <glm/glm.hpp>
+
+#include "../Scenes/Scene.h"
+#include "../Scenes/Entity.h"
+#include "../Scenes/Components/Components.h"
+
+namespace Rapture {
+
+    // One entity of a loaded model, everything needed to recreate it without touching the source file or the GPU
+    struct PrefabEntity {
+        std::string name;
+        int32_t parent = -1;                        // index of the parent entry, parents always come first
+        glm::mat4 transform = glm::mat4(1.0f);      // relative to the model root
+
+        // Shared with the loaded model and with every copy
+        std::shared_ptr<Mesh> mesh;
+        std::shared_ptr<Material> material;
+
+        std::optional<BoundingBox> localBoundingBox;
+        std::optional<AnimatorComponent> animator;
+        int32_t skinAnimator = -1;                  // index of the animator entry, -1 if the mesh isn't skinned
+        std::optional<MorphTargetComponent> morphTargets;
+    };
+
+    /**
+     * @brief Template of a loaded model, cloned into a scene as often as needed
+     *
+     * Captured once from the entities a load created. Instantiating only creates entities and copies component
+     * data, the meshes, materials, skeletons, clips and morph targets are shared with the original load.
+     * Copies made while a mesh of the template is still uploading stay hidden until the upload finishes.
+     */
+    class ModelPrefab {
+    public:
+        ModelPrefab(const std::string& path);
+
+        /**
+         * @brief Record the hierarchy and components of a finished load
+         *
+         * Entities without a TransformComponent (the bare model root) are skipped, every copy gets its own root.
+         *
+         * @param entities Entities the load created, parents before their children
+         */
+        void capture(const std::vector<Entity>& entities);
+
+        /**
+         * @brief Clone the template into a scene once per transform
+         *
+         * All entities of the batch are created in one go and the component pools are grown once,
+         * so spawning many copies of a prop is a matter of copying component data.
+         *
+         * @param scene Scene to create the copies in
+         * @param transforms World transform of every copy's root
+         * @return The root entity of every copy, empty if the template hasn't been captured yet
+         */
+        std::vector<Entity> instantiate(Scene* scene, const std::vector<glm::mat4>& transforms);
+
+        Entity instantiate(Scene* scene, const glm::mat4& transform = glm::mat4(1.0f));
+
+        /**
+         * @brief Mark a mesh of the template as resident, called on the GL thread by the upload queue
+         *
+         * Copies waiting on the mesh become drawable, or lose their mesh if the upload failed.
+         */
+        void onMeshUploaded(const std::shared_ptr<Mesh>& mesh, bool success);
+
+        bool isReady() const { return m_isReady.load(std::memory_order_acquire); }
+        const std::string& getPath() const { return m_path; }
+        size_t getEntityCount() const { return m_entities.size(); }
+
+    private:
+        std::string m_path;
+        std::string m_name;
+
+        // Written once by capture, read only afterwards
+        std::vector<PrefabEntity> m_entities;
+        std::atomic<bool> m_isReady{ false };
+
+        // Upload state of the template's meshes and the copies still waiting on one (guarded by m_uploadMutex)
+        std::mutex m_uploadMutex;
+        std::unordered_set<const Mesh*> m_residentMeshes;
+        std::unordered_set<const Mesh*> m_failedMeshes;
+        std::vector<Entity> m_waitingEntities;
+    };
+
+}
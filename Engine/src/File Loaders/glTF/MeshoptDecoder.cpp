@@ -0,0 +1,476 @@
+#include "MeshoptDecoder.h"
+
+#include <cmath>
+#include <cstring>
+
+#include "../../Debug/TracyProfiler.h"
+
+namespace Rapture {
+
+    namespace MeshoptDecoder {
+
+        namespace {
+
+            // Stream headers, the low nibble carries the codec version
+            constexpr unsigned char VERTEX_HEADER = 0xA0;
+            constexpr unsigned char INDEX_HEADER = 0xE0;
+            constexpr unsigned char SEQUENCE_HEADER = 0xD0;
+
+            // Vertex codec constants
+            constexpr size_t VERTEX_BLOCK_SIZE_BYTES = 8192;
+            constexpr size_t VERTEX_BLOCK_MAX_SIZE = 256;
+            constexpr size_t BYTE_GROUP_SIZE = 16;
+            constexpr size_t BYTE_GROUP_DECODE_LIMIT = 24;  // most bytes a single group can read
+            constexpr size_t TAIL_MAX_SIZE = 32;
+
+            size_t getVertexBlockSize(size_t stride) {
+                // A block never spans more than 8 KB of vertices, rounded down to whole byte groups
+                size_t result = (VERTEX_BLOCK_SIZE_BYTES / stride) & ~(BYTE_GROUP_SIZE - 1);
+                return result < VERTEX_BLOCK_MAX_SIZE ? result : VERTEX_BLOCK_MAX_SIZE;
+            }
+
+            inline unsigned char unzigzag8(unsigned char v) {
+                return static_cast<unsigned char>(-(v & 1) ^ (v >> 1));
+            }
+
+            // Decodes 16 bytes stored with 0, 2, 4 or 8 bits each. Values of all ones in the
+            // 2 and 4 bit modes are escapes, the real byte then follows the packed bits.
+            const unsigned char* decodeBytesGroup(const unsigned char* data, unsigned char* out, int bitsLog2) {
+                switch (bitsLog2) {
+                case 0:
+                    std::memset(out, 0, BYTE_GROUP_SIZE);
+                    return data;
+                case 1:
+                case 2: {
+                    int bits = 1 << bitsLog2;
+                    unsigned int escape = (1u << bits) - 1;
+                    size_t packedBytes = BYTE_GROUP_SIZE * bits / 8;
+                    const unsigned char* extra = data + packedBytes;
+
+                    for (size_t i = 0; i < packedBytes; i++) {
+                        unsigned char byte = data[i];
+                        for (int j = 0; j < 8 / bits; j++) {
+                            unsigned int enc = byte >> (8 - bits);
+                            byte = static_cast<unsigned char>(byte << bits);
+                            *out++ = enc == escape ? *extra++ : static_cast<unsigned char>(enc);
+                        }
+                    }
+                    return extra;
+                }
+                default:
+                    std::memcpy(out, data, BYTE_GROUP_SIZE);
+                    return data + BYTE_GROUP_SIZE;
+                }
+            }
+
+            const unsigned char* decodeBytes(const unsigned char* data, const unsigned char* dataEnd, unsigned char* out, size_t count) {
+                // Two bits of mode per group, four groups per header byte
+                const unsigned char* header = data;
+                size_t headerSize = (count / BYTE_GROUP_SIZE + 3) / 4;
+                if (static_cast<size_t>(dataEnd - data) < headerSize) {
+                    return nullptr;
+                }
+                data += headerSize;
+
+                for (size_t i = 0; i < count; i += BYTE_GROUP_SIZE) {
+                    // The encoder pads the stream, so a valid one always has this much left
+                    if (static_cast<size_t>(dataEnd - data) < BYTE_GROUP_DECODE_LIMIT) {
+                        return nullptr;
+                    }
+                    size_t group = i / BYTE_GROUP_SIZE;
+                    int bitsLog2 = (header[group / 4] >> ((group % 4) * 2)) & 3;
+                    data = decodeBytesGroup(data, out + i, bitsLog2);
+                }
+                return data;
+            }
+
+            const unsigned char* decodeVertexBlock(const unsigned char* data, const unsigned char* dataEnd,
+                unsigned char* vertices, size_t count, size_t stride, unsigned char* lastVertex) {
+                unsigned char deltas[VERTEX_BLOCK_MAX_SIZE];
+                size_t alignedCount = (count + BYTE_GROUP_SIZE - 1) & ~(BYTE_GROUP_SIZE - 1);
+
+                // Each byte of the vertex is its own stream of deltas against the previous vertex
+                for (size_t k = 0; k < stride; k++) {
+                    data = decodeBytes(data, dataEnd, deltas, alignedCount);
+                    if (!data) {
+                        return nullptr;
+                    }
+
+                    unsigned char previous = lastVertex[k];
+                    unsigned char* out = vertices + k;
+                    for (size_t i = 0; i < count; i++) {
+                        unsigned char value = static_cast<unsigned char>(unzigzag8(deltas[i]) + previous);
+                        *out = value;
+                        out += stride;
+                        previous = value;
+                    }
+                }
+
+                std::memcpy(lastVertex, vertices + (count - 1) * stride, stride);
+                return data;
+            }
+
+            inline void writeIndex(unsigned char* destination, size_t i, size_t indexSize, uint32_t value) {
+                if (indexSize == 2) {
+                    uint16_t narrow = static_cast<uint16_t>(value);
+                    std::memcpy(destination + i * 2, &narrow, 2);
+                }
+                else {
+                    std::memcpy(destination + i * 4, &value, 4);
+                }
+            }
+
+            inline uint32_t decodeVByte(const unsigned char*& data) {
+                unsigned char lead = *data++;
+                if (lead < 128) {
+                    return lead;
+                }
+
+                // Up to four more bytes, the loop always terminates even on malformed data
+                uint32_t result = lead & 127;
+                uint32_t shift = 7;
+                for (int i = 0; i < 4; i++) {
+                    unsigned char group = *data++;
+                    result |= static_cast<uint32_t>(group & 127) << shift;
+                    shift += 7;
+                    if (group < 128) {
+                        break;
+                    }
+                }
+                return result;
+            }
+
+            inline uint32_t decodeIndex(const unsigned char*& data, uint32_t last) {
+                uint32_t v = decodeVByte(data);
+                uint32_t delta = (v >> 1) ^ (0u - (v & 1));
+                return last + delta;
+            }
+
+            // FIFOs of recently seen edges and vertices, both wrap around at 16 entries
+            struct IndexFifos {
+                uint32_t edges[16][2];
+                uint32_t vertices[16];
+                size_t edgeOffset = 0;
+                size_t vertexOffset = 0;
+
+                IndexFifos() {
+                    std::memset(edges, -1, sizeof(edges));
+                    std::memset(vertices, -1, sizeof(vertices));
+                }
+
+                void pushEdge(uint32_t a, uint32_t b) {
+                    edges[edgeOffset][0] = a;
+                    edges[edgeOffset][1] = b;
+                    edgeOffset = (edgeOffset + 1) & 15;
+                }
+
+                void pushVertex(uint32_t v, bool advance = true) {
+                    vertices[vertexOffset] = v;
+                    vertexOffset = (vertexOffset + (advance ? 1 : 0)) & 15;
+                }
+            };
+
+            template<typename T>
+            void decodeFilterOctahedral(T* data, size_t count) {
+                const float maxValue = static_cast<float>((1 << (sizeof(T) * 8 - 1)) - 1);
+
+                for (size_t i = 0; i < count; i++) {
+                    // z stores the octahedron's scale, so it can be reconstructed from x and y
+                    float x = static_cast<float>(data[i * 4 + 0]);
+                    float y = static_cast<float>(data[i * 4 + 1]);
+                    float z = static_cast<float>(data[i * 4 + 2]) - std::fabs(x) - std::fabs(y);
+
+                    // Unfold the lower hemisphere
+                    float t = z >= 0.0f ? 0.0f : z;
+                    x += x >= 0.0f ? t : -t;
+                    y += y >= 0.0f ? t : -t;
+
+                    float length = std::sqrt(x * x + y * y + z * z);
+                    float scale = length > 0.0f ? maxValue / length : 0.0f;
+
+                    data[i * 4 + 0] = static_cast<T>(static_cast<int>(x * scale + (x >= 0.0f ? 0.5f : -0.5f)));
+                    data[i * 4 + 1] = static_cast<T>(static_cast<int>(y * scale + (y >= 0.0f ? 0.5f : -0.5f)));
+                    data[i * 4 + 2] = static_cast<T>(static_cast<int>(z * scale + (z >= 0.0f ? 0.5f : -0.5f)));
+                }
+            }
+
+            void decodeFilterQuaternion(int16_t* data, size_t count) {
+                const float invSqrt2 = 0.70710678f;
+
+                for (size_t i = 0; i < count; i++) {
+                    // The last component holds the scale in its high bits and the dropped component's index in the low two
+                    int16_t packed = data[i * 4 + 3];
+                    int scaleBits = packed | 3;
+                    float scale = invSqrt2 / static_cast<float>(scaleBits);
+
+                    float x = static_cast<float>(data[i * 4 + 0]) * scale;
+                    float y = static_cast<float>(data[i * 4 + 1]) * scale;
+                    float z = static_cast<float>(data[i * 4 + 2]) * scale;
+
+                    // The dropped component is the largest, so it is always positive
+                    float ww = 1.0f - x * x - y * y - z * z;
+                    float w = std::sqrt(ww >= 0.0f ? ww : 0.0f);
+
+                    int droppedIndex = packed & 3;
+                    data[i * 4 + ((droppedIndex + 1) & 3)] = static_cast<int16_t>(static_cast<int>(x * 32767.0f + (x >= 0.0f ? 0.5f : -0.5f)));
+                    data[i * 4 + ((droppedIndex + 2) & 3)] = static_cast<int16_t>(static_cast<int>(y * 32767.0f + (y >= 0.0f ? 0.5f : -0.5f)));
+                    data[i * 4 + ((droppedIndex + 3) & 3)] = static_cast<int16_t>(static_cast<int>(z * 32767.0f + (z >= 0.0f ? 0.5f : -0.5f)));
+                    data[i * 4 + ((droppedIndex + 0) & 3)] = static_cast<int16_t>(static_cast<int>(w * 32767.0f + 0.5f));
+                }
+            }
+
+            void decodeFilterExponential(uint32_t* data, size_t count) {
+                for (size_t i = 0; i < count; i++) {
+                    // 24 bit signed mantissa and 8 bit signed exponent
+                    uint32_t v = data[i];
+                    int32_t mantissa = static_cast<int32_t>(v << 8) >> 8;
+                    int32_t exponent = static_cast<int32_t>(v) >> 24;
+
+                    // ldexp(mantissa, exponent) without the libm call
+                    uint32_t scaleBits = static_cast<uint32_t>(exponent + 127) << 23;
+                    float scale;
+                    std::memcpy(&scale, &scaleBits, sizeof(float));
+                    float value = scale * static_cast<float>(mantissa);
+                    std::memcpy(&data[i], &value, sizeof(float));
+                }
+            }
+
+        }
+
+        bool decodeVertexBuffer(unsigned char* destination, size_t count, size_t stride, const unsigned char* buffer, size_t bufferSize) {
+            RAPTURE_PROFILE_FUNCTION();
+
+            if (stride == 0 || stride > 256 || stride % 4 != 0) {
+                return false;
+            }
+            if (bufferSize < 1 + stride) {
+                return false;
+            }
+
+            const unsigned char* data = buffer;
+            const unsigned char* dataEnd = buffer + bufferSize;
+
+            unsigned char header = *data++;
+            if ((header & 0xF0) != VERTEX_HEADER || (header & 0x0F) > 0) {
+                return false;
+            }
+
+            // The first vertex is predicted from the baseline stored at the very end of the stream
+            unsigned char lastVertex[256];
+            std::memcpy(lastVertex, dataEnd - stride, stride);
+
+            size_t blockSize = getVertexBlockSize(stride);
+            for (size_t offset = 0; offset < count; offset += blockSize) {
+                size_t blockCount = offset + blockSize < count ? blockSize : count - offset;
+                data = decodeVertexBlock(data, dataEnd, destination + offset * stride, blockCount, stride, lastVertex);
+                if (!data) {
+                    return false;
+                }
+            }
+
+            // Everything but the padded tail must have been consumed
+            size_t tailSize = stride < TAIL_MAX_SIZE ? TAIL_MAX_SIZE : stride;
+            return static_cast<size_t>(dataEnd - data) == tailSize;
+        }
+
+        bool decodeIndexBuffer(unsigned char* destination, size_t count, size_t indexSize, const unsigned char* buffer, size_t bufferSize) {
+            RAPTURE_PROFILE_FUNCTION();
+
+            if (count % 3 != 0 || (indexSize != 2 && indexSize != 4)) {
+                return false;
+            }
+            // Header, one code byte per triangle and the 16 byte table of auxiliary codes
+            if (bufferSize < 1 + count / 3 + 16) {
+                return false;
+            }
+            if ((buffer[0] & 0xF0) != INDEX_HEADER) {
+                return false;
+            }
+            int version = buffer[0] & 0x0F;
+            if (version > 1) {
+                return false;
+            }
+
+            IndexFifos fifos;
+            uint32_t next = 0;
+            uint32_t last = 0;
+            int fecMax = version >= 1 ? 13 : 15;
+
+            const unsigned char* code = buffer + 1;
+            const unsigned char* data = code + count / 3;
+            const unsigned char* dataSafeEnd = buffer + bufferSize - 16;
+            const unsigned char* codeAuxTable = dataSafeEnd;
+
+            for (size_t i = 0; i < count; i += 3) {
+                // A triangle reads at most 16 bytes, which the auxiliary table behind the data guarantees
+                if (data > dataSafeEnd) {
+                    return false;
+                }
+
+                unsigned char codeTri = *code++;
+                uint32_t a, b, c;
+
+                if (codeTri < 0xF0) {
+                    // Triangle sharing an edge from the FIFO, the third vertex is new, cached or free
+                    int fe = codeTri >> 4;
+                    a = fifos.edges[(fifos.edgeOffset - 1 - fe) & 15][0];
+                    b = fifos.edges[(fifos.edgeOffset - 1 - fe) & 15][1];
+
+                    int fec = codeTri & 15;
+                    if (fec < fecMax) {
+                        c = fec == 0 ? next++ : fifos.vertices[(fifos.vertexOffset - 1 - fec) & 15];
+                        fifos.pushVertex(c, fec == 0);
+                    }
+                    else {
+                        // 13 and 14 encode a delta of -1 and +1 to the last free index, 15 an explicit one
+                        c = last = fec != 15 ? last + (fec - (fec ^ 3)) : decodeIndex(data, last);
+                        fifos.pushVertex(c);
+                    }
+
+                    writeIndex(destination, i + 0, indexSize, a);
+                    writeIndex(destination, i + 1, indexSize, b);
+                    writeIndex(destination, i + 2, indexSize, c);
+
+                    fifos.pushEdge(c, b);
+                    fifos.pushEdge(a, c);
+                    continue;
+                }
+
+                int feb, fec;
+                if (codeTri < 0xFE) {
+                    // Common case, the auxiliary code comes from the table
+                    unsigned char codeAux = codeAuxTable[codeTri & 15];
+                    feb = codeAux >> 4;
+                    fec = codeAux & 15;
+
+                    a = next++;
+                    b = feb == 0 ? next++ : fifos.vertices[(fifos.vertexOffset - feb) & 15];
+                    c = fec == 0 ? next++ : fifos.vertices[(fifos.vertexOffset - fec) & 15];
+                }
+                else {
+                    // Rare case, the auxiliary code is stored inline and any vertex may be a free index
+                    unsigned char codeAux = *data++;
+                    int fea = codeTri == 0xFE ? 0 : 15;
+                    feb = codeAux >> 4;
+                    fec = codeAux & 15;
+
+                    // An inline code of zero restarts the sequence of new vertices
+                    if (codeAux == 0) {
+                        next = 0;
+                    }
+
+                    a = fea == 0 ? next++ : 0;
+                    b = feb == 0 ? next++ : fifos.vertices[(fifos.vertexOffset - feb) & 15];
+                    c = fec == 0 ? next++ : fifos.vertices[(fifos.vertexOffset - fec) & 15];
+
+                    if (fea == 15) last = a = decodeIndex(data, last);
+                    if (feb == 15) last = b = decodeIndex(data, last);
+                    if (fec == 15) last = c = decodeIndex(data, last);
+                }
+
+                writeIndex(destination, i + 0, indexSize, a);
+                writeIndex(destination, i + 1, indexSize, b);
+                writeIndex(destination, i + 2, indexSize, c);
+
+                fifos.pushVertex(a);
+                fifos.pushVertex(b, feb == 0 || feb == 15);
+                fifos.pushVertex(c, fec == 0 || fec == 15);
+
+                fifos.pushEdge(b, a);
+                fifos.pushEdge(c, b);
+                fifos.pushEdge(a, c);
+            }
+
+            // All triangle data must end exactly where the auxiliary table starts
+            return data == dataSafeEnd;
+        }
+
+        bool decodeIndexSequence(unsigned char* destination, size_t count, size_t indexSize, const unsigned char* buffer, size_t bufferSize) {
+            RAPTURE_PROFILE_FUNCTION();
+
+            if (indexSize != 2 && indexSize != 4) {
+                return false;
+            }
+            // Header, at least one byte per index and a 4 byte tail
+            if (bufferSize < 1 + count + 4) {
+                return false;
+            }
+            if ((buffer[0] & 0xF0) != SEQUENCE_HEADER || (buffer[0] & 0x0F) > 1) {
+                return false;
+            }
+
+            const unsigned char* data = buffer + 1;
+            const unsigned char* dataSafeEnd = buffer + bufferSize - 4;
+
+            // Two baselines, the low bit of every value picks the one its delta is relative to
+            uint32_t last[2] = { 0, 0 };
+
+            for (size_t i = 0; i < count; i++) {
+                // An index reads at most 5 bytes, the tail covers the overrun
+                if (data >= dataSafeEnd) {
+                    return false;
+                }
+
+                uint32_t v = decodeVByte(data);
+                uint32_t baseline = v & 1;
+                v >>= 1;
+
+                uint32_t delta = (v >> 1) ^ (0u - (v & 1));
+                uint32_t index = last[baseline] + delta;
+                last[baseline] = index;
+
+                writeIndex(destination, i, indexSize, index);
+            }
+
+            return data == dataSafeEnd;
+        }
+
+        bool applyFilter(Filter filter, unsigned char* data, size_t count, size_t stride) {
+            RAPTURE_PROFILE_FUNCTION();
+
+            switch (filter) {
+            case Filter::None:
+                return true;
+            case Filter::Octahedral:
+                if (stride == 4) {
+                    decodeFilterOctahedral(reinterpret_cast<int8_t*>(data), count);
+                    return true;
+                }
+                if (stride == 8) {
+                    decodeFilterOctahedral(reinterpret_cast<int16_t*>(data), count);
+                    return true;
+                }
+                return false;
+            case Filter::Quaternion:
+                if (stride != 8) {
+                    return false;
+                }
+                decodeFilterQuaternion(reinterpret_cast<int16_t*>(data), count);
+                return true;
+            case Filter::Exponential:
+                if (stride % 4 != 0) {
+                    return false;
+                }
+                decodeFilterExponential(reinterpret_cast<uint32_t*>(data), count * (stride / 4));
+                return true;
+            }
+            return false;
+        }
+
+        bool decode(Mode mode, Filter filter, unsigned char* destination, size_t count, size_t stride, const unsigned char* buffer, size_t bufferSize) {
+            switch (mode) {
+            case Mode::Attributes:
+                return decodeVertexBuffer(destination, count, stride, buffer, bufferSize)
+                    && applyFilter(filter, destination, count, stride);
+            case Mode::Triangles:
+                // Filters only apply to attributes
+                return filter == Filter::None && decodeIndexBuffer(destination, count, stride, buffer, bufferSize);
+            case Mode::Indices:
+                return filter == Filter::None && decodeIndexSequence(destination, count, stride, buffer, bufferSize);
+            }
+            return false;
+        }
+
+    }
+
+}
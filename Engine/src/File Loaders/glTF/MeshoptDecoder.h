@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Rapture {
+
+    // Decoders for the bitstreams of EXT_meshopt_compression.
+    // Only decoding is supported, and every decoder validates its input instead of trusting the file.
+    namespace MeshoptDecoder {
+
+        enum class Mode {
+            Attributes,     // vertex codec, byte deltas grouped per vertex byte
+            Triangles,      // index codec, triangle list encoded through edge and vertex FIFOs
+            Indices         // index sequence codec, for arbitrary index lists
+        };
+
+        enum class Filter {
+            None,
+            Octahedral,     // octahedral encoded unit vectors, 4 x int8 or 4 x int16
+            Quaternion,     // unit quaternions with the largest component dropped, 4 x int16
+            Exponential     // shared exponent floats, any number of 32 bit components
+        };
+
+        /**
+         * @brief Decode a vertex buffer encoded with the attributes codec
+         *
+         * @param destination Receives count * stride bytes
+         * @param count Number of vertices
+         * @param stride Size of one vertex, a multiple of 4 up to 256
+         * @return false if the stream is malformed or truncated
+         */
+        bool decodeVertexBuffer(unsigned char* destination, size_t count, size_t stride, const unsigned char* buffer, size_t bufferSize);
+
+        /**
+         * @brief Decode a triangle list encoded with the triangles codec
+         *
+         * @param destination Receives count indices of indexSize bytes each
+         * @param count Number of indices, a multiple of 3
+         * @param indexSize 2 or 4
+         * @return false if the stream is malformed or truncated
+         */
+        bool decodeIndexBuffer(unsigned char* destination, size_t count, size_t indexSize, const unsigned char* buffer, size_t bufferSize);
+
+        /**
+         * @brief Decode an index list encoded with the indices codec
+         *
+         * @param destination Receives count indices of indexSize bytes each
+         * @param count Number of indices
+         * @param indexSize 2 or 4
+         * @return false if the stream is malformed or truncated
+         */
+        bool decodeIndexSequence(unsigned char* destination, size_t count, size_t indexSize, const unsigned char* buffer, size_t bufferSize);
+
+        /**
+         * @brief Undo a filter in place on already decoded data
+         *
+         * @return false if the stride isn't valid for the filter
+         */
+        bool applyFilter(Filter filter, unsigned char* data, size_t count, size_t stride);
+
+        // Decodes a buffer view with the given mode and filter, the entry point used by the loaders
+        bool decode(Mode mode, Filter filter, unsigned char* destination, size_t count, size_t stride, const unsigned char* buffer, size_t bufferSize);
+
+    }
+
+}
@@ -3,6 +3,9 @@
 #include <fstream>
 #include <iostream>
 #include <type_traits>
+#include <algorithm>
+#include <cstring>
+#include <atomic>
 
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -15,6 +18,13 @@
 #include "../../Debug/TracyProfiler.h"
 
 #include "../../Scenes/Systems/BoundingBoxSystem.h"
+#include "../../Buffers/BufferUploadQueue.h"
+#include "../../Buffers/BufferConversionHelpers.h"
+#include "../../Jobs/JobSystem.h"
+#include "../Base64.h"
+#include "../ModelPrefab.h"
+#include "../MemoryStats.h"
+#include "MeshoptDecoder.h"
 
 
 
@@ -42,93 +52,97 @@ namespace Rapture {
         
         // Set the bounding box calculation flag
         m_calculateBoundingBoxes = true;
+
+        m_memoryStats = ImportMemoryStats();
+        m_stagingBytes = 0;
+        m_peakStagingBytes = 0;
+        m_decompressedBytes = 0;
+        m_peakDecompressedBytes = 0;
         
-        // Report initial progress
-        reportProgress(0.0f);
+        if (isCancelled()) {
+            return false;
+        }
         
         std::string fullPath = isAbsolute ? filepath : DIRNAME + filepath;
 
-        // Load the gltf file
-        std::ifstream gltf_file(fullPath);
-        if (!gltf_file)
-        {
-            GE_CORE_ERROR("glTF2Loader: Couldn't load glTF file '{}'", fullPath);
-            return false;
+        // Extract the directory path from the filepath
+        m_basePath = "";
+        size_t lastSlashPos = fullPath.find_last_of("/\\");
+        if (lastSlashPos != std::string::npos) {
+            m_basePath = fullPath.substr(0, lastSlashPos + 1);
         }
 
-        // Parse the JSON file
-        try {
-            gltf_file >> m_glTFfile;
-        }
-        catch (const std::exception& e) {
-            GE_CORE_ERROR("glTF2Loader: Failed to parse glTF JSON: {}", e.what());
-            return false;
+        // A valid baked cache skips the JSON, decoding and interleaving entirely
+        m_bakeEnabled = MeshCache::isEnabled();
+        if (m_bakeEnabled && loadFromCache(fullPath)) {
+            if (m_prefab) {
+                m_prefab->capture(m_createdEntities);
+            }
+            cleanUp();
+            return true;
         }
-        gltf_file.close();
-
-        // Load references to major sections
-        m_accessors = m_glTFfile.value("accessors", json::array());
-        m_meshes = m_glTFfile.value("meshes", json::array());
-        m_bufferViews = m_glTFfile.value("bufferViews", json::array());
-        m_buffers = m_glTFfile.value("buffers", json::array());
-        m_nodes = m_glTFfile.value("nodes", json::array());
-        m_materials = m_glTFfile.value("materials", json::array());
-        m_animations = m_glTFfile.value("animations", json::array());
-        m_skins = m_glTFfile.value("skins", json::array());
-        m_textures = m_glTFfile.value("textures", json::array());
-        m_images = m_glTFfile.value("images", json::array());
-        m_samplers = m_glTFfile.value("samplers", json::array());
 
+        // Binary .glb containers carry the JSON and the BIN payload in one file
+        std::string extension = fullPath.substr(fullPath.find_last_of('.') + 1);
+        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+        bool isBinary = extension == "glb";
 
-        // Validate required sections
-        if (m_accessors.empty() || m_meshes.empty() || m_bufferViews.empty() || m_buffers.empty()) {
-            GE_CORE_ERROR("glTF2Loader: Missing required glTF sections");
-            return false;
+        if (isBinary) {
+            if (!loadGLB(fullPath)) {
+                return false;
+            }
         }
+        else {
+            // Load the gltf file
+            std::ifstream gltf_file(fullPath);
+            if (!gltf_file)
+            {
+                GE_CORE_ERROR("glTF2Loader: Couldn't load glTF file '{}'", fullPath);
+                return false;
+            }
 
-        // Extract the directory path from the filepath
-        m_basePath = "";
-        size_t lastSlashPos = fullPath.find_last_of("/\\");
-        if (lastSlashPos != std::string::npos) {
-            m_basePath = fullPath.substr(0, lastSlashPos + 1);
+            // Parse the JSON file
+            try {
+                gltf_file >> m_glTFfile;
+            }
+            catch (const std::exception& e) {
+                GE_CORE_ERROR("glTF2Loader: Failed to parse glTF JSON: {}", e.what());
+                return false;
+            }
+            gltf_file.close();
         }
 
-        // Load the bin file with all the buffer data
-        std::string bufferURI = m_buffers[0].value("uri", "");
-        if (bufferURI.empty()) {
-            GE_CORE_ERROR("glTF2Loader: Buffer URI is missing");
+        // Parse the hot sections into typed records, the rest is referenced in place
+        if (!parseDocument()) {
             return false;
         }
-        
-        // Check if the buffer URI is a relative path
-        if (bufferURI.find("://") == std::string::npos && !bufferURI.empty()) {
-            // Combine the directory path with the buffer URI
-            bufferURI = m_basePath + bufferURI;
-        }
-        std::ifstream binary_file(bufferURI, std::ios::binary);
-        if (!binary_file)
-        {
-            GE_CORE_ERROR("glTF2Loader: Couldn't load binary file '{}'", bufferURI);
+        if (isCancelled()) {
+            GE_CORE_INFO("glTF2Loader: Load of '{}' cancelled", fullPath);
+            cleanUp();
             return false;
         }
-        
-        // Get file size and reserve space
-        binary_file.seekg(0, std::ios::end);
-        size_t fileSize = binary_file.tellg();
-        binary_file.seekg(0, std::ios::beg);
-        
-        m_binVec.resize(fileSize);
-        
-        // Read the entire file at once for efficiency
-        if (!binary_file.read(reinterpret_cast<char*>(m_binVec.data()), fileSize)) {
-            GE_CORE_ERROR("glTF2Loader: Failed to read binary data");
+
+        // The baked cache holds static meshes only, animated and morphed models are always imported from the source
+        bool hasMorphTargets = std::any_of(m_meshes.begin(), m_meshes.end(), [](const glTFMesh& mesh) {
+            return std::any_of(mesh.primitives.begin(), mesh.primitives.end(), [](const glTFPrimitive& primitive) { return !primitive.targets.empty(); });
+        });
+        if (!m_skins.empty() || !m_animations.empty() || hasMorphTargets) {
+            m_bakeEnabled = false;
+        }
+
+        // Validate required sections
+        if (m_accessors.empty() || m_meshes.empty() || m_bufferViews.empty() || m_buffers.empty()) {
+            GE_CORE_ERROR("glTF2Loader: Missing required glTF sections");
             return false;
         }
-        
-        binary_file.close();
+
+        // Buffers are resolved lazily on first accessor use, so unused buffers are never read
+        m_bufferData.clear();
+        m_bufferData.resize(m_buffers.size());
 
         // Create a root entity for the model
         Entity rootEntity = m_scene->createEntity("glTF_Model");
+        m_createdEntities.push_back(rootEntity);
         
         GE_CORE_INFO("glTF2Loader: Loading model from '{}'", fullPath);
 
@@ -142,6 +156,69 @@ namespace Rapture {
             Entity nodeEntity = m_scene->createEntity("Root Node");
             processNode(nodeEntity, m_nodes[0]);
         }
+
+        if (m_progress) {
+            m_progress->primitivesTotal = m_primitiveJobs.size();
+            reportProgress();
+        }
+
+        // Compressed buffer views are decoded when something is about to read them, and freed once nothing will
+        m_decompressedViews.assign(m_bufferViews.size(), {});
+        m_isViewDecompressed.assign(m_bufferViews.size(), 0);
+
+        if (!m_skins.empty()) {
+            // Inverse bind matrices and keyframes may be meshopt compressed as well
+            std::vector<size_t> animationViews;
+            for (const glTFSkin& skin : m_skins) {
+                collectAccessorViews(skin.inverseBindMatrices, animationViews);
+            }
+            for (const glTFAnimation& animation : m_animations) {
+                for (const glTFAnimationSampler& sampler : animation.samplers) {
+                    collectAccessorViews(sampler.input, animationViews);
+                    collectAccessorViews(sampler.output, animationViews);
+                }
+            }
+            if (!decompressBufferViews(animationViews)) {
+                GE_CORE_WARN("glTF2Loader: Some compressed buffer views couldn't be decoded, animations using them are skipped");
+            }
+
+            processSkins();
+        }
+
+        // The hierarchy is in place, decode the unique primitives in parallel, batch by batch,
+        // and only then touch the entities again and hand the data to the upload queue
+        decodePrimitives();
+
+        // Checked once more after decoding. Batches finished before the cancel are already in the upload queue,
+        // their entities are gone by the time the uploads complete, so the results are dropped
+        if (isCancelled()) {
+            GE_CORE_INFO("glTF2Loader: Load of '{}' cancelled", fullPath);
+            discardCreatedEntities();
+            cleanUp();
+            return false;
+        }
+
+        // A baked model fits the budget in one batch, which is kept until the cache is written
+        if (m_bakeEnabled) {
+            writeCache(fullPath);
+            for (auto& job : m_primitiveJobs) {
+                finalizePrimitive(job);
+            }
+        }
+
+        m_memoryStats.peakStagingBytes = m_peakStagingBytes;
+        m_memoryStats.peakDecompressedBytes = m_peakDecompressedBytes;
+        m_memoryStats.peakWorkingSet = MemoryStats::getPeakWorkingSet();
+        if (m_progress) {
+            m_progress->peakStagingBytes = m_memoryStats.peakStagingBytes;
+        }
+        GE_CORE_INFO("glTF2Loader: Imported '{}' in {} batches, peak staging {:.1f} MB, peak decoded views {:.1f} MB, process peak working set {:.1f} MB",
+            fullPath, m_memoryStats.batchCount, m_memoryStats.peakStagingBytes / 1048576.0, m_memoryStats.peakDecompressedBytes / 1048576.0,
+            m_memoryStats.peakWorkingSet / 1048576.0);
+
+        if (m_prefab) {
+            m_prefab->capture(m_createdEntities);
+        }
         
         // Clean up
         cleanUp();
@@ -149,323 +226,1611 @@ namespace Rapture {
         return true;
     }
 
-    void glTF2Loader::processScene(json& sceneJSON)
+    bool glTF2Loader::parseDocument()
     {
-        // Create a root entity for the scene
-        std::string sceneName = sceneJSON.value("name", "Scene");
-        
-        // Process each node in the scene
-        if (sceneJSON.contains("nodes") && !sceneJSON["nodes"].empty()) {
-            for (auto& nodeIdx : sceneJSON["nodes"]) {
-                unsigned int nodeIndex = nodeIdx.get<unsigned int>();
-                if (nodeIndex < m_nodes.size()) {
-                    Entity nodeEntity = m_scene->createEntity("Root Node");
-                    processNode(nodeEntity, m_nodes[nodeIndex]);
+        RAPTURE_PROFILE_FUNCTION();
+
+        try {
+            if (m_glTFfile.contains("buffers")) {
+                const json& buffers = m_glTFfile["buffers"];
+                m_buffers.reserve(buffers.size());
+                for (const json& bufferJSON : buffers) {
+                    glTFBuffer& buffer = m_buffers.emplace_back();
+                    buffer.uri = bufferJSON.value("uri", "");
+                    buffer.byteLength = bufferJSON.value("byteLength", (size_t)0);
+                }
+            }
+
+            if (m_glTFfile.contains("bufferViews")) {
+                const json& bufferViews = m_glTFfile["bufferViews"];
+                m_bufferViews.reserve(bufferViews.size());
+                for (const json& viewJSON : bufferViews) {
+                    glTFBufferView& view = m_bufferViews.emplace_back();
+                    view.buffer = viewJSON.value("buffer", 0u);
+                    view.byteOffset = viewJSON.value("byteOffset", (size_t)0);
+                    view.byteLength = viewJSON.value("byteLength", (size_t)0);
+                    view.byteStride = viewJSON.value("byteStride", 0u);
+
+                    if (viewJSON.contains("extensions") && viewJSON["extensions"].contains("EXT_meshopt_compression")) {
+                        const json& compression = viewJSON["extensions"]["EXT_meshopt_compression"];
+                        view.isCompressed = true;
+                        view.compressedBuffer = compression.value("buffer", 0u);
+                        view.compressedOffset = compression.value("byteOffset", (size_t)0);
+                        view.compressedLength = compression.value("byteLength", (size_t)0);
+                        view.compressedCount = compression.value("count", 0u);
+                        // The extension's stride is the decoded element size, it overrides the view's
+                        view.byteStride = compression.value("byteStride", 0u);
+
+                        std::string mode = compression.value("mode", "ATTRIBUTES");
+                        if (mode == "TRIANGLES") view.compressionMode = MeshoptDecoder::Mode::Triangles;
+                        else if (mode == "INDICES") view.compressionMode = MeshoptDecoder::Mode::Indices;
+                        else view.compressionMode = MeshoptDecoder::Mode::Attributes;
+
+                        std::string filter = compression.value("filter", "NONE");
+                        if (filter == "OCTAHEDRAL") view.compressionFilter = MeshoptDecoder::Filter::Octahedral;
+                        else if (filter == "QUATERNION") view.compressionFilter = MeshoptDecoder::Filter::Quaternion;
+                        else if (filter == "EXPONENTIAL") view.compressionFilter = MeshoptDecoder::Filter::Exponential;
+                        else view.compressionFilter = MeshoptDecoder::Filter::None;
+                    }
+                }
+            }
+
+            if (m_glTFfile.contains("accessors")) {
+                const json& accessors = m_glTFfile["accessors"];
+                m_accessors.reserve(accessors.size());
+                for (const json& accessorJSON : accessors) {
+                    glTFAccessor& accessor = m_accessors.emplace_back();
+                    accessor.bufferView = accessorJSON.value("bufferView", -1);
+                    accessor.byteOffset = accessorJSON.value("byteOffset", (size_t)0);
+                    accessor.count = accessorJSON.value("count", 0u);
+                    accessor.componentType = accessorJSON.value("componentType", 0u);
+                    accessor.type = typeFromString(accessorJSON.value("type", "SCALAR"));
+                    accessor.normalized = accessorJSON.value("normalized", false);
+
+                    if (accessorJSON.contains("sparse")) {
+                        const json& sparse = accessorJSON["sparse"];
+                        accessor.sparseCount = sparse.value("count", 0u);
+                        if (sparse.contains("indices")) {
+                            accessor.sparseIndicesView = sparse["indices"].value("bufferView", -1);
+                            accessor.sparseIndicesOffset = sparse["indices"].value("byteOffset", (size_t)0);
+                            accessor.sparseIndicesComponentType = sparse["indices"].value("componentType", 0u);
+                        }
+                        if (sparse.contains("values")) {
+                            accessor.sparseValuesView = sparse["values"].value("bufferView", -1);
+                            accessor.sparseValuesOffset = sparse["values"].value("byteOffset", (size_t)0);
+                        }
+                    }
+                }
+            }
+
+            if (m_glTFfile.contains("meshes")) {
+                const json& meshes = m_glTFfile["meshes"];
+                m_meshes.reserve(meshes.size());
+                for (const json& meshJSON : meshes) {
+                    glTFMesh& mesh = m_meshes.emplace_back();
+                    mesh.name = meshJSON.value("name", "Mesh");
+                    if (meshJSON.contains("weights")) {
+                        mesh.weights = meshJSON["weights"].get<std::vector<float>>();
+                    }
+
+                    // Not part of the spec, but the common way exporters name blend shapes
+                    std::vector<std::string> targetNames;
+                    if (meshJSON.contains("extras") && meshJSON["extras"].contains("targetNames")) {
+                        targetNames = meshJSON["extras"]["targetNames"].get<std::vector<std::string>>();
+                    }
+
+                    if (!meshJSON.contains("primitives")) {
+                        continue;
+                    }
+                    for (const json& primitiveJSON : meshJSON["primitives"]) {
+                        glTFPrimitive& primitive = mesh.primitives.emplace_back();
+                        primitive.indices = primitiveJSON.value("indices", -1);
+                        primitive.material = primitiveJSON.value("material", -1);
+
+                        if (!primitiveJSON.contains("attributes")) {
+                            continue;
+                        }
+                        for (const auto& attrib : primitiveJSON["attributes"].items()) {
+                            primitive.attributes.emplace_back(semanticFromString(attrib.key()), attrib.value().get<uint32_t>());
+                        }
+
+                        if (primitiveJSON.contains("targets")) {
+                            for (const json& targetJSON : primitiveJSON["targets"]) {
+                                auto& target = primitive.targets.emplace_back();
+                                for (const auto& attrib : targetJSON.items()) {
+                                    target.emplace_back(semanticFromString(attrib.key()), attrib.value().get<uint32_t>());
+                                }
+                            }
+                            primitive.targetNames = targetNames;
+                        }
+                    }
+                }
+            }
+
+            if (m_glTFfile.contains("nodes")) {
+                const json& nodes = m_glTFfile["nodes"];
+                m_nodes.reserve(nodes.size());
+                for (const json& nodeJSON : nodes) {
+                    glTFNode& node = m_nodes.emplace_back();
+                    node.name = nodeJSON.value("name", "Node");
+                    node.mesh = nodeJSON.value("mesh", -1);
+                    node.skin = nodeJSON.value("skin", -1);
+                    if (nodeJSON.contains("weights")) {
+                        node.weights = nodeJSON["weights"].get<std::vector<float>>();
+                    }
+
+                    if (nodeJSON.contains("children")) {
+                        node.children = nodeJSON["children"].get<std::vector<uint32_t>>();
+                    }
+
+                    if (nodeJSON.contains("matrix")) {
+                        float matrixValues[16];
+                        for (int i = 0; i < 16; i++) {
+                            matrixValues[i] = nodeJSON["matrix"][i];
+                        }
+                        node.hasMatrix = true;
+                        node.matrix = glm::make_mat4(matrixValues);
+                    }
+                    if (nodeJSON.contains("translation")) {
+                        const json& t = nodeJSON["translation"];
+                        node.translation = glm::vec3(t[0], t[1], t[2]);
+                    }
+                    if (nodeJSON.contains("rotation")) {
+                        // glTF quaternions are [x,y,z,w], but glm::quat constructor takes [w,x,y,z]
+                        const json& r = nodeJSON["rotation"];
+                        node.rotation = glm::quat(r[3], r[0], r[1], r[2]);
+                    }
+                    if (nodeJSON.contains("scale")) {
+                        const json& sc = nodeJSON["scale"];
+                        node.scale = glm::vec3(sc[0], sc[1], sc[2]);
+                    }
+                }
+            }
+
+            if (m_glTFfile.contains("skins")) {
+                const json& skins = m_glTFfile["skins"];
+                m_skins.reserve(skins.size());
+                for (const json& skinJSON : skins) {
+                    glTFSkin& skin = m_skins.emplace_back();
+                    skin.name = skinJSON.value("name", "");
+                    skin.inverseBindMatrices = skinJSON.value("inverseBindMatrices", -1);
+                    skin.skeleton = skinJSON.value("skeleton", -1);
+                    if (skinJSON.contains("joints")) {
+                        skin.joints = skinJSON["joints"].get<std::vector<uint32_t>>();
+                    }
+                }
+            }
+
+            if (m_glTFfile.contains("animations")) {
+                const json& animations = m_glTFfile["animations"];
+                m_animations.reserve(animations.size());
+                for (const json& animationJSON : animations) {
+                    glTFAnimation& animation = m_animations.emplace_back();
+                    animation.name = animationJSON.value("name", "");
+
+                    if (animationJSON.contains("samplers")) {
+                        for (const json& samplerJSON : animationJSON["samplers"]) {
+                            glTFAnimationSampler& sampler = animation.samplers.emplace_back();
+                            sampler.input = samplerJSON.value("input", 0u);
+                            sampler.output = samplerJSON.value("output", 0u);
+                            sampler.interpolation = samplerJSON.value("interpolation", "LINEAR");
+                        }
+                    }
+                    if (animationJSON.contains("channels")) {
+                        for (const json& channelJSON : animationJSON["channels"]) {
+                            glTFAnimationChannel& channel = animation.channels.emplace_back();
+                            channel.sampler = channelJSON.value("sampler", 0u);
+                            if (channelJSON.contains("target")) {
+                                channel.node = channelJSON["target"].value("node", -1);
+                                channel.path = channelJSON["target"].value("path", "");
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        catch (const std::exception& e) {
+            GE_CORE_ERROR("glTF2Loader: Malformed glTF document: {}", e.what());
+            return false;
+        }
+
+        // Required extensions change how the data has to be read, so anything unknown is worth a warning
+        if (m_glTFfile.contains("extensionsRequired")) {
+            for (const json& extension : m_glTFfile["extensionsRequired"]) {
+                std::string name = extension.is_string() ? extension.get<std::string>() : std::string();
+                if (name != "KHR_mesh_quantization" && name != "EXT_meshopt_compression" &&
+                    name != "KHR_materials_pbrSpecularGlossiness") {
+                    GE_CORE_WARN("glTF2Loader: Required extension '{}' is not supported, the model may load incorrectly", name);
                 }
             }
         }
+
+        // Everything above now lives in the typed records, so drop it from the DOM instead of holding it twice
+        for (const char* parsedSection : { "buffers", "bufferViews", "accessors", "meshes", "nodes", "skins", "animations" }) {
+            m_glTFfile.erase(parsedSection);
+        }
+
+        bindMaterialSections();
+
+        return true;
+    }
+
+    void glTF2Loader::bindMaterialSections()
+    {
+        // Materials and textures are only read once per use, they stay in the DOM and are referenced in place
+        auto section = [this](const char* name) {
+            if (!m_glTFfile.contains(name)) {
+                m_glTFfile[name] = json::array();
+            }
+            return &m_glTFfile[name];
+        };
+        m_materials = section("materials");
+        m_textures = section("textures");
+        m_images = section("images");
+        m_samplers = section("samplers");
     }
 
-    Entity glTF2Loader::processNode(Entity nodeEntity, json& nodeJSON)
+    uint64_t glTF2Loader::getImportSettingsHash() const
     {
+        // FNV-1a over every setting that changes what a load produces. Behaviour fixed in code is covered by
+        // MESH_CACHE_VERSION instead. Animated models aren't baked today, their compression is hashed anyway
+        // so that baking them later can't pick up clips compressed with other tolerances
+        uint64_t hash = 14695981039346656037ull;
+        auto mix = [&hash](const void* data, size_t size) {
+            const unsigned char* bytes = static_cast<const unsigned char*>(data);
+            for (size_t i = 0; i < size; i++) {
+                hash ^= bytes[i];
+                hash *= 1099511628211ull;
+            }
+        };
 
-        if (!nodeEntity.hasComponent<EntityNodeComponent>()) {
-            nodeEntity.addComponent<EntityNodeComponent>(nodeEntity);
+        uint8_t calculateBoundingBoxes = m_calculateBoundingBoxes ? 1 : 0;
+        uint8_t compressAnimations = m_animationCompression.enabled ? 1 : 0;
+        mix(&calculateBoundingBoxes, sizeof(calculateBoundingBoxes));
+        mix(&compressAnimations, sizeof(compressAnimations));
+        if (m_animationCompression.enabled) {
+            mix(&m_animationCompression.translationTolerance, sizeof(float));
+            mix(&m_animationCompression.rotationTolerance, sizeof(float));
+            mix(&m_animationCompression.scaleTolerance, sizeof(float));
         }
+        return hash;
+    }
 
-        // Create a new entity for this node
-        std::string nodeName = nodeJSON.value("name", "Node");
-        //Entity nodeEntity = m_scene->createEntity(nodeName);
+    void glTF2Loader::recordEntity(Entity entity, int32_t primitive, int32_t material)
+    {
+        m_createdEntities.push_back(entity);
 
-        // Update the tag
-        nodeEntity.getComponent<TagComponent>().tag = nodeName;
-        auto& nodeEntityComp = nodeEntity.getComponent<EntityNodeComponent>();
-        
+        if (!m_bakeEnabled) {
+            return;
+        }
 
-        nodeEntity.addComponent<TransformComponent>();
-        auto& transformComp = nodeEntity.getComponent<TransformComponent>();
+        BakedEntity record;
+        record.name = entity.getComponent<TagComponent>().tag;
+        record.transform = entity.getComponent<TransformComponent>().transformMatrix();
+        record.primitive = primitive;
+        record.material = material;
 
-        // Extract transform components if present
-        if (nodeJSON.contains("matrix")) {
-            // Use matrix directly
-            float matrixValues[16];
-            for (int i = 0; i < 16; i++) {
-                matrixValues[i] = nodeJSON["matrix"][i];
+        std::shared_ptr<EntityNode> parentNode = entity.getComponent<EntityNodeComponent>().entity_node->getParent();
+        if (parentNode) {
+            auto parentRecord = m_entityRecords.find(parentNode->getEntity()->getID());
+            if (parentRecord != m_entityRecords.end()) {
+                record.parent = parentRecord->second;
             }
-            glm::mat4 nodeMatrix = glm::make_mat4(matrixValues);
-            std::shared_ptr<EntityNode> parent = nodeEntityComp.entity_node->getParent();
-            if (parent != nullptr) {
-                nodeMatrix = parent->getEntity()->getComponent<TransformComponent>().transformMatrix() * nodeMatrix;
+        }
+
+        m_entityRecords[entity.getID()] = static_cast<int32_t>(m_bakedEntities.size());
+        m_bakedEntities.push_back(std::move(record));
+    }
+
+    void glTF2Loader::writeCache(const std::string& sourcePath)
+    {
+        RAPTURE_PROFILE_FUNCTION();
+
+        BakedModel model;
+        model.settingsHash = getImportSettingsHash();
+
+        // The source and every external buffer it pulls in, data URIs and the GLB BIN chunk are part of the source
+        model.dependencies.push_back(sourcePath);
+        for (const auto& buffer : m_buffers) {
+            if (!buffer.uri.empty() && buffer.uri.rfind("data:", 0) != 0) {
+                model.dependencies.push_back(buffer.uri.find("://") == std::string::npos ? m_basePath + buffer.uri : buffer.uri);
             }
+        }
 
-            transformComp.transforms.setTransform(nodeMatrix);
+        json materialDocument;
+        materialDocument["materials"] = *m_materials;
+        materialDocument["textures"] = *m_textures;
+        materialDocument["images"] = *m_images;
+        materialDocument["samplers"] = *m_samplers;
+        model.materialJSON = materialDocument.dump();
+
+        model.primitives.reserve(m_primitiveJobs.size());
+        for (const auto& job : m_primitiveJobs) {
+            const DecodedPrimitive& decoded = job.decoded;
+            if (!decoded.isValid) {
+                // Entities referencing a failed primitive would come back without their error, so don't cache at all
+                GE_CORE_INFO("glTF2Loader: Not caching '{}', it has primitives that failed to decode", sourcePath);
+                return;
+            }
+
+            BakedPrimitive& baked = model.primitives.emplace_back();
+            baked.layout = decoded.layout;
+            baked.vertexData = decoded.vertexData.data();
+            baked.vertexDataSize = decoded.vertexData.size();
+            baked.positionData = decoded.positionData.data();
+            baked.positionDataSize = decoded.positionData.size();
+            baked.indexData = decoded.indexData.data();
+            baked.indexDataSize = decoded.indexData.size();
+            baked.indexCount = static_cast<uint32_t>(decoded.indexCount);
+            baked.indexType = decoded.indexType;
+            baked.localBoundingBox = decoded.localBoundingBox;
         }
-        else {
-            // Use TRS components
-            glm::vec3 translation(0.0f);
-            glm::quat rotation(1.0f, 0.0f, 0.0f, 0.0f);
-            glm::vec3 scale(1.0f);
-            
-            if (nodeJSON.contains("translation"))
-                translation = glm::vec3(
-                    nodeJSON["translation"][0],
-                    nodeJSON["translation"][1],
-                    nodeJSON["translation"][2]
-                );
-                
-            if (nodeJSON.contains("rotation")) {
-                // glTF quaternions are [x,y,z,w], but glm::quat constructor takes [w,x,y,z]
-                rotation = glm::quat(
-                    nodeJSON["rotation"][3], // w
-                    nodeJSON["rotation"][0], // x
-                    nodeJSON["rotation"][1], // y
-                    nodeJSON["rotation"][2]  // z
-                );
+        model.entities = m_bakedEntities;
+
+        MeshCache::write(MeshCache::getCachePath(sourcePath), model);
+    }
+
+    bool glTF2Loader::loadFromCache(const std::string& sourcePath)
+    {
+        RAPTURE_PROFILE_FUNCTION();
+
+        BakedModel model;
+        if (!MeshCache::read(MeshCache::getCachePath(sourcePath), getImportSettingsHash(), model)) {
+            return false;
+        }
+
+        // Only the small material document is parsed, everything else comes straight from the mapping
+        try {
+            m_glTFfile = json::parse(model.materialJSON);
+        }
+        catch (const std::exception& e) {
+            GE_CORE_WARN("glTF2Loader: Cached material data for '{}' is invalid, reimporting: {}", sourcePath, e.what());
+            m_glTFfile.clear();
+            return false;
+        }
+        bindMaterialSections();
+
+        GE_CORE_INFO("glTF2Loader: Loading model from cache for '{}'", sourcePath);
+
+        // Nothing is decoded on a cache hit, every primitive is ready as soon as it is mapped
+        if (m_progress) {
+            m_progress->primitivesTotal = model.primitives.size();
+            m_progress->primitivesDecoded = model.primitives.size();
+            reportProgress();
+        }
+
+        // Create a root entity for the model
+        Entity rootEntity = m_scene->createEntity("glTF_Model");
+        m_createdEntities.push_back(rootEntity);
+
+        // Recreate the hierarchy, parents are always stored before their children
+        std::vector<Entity> entities;
+        entities.reserve(model.entities.size());
+        std::vector<std::shared_ptr<Mesh>> meshes(model.primitives.size());
+        std::vector<std::vector<Entity>> primitiveEntities(model.primitives.size());
+
+        for (const BakedEntity& record : model.entities) {
+            Entity entity = m_scene->createEntity(record.name);
+
+            if (record.parent >= 0 && record.parent < (int32_t)entities.size()) {
+                std::shared_ptr<EntityNode> parentNode = entities[record.parent].getComponent<EntityNodeComponent>().entity_node;
+                entity.addComponent<EntityNodeComponent>(entity, parentNode);
+                parentNode->addChild(entity.getComponent<EntityNodeComponent>().entity_node);
             }
-                
-            if (nodeJSON.contains("scale"))
-                scale = glm::vec3(
-                    nodeJSON["scale"][0],
-                    nodeJSON["scale"][1],
-                    nodeJSON["scale"][2]
-                );
-            
-            // Build transform matrix correctly using GLM
-            glm::mat4 transformMatrix = glm::mat4(1.0f);
-            transformMatrix = glm::translate(transformMatrix, translation);
-            transformMatrix = transformMatrix * glm::mat4_cast(rotation);
-            transformMatrix = glm::scale(transformMatrix, scale);
-            
-            
-            std::shared_ptr<EntityNode> parent = nodeEntityComp.entity_node->getParent();
-            if (parent != nullptr) {
-                transformMatrix = parent->getEntity()->getComponent<TransformComponent>().transformMatrix() * transformMatrix;
+            else {
+                entity.addComponent<EntityNodeComponent>(entity);
+            }
+            entity.addComponent<TransformComponent>(record.transform);
+
+            if (record.primitive >= 0) {
+                entity.addComponent<MeshComponent>(true);
+                entity.addComponent<MaterialComponent>();
+
+                // Entities of the same primitive share one Mesh, like on a normal import
+                auto& meshComp = entity.getComponent<MeshComponent>();
+                if (meshes[record.primitive]) {
+                    meshComp.mesh = meshes[record.primitive];
+                }
+                else {
+                    meshes[record.primitive] = meshComp.mesh;
+                }
+                primitiveEntities[record.primitive].push_back(entity);
+
+                glTFPrimitive materialReference;
+                materialReference.material = record.material;
+                assignPrimitiveMaterial(entity, materialReference);
+            }
+
+            entities.push_back(entity);
+            m_createdEntities.push_back(entity);
+        }
+
+        for (size_t i = 0; i < model.primitives.size(); i++) {
+            const BakedPrimitive& baked = model.primitives[i];
+            if (!meshes[i]) {
+                continue;
+            }
+
+            if (m_calculateBoundingBoxes && baked.localBoundingBox.isValid()) {
+                for (Entity& entity : primitiveEntities[i]) {
+                    BoundingBoxSystem::addBoundingBoxToEntity(entity, baked.localBoundingBox);
+                }
+            }
+
+            // Uploaded straight from the mapping, the request keeps it alive until it is done
+            MeshUploadRequest uploadRequest;
+            uploadRequest.mesh = meshes[i];
+            uploadRequest.layout = baked.layout;
+            uploadRequest.vertexData = StagedBytes::borrow(baked.vertexData, baked.vertexDataSize);
+            uploadRequest.positionData = StagedBytes::borrow(baked.positionData, baked.positionDataSize);
+            uploadRequest.indexData = StagedBytes::borrow(baked.indexData, baked.indexDataSize);
+            uploadRequest.indexCount = baked.indexCount;
+            uploadRequest.indexType = baked.indexType;
+            uploadRequest.keepAlive = model.mapping;
+            enqueuePrimitiveUpload(std::move(uploadRequest), std::move(primitiveEntities[i]), m_prefab, m_stagingScene);
+        }
+
+        return true;
+    }
+
+    bool glTF2Loader::loadGLB(const std::string& path)
+    {
+        RAPTURE_PROFILE_FUNCTION();
+
+        if (!m_glbFile.open(path)) {
+            GE_CORE_ERROR("glTF2Loader: Couldn't load GLB file '{}'", path);
+            return false;
+        }
+
+        const unsigned char* data = m_glbFile.data();
+        size_t size = m_glbFile.size();
+
+        auto readU32 = [data](size_t offset) {
+            uint32_t value;
+            std::memcpy(&value, data + offset, sizeof(uint32_t));
+            return value;
+        };
+
+        // 12 byte header: magic, version, total length
+        if (size < GLB_HEADER_SIZE || readU32(0) != GLB_MAGIC) {
+            GE_CORE_ERROR("glTF2Loader: '{}' is not a GLB file", path);
+            return false;
+        }
+
+        uint32_t version = readU32(4);
+        if (version != 2) {
+            GE_CORE_ERROR("glTF2Loader: Unsupported GLB version {} in '{}'", version, path);
+            return false;
+        }
+
+        size_t totalLength = std::min<size_t>(readU32(8), size);
+
+        // Chunks follow the header, each with an 8 byte header of its own: length, type
+        const unsigned char* jsonChunk = nullptr;
+        size_t jsonChunkLength = 0;
+        size_t offset = GLB_HEADER_SIZE;
+
+        while (offset + GLB_CHUNK_HEADER_SIZE <= totalLength) {
+            uint32_t chunkLength = readU32(offset);
+            uint32_t chunkType = readU32(offset + 4);
+            offset += GLB_CHUNK_HEADER_SIZE;
+
+            if (offset + chunkLength > totalLength) {
+                GE_CORE_ERROR("glTF2Loader: GLB chunk runs past the end of '{}'", path);
+                return false;
             }
 
+            if (chunkType == GLB_CHUNK_JSON && !jsonChunk) {
+                jsonChunk = data + offset;
+                jsonChunkLength = chunkLength;
+            }
+            else if (chunkType == GLB_CHUNK_BIN && !m_glbBinChunk) {
+                m_glbBinChunk = data + offset;
+                m_glbBinChunkSize = chunkLength;
+            }
+            // Unknown chunk types must be ignored
+
+            offset += chunkLength;
+        }
+
+        if (!jsonChunk) {
+            GE_CORE_ERROR("glTF2Loader: GLB file '{}' has no JSON chunk", path);
+            return false;
+        }
+
+        try {
+            m_glTFfile = json::parse(jsonChunk, jsonChunk + jsonChunkLength);
+        }
+        catch (const std::exception& e) {
+            GE_CORE_ERROR("glTF2Loader: Failed to parse GLB JSON chunk: {}", e.what());
+            return false;
+        }
+
+        return true;
+    }
+
+    const glTF2Loader::BufferData* glTF2Loader::resolveBuffer(size_t bufferIndex)
+    {
+        if (bufferIndex >= m_bufferData.size()) {
+            GE_CORE_ERROR("glTF2Loader: Buffer index out of range: {}", bufferIndex);
+            return nullptr;
+        }
+
+        // Primitives decode in parallel, so the first use of a buffer may race
+        std::lock_guard<std::mutex> lock(m_bufferMutex);
+
+        BufferData& buffer = m_bufferData[bufferIndex];
+        if (buffer.isResolved) {
+            return buffer.data ? &buffer : nullptr;
+        }
+        buffer.isResolved = true;
+
+        RAPTURE_PROFILE_FUNCTION();
+
+        const std::string& uri = m_buffers[bufferIndex].uri;
+        size_t byteLength = m_buffers[bufferIndex].byteLength;
+
+        if (uri.empty()) {
+            // Only the first buffer of a .glb may omit its URI, it is the BIN chunk
+            if (bufferIndex != 0 || !m_glbBinChunk) {
+                GE_CORE_ERROR("glTF2Loader: Buffer {} has no URI and no GLB BIN chunk", bufferIndex);
+                return nullptr;
+            }
+            buffer.data = m_glbBinChunk;
+            buffer.size = m_glbBinChunkSize;
+        }
+        else if (uri.rfind("data:", 0) == 0) {
+            // Embedded data URI, "data:<mime type>;base64,<payload>"
+            size_t payloadStart = uri.find(";base64,");
+            if (payloadStart == std::string::npos) {
+                GE_CORE_ERROR("glTF2Loader: Buffer {} has a data URI that isn't base64 encoded", bufferIndex);
+                return nullptr;
+            }
+            payloadStart += 8;
+
+            if (!Base64::decode(std::string_view(uri).substr(payloadStart), buffer.decoded)) {
+                GE_CORE_ERROR("glTF2Loader: Buffer {} has an invalid base64 payload", bufferIndex);
+                return nullptr;
+            }
+            buffer.data = buffer.decoded.data();
+            buffer.size = buffer.decoded.size();
+        }
+        else {
+            std::string bufferPath = uri;
+
+            // Check if the buffer URI is a relative path
+            if (bufferPath.find("://") == std::string::npos) {
+                // Combine the directory path with the buffer URI
+                bufferPath = m_basePath + bufferPath;
+            }
+
+            // Map the file instead of reading it, accessors copy straight out of the mapping
+            if (!buffer.file.open(bufferPath)) {
+                GE_CORE_ERROR("glTF2Loader: Couldn't load binary file '{}'", bufferPath);
+                return nullptr;
+            }
+            buffer.data = buffer.file.data();
+            buffer.size = buffer.file.size();
+        }
+
+        // The source may be padded past byteLength, but never shorter
+        if (buffer.size < byteLength) {
+            GE_CORE_ERROR("glTF2Loader: Buffer {} holds {} bytes but declares {}", bufferIndex, buffer.size, byteLength);
+            buffer.data = nullptr;
+            return nullptr;
+        }
+
+        return &buffer;
+    }
+
+    void glTF2Loader::processScene(json& sceneJSON)
+    {
+        // Create a root entity for the scene
+        std::string sceneName = sceneJSON.value("name", "Scene");
+        
+        // Process each node in the scene
+        if (sceneJSON.contains("nodes") && !sceneJSON["nodes"].empty()) {
+            for (auto& nodeIdx : sceneJSON["nodes"]) {
+                unsigned int nodeIndex = nodeIdx.get<unsigned int>();
+                if (nodeIndex < m_nodes.size()) {
+                    Entity nodeEntity = m_scene->createEntity("Root Node");
+                    processNode(nodeEntity, m_nodes[nodeIndex]);
+                }
+            }
+        }
+    }
+
+    Entity glTF2Loader::processNode(Entity nodeEntity, const glTFNode& node)
+    {
+
+        if (!nodeEntity.hasComponent<EntityNodeComponent>()) {
+            nodeEntity.addComponent<EntityNodeComponent>(nodeEntity);
+        }
+
+        // Create a new entity for this node
+        const std::string& nodeName = node.name;
+        //Entity nodeEntity = m_scene->createEntity(nodeName);
+
+        // Update the tag
+        nodeEntity.getComponent<TagComponent>().tag = nodeName;
+        auto& nodeEntityComp = nodeEntity.getComponent<EntityNodeComponent>();
+        
+
+        nodeEntity.addComponent<TransformComponent>();
+        auto& transformComp = nodeEntity.getComponent<TransformComponent>();
+
+        // Extract transform components if present
+        if (node.hasMatrix) {
+            // Use matrix directly
+            glm::mat4 nodeMatrix = node.matrix;
+            std::shared_ptr<EntityNode> parent = nodeEntityComp.entity_node->getParent();
+            if (parent != nullptr) {
+                nodeMatrix = parent->getEntity()->getComponent<TransformComponent>().transformMatrix() * nodeMatrix;
+            }
+
+            transformComp.transforms.setTransform(nodeMatrix);
+        }
+        else {
+            // Use TRS components, build transform matrix correctly using GLM
+            glm::mat4 transformMatrix = glm::mat4(1.0f);
+            transformMatrix = glm::translate(transformMatrix, node.translation);
+            transformMatrix = transformMatrix * glm::mat4_cast(node.rotation);
+            transformMatrix = glm::scale(transformMatrix, node.scale);
+            
+            
+            std::shared_ptr<EntityNode> parent = nodeEntityComp.entity_node->getParent();
+            if (parent != nullptr) {
+                transformMatrix = parent->getEntity()->getComponent<TransformComponent>().transformMatrix() * transformMatrix;
+            }
+
+
+
+            // Add the component with the full transform matrix
+            transformComp.transforms.setTransform(transformMatrix);
+            
+        }
+        
+        recordEntity(nodeEntity);
+
+        // If this node has a mesh, process it
+        if (node.mesh >= 0) {
+            unsigned int meshIndex = node.mesh;
+            if (meshIndex < m_meshes.size()) {
+                processMesh(nodeEntity, node, m_meshes[meshIndex], meshIndex);
+            }
+        }
+        
+        // Process children
+        if (!node.children.empty()) {
+            for (unsigned int childIndex : node.children) {
+                if (childIndex < m_nodes.size()) {
+                    Entity childEntity = m_scene->createEntity("Child Node");
+                    childEntity.addComponent<EntityNodeComponent>(childEntity, nodeEntity.getComponent<EntityNodeComponent>().entity_node);
+
+                    nodeEntity.getComponent<EntityNodeComponent>().entity_node->addChild(childEntity.getComponent<EntityNodeComponent>().entity_node);
+
+                    processNode(childEntity, m_nodes[childIndex]);
+
+                    // Establish parent-child relationship
+                    if (!childEntity.hasComponent<EntityNodeComponent>()) {
+                        GE_CORE_ERROR("Child entity '{}' missing EntityNodeComponent", childIndex);
+                        continue;
+                    }
+                    
+                    if (!nodeEntity.hasComponent<EntityNodeComponent>()) {
+                        GE_CORE_ERROR("Node entity '{}' missing EntityNodeComponent", nodeName);
+                        continue;
+                    }
+                    
+
+                }
+            }
+        }
+        
+        return nodeEntity;
+    }
+
+    Entity glTF2Loader::processMesh(Entity parent, const glTFNode& node, const glTFMesh& mesh, unsigned int meshIndex)
+    {
+        auto& parentTransform = parent.getComponent<TransformComponent>();
+
+
+        const std::string& meshName = mesh.name;
+        Entity meshEntity = m_scene->createEntity(meshName);
+        // Create transform component that inherits parent transform
+        meshEntity.addComponent<TransformComponent>(parentTransform.transformMatrix());
+        
+        
+        // Check if parent entity has EntityNodeComponent
+        if (!parent.hasComponent<EntityNodeComponent>()) {
+            GE_CORE_ERROR("Parent entity '{}' missing EntityNodeComponent", meshName);
+            return meshEntity;
+        }
+        
+        meshEntity.addComponent<EntityNodeComponent>(meshEntity, parent.getComponent<EntityNodeComponent>().entity_node);
+        
+        // Check if mesh entity has EntityNodeComponent after adding it
+        if (!meshEntity.hasComponent<EntityNodeComponent>()) {
+            GE_CORE_ERROR("Mesh entity '{}' failed to add EntityNodeComponent", meshName);
+            return meshEntity;
+        }
+        
+        std::shared_ptr<EntityNode> mesh_entity_node = meshEntity.getComponent<EntityNodeComponent>().entity_node;
+        
+        parent.getComponent<EntityNodeComponent>().entity_node->addChild(mesh_entity_node);
+        recordEntity(meshEntity);
+    
+        // Process primitives
+        if (!mesh.primitives.empty()) {
+            int primitiveIndex = 0;
+            for (const glTFPrimitive& primitive : mesh.primitives) {
+                // For each primitive, create a new entity
+                Entity primitiveEntity = m_scene->createEntity("_Primitive_" + std::to_string(primitiveIndex) + "_" + meshName);
+                primitiveEntity.addComponent<EntityNodeComponent>(primitiveEntity, mesh_entity_node);
+                mesh_entity_node->addChild(primitiveEntity.getComponent<EntityNodeComponent>().entity_node);
+
+                primitiveEntity.addComponent<TransformComponent>(parentTransform.transformMatrix());
+
+                // Process the primitive data, nodes that share a mesh also share its decoded primitives
+                uint64_t primitiveKey = (static_cast<uint64_t>(meshIndex) << 32) | static_cast<uint32_t>(primitiveIndex);
+                processPrimitive(primitiveEntity, primitive, primitiveKey);
+
+                // The animator entity only exists once the skins are processed, it is filled in then
+                if (node.skin >= 0 && (size_t)node.skin < m_skins.size()) {
+                    primitiveEntity.addComponent<SkinComponent>();
+                    m_skinnedEntities.emplace_back(primitiveEntity, node.skin);
+                }
+
+                // Weights are per node, the targets themselves arrive with the decoded primitive
+                if (!primitive.targets.empty()) {
+                    std::vector<float> weights = node.weights.empty() ? mesh.weights : node.weights;
+                    weights.resize(primitive.targets.size(), 0.0f);
+                    primitiveEntity.addComponent<MorphTargetComponent>(std::move(weights));
+                }
+                primitiveIndex++;
+            }
+        }
+        
+        return meshEntity;
+    }
+
+    void glTF2Loader::processPrimitive(Entity entity, const glTFPrimitive& primitive, uint64_t primitiveKey)
+    {
+        // Add mesh component to the entity
+        entity.addComponent<MeshComponent>(true);
+        entity.addComponent<MaterialComponent>();
+        
+        // Check if entity has MeshComponent before accessing it
+        if (!entity.hasComponent<MeshComponent>()) {
+            GE_CORE_ERROR("Entity missing MeshComponent");
+            return;
+        }
+        auto& meshComp = entity.getComponent<MeshComponent>();
+
+        // Nodes that share a mesh share its decode job, and with it the Mesh and its pool allocation
+        size_t jobIndex = m_primitiveJobs.size();
+        if (auto cached = m_primitiveCache.find(primitiveKey); cached != m_primitiveCache.end()) {
+            jobIndex = cached->second;
+            PrimitiveDecodeJob& job = m_primitiveJobs[jobIndex];
+            meshComp.mesh = job.mesh;
+            job.entities.push_back(entity);
+        }
+        else {
+            m_primitiveCache[primitiveKey] = jobIndex;
+
+            PrimitiveDecodeJob job;
+            job.primitive = &primitive;
+            job.mesh = meshComp.mesh;
+            job.entities.push_back(entity);
+            m_primitiveJobs.push_back(std::move(job));
+        }
+        recordEntity(entity, static_cast<int32_t>(jobIndex), primitive.material);
+
+        assignPrimitiveMaterial(entity, primitive);
+    }
+
+    namespace {
+
+        glm::mat4 getNodeLocalMatrix(const glTFNode& node)
+        {
+            if (node.hasMatrix) {
+                return node.matrix;
+            }
+            glm::mat4 transformMatrix = glm::translate(glm::mat4(1.0f), node.translation);
+            transformMatrix = transformMatrix * glm::mat4_cast(node.rotation);
+            return glm::scale(transformMatrix, node.scale);
+        }
+
+        // Clips override translation, rotation and scale separately, so a node given as a matrix is split into TRS
+        JointPose getNodePose(const glTFNode& node)
+        {
+            JointPose pose;
+            if (!node.hasMatrix) {
+                pose.translation = node.translation;
+                pose.rotation = node.rotation;
+                pose.scale = node.scale;
+                return pose;
+            }
+
+            const glm::mat4& m = node.matrix;
+            glm::vec3 axes[3] = { glm::vec3(m[0]), glm::vec3(m[1]), glm::vec3(m[2]) };
+            pose.translation = glm::vec3(m[3]);
+            pose.scale = glm::vec3(glm::length(axes[0]), glm::length(axes[1]), glm::length(axes[2]));
+            if (glm::dot(glm::cross(axes[0], axes[1]), axes[2]) < 0.0f) {
+                pose.scale.x = -pose.scale.x;
+            }
+
+            glm::mat3 rotation(1.0f);
+            for (int i = 0; i < 3; i++) {
+                if (pose.scale[i] != 0.0f) {
+                    rotation[i] = axes[i] / pose.scale[i];
+                }
+            }
+            pose.rotation = glm::normalize(glm::quat_cast(rotation));
+            return pose;
+        }
+
+    }
+
+    void glTF2Loader::processSkins()
+    {
+        RAPTURE_PROFILE_FUNCTION();
+
+        // glTF only stores children, the skeletons need the parent of every node
+        std::vector<int32_t> nodeParents(m_nodes.size(), -1);
+        for (size_t nodeIndex = 0; nodeIndex < m_nodes.size(); nodeIndex++) {
+            for (uint32_t child : m_nodes[nodeIndex].children) {
+                if (child < m_nodes.size()) {
+                    nodeParents[child] = static_cast<int32_t>(nodeIndex);
+                }
+            }
+        }
+
+        std::vector<bool> isJointNode(m_nodes.size(), false);
+        std::vector<Entity> animators(m_skins.size());
+
+        for (size_t skinIndex = 0; skinIndex < m_skins.size(); skinIndex++) {
+            if (isCancelled()) {
+                return;
+            }
+
+            const glTFSkin& skin = m_skins[skinIndex];
+            std::vector<int32_t> jointOfNode(m_nodes.size(), -1);
+            bool jointsValid = !skin.joints.empty();
+            for (size_t joint = 0; joint < skin.joints.size() && jointsValid; joint++) {
+                jointsValid = skin.joints[joint] < m_nodes.size();
+                if (jointsValid) {
+                    jointOfNode[skin.joints[joint]] = static_cast<int32_t>(joint);
+                    isJointNode[skin.joints[joint]] = true;
+                }
+            }
+            if (!jointsValid) {
+                GE_CORE_WARN("glTF2Loader: Skin {} has no valid joints, its meshes stay in the bind pose", skinIndex);
+                continue;
+            }
+
+            std::shared_ptr<Skeleton> skeleton = buildSkeleton(skin, nodeParents, jointOfNode);
+            if (!skeleton) {
+                continue;
+            }
+            if (skeleton->name.empty()) {
+                skeleton->name = "Skin_" + std::to_string(skinIndex);
+            }
+
+            std::vector<std::shared_ptr<const AnimationClip>> clips;
+            size_t rawBytes = 0;
+            size_t clipBytes = 0;
+            for (size_t animationIndex = 0; animationIndex < m_animations.size(); animationIndex++) {
+                if (std::shared_ptr<AnimationClip> clip = buildClip(m_animations[animationIndex], animationIndex, *skeleton, jointOfNode, rawBytes)) {
+                    clipBytes += clip->getMemoryUsage();
+                    clips.push_back(std::move(clip));
+                }
+            }
+            if (m_animationCompression.enabled && clipBytes > 0) {
+                GE_CORE_INFO("glTF2Loader: Compressed the clips of skin '{}' from {} to {} bytes ({:.1f}x)", skeleton->name,
+                    rawBytes, clipBytes, static_cast<float>(rawBytes) / static_cast<float>(clipBytes));
+            }
+
+            // One animator per skin, moving it moves the whole skinned model
+            Entity animatorEntity = m_scene->createEntity("Skeleton_" + skeleton->name);
+            animatorEntity.addComponent<EntityNodeComponent>(animatorEntity);
+            animatorEntity.addComponent<TransformComponent>();
+            animatorEntity.addComponent<AnimatorComponent>(skeleton, std::move(clips));
+            m_createdEntities.push_back(animatorEntity);
+            animators[skinIndex] = animatorEntity;
+
+            GE_CORE_INFO("glTF2Loader: Skin '{}' with {} joints and {} animation clips", skeleton->name,
+                skeleton->getJointCount(), animatorEntity.getComponent<AnimatorComponent>().clips.size());
+        }
+
+        for (auto& [entity, skinIndex] : m_skinnedEntities) {
+            if (animators[skinIndex].isValid()) {
+                entity.getComponent<SkinComponent>().animator = static_cast<entt::entity>(animators[skinIndex].getID());
+            }
+        }
+
+        // Rigid node animation has no player yet, say so instead of silently dropping it
+        size_t skippedChannels = 0;
+        for (const glTFAnimation& animation : m_animations) {
+            for (const glTFAnimationChannel& channel : animation.channels) {
+                bool targetsJoint = channel.node >= 0 && (size_t)channel.node < m_nodes.size() && isJointNode[channel.node];
+                if (!targetsJoint && channel.path != "weights") {
+                    skippedChannels++;
+                }
+            }
+        }
+        if (skippedChannels > 0) {
+            GE_CORE_WARN("glTF2Loader: Skipped {} animation channels that target nodes outside any skin", skippedChannels);
+        }
+    }
+
+    std::shared_ptr<Skeleton> glTF2Loader::buildSkeleton(const glTFSkin& skin, const std::vector<int32_t>& nodeParents, const std::vector<int32_t>& jointOfNode)
+    {
+        size_t jointCount = skin.joints.size();
+        if (jointCount == 0) {
+            return nullptr;
+        }
+
+        auto skeleton = std::make_shared<Skeleton>();
+        skeleton->name = skin.name;
+        skeleton->jointNames.resize(jointCount);
+        skeleton->parents.assign(jointCount, -1);
+        skeleton->restPose.resize(jointCount);
+        skeleton->inverseBindMatrices.assign(jointCount, glm::mat4(1.0f));
+        skeleton->rootTransforms.assign(jointCount, glm::mat4(1.0f));
+
+        bool hasIntermediateNodes = false;
+        for (size_t joint = 0; joint < jointCount; joint++) {
+            const glTFNode& node = m_nodes[skin.joints[joint]];
+            skeleton->jointNames[joint] = node.name;
+            skeleton->restPose[joint] = getNodePose(node);
+
+            // Walk up to the nearest joint, collecting the static transforms of plain nodes on the way.
+            // The walk is bounded by the node count, so a malformed cyclic hierarchy can't hang the import
+            glm::mat4 above(1.0f);
+            int32_t ancestor = nodeParents[skin.joints[joint]];
+            for (size_t steps = 0; ancestor >= 0 && jointOfNode[ancestor] < 0 && steps < m_nodes.size(); steps++) {
+                above = getNodeLocalMatrix(m_nodes[ancestor]) * above;
+                ancestor = nodeParents[ancestor];
+            }
+
+            if (ancestor >= 0 && jointOfNode[ancestor] >= 0) {
+                skeleton->parents[joint] = jointOfNode[ancestor];
+                hasIntermediateNodes |= above != glm::mat4(1.0f);
+            }
+            else {
+                skeleton->rootTransforms[joint] = above;
+            }
+        }
+        if (hasIntermediateNodes) {
+            GE_CORE_WARN("glTF2Loader: Skin '{}' has plain nodes between joints, their transforms are ignored", skin.name);
+        }
+
+        // Parents first, so every joint's model space matrix is ready before its children need it
+        std::vector<uint32_t> depths(jointCount, 0);
+        for (size_t joint = 0; joint < jointCount; joint++) {
+            int32_t parent = skeleton->parents[joint];
+            for (size_t steps = 0; parent >= 0 && steps < jointCount; steps++) {
+                depths[joint]++;
+                parent = skeleton->parents[parent];
+            }
+            if (parent >= 0) {
+                GE_CORE_ERROR("glTF2Loader: Skin '{}' has a cyclic joint hierarchy", skin.name);
+                return nullptr;
+            }
+        }
+        skeleton->evaluationOrder.resize(jointCount);
+        for (size_t joint = 0; joint < jointCount; joint++) {
+            skeleton->evaluationOrder[joint] = static_cast<uint32_t>(joint);
+        }
+        std::stable_sort(skeleton->evaluationOrder.begin(), skeleton->evaluationOrder.end(),
+            [&depths](uint32_t a, uint32_t b) { return depths[a] < depths[b]; });
+
+        // Without inverse bind matrices the spec says they are identity
+        if (skin.inverseBindMatrices >= 0) {
+            std::vector<float> matrices;
+            if (readAccessorFloats(skin.inverseBindMatrices, matrices) && matrices.size() >= jointCount * 16) {
+                for (size_t joint = 0; joint < jointCount; joint++) {
+                    skeleton->inverseBindMatrices[joint] = glm::make_mat4(matrices.data() + joint * 16);
+                }
+            }
+            else {
+                GE_CORE_WARN("glTF2Loader: Skin '{}' has invalid inverse bind matrices, using identity", skin.name);
+            }
+        }
+
+        return skeleton;
+    }
+
+    std::shared_ptr<AnimationClip> glTF2Loader::buildClip(const glTFAnimation& animation, size_t animationIndex, const Skeleton& skeleton,
+        const std::vector<int32_t>& jointOfNode, size_t& rawBytes)
+    {
+        std::string clipName = animation.name.empty() ? "Animation_" + std::to_string(animationIndex) : animation.name;
+
+        std::vector<AnimationChannel> channels;
+        for (const glTFAnimationChannel& channel : animation.channels) {
+            if (channel.node < 0 || (size_t)channel.node >= jointOfNode.size() || jointOfNode[channel.node] < 0) {
+                continue;
+            }
+            if (channel.sampler >= animation.samplers.size()) {
+                GE_CORE_WARN("glTF2Loader: Animation '{}' references missing sampler {}", clipName, channel.sampler);
+                continue;
+            }
+
+            AnimationChannel clipChannel;
+            clipChannel.joint = static_cast<uint32_t>(jointOfNode[channel.node]);
+            if (channel.path == "translation") clipChannel.path = AnimationPath::Translation;
+            else if (channel.path == "rotation") clipChannel.path = AnimationPath::Rotation;
+            else if (channel.path == "scale") clipChannel.path = AnimationPath::Scale;
+            else continue;
+
+            const glTFAnimationSampler& sampler = animation.samplers[channel.sampler];
+            if (sampler.interpolation == "STEP") clipChannel.interpolation = AnimationInterpolation::Step;
+            else if (sampler.interpolation == "CUBICSPLINE") clipChannel.interpolation = AnimationInterpolation::CubicSpline;
+            else clipChannel.interpolation = AnimationInterpolation::Linear;
+
+            // Quantized keys (normalized shorts for rotations, say) come out as floats here
+            if (!readAccessorFloats(sampler.input, clipChannel.times) || !readAccessorFloats(sampler.output, clipChannel.values)) {
+                GE_CORE_WARN("glTF2Loader: Animation '{}' has an unreadable channel, skipping it", clipName);
+                continue;
+            }
+
+            size_t valuesPerKey = clipChannel.getComponentCount() * (clipChannel.interpolation == AnimationInterpolation::CubicSpline ? 3 : 1);
+            if (clipChannel.times.empty() || clipChannel.values.size() != clipChannel.times.size() * valuesPerKey) {
+                GE_CORE_WARN("glTF2Loader: Animation '{}' has a channel whose keys and values don't match, skipping it", clipName);
+                continue;
+            }
+
+            channels.push_back(std::move(clipChannel));
+        }
+
+        if (channels.empty()) {
+            return nullptr;
+        }
+        rawBytes += AnimationCompression::getRawSize(channels);
+        if (!m_animationCompression.enabled) {
+            return std::make_shared<AnimationClip>(clipName, std::move(channels));
+        }
+        return std::make_shared<AnimationClip>(clipName, AnimationCompression::compress(channels, skeleton, m_animationCompression));
+    }
+
+    bool glTF2Loader::readAccessorFloats(int32_t accessorIndex, std::vector<float>& data)
+    {
+        data.clear();
+        if (accessorIndex < 0 || (size_t)accessorIndex >= m_accessors.size()) {
+            return false;
+        }
+
+        const glTFAccessor& accessor = m_accessors[accessorIndex];
+        size_t components = getComponentCount(accessor.type);
+        data.assign((size_t)accessor.count * components, 0.0f);
+
+        if (accessor.count == 0) {
+            return true;
+        }
+
+        size_t componentBytes = getComponentSize(accessor.componentType);
+
+        // Accessors without a buffer view start out as all zeros
+        if (accessor.bufferView >= 0) {
+            size_t elementBytes = 0;
+            size_t stride = 0;
+            const unsigned char* src = getAccessorView(accessor, elementBytes, stride);
+            if (!src) {
+                data.clear();
+                return false;
+            }
+
+            for (size_t i = 0; i < accessor.count; i++) {
+                const unsigned char* element = src + i * stride;
+                for (size_t c = 0; c < components; c++) {
+                    data[i * components + c] = readComponentAsFloat(element + c * componentBytes, accessor.componentType, accessor.normalized);
+                }
+            }
+        }
+
+        // Sparse elements override the dense ones, morph targets are often stored this way
+        if (accessor.sparseCount > 0) {
+            size_t indicesSize = 0;
+            size_t valuesSize = 0;
+            const unsigned char* indices = getBufferViewData(accessor.sparseIndicesView, indicesSize);
+            const unsigned char* values = getBufferViewData(accessor.sparseValuesView, valuesSize);
+            size_t indexBytes = getComponentSize(accessor.sparseIndicesComponentType);
+            size_t valueBytes = components * componentBytes;
+
+            if (!indices || !values ||
+                accessor.sparseIndicesOffset + (size_t)accessor.sparseCount * indexBytes > indicesSize ||
+                accessor.sparseValuesOffset + (size_t)accessor.sparseCount * valueBytes > valuesSize) {
+                GE_CORE_ERROR("glTF2Loader: Sparse accessor {} is out of bounds", accessorIndex);
+                data.clear();
+                return false;
+            }
+
+            indices += accessor.sparseIndicesOffset;
+            values += accessor.sparseValuesOffset;
+            for (size_t i = 0; i < accessor.sparseCount; i++) {
+                uint32_t index = 0;
+                switch (accessor.sparseIndicesComponentType) {
+                case GLTF_UBYTE:  index = indices[i]; break;
+                case GLTF_USHORT: { uint16_t v; std::memcpy(&v, indices + i * 2, 2); index = v; break; }
+                default:          std::memcpy(&index, indices + i * 4, 4); break;
+                }
+                if (index >= accessor.count) {
+                    continue;
+                }
+
+                for (size_t c = 0; c < components; c++) {
+                    data[index * components + c] = readComponentAsFloat(values + i * valueBytes + c * componentBytes, accessor.componentType, accessor.normalized);
+                }
+            }
+        }
+        return true;
+    }
+
+    const unsigned char* glTF2Loader::getBufferViewData(int32_t viewIndex, size_t& viewSize)
+    {
+        viewSize = 0;
+        if (viewIndex < 0 || (size_t)viewIndex >= m_bufferViews.size()) {
+            return nullptr;
+        }
+
+        const glTFBufferView& view = m_bufferViews[viewIndex];
+        if (view.isCompressed) {
+            const std::vector<unsigned char>& decompressed = m_decompressedViews[viewIndex];
+            viewSize = decompressed.size();
+            return decompressed.empty() ? nullptr : decompressed.data();
+        }
+
+        const BufferData* buffer = resolveBuffer(view.buffer);
+        if (!buffer || view.byteOffset + view.byteLength > buffer->size) {
+            return nullptr;
+        }
+        viewSize = view.byteLength;
+        return buffer->data + view.byteOffset;
+    }
+
+    std::shared_ptr<MorphTargetSet> glTF2Loader::decodeMorphTargets(const glTFPrimitive& primitive, uint32_t vertexCount, DecodeScratch& scratch)
+    {
+        auto set = std::make_shared<MorphTargetSet>();
+        set->vertexCount = vertexCount;
+        set->targets.reserve(primitive.targets.size());
+
+        std::vector<float>& positions = scratch.positions;
+        std::vector<float>& normals = scratch.normals;
+        for (size_t targetIndex = 0; targetIndex < primitive.targets.size(); targetIndex++) {
+            positions.clear();
+            normals.clear();
+            for (const auto& [semantic, accessorIdx] : primitive.targets[targetIndex]) {
+                // Tangent deltas have nothing to apply to, the shaders don't read tangents
+                if (semantic == VertexAttributeSemantic::Position) {
+                    readAccessorFloats(accessorIdx, positions);
+                }
+                else if (semantic == VertexAttributeSemantic::Normal) {
+                    readAccessorFloats(accessorIdx, normals);
+                }
+            }
+
+            // A target whose accessors don't line up with the vertices still takes its slot, so the weights keep their indices
+            bool hasPositions = positions.size() == (size_t)vertexCount * 3;
+            bool hasNormals = normals.size() == (size_t)vertexCount * 3;
+            if (!hasPositions && !positions.empty()) {
+                GE_CORE_WARN("glTF2Loader: Morph target {} has {} position deltas for {} vertices, ignoring them", targetIndex, positions.size() / 3, vertexCount);
+            }
+
+            MorphTarget& target = set->targets.emplace_back();
+            target.name = targetIndex < primitive.targetNames.size() ? primitive.targetNames[targetIndex] : "Target_" + std::to_string(targetIndex);
+            target.firstEntry = static_cast<uint32_t>(set->vertices.size());
+
+            for (uint32_t vertex = 0; vertex < vertexCount; vertex++) {
+                glm::vec3 position = hasPositions ? glm::make_vec3(positions.data() + vertex * 3) : glm::vec3(0.0f);
+                glm::vec3 normal = hasNormals ? glm::make_vec3(normals.data() + vertex * 3) : glm::vec3(0.0f);
+                glm::vec3 largest = glm::max(glm::abs(position), glm::abs(normal));
+                if (std::max(largest.x, std::max(largest.y, largest.z)) <= MORPH_DELTA_EPSILON) {
+                    continue;
+                }
+
+                set->vertices.push_back(vertex);
+                set->deltas.emplace_back(position, 0.0f);
+                set->deltas.emplace_back(normal, 0.0f);
+            }
+            target.entryCount = static_cast<uint32_t>(set->vertices.size()) - target.firstEntry;
+        }
+
+        if (set->vertices.empty()) {
+            return nullptr;
+        }
+        return set;
+    }
+
+    void glTF2Loader::decodePrimitives()
+    {
+        RAPTURE_PROFILE_FUNCTION();
+
+        size_t jobCount = m_primitiveJobs.size();
+
+        // Count the primitives reading each view, so the view can go as soon as the last of them is decoded
+        m_viewUsers.assign(m_bufferViews.size(), 0);
+        std::vector<std::vector<size_t>> jobViews(jobCount);
+        std::vector<size_t> estimates(jobCount);
+        size_t totalEstimate = 0;
+        for (size_t i = 0; i < jobCount; i++) {
+            const glTFPrimitive& primitive = *m_primitiveJobs[i].primitive;
+            collectBufferViews(primitive, jobViews[i]);
+            for (size_t view : jobViews[i]) {
+                m_viewUsers[view]++;
+            }
+            estimates[i] = estimateStagingSize(primitive);
+            totalEstimate += estimates[i];
+        }
+
+        // Views only the skins read are done with
+        for (size_t view = 0; view < m_bufferViews.size(); view++) {
+            if (m_viewUsers[view] == 0) {
+                releaseBufferView(view);
+            }
+        }
+
+        if (m_bakeEnabled && totalEstimate > m_memoryBudget) {
+            GE_CORE_INFO("glTF2Loader: Not caching, the decoded model ({:.1f} MB) doesn't fit the import budget ({:.1f} MB)",
+                totalEstimate / 1048576.0, m_memoryBudget / 1048576.0);
+            m_bakeEnabled = false;
+        }
+
+        size_t batchStart = 0;
+        while (batchStart < jobCount && !isCancelled()) {
+            // At least one primitive per batch, even if it is larger than the whole budget
+            size_t batchEnd = batchStart;
+            size_t batchBytes = 0;
+            while (batchEnd < jobCount && (batchEnd == batchStart || batchBytes + estimates[batchEnd] <= m_memoryBudget)) {
+                batchBytes += estimates[batchEnd++];
+            }
+
+            // Whatever earlier batches still have waiting in the upload queue counts against the budget too
+            BufferUploadQueue::waitForPendingBytes(batchBytes < m_memoryBudget ? m_memoryBudget - batchBytes : 0,
+                [this]() { return isCancelled(); });
+
+            std::vector<size_t> batchViews;
+            for (size_t i = batchStart; i < batchEnd; i++) {
+                batchViews.insert(batchViews.end(), jobViews[i].begin(), jobViews[i].end());
+            }
+            if (!decompressBufferViews(batchViews)) {
+                GE_CORE_WARN("glTF2Loader: Some compressed buffer views couldn't be decoded, primitives using them are skipped");
+            }
+
+            // Normal priority, a thread waiting on the batch helps with other loads' batches but never starts a whole load
+            JobSystem::parallelFor(batchEnd - batchStart, [this, batchStart](size_t i) {
+                // Once cancelled the remaining jobs are only claimed and dropped, so the workers wind down quickly
+                if (isCancelled()) {
+                    return;
+                }
+
+                PrimitiveDecodeJob& job = m_primitiveJobs[batchStart + i];
+                // Stays invalid if decoding throws
+                thread_local DecodeScratch scratch;
+                job.decoded.isValid = decodePrimitive(*job.primitive, job.decoded, scratch);
+
+                const DecodedPrimitive& decoded = job.decoded;
+                size_t decodedBytes = decoded.vertexData.size() + decoded.positionData.size() + decoded.indexData.size();
+                trackStagingBytes(static_cast<int64_t>(decodedBytes));
+
+                if (m_progress) {
+                    m_progress->bytesDecoded += decodedBytes;
+                    m_progress->primitivesDecoded++;
+                    reportProgress();
+                }
+            }, JobPriority::Normal);
+
+            for (size_t i = batchStart; i < batchEnd; i++) {
+                for (size_t view : jobViews[i]) {
+                    if (--m_viewUsers[view] == 0) {
+                        releaseBufferView(view);
+                    }
+                }
+            }
+
+            if (!m_bakeEnabled && !isCancelled()) {
+                for (size_t i = batchStart; i < batchEnd; i++) {
+                    finalizePrimitive(m_primitiveJobs[i]);
+                }
+            }
+
+            m_memoryStats.batchCount++;
+            batchStart = batchEnd;
+        }
+    }
+
+    void glTF2Loader::collectAccessorViews(int32_t accessorIndex, std::vector<size_t>& viewIndices) const
+    {
+        if (accessorIndex < 0 || (size_t)accessorIndex >= m_accessors.size()) {
+            return;
+        }
 
+        const glTFAccessor& accessor = m_accessors[accessorIndex];
+        for (int32_t view : { accessor.bufferView, accessor.sparseCount > 0 ? accessor.sparseIndicesView : -1, accessor.sparseCount > 0 ? accessor.sparseValuesView : -1 }) {
+            if (view >= 0 && (size_t)view < m_bufferViews.size()) {
+                viewIndices.push_back(static_cast<size_t>(view));
+            }
+        }
+    }
 
-            // Add the component with the full transform matrix
-            transformComp.transforms.setTransform(transformMatrix);
-            
+    void glTF2Loader::collectBufferViews(const glTFPrimitive& primitive, std::vector<size_t>& viewIndices) const
+    {
+        // Same attributes decodePrimitive and decodeMorphTargets read
+        for (const auto& [semantic, accessorIdx] : primitive.attributes) {
+            if (semantic != VertexAttributeSemantic::Color0 && semantic != VertexAttributeSemantic::Unknown) {
+                collectAccessorViews(static_cast<int32_t>(accessorIdx), viewIndices);
+            }
         }
-        
-        // If this node has a mesh, process it
-        if (nodeJSON.contains("mesh")) {
-            unsigned int meshIndex = nodeJSON["mesh"];
-            if (meshIndex < m_meshes.size()) {
-                processMesh(nodeEntity, m_meshes[meshIndex]);
+        collectAccessorViews(primitive.indices, viewIndices);
+        for (const auto& target : primitive.targets) {
+            for (const auto& [semantic, accessorIdx] : target) {
+                if (semantic == VertexAttributeSemantic::Position || semantic == VertexAttributeSemantic::Normal) {
+                    collectAccessorViews(static_cast<int32_t>(accessorIdx), viewIndices);
+                }
             }
         }
-        
-        // Process children
-        if (nodeJSON.contains("children")) {
-            for (auto& childIdx : nodeJSON["children"]) {
-                unsigned int childIndex = childIdx.get<unsigned int>();
-                if (childIndex < m_nodes.size()) {
-                    Entity childEntity = m_scene->createEntity("Child Node");
-                    childEntity.addComponent<EntityNodeComponent>(childEntity, nodeEntity.getComponent<EntityNodeComponent>().entity_node);
 
-                    nodeEntity.getComponent<EntityNodeComponent>().entity_node->addChild(childEntity.getComponent<EntityNodeComponent>().entity_node);
-
-                    processNode(childEntity, m_nodes[childIndex]);
+        std::sort(viewIndices.begin(), viewIndices.end());
+        viewIndices.erase(std::unique(viewIndices.begin(), viewIndices.end()), viewIndices.end());
+    }
 
-                    // Establish parent-child relationship
-                    if (!childEntity.hasComponent<EntityNodeComponent>()) {
-                        GE_CORE_ERROR("Child entity '{}' missing EntityNodeComponent", childIndex);
-                        continue;
-                    }
-                    
-                    if (!nodeEntity.hasComponent<EntityNodeComponent>()) {
-                        GE_CORE_ERROR("Node entity '{}' missing EntityNodeComponent", nodeName);
-                        continue;
-                    }
-                    
+    size_t glTF2Loader::estimateStagingSize(const glTFPrimitive& primitive) const
+    {
+        // Interleaved slots are padded to 4 bytes, indices are counted before narrowing
+        size_t bytes = 0;
+        for (const auto& [semantic, accessorIdx] : primitive.attributes) {
+            if (semantic == VertexAttributeSemantic::Color0 || semantic == VertexAttributeSemantic::Unknown || accessorIdx >= m_accessors.size()) {
+                continue;
+            }
+            const glTFAccessor& accessor = m_accessors[accessorIdx];
+            size_t elementBytes = getComponentCount(accessor.type) * getComponentSize(accessor.componentType);
+            bytes += (size_t)accessor.count * ((elementBytes + 3) & ~(size_t)3);
+        }
+        if (primitive.indices >= 0 && (size_t)primitive.indices < m_accessors.size()) {
+            const glTFAccessor& accessor = m_accessors[primitive.indices];
+            bytes += (size_t)accessor.count * getComponentSize(accessor.componentType);
+        }
+        return bytes;
+    }
 
-                }
+    void glTF2Loader::releaseBufferView(size_t viewIndex)
+    {
+        // Only called between batches, nothing decodes concurrently
+        auto evict = [this](size_t bufferIndex, size_t offset, size_t length) {
+            if (bufferIndex >= m_bufferData.size()) {
+                return;
+            }
+            const BufferData& buffer = m_bufferData[bufferIndex];
+            if (!buffer.isResolved || !buffer.data || offset + length > buffer.size) {
+                return;
             }
+            // Decoded data URIs have no file behind them, they stay until the load ends
+            const MappedFile& file = buffer.file.isOpen() ? buffer.file : m_glbFile;
+            file.evict(buffer.data + offset, length);
+        };
+
+        const glTFBufferView& view = m_bufferViews[viewIndex];
+        if (view.isCompressed) {
+            std::vector<unsigned char>& decompressed = m_decompressedViews[viewIndex];
+            m_decompressedBytes -= decompressed.size();
+            std::vector<unsigned char>().swap(decompressed);
+            evict(view.compressedBuffer, view.compressedOffset, view.compressedLength);
+        }
+        else {
+            evict(view.buffer, view.byteOffset, view.byteLength);
         }
-        
-        return nodeEntity;
     }
 
-    Entity glTF2Loader::processMesh(Entity parent, json& meshJSON)
+    void glTF2Loader::trackStagingBytes(int64_t delta)
     {
-        auto& parentTransform = parent.getComponent<TransformComponent>();
+        size_t staged = m_stagingBytes.fetch_add(static_cast<size_t>(delta)) + static_cast<size_t>(delta);
 
+        size_t total = staged + BufferUploadQueue::getPendingUploadBytes();
+        size_t peak = m_peakStagingBytes.load();
+        while (total > peak && !m_peakStagingBytes.compare_exchange_weak(peak, total)) {
+        }
+    }
 
-        std::string meshName = meshJSON.value("name", "Mesh");
-        Entity meshEntity = m_scene->createEntity(meshName);
-        // Create transform component that inherits parent transform
-        meshEntity.addComponent<TransformComponent>(parentTransform.transformMatrix());
-        
-        
-        // Check if parent entity has EntityNodeComponent
-        if (!parent.hasComponent<EntityNodeComponent>()) {
-            GE_CORE_ERROR("Parent entity '{}' missing EntityNodeComponent", meshName);
-            return meshEntity;
+    bool glTF2Loader::decompressBufferViews(const std::vector<size_t>& viewIndices)
+    {
+        RAPTURE_PROFILE_FUNCTION();
+
+        std::vector<size_t> compressedViews;
+        for (size_t viewIndex : viewIndices) {
+            if (viewIndex < m_bufferViews.size() && m_bufferViews[viewIndex].isCompressed && !m_isViewDecompressed[viewIndex]) {
+                m_isViewDecompressed[viewIndex] = 1;
+                compressedViews.push_back(viewIndex);
+            }
         }
-        
-        meshEntity.addComponent<EntityNodeComponent>(meshEntity, parent.getComponent<EntityNodeComponent>().entity_node);
-        
-        // Check if mesh entity has EntityNodeComponent after adding it
-        if (!meshEntity.hasComponent<EntityNodeComponent>()) {
-            GE_CORE_ERROR("Mesh entity '{}' failed to add EntityNodeComponent", meshName);
-            return meshEntity;
+        if (compressedViews.empty()) {
+            return true;
         }
-        
-        std::shared_ptr<EntityNode> mesh_entity_node = meshEntity.getComponent<EntityNodeComponent>().entity_node;
-        
-        parent.getComponent<EntityNodeComponent>().entity_node->addChild(mesh_entity_node);
-    
-        // Process primitives
-        if (meshJSON.contains("primitives") && !meshJSON["primitives"].empty()) {
-            int primitiveIndex = 0;
-            for (auto& primitive : meshJSON["primitives"]) {
-                // For each primitive, create a new entity
-                Entity primitiveEntity = m_scene->createEntity("_Primitive_" + std::to_string(primitiveIndex) + "_" + meshName);
-                primitiveEntity.addComponent<EntityNodeComponent>(primitiveEntity, mesh_entity_node);
-                mesh_entity_node->addChild(primitiveEntity.getComponent<EntityNodeComponent>().entity_node);
 
-                primitiveEntity.addComponent<TransformComponent>(parentTransform.transformMatrix());
+        // Views that fail to decode stay empty, and every accessor into them reports an error
+        JobSystem::parallelFor(compressedViews.size(), [this, &compressedViews](size_t i) {
+            if (isCancelled()) {
+                return;
+            }
 
-                // Process the primitive data
-                processPrimitive(primitiveEntity, primitive);
-                primitiveIndex++;
+            size_t viewIndex = compressedViews[i];
+            const glTFBufferView& view = m_bufferViews[viewIndex];
+
+            const BufferData* buffer = resolveBuffer(view.compressedBuffer);
+            if (!buffer) {
+                return;
+            }
+            if (view.compressedOffset + view.compressedLength > buffer->size) {
+                GE_CORE_ERROR("glTF2Loader: Compressed buffer view {} reaches past the end of buffer {}", viewIndex, view.compressedBuffer);
+                return;
+            }
+
+            std::vector<unsigned char> decoded((size_t)view.compressedCount * view.byteStride);
+            if (!MeshoptDecoder::decode(view.compressionMode, view.compressionFilter, decoded.data(), view.compressedCount,
+                view.byteStride, buffer->data + view.compressedOffset, view.compressedLength)) {
+                GE_CORE_ERROR("glTF2Loader: Failed to decode compressed buffer view {}", viewIndex);
+                return;
+            }
+
+            if (m_progress) {
+                m_progress->bytesDecoded += decoded.size();
+            }
+            m_decompressedViews[viewIndex] = std::move(decoded);
+        }, JobPriority::Normal);
+
+        bool allDecoded = true;
+        size_t decompressedBytes = 0;
+        for (size_t viewIndex : compressedViews) {
+            decompressedBytes += m_decompressedViews[viewIndex].size();
+            if (m_decompressedViews[viewIndex].empty() && m_bufferViews[viewIndex].compressedCount > 0) {
+                allDecoded = false;
             }
         }
-        
-        return meshEntity;
+
+        size_t inUse = m_decompressedBytes += decompressedBytes;
+        m_peakDecompressedBytes = std::max<size_t>(m_peakDecompressedBytes, inUse);
+        return allDecoded;
     }
 
-    void glTF2Loader::processPrimitive(Entity entity, json& primitive)
+    bool glTF2Loader::decodePrimitive(const glTFPrimitive& primitive, DecodedPrimitive& decoded, DecodeScratch& scratch)
     {
-        // Add mesh component to the entity
-        entity.addComponent<MeshComponent>(true);
-        entity.addComponent<MaterialComponent>();
-        
-        // Check if entity has MeshComponent before accessing it
-        if (!entity.hasComponent<MeshComponent>()) {
-            GE_CORE_ERROR("Entity missing MeshComponent");
-            return;
-        }
-        auto& meshComp = entity.getComponent<MeshComponent>();
+        RAPTURE_PROFILE_FUNCTION();
 
         BufferLayout bufferLayout;
         
-        // Gather attribute data and calculate attribute sizes
-        std::vector<std::pair<std::string, std::vector<unsigned char>>> attributeData;
+        // Where each attribute lives in its source buffer view, nothing is copied until the final pass
+        struct AttributeSource {
+            VertexAttributeSemantic semantic;
+            const glTFAccessor* accessor;
+            const unsigned char* data;
+            size_t stride;
+            size_t size;
+        };
+        std::vector<AttributeSource> attributeSources;
         
-        std::vector<unsigned char> temp_indexData;
-        unsigned int temp_indCount = 0;
-        unsigned int temp_compType = 0;
         unsigned int vertexCount = 0;
 
-        // Process vertex attributes
-        if (primitive.contains("attributes")) {
-            json& attribs = primitive["attributes"];
+        // First pass: locate the source data and determine vertex count
+        for (const auto& [semantic, accessorIdx] : primitive.attributes) {
+            // Skip color data for now, and anything the shaders have no location for
+            if (semantic == VertexAttributeSemantic::Color0 || semantic == VertexAttributeSemantic::Unknown) continue;
             
-            // First pass: gather data and determine vertex count
-            for (auto& attrib : attribs.items()) {
-                std::string name = attrib.key();
-                if (name == "COLOR_0") continue; // Skip color data for now
-                
-                unsigned int accessorIdx = attrib.value();
-                json& accessor = m_accessors[accessorIdx];
-                
-                // Get vertex count from the first attribute (should be the same for all attributes)
-                if (vertexCount == 0 && accessor.contains("count")) {
-                    vertexCount = accessor["count"];
-                }
-                
-                // Load attribute data
-                std::vector<unsigned char> attrData;
-                loadAccessor(m_accessors[accessorIdx], attrData);
-                
-                if (!attrData.empty()) {
-                    attributeData.push_back({name, attrData});
-                }
+            if (accessorIdx >= m_accessors.size()) {
+                GE_CORE_ERROR("glTF2Loader: Accessor index out of range: {}", accessorIdx);
+                continue;
+            }
+            const glTFAccessor& accessor = m_accessors[accessorIdx];
+            
+            // Get vertex count from the first attribute, every other attribute must match it
+            if (vertexCount == 0) {
+                vertexCount = accessor.count;
+            }
+            else if (accessor.count != vertexCount) {
+                GE_CORE_ERROR("glTF2Loader: Attribute {} has {} elements, expected {}", semanticToString(semantic), accessor.count, vertexCount);
+                continue;
+            }
+            
+            AttributeSource source{ semantic, &accessor, nullptr, 0, 0 };
+            source.data = getAccessorView(accessor, source.size, source.stride);
+            
+            if (source.data) {
+                attributeSources.push_back(source);
             }
         }
 
         // Early exit if no vertex data
-        if (attributeData.empty() || vertexCount == 0) {
+        if (attributeSources.empty() || vertexCount == 0) {
             GE_CORE_ERROR("No vertex data found for primitive");
-            return;
+            return false;
+        }
+
+        // Positions get their own tightly packed stream when there is anything else to interleave,
+        // so position-only passes (depth, shadows, picking) don't fetch normals, uvs and tangents
+        size_t positionAttrIdx = attributeSources.size();
+        for (size_t i = 0; i < attributeSources.size(); i++) {
+            if (attributeSources[i].semantic == VertexAttributeSemantic::Position) {
+                positionAttrIdx = i;
+                break;
+            }
         }
+        bool foundPosition = positionAttrIdx < attributeSources.size();
+        bool splitPositionStream = foundPosition && attributeSources.size() > 1;
 
-        // Calculate attribute sizes and strides
+        // Calculate attribute offsets and the vertex stride. Quantized attributes (KHR_mesh_quantization) can be
+        // 2 or 6 bytes wide, so every slot is padded to 4 bytes to keep each attribute aligned for the GPU
+        auto alignedSize = [](size_t size) { return (size + 3) & ~(size_t)3; };
         size_t vertexStride = 0;
-        std::vector<size_t> attrSizes;
         std::vector<size_t> attrOffsets;
         
-        for (const auto& [name, data] : attributeData) {
-            size_t attrSize = data.size() / vertexCount;
-            attrSizes.push_back(attrSize);
+        for (size_t i = 0; i < attributeSources.size(); i++) {
+            if (splitPositionStream && i == positionAttrIdx) {
+                attrOffsets.push_back(0);
+                continue;
+            }
             attrOffsets.push_back(vertexStride);
-            vertexStride += attrSize;
+            vertexStride += alignedSize(attributeSources[i].size);
         }
         
         // Create buffer layout for interleaved data
-        size_t currentOffset = 0;
-        size_t positionOffset = 0;
-        bool foundPosition = false;
-        
-        for (size_t i = 0; i < attributeData.size(); i++) {
-            const auto& [name, data] = attributeData[i];
-            unsigned int accessorIdx = primitive["attributes"][name];
-            json& accessor = m_accessors[accessorIdx];
-            
-            unsigned int componentType = accessor["componentType"];
-            std::string type = accessor["type"];
+        for (size_t i = 0; i < attributeSources.size(); i++) {
+            const glTFAccessor& accessor = *attributeSources[i].accessor;
             
-            // For interleaved data, the offset is the relative position within a single vertex
-            bufferLayout.buffer_attribs.push_back({name, componentType, type, attrOffsets[i]});
-            
-            // Find position attribute and record its offset
-            if (name == "POSITION") {
-                positionOffset = attrOffsets[i] / sizeof(float);
-                foundPosition = true;
-            }
+            BufferAttribute attribute;
+            attribute.semantic = attributeSources[i].semantic;
+            attribute.componentType = accessor.componentType;
+            attribute.type = accessor.type;
+            attribute.normalized = accessor.normalized;
+            // For interleaved data, the offset is the relative position within a single vertex (or its own stream)
+            attribute.offset = attrOffsets[i];
+            bufferLayout.addAttribute(attribute);
         }
         
         // Set interleaved flag to true
-        bufferLayout.isInterleaved = true;
-        bufferLayout.vertexSize = vertexStride;
+        bufferLayout.setInterleaved(true);
+        bufferLayout.setVertexSize(vertexStride);
+        if (splitPositionStream) {
+            bufferLayout.setPositionStream(true, alignedSize(attributeSources[positionAttrIdx].size));
+        }
+        // Intern once here, so the pools only compare ids from now on
+        bufferLayout.intern();
         
         // Create vertex buffer with the correct size
-        size_t totalVertexDataSize = vertexCount * vertexStride;
-        
-        // Pre-allocate interleaved data with the exact known size
-        std::vector<unsigned char> interleavedData;
-        interleavedData.reserve(totalVertexDataSize);
-        interleavedData.resize(totalVertexDataSize);
-        
-        // Fill the interleaved buffer using direct memory access
-        for (unsigned int v = 0; v < vertexCount; v++) {
-            unsigned char* vertexDest = interleavedData.data() + (v * vertexStride);
-            for (size_t a = 0; a < attributeData.size(); a++) {
-                const auto& [name, data] = attributeData[a];
-                size_t attrSize = attrSizes[a];
-                const unsigned char* attrSrc = data.data() + (v * attrSize);
-                unsigned char* attrDest = vertexDest + attrOffsets[a];
-                
-                // Direct memory copy
-                std::memcpy(attrDest, attrSrc, attrSize);
+        size_t totalVertexDataSize = (size_t)vertexCount * vertexStride;
+        
+        // Staging memory for the upload queue, every byte is written exactly once below
+        std::vector<unsigned char> interleavedData(totalVertexDataSize);
+        std::vector<unsigned char> positionData;
+        if (splitPositionStream) {
+            positionData.resize((size_t)vertexCount * bufferLayout.getPositionStride());
+        }
+        
+        // Single pass straight from the source buffer views (often the mapped file) into staging,
+        // handling strided sources and destinations in one go
+        {
+            RAPTURE_PROFILE_SCOPE("Interleave Vertices");
+            for (size_t a = 0; a < attributeSources.size(); a++) {
+                const AttributeSource& source = attributeSources[a];
+                if (splitPositionStream && a == positionAttrIdx) {
+                    BufferConversionHelpers::copyStrided(positionData.data(), bufferLayout.getPositionStride(), source.data, source.stride, source.size, vertexCount);
+                }
+                else {
+                    BufferConversionHelpers::copyStrided(interleavedData.data() + attrOffsets[a], vertexStride, source.data, source.stride, source.size, vertexCount);
+                }
             }
         }
         
-        // Calculate bounding box from the interleaved vertex data if position data is available
-        BoundingBox localBoundingBox;
+        // Calculate bounding box from the vertex data if position data is available
+        BoundingBox& localBoundingBox = decoded.localBoundingBox;
         if (m_calculateBoundingBoxes && foundPosition) {
             RAPTURE_PROFILE_SCOPE("Calculate Bounding Box");
             
-            // Calculate bounding box directly from vertex data in RAM
-            size_t floatStride = vertexStride / sizeof(float);
-            localBoundingBox = BoundingBoxSystem::calculateFromVertexData(
-                interleavedData.data(), 
-                totalVertexDataSize, 
-                floatStride, 
-                positionOffset
+            // Read straight from the source view, dequantizing normalized or integer positions as needed
+            const AttributeSource& position = attributeSources[positionAttrIdx];
+            localBoundingBox = BoundingBoxSystem::calculateFromPositions(
+                position.data,
+                vertexCount,
+                position.stride,
+                position.accessor->componentType,
+                position.accessor->normalized
             );
             
             if (localBoundingBox.isValid()) {
@@ -479,48 +1844,125 @@ namespace Rapture {
         unsigned int compType = 0;
         unsigned int indCount = 0;
 
-        if (primitive.contains("indices")) {
-            unsigned int indicesIdx = primitive["indices"];
-            
-            // Pre-allocate index data to avoid reallocation
-            indexData.reserve(m_accessors[indicesIdx].value("count", 0) * 4); // Worst case: 4 bytes per index
-            
+        if (primitive.indices >= 0 && (size_t)primitive.indices < m_accessors.size()) {
+            const glTFAccessor& indexAccessor = m_accessors[primitive.indices];
+
             // Load index data
-            loadAccessor(m_accessors[indicesIdx], indexData);
-            
+            loadAccessor(indexAccessor, indexData);
+
             if (!indexData.empty()) {
                 // Get index component type
-                compType = m_accessors[indicesIdx]["componentType"];
-                indCount = m_accessors[indicesIdx]["count"];
+                compType = indexAccessor.componentType;
+                indCount = indexAccessor.count;
             }
         }
-        
-        {
-            RAPTURE_PROFILE_SCOPE("Set Mesh Data");
-            if (indexData.size() > 0) {
-                meshComp.mesh->setMeshData(bufferLayout, 
-                    interleavedData.data(), 
-                    totalVertexDataSize, 
-                    indexData.data(), 
-                    indexData.size(), 
-                    indCount, 
-                    compType);
-            } else {
-                GE_CORE_ERROR("glTF2Loader: Vertex data only not supported yet");
-                entity.removeComponent<MeshComponent>();
-                return;
+
+        if (indexData.empty()) {
+            GE_CORE_ERROR("glTF2Loader: Vertex data only not supported yet");
+            return false;
+        }
+
+        // Convert here rather than in the upload queue, so it runs on the decode threads too
+        BufferConversionHelpers::convertIndices(indexData, indCount, compType, BufferConversionHelpers::chooseIndexType(vertexCount));
+
+        if (!primitive.targets.empty()) {
+            RAPTURE_PROFILE_SCOPE("Decode Morph Targets");
+            decoded.morphTargets = decodeMorphTargets(primitive, vertexCount, scratch);
+        }
+
+        decoded.layout = std::move(bufferLayout);
+        decoded.vertexData = std::move(interleavedData);
+        decoded.positionData = std::move(positionData);
+        decoded.indexData = std::move(indexData);
+        decoded.indexCount = indCount;
+        decoded.indexType = compType;
+        return true;
+    }
+
+    void glTF2Loader::finalizePrimitive(PrimitiveDecodeJob& job)
+    {
+        RAPTURE_PROFILE_FUNCTION();
+
+        DecodedPrimitive& decoded = job.decoded;
+        if (!decoded.isValid) {
+            for (Entity& entity : job.entities) {
+                entity.tryRemoveComponent<MeshComponent>();
             }
+            return;
         }
-        
+
+        if (decoded.morphTargets) {
+            for (Entity& entity : job.entities) {
+                if (auto* morph = entity.tryGetComponent<MorphTargetComponent>()) {
+                    morph->targets = decoded.morphTargets;
+                    morph->weights.resize(decoded.morphTargets->getTargetCount(), 0.0f);
+                }
+            }
+        }
+
+        // Add the bounding box component if we calculated one
+        if (m_calculateBoundingBoxes && decoded.localBoundingBox.isValid()) {
+            for (Entity& entity : job.entities) {
+                BoundingBoxSystem::addBoundingBoxToEntity(entity, decoded.localBoundingBox);
+            }
+        }
+
+        {
+            RAPTURE_PROFILE_SCOPE("Queue Mesh Upload");
+            // From here on the upload queue accounts for the bytes
+            size_t decodedBytes = decoded.vertexData.size() + decoded.positionData.size() + decoded.indexData.size();
+
+            // The loader may run on a worker thread, so the data is handed to the GL thread instead of uploaded here
+            MeshUploadRequest uploadRequest;
+            uploadRequest.mesh = job.mesh;
+            uploadRequest.layout = std::move(decoded.layout);
+            uploadRequest.vertexData = std::move(decoded.vertexData);
+            uploadRequest.positionData = std::move(decoded.positionData);
+            uploadRequest.indexData = std::move(decoded.indexData);
+            uploadRequest.indexCount = decoded.indexCount;
+            uploadRequest.indexType = decoded.indexType;
+
+            enqueuePrimitiveUpload(std::move(uploadRequest), job.entities, m_prefab, m_stagingScene);
+            trackStagingBytes(-static_cast<int64_t>(decodedBytes));
+        }
+    }
+
+    void glTF2Loader::enqueuePrimitiveUpload(MeshUploadRequest&& uploadRequest, std::vector<Entity> entities, std::shared_ptr<ModelPrefab> prefab,
+        std::shared_ptr<StagingScene> staging)
+    {
+        // Every entity sharing this primitive waits on the same upload, and so do prefab copies made in the meantime
+        uploadRequest.callback = [entities = std::move(entities), prefab = std::move(prefab), staging = std::move(staging), mesh = uploadRequest.mesh](bool success) mutable {
+            if (staging) {
+                // The worker may still be building the staging registry, the result is applied to the live entities
+                staging->runWhenMerged([entities = std::move(entities), success](const StagingScene& merged) {
+                    for (const Entity& entity : entities) {
+                        applyUploadResult(merged.resolve(entity), success);
+                    }
+                });
+            }
+            else {
+                for (Entity& entity : entities) {
+                    applyUploadResult(entity, success);
+                }
+            }
+            if (prefab) {
+                prefab->onMeshUploaded(mesh, success);
+            }
+        };
+        BufferUploadQueue::enqueueMeshUpload(std::move(uploadRequest));
+    }
+
+    void glTF2Loader::assignPrimitiveMaterial(Entity entity, const glTFPrimitive& primitive)
+    {
         // Set material if present
-        if (primitive.contains("material")) {
-            unsigned int materialIdx = primitive["material"];
-            if (materialIdx < m_materials.size()) {
+        if (primitive.material >= 0) {
+            unsigned int materialIdx = primitive.material;
+            if (materialIdx < m_materials->size()) {
                 if (!entity.hasComponent<MaterialComponent>()) {
                     GE_CORE_WARN("Entity missing MaterialComponent for material index {}", materialIdx);
                 }
 
-                json& materialJSON = m_materials[materialIdx];
+                json& materialJSON = (*m_materials)[materialIdx];
                 
                 // Check if this material uses the KHR_materials_pbrSpecularGlossiness extension
                 bool hasSpecularGlossiness = false;
@@ -548,15 +1990,21 @@ namespace Rapture {
                 }
             }
         }
+    }
 
-        // Mark the mesh as loaded
-        meshComp.isLoading = false;
-        
-        // Add the bounding box component if we calculated one
-        if (m_calculateBoundingBoxes && localBoundingBox.isValid()) {
-            
-            BoundingBoxSystem::addBoundingBoxToEntity(entity, localBoundingBox);
-
+    void glTF2Loader::applyUploadResult(Entity entity, bool success)
+    {
+        if (!entity.isValid()) {
+            return;
+        }
+        if (!success) {
+            GE_CORE_ERROR("glTF2Loader: Mesh upload failed for entity {0}", entity.getID());
+            entity.tryRemoveComponent<MeshComponent>();
+            return;
+        }
+        // Mark the mesh as loaded, only now is it safe to draw
+        if (auto* uploadedMeshComp = entity.tryGetComponent<MeshComponent>()) {
+            uploadedMeshComp->isLoading = false;
         }
     }
 
@@ -779,43 +2227,15 @@ namespace Rapture {
         return material;
     }
 
-    void glTF2Loader::loadAccessor(json& accessorJSON, std::vector<unsigned char>& dataVec)
+    const unsigned char* glTF2Loader::getAccessorView(const glTFAccessor& accessor, size_t& elementBytes, size_t& stride)
     {
-        // Clear output vector
-        dataVec.clear();
-        
-        // Validate accessor has necessary fields
-        if (!accessorJSON.contains("count") || 
-            !accessorJSON.contains("componentType") || 
-            !accessorJSON.contains("type")) {
-            GE_CORE_ERROR("glTF2Loader: Accessor is missing required fields");
-            return;
-        }
-        
-        unsigned int bufferviewInd = accessorJSON.value("bufferView", 0);
-        if (bufferviewInd >= m_bufferViews.size()) {
-            GE_CORE_ERROR("glTF2Loader: Buffer view index out of range: {}", bufferviewInd);
-            return;
+        if (accessor.bufferView < 0 || (size_t)accessor.bufferView >= m_bufferViews.size()) {
+            GE_CORE_ERROR("glTF2Loader: Buffer view index out of range: {}", accessor.bufferView);
+            return nullptr;
         }
         
-        unsigned int count = accessorJSON["count"];
-        unsigned int componentType = accessorJSON["componentType"];
-        size_t accbyteOffset = accessorJSON.value("byteOffset", 0);
-        std::string type = accessorJSON["type"];
-
-        json& bufferView = m_bufferViews[bufferviewInd];
-        size_t byteOffset = bufferView.value("byteOffset", 0) + accbyteOffset;
-        unsigned int byteStride = bufferView.value("byteStride", 0);
-        
-        // Calculate element size
-        unsigned int elementSize = 1; // default for SCALAR
-        if (type == "VEC2") elementSize = 2;
-        else if (type == "VEC3") elementSize = 3;
-        else if (type == "VEC4") elementSize = 4;
-        else if (type == "MAT4") elementSize = 16;
-        
         unsigned int componentSize = 0;
-        switch (componentType)
+        switch (accessor.componentType)
         {
         case 5120: componentSize = 1; break; // BYTE
         case 5121: componentSize = 1; break; // UNSIGNED_BYTE
@@ -824,47 +2244,77 @@ namespace Rapture {
         case 5125: componentSize = 4; break; // UNSIGNED_INT
         case 5126: componentSize = 4; break; // FLOAT
         default:
-            GE_CORE_ERROR("glTF2Loader: Unknown component type: {}", componentType);
-            return;
+            GE_CORE_ERROR("glTF2Loader: Unknown component type: {}", accessor.componentType);
+            return nullptr;
         }
-        
-        // Total bytes for this accessor
-        unsigned int totalBytes = count * elementSize * componentSize;
-        
-        // Pre-allocate the vector to avoid reallocations
-        dataVec.reserve(totalBytes);
-        dataVec.resize(totalBytes);
-        
-        // Check if we need to handle interleaved data with stride
-        if (byteStride > 0 && byteStride != (elementSize * componentSize)) {
-            // Data is interleaved, need to copy with stride
-            unsigned int elementBytes = elementSize * componentSize;
-            unsigned char* dstPtr = dataVec.data();
-            
-            for (unsigned int i = 0; i < count; i++) {
-                if (byteOffset + i * byteStride + elementBytes > m_binVec.size()) {
-                    GE_CORE_ERROR("glTF2Loader: Buffer access out of bounds");
-                    dataVec.clear();
-                    return;
-                }
-                
-                const unsigned char* srcPtr = m_binVec.data() + byteOffset + i * byteStride;
-                std::memcpy(dstPtr, srcPtr, elementBytes);
-                dstPtr += elementBytes;
-            }
-        } else {
-            // Data is tightly packed, can copy in one go
-            if (byteOffset + totalBytes > m_binVec.size()) {
-                GE_CORE_ERROR("glTF2Loader: Buffer access out of bounds: offset={}, size={}, buffer size={}", 
-                    byteOffset, totalBytes, m_binVec.size());
-                return;
+
+        const glTFBufferView& bufferView = m_bufferViews[accessor.bufferView];
+        const unsigned char* viewData = nullptr;
+        size_t viewSize = 0;
+        size_t byteOffset = accessor.byteOffset;
+
+        if (bufferView.isCompressed) {
+            // Already decoded by decompressBufferViews, the accessor offset is relative to the decoded view
+            const std::vector<unsigned char>& decompressed = m_decompressedViews[accessor.bufferView];
+            if (decompressed.empty()) {
+                GE_CORE_ERROR("glTF2Loader: Compressed buffer view {} has no decoded data", accessor.bufferView);
+                return nullptr;
             }
-            
-            std::memcpy(dataVec.data(), m_binVec.data() + byteOffset, totalBytes);
+            viewData = decompressed.data();
+            viewSize = decompressed.size();
+        }
+        else {
+            const BufferData* buffer = resolveBuffer(bufferView.buffer);
+            if (!buffer) {
+                return nullptr;
+            }
+            viewData = buffer->data;
+            viewSize = buffer->size;
+            byteOffset += bufferView.byteOffset;
+        }
+
+        // Calculate element size, a stride of 0 means tightly packed
+        elementBytes = getComponentCount(accessor.type) * componentSize;
+        stride = bufferView.byteStride > 0 ? bufferView.byteStride : elementBytes;
+
+        if (accessor.count == 0) {
+            return nullptr;
+        }
+
+        // The last element has to end inside the buffer, everything before it then does too
+        size_t lastElementEnd = byteOffset + (size_t)(accessor.count - 1) * stride + elementBytes;
+        if (lastElementEnd > viewSize) {
+            GE_CORE_ERROR("glTF2Loader: Buffer access out of bounds: offset={}, end={}, buffer size={}", 
+                byteOffset, lastElementEnd, viewSize);
+            return nullptr;
+        }
+
+        return viewData + byteOffset;
+    }
+
+    void glTF2Loader::loadAccessor(const glTFAccessor& accessor, std::vector<unsigned char>& dataVec)
+    {
+        // Clear output vector
+        dataVec.clear();
+
+        size_t elementBytes = 0;
+        size_t stride = 0;
+        const unsigned char* src = getAccessorView(accessor, elementBytes, stride);
+        if (!src) {
+            return;
         }
+
+        unsigned int count = accessor.count;
+        unsigned int componentType = accessor.componentType;
+        VertexAttributeType type = accessor.type;
+        unsigned int elementSize = (unsigned int)getComponentCount(type);
+        size_t totalBytes = (size_t)count * elementBytes;
+
+        dataVec.resize(totalBytes);
+        BufferConversionHelpers::copyStrided(dataVec.data(), elementBytes, src, stride, elementBytes, count);
         
         // Additional validation for TEXCOORD_0
-        if (type == "VEC2" && elementSize == 2 && (totalBytes > 0)) {
+        if (type == VertexAttributeType::Vec2 && elementSize == 2 && (totalBytes > 0)) {
             // Check if any texture coordinates are outside the [0,1] range 
             // This could indicate potential issues with texture mapping
             bool hasOutOfRange = false;
@@ -894,30 +2344,63 @@ namespace Rapture {
         m_bufferViews.clear();
         m_buffers.clear();
         m_nodes.clear();
-        m_materials.clear();
-        m_animations.clear();
         m_skins.clear();
-        m_textures.clear();
-        m_images.clear();
-        m_samplers.clear();
-        
-        m_binVec.clear();
+        m_animations.clear();
+        m_skinnedEntities.clear();
+        m_materials = nullptr;
+        m_textures = nullptr;
+        m_images = nullptr;
+        m_samplers = nullptr;
+        
+        // Accessor data has been copied out by now, so the mappings and decoded buffers can go
+        m_bufferData.clear();
+        m_decompressedViews.clear();
+        m_isViewDecompressed.clear();
+        m_viewUsers.clear();
+        m_primitiveCache.clear();
+        m_primitiveJobs.clear();
+        m_bakedEntities.clear();
+        m_entityRecords.clear();
+        m_createdEntities.clear();
+        m_glbBinChunk = nullptr;
+        m_glbBinChunkSize = 0;
+        m_glbFile.close();
+    }
+
+    void glTF2Loader::reportProgress()
+    {
+        if (m_progress && m_progress->callback) {
+            m_progress->callback(*m_progress);
+        }
     }
 
-    void glTF2Loader::reportProgress(float progress)
+    void glTF2Loader::discardCreatedEntities()
     {
-        GE_CORE_INFO("glTF2Loader: Progress: {}", progress);
-        //m_progressCallback(progress);
+        RAPTURE_PROFILE_FUNCTION();
+
+        // Unlink from the parents first, so no node keeps a removed entity reachable
+        for (Entity& entity : m_createdEntities) {
+            if (entity.isValid() && entity.hasComponent<EntityNodeComponent>()) {
+                std::shared_ptr<EntityNode> node = entity.getComponent<EntityNodeComponent>().entity_node;
+                if (node && node->getParent()) {
+                    node->getParent()->removeChild(node);
+                }
+            }
+        }
+        for (Entity& entity : m_createdEntities) {
+            entity.destroy();
+        }
+        m_createdEntities.clear();
     }
 
     bool glTF2Loader::loadAndSetTexture(std::shared_ptr<Material> material, const std::string& textureName, int textureIndex)
     {
-        if (textureIndex < 0 || textureIndex >= m_textures.size()) {
+        if (textureIndex < 0 || textureIndex >= m_textures->size()) {
             GE_CORE_ERROR("glTF2Loader: Invalid texture index {}", textureIndex);
             return false;
         }
 
-        json& texture = m_textures[textureIndex];
+        json& texture = (*m_textures)[textureIndex];
         
         // Get the image index
         if (!texture.contains("source")) {
@@ -926,12 +2409,12 @@ namespace Rapture {
         }
         
         int imageIndex = texture["source"];
-        if (imageIndex < 0 || imageIndex >= m_images.size()) {
+        if (imageIndex < 0 || imageIndex >= m_images->size()) {
             GE_CORE_ERROR("glTF2Loader: Invalid image index {}", imageIndex);
             return false;
         }
         
-        json& image = m_images[imageIndex];
+        json& image = (*m_images)[imageIndex];
         
         // Get the image URI
         if (!image.contains("uri")) {
@@ -953,9 +2436,11 @@ namespace Rapture {
 
             // Apply sampler parameters if present
         if (texture.contains("sampler")) {
+            // The loader runs off the GL thread, the parameters are collected and set with the upload
+            TextureSampler textureSampler;
             int samplerIndex = texture["sampler"];
-            if (samplerIndex >= 0 && samplerIndex < m_samplers.size()) {
-                json& sampler = m_samplers[samplerIndex];
+            if (samplerIndex >= 0 && samplerIndex < m_samplers->size()) {
+                json& sampler = (*m_samplers)[samplerIndex];
                 
                 // The glTF spec defines these constants:
                 // GL_NEAREST = 9728
@@ -972,26 +2457,26 @@ namespace Rapture {
                 if (sampler.contains("magFilter")) {
                     int magFilter = sampler["magFilter"];
                     if (magFilter == 9728) { // GL_NEAREST
-                        tex->setMagFilter(TextureFilter::Nearest);
+                        textureSampler.magFilter = TextureFilter::Nearest;
                     } else if (magFilter == 9729) { // GL_LINEAR
-                        tex->setMagFilter(TextureFilter::Linear);
+                        textureSampler.magFilter = TextureFilter::Linear;
                     }
                 }
                 
                 if (sampler.contains("minFilter")) {
                     int minFilter = sampler["minFilter"];
                     if (minFilter == 9728) { // GL_NEAREST
-                        tex->setMinFilter(TextureFilter::Nearest);
+                        textureSampler.minFilter = TextureFilter::Nearest;
                     } else if (minFilter == 9729) { // GL_LINEAR
-                        tex->setMinFilter(TextureFilter::Linear);
+                        textureSampler.minFilter = TextureFilter::Linear;
                     } else if (minFilter == 9984) { // GL_NEAREST_MIPMAP_NEAREST
-                        tex->setMinFilter(TextureFilter::NearestMipmapNearest);
+                        textureSampler.minFilter = TextureFilter::NearestMipmapNearest;
                     } else if (minFilter == 9985) { // GL_LINEAR_MIPMAP_NEAREST
-                        tex->setMinFilter(TextureFilter::LinearMipmapNearest);
+                        textureSampler.minFilter = TextureFilter::LinearMipmapNearest;
                     } else if (minFilter == 9986) { // GL_NEAREST_MIPMAP_LINEAR
-                        tex->setMinFilter(TextureFilter::NearestMipmapLinear);
+                        textureSampler.minFilter = TextureFilter::NearestMipmapLinear;
                     } else if (minFilter == 9987) { // GL_LINEAR_MIPMAP_LINEAR
-                        tex->setMinFilter(TextureFilter::LinearMipmapLinear);
+                        textureSampler.minFilter = TextureFilter::LinearMipmapLinear;
                     }
                 }
                 
@@ -999,31 +2484,32 @@ namespace Rapture {
                 if (sampler.contains("wrapS")) {
                     int wrapS = sampler["wrapS"];
                     if (wrapS == 33071) { // GL_CLAMP_TO_EDGE
-                        tex->setWrapS(TextureWrap::ClampToEdge);
+                        textureSampler.wrapS = TextureWrap::ClampToEdge;
                     } else if (wrapS == 33648) { // GL_MIRRORED_REPEAT
-                        tex->setWrapS(TextureWrap::MirroredRepeat);
+                        textureSampler.wrapS = TextureWrap::MirroredRepeat;
                     } else if (wrapS == 10497) { // GL_REPEAT
-                        tex->setWrapS(TextureWrap::Repeat);
+                        textureSampler.wrapS = TextureWrap::Repeat;
                     }
                 }
                 
                 if (sampler.contains("wrapT")) {
                     int wrapT = sampler["wrapT"];
                     if (wrapT == 33071) { // GL_CLAMP_TO_EDGE
-                        tex->setWrapT(TextureWrap::ClampToEdge);
+                        textureSampler.wrapT = TextureWrap::ClampToEdge;
                     } else if (wrapT == 33648) { // GL_MIRRORED_REPEAT
-                        tex->setWrapT(TextureWrap::MirroredRepeat);
+                        textureSampler.wrapT = TextureWrap::MirroredRepeat;
                     } else if (wrapT == 10497) { // GL_REPEAT
-                        tex->setWrapT(TextureWrap::Repeat);
+                        textureSampler.wrapT = TextureWrap::Repeat;
                     }
                 }
             } else {
                 // Set default texture parameters if no sampler is specified
-                tex->setMinFilter(TextureFilter::LinearMipmapLinear);
-                tex->setMagFilter(TextureFilter::Linear);
-                tex->setWrapS(TextureWrap::Repeat);
-                tex->setWrapT(TextureWrap::Repeat);
+                textureSampler.minFilter = TextureFilter::LinearMipmapLinear;
+                textureSampler.magFilter = TextureFilter::Linear;
+                textureSampler.wrapS = TextureWrap::Repeat;
+                textureSampler.wrapT = TextureWrap::Repeat;
             }
+            TextureLibrary::setSampler(tex, textureSampler);
             
             // Set the texture on the material
             material->setTexture(textureName, tex);
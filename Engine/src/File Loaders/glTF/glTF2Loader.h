@@ -4,21 +4,50 @@
 #include <vector>
 #include <memory>
 #include <functional>
+#include <mutex>
+#include <atomic>
+#include <unordered_map>
 
 #include <glm/glm.hpp>
 #include "json.hpp"
+#include "glTFTypes.h"
 
 #include "../../DataTypes.h"
 #include "../../Buffers/VertexArray.h"
 #include "../../Scenes/Scene.h"
 #include "../../Scenes/Entity.h"
+#include "../../Scenes/StagingScene.h"
 #include "../../Materials/Material.h"
+#include "../../Mesh/Mesh.h"
+#include "../../Scenes/Components/BoundingBox.h"
+#include "../../Animation/Skeleton.h"
+#include "../../Animation/AnimationClip.h"
+#include "../../Animation/AnimationCompression.h"
+#include "../../Animation/MorphTargets.h"
+#include "../MappedFile.h"
+#include "../MeshCache.h"
+#include "../ModelLoadProgress.h"
 
 using json = nlohmann::json;
 
 namespace Rapture
 {
 
+	struct MeshUploadRequest;
+	class ModelPrefab;
+
+	// Decoded vertex and index data a load may hold at once, including what still waits in the upload queue.
+	// Primitives are decoded in batches that fit, so importing an asset takes about this much on top of its mapping
+	constexpr size_t DEFAULT_IMPORT_MEMORY_BUDGET = 512ull * 1024 * 1024;
+
+	// Memory high water marks of the last load
+	struct ImportMemoryStats {
+		size_t peakStagingBytes = 0;		// decoded primitives, in the loader and in the upload queue
+		size_t peakDecompressedBytes = 0;	// EXT_meshopt_compression views decoded at the same time
+		size_t peakWorkingSet = 0;			// of the whole process, as reported by the OS
+		size_t batchCount = 0;
+	};
+
 	/**
 	 * @brief Modern loader for glTF 2.0 format 3D models using entity-component architecture
 	 * 
@@ -27,6 +56,43 @@ namespace Rapture
 	 */
 	class glTF2Loader
 	{
+	private:
+		// Bytes of a glTF buffer, either a mapped file, the GLB BIN chunk or a decoded data URI
+		struct BufferData {
+			MappedFile file;
+			std::vector<unsigned char> decoded;
+			const unsigned char* data = nullptr;
+			size_t size = 0;
+			bool isResolved = false;
+		};
+
+		// Temporaries of one decode thread, kept across primitives and loads so their capacity is only allocated once
+		struct DecodeScratch {
+			std::vector<float> positions;
+			std::vector<float> normals;
+		};
+
+		// CPU side result of decoding one primitive, ready for the upload queue
+		struct DecodedPrimitive {
+			BufferLayout layout;
+			std::vector<unsigned char> vertexData;
+			std::vector<unsigned char> positionData;
+			std::vector<unsigned char> indexData;
+			size_t indexCount = 0;
+			unsigned int indexType = 0;
+			BoundingBox localBoundingBox;
+			std::shared_ptr<MorphTargetSet> morphTargets;
+			bool isValid = false;
+		};
+
+		// One unique primitive of the model, along with every entity that uses it
+		struct PrimitiveDecodeJob {
+			const glTFPrimitive* primitive = nullptr;
+			std::shared_ptr<Mesh> mesh;
+			std::vector<Entity> entities;
+			DecodedPrimitive decoded;
+		};
+
 	public:
 		/**
 		 * @brief Constructor that takes a scene to populate
@@ -43,46 +109,311 @@ namespace Rapture
 		/**
 		 * @brief Load a model from a glTF file and populate the scene with entities
 		 * 
-		 * @param filepath Path to the .gltf file
+		 * @param filepath Path to the .gltf or .glb file
 		 * @param calculateBoundingBoxes If true, bounding boxes will be calculated for all primitives
 		 * @return true if loading was successful, false otherwise
 		 */
 		bool loadModel(const std::string& filepath, bool isAbsolute=false, bool calculateBoundingBoxes = false);
 
+		/**
+		 * @brief Share progress counters and a cancellation flag with the caller
+		 * 
+		 * A cancelled load stops between primitives, removes the entities it created and returns false.
+		 * 
+		 * @param progress Progress of the next load, nullptr to stop reporting
+		 */
+		void setProgress(std::shared_ptr<ModelLoadProgress> progress) { m_progress = std::move(progress); }
+
+		bool isCancelled() const { return m_progress && m_progress->isCancelled(); }
+
+		/**
+		 * @brief Set the key reduction tolerances for imported animation clips, or disable compression
+		 */
+		void setAnimationCompression(const AnimationCompressionSettings& settings) { m_animationCompression = settings; }
+
+		/**
+		 * @brief Capture the next load into a prefab, so later copies of the model skip the loader entirely
+		 * 
+		 * The prefab is captured once the load succeeds and follows the uploads of its meshes.
+		 * 
+		 * @param prefab Prefab to fill, nullptr to stop capturing
+		 */
+		void setPrefab(std::shared_ptr<ModelPrefab> prefab) { m_prefab = std::move(prefab); }
+
+		/**
+		 * @brief Build the next load into a staging scene instead of a live one
+		 * 
+		 * The loader must have been constructed with the staging scene's private scene. Upload results
+		 * wait for the merge, the staged entities are only touched again once they are live.
+		 * 
+		 * @param staging Staging scene being built, nullptr when loading straight into a scene
+		 */
+		void setStagingScene(std::shared_ptr<StagingScene> staging) { m_stagingScene = std::move(staging); }
+
+		/**
+		 * @brief Limit the decoded data a load holds at once, see DEFAULT_IMPORT_MEMORY_BUDGET
+		 * 
+		 * Models that don't fit in one batch are not baked into the mesh cache, the cache is written in one piece.
+		 * 
+		 * @param bytes Budget in bytes, a single primitive larger than this is still decoded on its own
+		 */
+		void setMemoryBudget(size_t bytes) { m_memoryBudget = bytes; }
+
+		// Memory high water marks of the last load
+		const ImportMemoryStats& getMemoryStats() const { return m_memoryStats; }
+
 	private:
 		/**
-		 * @brief Process a glTF primitive and set up mesh data
+		 * @brief Parse buffers, buffer views, accessors, meshes and nodes into typed records
+		 * 
+		 * The parsed sections are erased from the DOM afterwards, materials and textures stay and are referenced in place.
+		 * 
+		 * @return true if the document was well formed
+		 */
+		bool parseDocument();
+
+		/**
+		 * @brief Map a binary .glb container, parse its JSON chunk and locate its BIN chunk
+		 * 
+		 * @param path Full path to the .glb file
+		 * @return true if the container was valid
+		 */
+		bool loadGLB(const std::string& path);
+
+		/**
+		 * @brief Load a buffer the first time it is referenced
+		 * 
+		 * @param bufferIndex Index into the glTF buffers array
+		 * @return The buffer bytes, or nullptr if the buffer couldn't be loaded
+		 */
+		const BufferData* resolveBuffer(size_t bufferIndex);
+
+		/**
+		 * @brief Decode the given EXT_meshopt_compression buffer views that aren't decoded yet, spread over all hardware threads
+		 * 
+		 * Plain views in the list are skipped.
+		 * 
+		 * @param viewIndices Views about to be read
+		 * @return false if any compressed view failed to decode
+		 */
+		bool decompressBufferViews(const std::vector<size_t>& viewIndices);
+
+		/**
+		 * @brief Collect the buffer views a primitive reads, attributes, indices and morph targets including sparse storage
+		 */
+		void collectBufferViews(const glTFPrimitive& primitive, std::vector<size_t>& viewIndices) const;
+
+		// Append the views of one accessor, its dense view and the sparse index and value views
+		void collectAccessorViews(int32_t accessorIndex, std::vector<size_t>& viewIndices) const;
+
+		/**
+		 * @brief Bytes of staging memory decoding a primitive will need, read from its accessors before decoding
+		 */
+		size_t estimateStagingSize(const glTFPrimitive& primitive) const;
+
+		/**
+		 * @brief Free a buffer view nothing reads anymore, decoded views are released and mapped pages dropped from the working set
+		 */
+		void releaseBufferView(size_t viewIndex);
+
+		/**
+		 * @brief Add to the staging memory in use and raise the peak if needed, negative deltas release
+		 */
+		void trackStagingBytes(int64_t delta);
+
+		/**
+		 * @brief Build a skeleton and its clips for every skin and create one animator entity per skin
+		 * 
+		 * Runs after the compressed views are decoded, since keyframes may be meshopt compressed as well.
+		 * Skinned primitives created during the hierarchy pass are pointed at their animator here.
+		 */
+		void processSkins();
+
+		/**
+		 * @brief Build the joint hierarchy, rest pose and inverse bind matrices of a skin
+		 * 
+		 * @param skin Parsed skin record
+		 * @param nodeParents Parent node of every node, -1 for scene roots
+		 * @param jointOfNode Joint index of every node for this skin, -1 for nodes outside it
+		 * @return The skeleton, or nullptr if the skin has no joints
+		 */
+		std::shared_ptr<Skeleton> buildSkeleton(const glTFSkin& skin, const std::vector<int32_t>& nodeParents, const std::vector<int32_t>& jointOfNode);
+
+		/**
+		 * @brief Collect the channels of an animation that target the skin's joints into a clip
+		 * 
+		 * @param animation Parsed animation record
+		 * @param animationIndex Index of the animation, used for unnamed ones
+		 * @param skeleton Skeleton of the skin, compression drops tracks that only repeat its rest pose
+		 * @param jointOfNode Joint index of every node for this skin, -1 for nodes outside it
+		 * @param rawBytes Incremented by the size of the uncompressed keys
+		 * @return The clip, compressed unless disabled, or nullptr if no channel animates the skin
+		 */
+		std::shared_ptr<AnimationClip> buildClip(const glTFAnimation& animation, size_t animationIndex, const Skeleton& skeleton,
+			const std::vector<int32_t>& jointOfNode, size_t& rawBytes);
+
+		/**
+		 * @brief Read an accessor as floats, dequantizing normalized integer components and applying sparse storage
+		 * 
+		 * @param accessorIndex Index into the accessors array
+		 * @param data Receives count * component count floats
+		 * @return false if the accessor is missing or invalid
+		 */
+		bool readAccessorFloats(int32_t accessorIndex, std::vector<float>& data);
+
+		/**
+		 * @brief Locate a whole buffer view, decoded if it is compressed
+		 * 
+		 * @param viewIndex Index into the buffer views array
+		 * @param viewSize Receives the number of bytes of the view
+		 * @return Pointer to the first byte of the view, or nullptr if it can't be read
+		 */
+		const unsigned char* getBufferViewData(int32_t viewIndex, size_t& viewSize);
+
+		/**
+		 * @brief Attach mesh and material components for a glTF primitive and queue it for decoding
 		 * 
 		 * @param entity Entity to attach mesh data to
-		 * @param primitive JSON object containing primitive data
+		 * @param primitive Parsed primitive record
+		 * @param primitiveKey (mesh index, primitive index) pair, primitives already queued under this key are shared
+		 */
+		void processPrimitive(Entity entity, const glTFPrimitive& primitive, uint64_t primitiveKey);
+
+		/**
+		 * @brief Decode every queued primitive, spread over all hardware threads
+		 * 
+		 * Primitives go in batches that fit the memory budget. Each batch's compressed views are decoded just before it,
+		 * views no later primitive reads are released after it, and unless the model is being baked the batch is
+		 * finalized right away. Batches wait for the upload queue to drain, so staging never outgrows the budget.
+		 */
+		void decodePrimitives();
+
+		/**
+		 * @brief Decode accessors, interleave vertices and compute bounds for one primitive
+		 * 
+		 * Thread safe, it only reads the parsed records and buffers and never touches the scene.
+		 * 
+		 * @param primitive Parsed primitive record
+		 * @param decoded Receives the vertex, position and index data
+		 * @param scratch Temporaries of the calling thread
+		 * @return true if the primitive has usable vertex and index data
+		 */
+		bool decodePrimitive(const glTFPrimitive& primitive, DecodedPrimitive& decoded, DecodeScratch& scratch);
+
+		/**
+		 * @brief Read a primitive's morph targets into sparse deltas, keeping only the vertices each target moves
+		 * 
+		 * Thread safe like decodePrimitive.
+		 * 
+		 * @param primitive Parsed primitive record with targets
+		 * @param vertexCount Vertex count of the primitive, every delta accessor must match it
+		 * @param scratch Temporaries of the calling thread
+		 * @return The target set, or nullptr if no target could be read
+		 */
+		std::shared_ptr<MorphTargetSet> decodeMorphTargets(const glTFPrimitive& primitive, uint32_t vertexCount, DecodeScratch& scratch);
+
+		/**
+		 * @brief Add bounding boxes to the primitive's entities and queue its upload
+		 * 
+		 * @param job A decoded primitive
+		 */
+		void finalizePrimitive(PrimitiveDecodeJob& job);
+
+		/**
+		 * @brief Create the primitive's material and set it on the entity
+		 * 
+		 * @param entity Entity with a MaterialComponent
+		 * @param primitive Parsed primitive record
+		 */
+		void assignPrimitiveMaterial(Entity entity, const glTFPrimitive& primitive);
+
+		/**
+		 * @brief Queue a primitive's upload, every entity using it is marked loaded (or dropped) once it finishes
+		 * 
+		 * @param uploadRequest Request with everything but the callback filled in
+		 * @param entities Entities sharing the primitive's mesh
+		 * @param prefab Prefab captured from the load, told about the upload as well, may be null
+		 * @param staging Staging scene the entities live in until the merge, may be null
+		 */
+		static void enqueuePrimitiveUpload(MeshUploadRequest&& uploadRequest, std::vector<Entity> entities, std::shared_ptr<ModelPrefab> prefab,
+			std::shared_ptr<StagingScene> staging);
+
+		/**
+		 * @brief Point m_materials, m_textures, m_images and m_samplers at their sections of m_glTFfile
+		 */
+		void bindMaterialSections();
+
+		/**
+		 * @brief Hash of the import settings that change the decoded output, part of the cache key
 		 */
-		void processPrimitive(Entity entity, json& primitive);
+		uint64_t getImportSettingsHash() const;
+
+		/**
+		 * @brief Remember a created entity for the baked cache, its parent must have been recorded before it
+		 * 
+		 * @param entity The entity with its tag, transform and node set up
+		 * @param primitive Index of the primitive decode job the entity draws, -1 for none
+		 * @param material Index of the glTF material, -1 for none
+		 */
+		void recordEntity(Entity entity, int32_t primitive = -1, int32_t material = -1);
+
+		/**
+		 * @brief Write the decoded primitives and recorded hierarchy to the baked cache next to the source
+		 * 
+		 * @param sourcePath Full path of the imported file
+		 */
+		void writeCache(const std::string& sourcePath);
+
+		/**
+		 * @brief Recreate the model from its baked cache, uploading straight out of the mapped cache file
+		 * 
+		 * @param sourcePath Full path of the file being imported
+		 * @return true on a cache hit, false if the cache is missing, stale or invalid
+		 */
+		bool loadFromCache(const std::string& sourcePath);
+
+		/**
+		 * @brief Mark the entity's mesh as loaded, or drop it if the upload failed
+		 */
+		static void applyUploadResult(Entity entity, bool success);
+
+		/**
+		 * @brief Locate an accessor's data inside its buffer without copying it
+		 * 
+		 * @param accessor Parsed accessor record
+		 * @param elementBytes Receives the size of one element
+		 * @param stride Receives the distance between consecutive elements
+		 * @return Pointer to the first element, or nullptr if the accessor is invalid or out of bounds
+		 */
+		const unsigned char* getAccessorView(const glTFAccessor& accessor, size_t& elementBytes, size_t& stride);
 
 		/**
 		 * @brief Extract raw binary data from an accessor
 		 * 
-		 * @param accessorJSON JSON object containing accessor information
+		 * @param accessor Parsed accessor record
 		 * @param data_vec Vector to store the extracted binary data
 		 */
-		void loadAccessor(json& accessorJSON, std::vector<unsigned char>& data_vec);
+		void loadAccessor(const glTFAccessor& accessor, std::vector<unsigned char>& data_vec);
 
 		/**
 		 * @brief Process a mesh from the glTF file and create entities
 		 * 
 		 * @param parentEntity Parent entity for this mesh
-		 * @param meshJSON JSON object containing mesh data
+		 * @param node Node holding the mesh, for its skin and morph weights
+		 * @param mesh Parsed mesh record
+		 * @param meshIndex Index of the mesh in the glTF meshes array
 		 * @return Entity The created entity
 		 */
-		Entity processMesh(Entity parentEntity, json& meshJSON);
+		Entity processMesh(Entity parentEntity, const glTFNode& node, const glTFMesh& mesh, unsigned int meshIndex);
 
 		/**
 		 * @brief Process the node hierarchy and create entities with proper transforms
 		 * 
 		 * @param parentEntity Parent entity
-		 * @param nodeJSON JSON object containing node data
+		 * @param node Parsed node record
 		 * @return Entity The created entity
 		 */
-		Entity processNode(Entity parentEntity, json& nodeJSON);
+		Entity processNode(Entity parentEntity, const glTFNode& node);
 
 		/**
 		 * @brief Process a scene from the glTF file
@@ -124,11 +455,14 @@ namespace Rapture
 		void cleanUp();
 
         /**
-         * @brief Report progress of the loading process
-         * 
-         * @param progress The progress value between 0.0 and 1.0
+         * @brief Hand the current progress counters to the progress callback, if any
          */
-        void reportProgress(float progress);
+        void reportProgress();
+
+		/**
+		 * @brief Remove every entity this load created, used when the load is cancelled half way
+		 */
+		void discardCreatedEntities();
 
 	private:
 		// Reference to the scene being populated
@@ -136,24 +470,74 @@ namespace Rapture
 		
 		// JSON components from the glTF file
 		json m_glTFfile;
-		json m_accessors;
-		json m_meshes;
-		json m_bufferViews;
-		json m_buffers;
-		json m_nodes;
-		json m_materials;
-		json m_animations;
-		json m_skins;
-		json m_textures;
-		json m_images;
-		json m_samplers;
+
+		// Typed records for the sections read on every primitive
+		std::vector<glTFAccessor> m_accessors;
+		std::vector<glTFMesh> m_meshes;
+		std::vector<glTFBufferView> m_bufferViews;
+		std::vector<glTFBuffer> m_buffers;
+		std::vector<glTFNode> m_nodes;
+		std::vector<glTFSkin> m_skins;
+		std::vector<glTFAnimation> m_animations;
+
+		// Sections that stay in m_glTFfile, pointers into it
+		json* m_materials = nullptr;
+		json* m_textures = nullptr;
+		json* m_images = nullptr;
+		json* m_samplers = nullptr;
 
 		bool m_calculateBoundingBoxes = false;
+		AnimationCompressionSettings m_animationCompression;
+
+
+		// Memory mapped .glb container and its BIN chunk
+		MappedFile m_glbFile;
+		const unsigned char* m_glbBinChunk = nullptr;
+		size_t m_glbBinChunkSize = 0;
+
+		// One entry per glTF buffer, resolved on first use
+		std::vector<BufferData> m_bufferData;
+
+		std::mutex m_bufferMutex;
 
+		// Decoded bytes of each EXT_meshopt_compression buffer view, empty for plain views and views not decoded yet
+		std::vector<std::vector<unsigned char>> m_decompressedViews;
+		std::vector<uint8_t> m_isViewDecompressed;
 
-		// Raw binary data from the .bin file
-		std::vector<unsigned char> m_binVec;
+		// Primitives still to be decoded that read each buffer view, the view is released when it drops to zero
+		std::vector<uint32_t> m_viewUsers;
+
+		size_t m_memoryBudget = DEFAULT_IMPORT_MEMORY_BUDGET;
+		ImportMemoryStats m_memoryStats;
+		std::atomic<size_t> m_stagingBytes{ 0 };			// decoded and not handed to the upload queue yet
+		std::atomic<size_t> m_peakStagingBytes{ 0 };		// including the upload queue's backlog
+		std::atomic<size_t> m_decompressedBytes{ 0 };
+		std::atomic<size_t> m_peakDecompressedBytes{ 0 };
+
+		// Unique primitives of this load, and their index keyed by (mesh index << 32 | primitive index)
+		std::vector<PrimitiveDecodeJob> m_primitiveJobs;
+		std::unordered_map<uint64_t, size_t> m_primitiveCache;
+
+		// Hierarchy recorded for the baked cache, and the record index of each entity id
+		bool m_bakeEnabled = false;
+		std::vector<BakedEntity> m_bakedEntities;
+		std::unordered_map<uint32_t, int32_t> m_entityRecords;
 		
+		// Progress and cancellation shared with the caller, may be null
+		std::shared_ptr<ModelLoadProgress> m_progress;
+
+		// Prefab captured from this load, may be null
+		std::shared_ptr<ModelPrefab> m_prefab;
+
+		// Staging scene m_scene belongs to, may be null
+		std::shared_ptr<StagingScene> m_stagingScene;
+
+		// Primitive entities of skinned nodes and their skin, linked to the skin's animator by processSkins
+		std::vector<std::pair<Entity, int32_t>> m_skinnedEntities;
+
+		// Every entity created by this load, so a cancelled load can take them out again
+		std::vector<Entity> m_createdEntities;
+
 		// Base path for loading external resources
 		std::string m_basePath;
 		
@@ -166,5 +550,12 @@ namespace Rapture
 		static const unsigned int GLTF_SHORT = 5122;
 		static const unsigned int GLTF_UBYTE = 5121;
 		static const unsigned int GLTF_BYTE = 5120;
+
+		// GLB container constants
+		static const uint32_t GLB_MAGIC = 0x46546C67;      // "glTF"
+		static const uint32_t GLB_CHUNK_JSON = 0x4E4F534A; // "JSON"
+		static const uint32_t GLB_CHUNK_BIN = 0x004E4942;  // "BIN\0"
+		static const size_t GLB_HEADER_SIZE = 12;
+		static const size_t GLB_CHUNK_HEADER_SIZE = 8;
 	};
 }
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "../../Buffers/VertexFormat.h"
+#include "MeshoptDecoder.h"
+
+namespace Rapture
+{
+
+	// Compact records for the hot parts of a glTF document.
+	// They are filled once right after parsing, so decoding never looks strings up in the JSON DOM again.
+
+	struct glTFBuffer {
+		std::string uri;                // empty for the GLB BIN chunk
+		size_t byteLength = 0;
+	};
+
+	struct glTFBufferView {
+		uint32_t buffer = 0;
+		size_t byteOffset = 0;
+		size_t byteLength = 0;
+		uint32_t byteStride = 0;        // 0 means tightly packed
+
+		// EXT_meshopt_compression, the view's own buffer is then only a fallback that usually has no data
+		bool isCompressed = false;
+		uint32_t compressedBuffer = 0;
+		size_t compressedOffset = 0;
+		size_t compressedLength = 0;
+		uint32_t compressedCount = 0;   // elements of byteStride bytes once decoded
+		MeshoptDecoder::Mode compressionMode = MeshoptDecoder::Mode::Attributes;
+		MeshoptDecoder::Filter compressionFilter = MeshoptDecoder::Filter::None;
+	};
+
+	struct glTFAccessor {
+		int32_t bufferView = -1;        // -1 when the accessor has no data (all zeros)
+		size_t byteOffset = 0;
+		uint32_t count = 0;
+		uint32_t componentType = 0;     // GL component type, e.g. 5126 for float
+		VertexAttributeType type = VertexAttributeType::Scalar;
+		bool normalized = false;
+
+		// Sparse storage, the listed elements replace those of the buffer view (or of all zeros)
+		uint32_t sparseCount = 0;
+		int32_t sparseIndicesView = -1;
+		size_t sparseIndicesOffset = 0;
+		uint32_t sparseIndicesComponentType = 0;
+		int32_t sparseValuesView = -1;
+		size_t sparseValuesOffset = 0;
+	};
+
+	struct glTFPrimitive {
+		std::vector<std::pair<VertexAttributeSemantic, uint32_t>> attributes;  // semantic -> accessor index
+		int32_t indices = -1;
+		int32_t material = -1;
+
+		// Morph targets, each with its own POSITION / NORMAL delta accessors, named from the mesh's extras if present
+		std::vector<std::vector<std::pair<VertexAttributeSemantic, uint32_t>>> targets;
+		std::vector<std::string> targetNames;
+	};
+
+	struct glTFMesh {
+		std::string name;
+		std::vector<glTFPrimitive> primitives;
+		std::vector<float> weights;     // default morph target weights
+	};
+
+	struct glTFNode {
+		std::string name;
+		int32_t mesh = -1;
+		int32_t skin = -1;
+		std::vector<uint32_t> children;
+		std::vector<float> weights;     // overrides the mesh's morph target weights when present
+
+		// Either a full matrix or TRS, as the file specifies
+		bool hasMatrix = false;
+		glm::mat4 matrix = glm::mat4(1.0f);
+		glm::vec3 translation = glm::vec3(0.0f);
+		glm::quat rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+		glm::vec3 scale = glm::vec3(1.0f);
+	};
+
+	struct glTFSkin {
+		std::string name;
+		std::vector<uint32_t> joints;   // node indices, the order the JOINTS_0 attribute refers to
+		int32_t inverseBindMatrices = -1;
+		int32_t skeleton = -1;
+	};
+
+	struct glTFAnimationSampler {
+		uint32_t input = 0;             // accessor with the key times
+		uint32_t output = 0;            // accessor with the key values
+		std::string interpolation = "LINEAR";
+	};
+
+	struct glTFAnimationChannel {
+		uint32_t sampler = 0;
+		int32_t node = -1;
+		std::string path;               // translation, rotation, scale or weights
+	};
+
+	struct glTFAnimation {
+		std::string name;
+		std::vector<glTFAnimationSampler> samplers;
+		std::vector<glTFAnimationChannel> channels;
+	};
+
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <memory>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+
+namespace Rapture {
+
+    /**
+     * @brief Fixed capacity queue any number of threads push to and pop from without locks
+     *
+     * A ring of cells, each with a sequence number saying whose turn the cell is (Vyukov's bounded MPMC queue).
+     * Pushing and popping claim a position with one compare-exchange and never wait on another thread,
+     * tryPush fails on a full queue and tryPop on an empty one. The capacity is rounded up to a power of two.
+     */
+    template<typename T>
+    class BoundedQueue {
+    public:
+        explicit BoundedQueue(size_t capacity)
+        {
+            size_t cellCount = 2;
+            while (cellCount < capacity) {
+                cellCount *= 2;
+            }
+            m_cells = std::make_unique<Cell[]>(cellCount);
+            m_mask = cellCount - 1;
+            for (size_t i = 0; i < cellCount; i++) {
+                m_cells[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        BoundedQueue(const BoundedQueue&) = delete;
+        BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+        // Leaves value untouched when the queue is full
+        bool tryPush(T&& value)
+        {
+            size_t position = m_enqueuePosition.load(std::memory_order_relaxed);
+            Cell* cell = nullptr;
+            while (true) {
+                cell = &m_cells[position & m_mask];
+                size_t sequence = cell->sequence.load(std::memory_order_acquire);
+                intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+                if (difference == 0) {
+                    if (m_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                }
+                else if (difference < 0) {
+                    return false;
+                }
+                else {
+                    position = m_enqueuePosition.load(std::memory_order_relaxed);
+                }
+            }
+
+            cell->value = std::move(value);
+            cell->sequence.store(position + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool tryPop(T& value)
+        {
+            size_t position = m_dequeuePosition.load(std::memory_order_relaxed);
+            Cell* cell = nullptr;
+            while (true) {
+                cell = &m_cells[position & m_mask];
+                size_t sequence = cell->sequence.load(std::memory_order_acquire);
+                intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+                if (difference == 0) {
+                    if (m_dequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                }
+                else if (difference < 0) {
+                    return false;
+                }
+                else {
+                    position = m_dequeuePosition.load(std::memory_order_relaxed);
+                }
+            }
+
+            value = std::move(cell->value);
+            cell->value = T();
+            cell->sequence.store(position + m_mask + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Claimed pushes minus claimed pops, exact only while no other thread pushes or pops
+        size_t size() const
+        {
+            size_t dequeued = m_dequeuePosition.load(std::memory_order_seq_cst);
+            size_t enqueued = m_enqueuePosition.load(std::memory_order_seq_cst);
+            return enqueued > dequeued ? std::min(enqueued - dequeued, capacity()) : 0;
+        }
+
+        bool empty() const { return size() == 0; }
+        size_t capacity() const { return m_mask + 1; }
+
+    private:
+        struct Cell {
+            std::atomic<size_t> sequence{ 0 };
+            T value{};
+        };
+
+        std::unique_ptr<Cell[]> m_cells;
+        size_t m_mask = 0;
+
+        // On their own cache lines, producers and consumers don't invalidate each other's position
+        alignas(64) std::atomic<size_t> m_enqueuePosition{ 0 };
+        alignas(64) std::atomic<size_t> m_dequeuePosition{ 0 };
+    };
+
+}
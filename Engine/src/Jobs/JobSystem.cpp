@@ -0,0 +1,447 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+
+#include "../Logger/Log.h"
+#include "../Debug/TracyProfiler.h"
+
+namespace Rapture {
+
+    std::vector<std::unique_ptr<JobWorker>> JobSystem::s_workers;
+    std::vector<std::thread> JobSystem::s_threads;
+    std::mutex JobSystem::s_injectionMutex;
+    std::deque<Job> JobSystem::s_injectionQueues[JOB_PRIORITY_COUNT];
+    std::mutex JobSystem::s_mainThreadMutex;
+    std::vector<Job> JobSystem::s_mainThreadJobs;
+    std::atomic<size_t> JobSystem::s_mainThreadJobCount(0);
+    std::thread::id JobSystem::s_mainThreadId;
+    std::mutex JobSystem::s_sleepMutex;
+    std::condition_variable JobSystem::s_sleepCondition;
+    std::atomic<size_t> JobSystem::s_queuedJobs[JOB_PRIORITY_COUNT];
+    std::atomic<size_t> JobSystem::s_sleepingThreads(0);
+    std::atomic<size_t> JobSystem::s_waitingThreads(0);
+    std::atomic<bool> JobSystem::s_isRunning(false);
+    thread_local int JobSystem::s_workerIndex = -1;
+
+    void JobSystem::init(unsigned int workerCount)
+    {
+        if (s_isRunning) {
+            GE_CORE_WARN("JobSystem: Already initialized");
+            return;
+        }
+
+        if (workerCount == 0) {
+            workerCount = std::max(2u, std::thread::hardware_concurrency()) - 1;
+        }
+
+        s_mainThreadId = std::this_thread::get_id();
+        s_isRunning = true;
+
+        // Every deque exists before the first worker starts stealing from it
+        s_workers.reserve(workerCount);
+        for (unsigned int i = 0; i < workerCount; i++) {
+            s_workers.push_back(std::make_unique<JobWorker>());
+        }
+        s_threads.reserve(workerCount);
+        for (unsigned int i = 0; i < workerCount; i++) {
+            s_threads.emplace_back(&JobSystem::workerLoop, static_cast<size_t>(i));
+        }
+
+        GE_CORE_INFO("JobSystem: Initialized with {0} worker threads", workerCount);
+    }
+
+    void JobSystem::shutdown()
+    {
+        if (!s_isRunning) {
+            GE_CORE_WARN("JobSystem: Not initialized, nothing to shut down");
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(s_sleepMutex);
+            s_isRunning = false;
+        }
+        s_sleepCondition.notify_all();
+
+        // Workers only leave once every queue is empty, so nothing scheduled before shutdown is lost
+        for (auto& thread : s_threads) {
+            if (thread.joinable()) {
+                thread.join();
+            }
+        }
+        s_threads.clear();
+        s_workers.clear();
+
+        std::vector<Job> dropped;
+        {
+            std::lock_guard<std::mutex> lock(s_mainThreadMutex);
+            dropped.swap(s_mainThreadJobs);
+            s_mainThreadJobCount = 0;
+        }
+        if (!dropped.empty()) {
+            GE_CORE_WARN("JobSystem: Dropping {0} main thread jobs on shutdown", dropped.size());
+        }
+        // Anyone still waiting on them is released
+        for (Job& job : dropped) {
+            finish(job.counter);
+        }
+
+        GE_CORE_INFO("JobSystem: Shutdown");
+    }
+
+    JobHandle JobSystem::schedule(std::function<void()> task, JobPriority priority, const JobHandle& parent)
+    {
+        Job job;
+        job.task = std::move(task);
+        job.counter = std::make_shared<JobCounter>();
+        job.priority = priority;
+        if (parent) {
+            parent->m_pending++;
+            job.counter->m_parent = parent;
+        }
+
+        JobHandle handle = job.counter;
+        enqueue(std::move(job));
+        return handle;
+    }
+
+    JobHandle JobSystem::scheduleAfter(const JobHandle& dependency, std::function<void()> task, JobPriority priority)
+    {
+        if (!dependency) {
+            return schedule(std::move(task), priority);
+        }
+
+        Job job;
+        job.task = std::move(task);
+        job.counter = std::make_shared<JobCounter>();
+        job.priority = priority;
+        JobHandle handle = job.counter;
+
+        {
+            // finish() zeroes the counter before it takes the continuations under this lock, so none can be missed
+            std::lock_guard<std::mutex> lock(dependency->m_mutex);
+            if (!dependency->isDone()) {
+                dependency->m_continuations.push_back(std::move(job));
+                return handle;
+            }
+        }
+
+        enqueue(std::move(job));
+        return handle;
+    }
+
+    JobHandle JobSystem::scheduleOnMainThread(std::function<void()> task, const JobHandle& parent)
+    {
+        Job job;
+        job.task = std::move(task);
+        job.counter = std::make_shared<JobCounter>();
+        job.priority = JobPriority::High;
+        job.isMainThreadOnly = true;
+        if (parent) {
+            parent->m_pending++;
+            job.counter->m_parent = parent;
+        }
+
+        JobHandle handle = job.counter;
+        enqueue(std::move(job));
+        return handle;
+    }
+
+    void JobSystem::runMainThreadJobs()
+    {
+        RAPTURE_PROFILE_FUNCTION();
+
+        if (s_mainThreadJobCount == 0) {
+            return;
+        }
+
+        // Jobs queued by the ones running now wait for the next call, so a chain of them can't stall the frame
+        std::vector<Job> jobs;
+        {
+            std::lock_guard<std::mutex> lock(s_mainThreadMutex);
+            jobs.swap(s_mainThreadJobs);
+            s_mainThreadJobCount = 0;
+        }
+
+        for (Job& job : jobs) {
+            execute(job);
+        }
+    }
+
+    size_t JobSystem::getQueuedJobCount(JobPriority upTo)
+    {
+        // Popping decrements right after taking the job and pushing increments right after queueing it,
+        // so a count may briefly wrap below zero. Such a sum reads as huge, which only costs a spurious wake-up
+        size_t count = 0;
+        for (size_t priority = 0; priority <= static_cast<size_t>(upTo); priority++) {
+            count += s_queuedJobs[priority];
+        }
+        return count;
+    }
+
+    void JobSystem::wait(const JobHandle& handle, JobPriority helpUpTo)
+    {
+        if (!handle || handle->isDone()) {
+            return;
+        }
+
+        RAPTURE_PROFILE_FUNCTION();
+
+        bool isMain = isMainThread();
+        s_waitingThreads++;
+        while (!handle->isDone()) {
+            // The awaited job may well be GL work only this thread can run
+            if (isMain && s_mainThreadJobCount > 0) {
+                runMainThreadJobs();
+                continue;
+            }
+            if (tryRunJob(helpUpTo)) {
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(s_sleepMutex);
+            s_sleepingThreads++;
+            s_sleepCondition.wait(lock, [&handle, isMain, helpUpTo] {
+                return handle->isDone() || getQueuedJobCount(helpUpTo) > 0 || (isMain && s_mainThreadJobCount > 0);
+            });
+            s_sleepingThreads--;
+        }
+        s_waitingThreads--;
+    }
+
+    void JobSystem::wait(const std::vector<JobHandle>& handles, JobPriority helpUpTo)
+    {
+        for (const JobHandle& handle : handles) {
+            wait(handle, helpUpTo);
+        }
+    }
+
+    void JobSystem::parallelFor(size_t count, const std::function<void(size_t)>& task, JobPriority priority)
+    {
+        // Each thread claims the next unprocessed index until none are left
+        std::atomic<size_t> nextIndex(0);
+        auto claim = [&nextIndex, &task, count]() {
+            for (size_t i = nextIndex++; i < count; i = nextIndex++) {
+                // One bad index must not abandon the rest of the loop
+                try {
+                    task(i);
+                }
+                catch (const std::exception& e) {
+                    GE_CORE_ERROR("JobSystem: Parallel task {0} failed: {1}", i, e.what());
+                }
+            }
+        };
+
+        // The calling thread works too, helpers that start after the indices ran out return right away
+        size_t helperCount = std::min(count > 0 ? count - 1 : 0, s_workers.size());
+        if (!s_isRunning || helperCount == 0) {
+            claim();
+            return;
+        }
+
+        std::vector<JobHandle> helpers;
+        helpers.reserve(helperCount);
+        for (size_t i = 0; i < helperCount; i++) {
+            helpers.push_back(schedule(claim, priority));
+        }
+        claim();
+
+        // Everything the helpers reference lives on this stack frame
+        wait(helpers, priority);
+    }
+
+    void JobSystem::parallelForRange(size_t count, size_t batchSize, const std::function<void(size_t begin, size_t end)>& task, JobPriority priority)
+    {
+        batchSize = std::max<size_t>(1, batchSize);
+        size_t batchCount = (count + batchSize - 1) / batchSize;
+        parallelFor(batchCount, [&task, batchSize, count](size_t batch) {
+            size_t begin = batch * batchSize;
+            task(begin, std::min(begin + batchSize, count));
+        }, priority);
+    }
+
+    void JobSystem::workerLoop(size_t workerIndex)
+    {
+        RAPTURE_PROFILE_THREAD("Job Worker");
+        s_workerIndex = static_cast<int>(workerIndex);
+
+        while (true) {
+            if (tryRunJob()) {
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(s_sleepMutex);
+            if (!s_isRunning && getQueuedJobCount() == 0) {
+                break;
+            }
+            s_sleepingThreads++;
+            s_sleepCondition.wait(lock, [] { return getQueuedJobCount() > 0 || !s_isRunning; });
+            s_sleepingThreads--;
+        }
+
+        s_workerIndex = -1;
+    }
+
+    void JobSystem::enqueue(Job&& job)
+    {
+        if (job.isMainThreadOnly) {
+            {
+                std::lock_guard<std::mutex> lock(s_mainThreadMutex);
+                s_mainThreadJobs.push_back(std::move(job));
+                s_mainThreadJobCount++;
+            }
+            // The main thread may be asleep in wait(), it is woken along with everyone else
+            if (s_sleepingThreads > 0) {
+                wakeSleepers(true);
+            }
+            return;
+        }
+
+        // Without workers (before init or after shutdown) the job runs on the caller
+        if (!s_isRunning && s_threads.empty()) {
+            execute(job);
+            return;
+        }
+
+        size_t priority = static_cast<size_t>(job.priority);
+        if (s_workerIndex >= 0 && static_cast<size_t>(s_workerIndex) < s_workers.size()) {
+            JobWorker& worker = *s_workers[s_workerIndex];
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            worker.queues[priority].push_back(std::move(job));
+        }
+        else {
+            std::lock_guard<std::mutex> lock(s_injectionMutex);
+            s_injectionQueues[priority].push_back(std::move(job));
+        }
+
+        s_queuedJobs[priority]++;
+        // A single wake-up could go to a waiter that doesn't help with this priority
+        if (s_sleepingThreads > 0) {
+            wakeSleepers(s_waitingThreads > 0);
+        }
+    }
+
+    bool JobSystem::popJob(Job& job, JobPriority maxPriority)
+    {
+        size_t workerCount = s_workers.size();
+        for (size_t priority = 0; priority <= static_cast<size_t>(maxPriority); priority++) {
+            if (s_queuedJobs[priority] == 0) {
+                continue;
+            }
+
+            if (s_workerIndex >= 0) {
+                JobWorker& own = *s_workers[s_workerIndex];
+                std::lock_guard<std::mutex> lock(own.mutex);
+                if (!own.queues[priority].empty()) {
+                    job = std::move(own.queues[priority].back());
+                    own.queues[priority].pop_back();
+                    s_queuedJobs[priority]--;
+                    return true;
+                }
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(s_injectionMutex);
+                if (!s_injectionQueues[priority].empty()) {
+                    job = std::move(s_injectionQueues[priority].front());
+                    s_injectionQueues[priority].pop_front();
+                    s_queuedJobs[priority]--;
+                    return true;
+                }
+            }
+
+            // Victims are visited starting after this worker, so thieves spread out instead of all hitting worker 0
+            size_t first = s_workerIndex >= 0 ? static_cast<size_t>(s_workerIndex) + 1 : 0;
+            for (size_t i = 0; i < workerCount; i++) {
+                size_t victimIndex = (first + i) % workerCount;
+                if (static_cast<int>(victimIndex) == s_workerIndex) {
+                    continue;
+                }
+
+                JobWorker& victim = *s_workers[victimIndex];
+                std::lock_guard<std::mutex> lock(victim.mutex);
+                if (!victim.queues[priority].empty()) {
+                    job = std::move(victim.queues[priority].front());
+                    victim.queues[priority].pop_front();
+                    s_queuedJobs[priority]--;
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    bool JobSystem::tryRunJob(JobPriority maxPriority)
+    {
+        Job job;
+        if (!popJob(job, maxPriority)) {
+            return false;
+        }
+        execute(job);
+        return true;
+    }
+
+    void JobSystem::execute(Job& job)
+    {
+        {
+            RAPTURE_PROFILE_SCOPE("Job");
+            // An exception must not take down a worker, nor leave the job's waiters hanging
+            try {
+                if (job.task) {
+                    job.task();
+                }
+            }
+            catch (const std::exception& e) {
+                GE_CORE_ERROR("JobSystem: Job failed: {0}", e.what());
+            }
+            catch (...) {
+                GE_CORE_ERROR("JobSystem: Job failed with an unknown exception");
+            }
+        }
+
+        // Release whatever the task captured before anyone waiting on the job resumes
+        job.task = nullptr;
+        finish(job.counter);
+    }
+
+    void JobSystem::finish(const JobHandle& counter)
+    {
+        // Walk up the parents iteratively, each one finishes when its last child does
+        JobHandle current = counter;
+        while (current) {
+            if (current->m_pending.fetch_sub(1) != 1) {
+                break;
+            }
+
+            std::vector<Job> continuations;
+            {
+                std::lock_guard<std::mutex> lock(current->m_mutex);
+                continuations.swap(current->m_continuations);
+            }
+            for (Job& continuation : continuations) {
+                enqueue(std::move(continuation));
+            }
+
+            current = std::move(current->m_parent);
+        }
+
+        if (s_waitingThreads > 0) {
+            wakeSleepers(true);
+        }
+    }
+
+    void JobSystem::wakeSleepers(bool all)
+    {
+        // Taking the lock orders the wake-up after a sleeper's last look at its predicate
+        {
+            std::lock_guard<std::mutex> lock(s_sleepMutex);
+        }
+        if (all) {
+            s_sleepCondition.notify_all();
+        }
+        else {
+            s_sleepCondition.notify_one();
+        }
+    }
+
+}
@@ -0,0 +1,167 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <functional>
+#include <condition_variable>
+
+namespace Rapture {
+
+    // Queues are always drained highest priority first, on every thread
+    enum class JobPriority : uint8_t {
+        High = 0,       // frame work somebody is waiting on right now: culling, animation
+        Normal,         // parallel loops inside background work, e.g. a loader decoding its primitives
+        Low,            // background work that may take many frames: model loads, texture decode
+        Count
+    };
+
+    constexpr size_t JOB_PRIORITY_COUNT = static_cast<size_t>(JobPriority::Count);
+
+    class JobCounter;
+    using JobHandle = std::shared_ptr<JobCounter>;
+
+    struct Job {
+        std::function<void()> task;
+        JobHandle counter;
+        JobPriority priority = JobPriority::Normal;
+        bool isMainThreadOnly = false;
+    };
+
+    // Unfinished work of one job: the job itself plus every child scheduled under it.
+    // A job counts as done only once all of its children are, continuations run after that
+    class JobCounter {
+    public:
+        bool isDone() const { return m_pending.load(std::memory_order_acquire) == 0; }
+
+    private:
+        friend class JobSystem;
+
+        std::atomic<uint32_t> m_pending{ 1 };
+        JobHandle m_parent;
+
+        // Jobs scheduled with scheduleAfter, released once the counter reaches zero
+        std::mutex m_mutex;
+        std::vector<Job> m_continuations;
+    };
+
+    // Per-thread state of a worker. The owner pushes and pops at the back (newest first, its data is still in cache),
+    // thieves take from the front (oldest first, usually the largest remaining pieces of work)
+    struct JobWorker {
+        std::mutex mutex;
+        std::deque<Job> queues[JOB_PRIORITY_COUNT];
+    };
+
+    /**
+     * @brief Engine wide job system, one set of worker threads shared by loaders, culling and systems
+     *
+     * Every worker owns a deque per priority and steals from the others when its own run dry, jobs scheduled
+     * from threads outside the system go to a shared injection queue. Waiting on a job never idles a thread
+     * while there is work: wait() and parallelFor() run queued jobs until the awaited one is done.
+     * GL work goes through the main thread queue, drained once per frame by runMainThreadJobs(). While a render
+     * thread owns GL, main thread jobs record it through RenderThread::submit instead.
+     */
+    class JobSystem {
+    public:
+        // Starts the workers, 0 uses one less than the hardware threads (the main thread helps while it waits).
+        // Must be called on the main (GL) thread
+        static void init(unsigned int workerCount = 0);
+
+        // Runs the jobs still queued, then stops the workers. Main thread jobs that never ran are dropped
+        static void shutdown();
+
+        /**
+         * @brief Queue a job on the workers
+         *
+         * @param task Work to run, exceptions are caught and logged
+         * @param priority Queue the job goes into
+         * @param parent Job this one is a child of, the parent isn't done before its children are
+         * @return Handle to wait on or to schedule continuations after
+         */
+        static JobHandle schedule(std::function<void()> task, JobPriority priority = JobPriority::Normal, const JobHandle& parent = nullptr);
+
+        // Queue a job once dependency (and all of its children) is done, right away if it already is
+        static JobHandle scheduleAfter(const JobHandle& dependency, std::function<void()> task, JobPriority priority = JobPriority::Normal);
+
+        // Queue GL work for the main thread, it runs at the next runMainThreadJobs()
+        static JobHandle scheduleOnMainThread(std::function<void()> task, const JobHandle& parent = nullptr);
+
+        // Main thread only, runs the main thread jobs queued so far. Call once per frame
+        static void runMainThreadJobs();
+
+        // Returns once the job and its children are done, running queued jobs of at most helpUpTo priority meanwhile.
+        // A frame waiting on culling passes High, so it never ends up running a whole model load
+        static void wait(const JobHandle& handle, JobPriority helpUpTo = JobPriority::Low);
+        static void wait(const std::vector<JobHandle>& handles, JobPriority helpUpTo = JobPriority::Low);
+
+        /**
+         * @brief Run task(i) for every i below count on the workers and the calling thread, returns once all are done
+         *
+         * Indices are claimed one by one, so uneven tasks balance themselves. Tasks must not touch GL.
+         * While waiting for the helpers, the caller only runs other jobs of the same or a higher priority.
+         *
+         * @param count Number of tasks
+         * @param task Work for one index
+         * @param priority Queue the helper jobs go into
+         */
+        static void parallelFor(size_t count, const std::function<void(size_t)>& task, JobPriority priority = JobPriority::High);
+
+        // Same, but hands out contiguous ranges of at most batchSize indices, for tasks too small to claim one by one
+        static void parallelForRange(size_t count, size_t batchSize, const std::function<void(size_t begin, size_t end)>& task,
+            JobPriority priority = JobPriority::High);
+
+        static bool isInitialized() { return s_isRunning; }
+        static bool isMainThread() { return std::this_thread::get_id() == s_mainThreadId; }
+        static bool isWorkerThread() { return s_workerIndex >= 0; }
+        static size_t getWorkerCount() { return s_workers.size(); }
+
+        // Jobs queued on the workers and not started yet
+        static size_t getQueuedJobCount(JobPriority upTo = JobPriority::Low);
+        static size_t getMainThreadJobCount() { return s_mainThreadJobCount; }
+
+    private:
+        static void workerLoop(size_t workerIndex);
+
+        // Push a ready job onto the calling worker's deque, or the injection queue from any other thread
+        static void enqueue(Job&& job);
+
+        // Take the most important job of at most maxPriority this thread can run,
+        // own deque first, then the injection queue, then steal
+        static bool popJob(Job& job, JobPriority maxPriority);
+        static bool tryRunJob(JobPriority maxPriority = JobPriority::Low);
+
+        static void execute(Job& job);
+        static void finish(const JobHandle& counter);
+
+        static void wakeSleepers(bool all);
+
+    private:
+        static std::vector<std::unique_ptr<JobWorker>> s_workers;
+        static std::vector<std::thread> s_threads;
+
+        // Jobs scheduled from threads that aren't workers
+        static std::mutex s_injectionMutex;
+        static std::deque<Job> s_injectionQueues[JOB_PRIORITY_COUNT];
+
+        static std::mutex s_mainThreadMutex;
+        static std::vector<Job> s_mainThreadJobs;
+        static std::atomic<size_t> s_mainThreadJobCount;
+        static std::thread::id s_mainThreadId;
+
+        // Idle workers and waiting threads sleep here until a job is queued or a counter they wait on finishes
+        static std::mutex s_sleepMutex;
+        static std::condition_variable s_sleepCondition;
+        static std::atomic<size_t> s_queuedJobs[JOB_PRIORITY_COUNT];
+        static std::atomic<size_t> s_sleepingThreads;
+        static std::atomic<size_t> s_waitingThreads;
+
+        static std::atomic<bool> s_isRunning;
+
+        // Index into s_workers of the calling thread, -1 on threads the system didn't start
+        static thread_local int s_workerIndex;
+    };
+
+}
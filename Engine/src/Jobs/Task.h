@@ -0,0 +1,303 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <utility>
+#include <optional>
+#include <variant>
+#include <exception>
+#include <coroutine>
+#include <type_traits>
+
+#include "JobSystem.h"
+#include "../Logger/Log.h"
+
+namespace Rapture {
+
+    // Thread a coroutine continues on once what it awaits is done
+    enum class ResumeOn {
+        MainThread,     // at the next runMainThreadJobs(), GL, scenes and the libraries may be touched
+        Worker          // as a job on the JobSystem workers, CPU work only
+    };
+
+    template<typename T = void>
+    class Task;
+
+    namespace TaskDetail {
+
+        // Continue a suspended coroutine on the requested thread. Already being on the main thread resumes right away,
+        // a worker always goes through the queue so the code that finished the awaited work isn't held up
+        inline void resume(std::coroutine_handle<> handle, ResumeOn resumeOn, JobPriority priority = JobPriority::Normal) {
+            if (resumeOn == ResumeOn::MainThread) {
+                if (JobSystem::isMainThread()) {
+                    handle.resume();
+                    return;
+                }
+                JobSystem::scheduleOnMainThread([handle]() { handle.resume(); });
+                return;
+            }
+            JobSystem::schedule([handle]() { handle.resume(); }, priority);
+        }
+
+        struct PromiseBase {
+            std::coroutine_handle<> continuation;
+            std::exception_ptr exception;
+            bool isDetached = false;
+
+            // Tasks are lazy, nothing runs before the task is awaited or detached
+            std::suspend_always initial_suspend() noexcept { return {}; }
+
+            // Hands the thread straight to whoever awaited the task, a detached task frees itself
+            struct FinalAwaiter {
+                bool await_ready() noexcept { return false; }
+
+                template<typename Promise>
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+                    PromiseBase& promise = handle.promise();
+                    if (promise.continuation) {
+                        return promise.continuation;
+                    }
+                    if (promise.isDetached) {
+                        if (promise.exception) {
+                            logDetachedException(promise.exception);
+                        }
+                        handle.destroy();
+                    }
+                    return std::noop_coroutine();
+                }
+
+                void await_resume() noexcept {}
+            };
+
+            FinalAwaiter final_suspend() noexcept { return {}; }
+
+            void unhandled_exception() noexcept { exception = std::current_exception(); }
+
+            void rethrowIfFailed() {
+                if (exception) {
+                    std::rethrow_exception(exception);
+                }
+            }
+
+            static void logDetachedException(const std::exception_ptr& exception) {
+                try {
+                    std::rethrow_exception(exception);
+                }
+                catch (const std::exception& e) {
+                    GE_CORE_ERROR("Task: Detached task failed: {}", e.what());
+                }
+                catch (...) {
+                    GE_CORE_ERROR("Task: Detached task failed with an unknown exception");
+                }
+            }
+        };
+
+        template<typename T>
+        struct TaskPromise : PromiseBase {
+            std::optional<T> value;
+
+            template<typename U>
+            void return_value(U&& result) { value.emplace(std::forward<U>(result)); }
+
+            T takeResult() {
+                rethrowIfFailed();
+                return std::move(*value);
+            }
+        };
+
+        template<>
+        struct TaskPromise<void> : PromiseBase {
+            void return_void() {}
+            void takeResult() { rethrowIfFailed(); }
+        };
+
+    }
+
+    /**
+     * @brief Result of a coroutine, awaited with co_await from another coroutine
+     *
+     * Tasks are lazy: the body starts when the task is first awaited (or detached) and runs on the awaiting thread
+     * until its first suspension. Whoever awaits it continues on the thread that finished it, asset awaitables and
+     * resumeOn() pick that thread explicitly. Exceptions thrown in the body are rethrown by co_await.
+     *
+     * A coroutine that nobody awaits, e.g. one started from a layer's onUpdate, is started with detach().
+     */
+    template<typename T>
+    class [[nodiscard]] Task {
+    public:
+        struct promise_type : TaskDetail::TaskPromise<T> {
+            Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        };
+
+        Task() = default;
+        Task(Task&& other) noexcept : m_handle(std::exchange(other.m_handle, nullptr)) {}
+        Task& operator=(Task&& other) noexcept {
+            if (this != &other) {
+                reset();
+                m_handle = std::exchange(other.m_handle, nullptr);
+            }
+            return *this;
+        }
+        Task(const Task&) = delete;
+        Task& operator=(const Task&) = delete;
+        ~Task() { reset(); }
+
+        bool isValid() const { return m_handle != nullptr; }
+
+        // Start the task without awaiting it, it frees itself once done. Exceptions are logged
+        void detach() {
+            if (!m_handle) {
+                return;
+            }
+            std::coroutine_handle<promise_type> handle = std::exchange(m_handle, nullptr);
+            handle.promise().isDetached = true;
+            handle.resume();
+        }
+
+        bool await_ready() const noexcept { return false; }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+            m_handle.promise().continuation = awaiting;
+            return m_handle;
+        }
+
+        T await_resume() { return m_handle.promise().takeResult(); }
+
+    private:
+        explicit Task(std::coroutine_handle<promise_type> handle) : m_handle(handle) {}
+
+        void reset() {
+            if (m_handle) {
+                m_handle.destroy();
+                m_handle = nullptr;
+            }
+        }
+
+    private:
+        std::coroutine_handle<promise_type> m_handle;
+    };
+
+    // co_await resumeOn(ResumeOn::Worker) moves the rest of a coroutine onto a worker, ResumeOn::MainThread back onto
+    // the GL thread. A coroutine already on the requested side keeps running
+    inline auto resumeOn(ResumeOn where, JobPriority priority = JobPriority::Normal) {
+        struct Awaiter {
+            ResumeOn where;
+            JobPriority priority;
+
+            bool await_ready() const {
+                return where == ResumeOn::MainThread ? JobSystem::isMainThread() : JobSystem::isWorkerThread();
+            }
+            void await_suspend(std::coroutine_handle<> handle) const { TaskDetail::resume(handle, where, priority); }
+            void await_resume() const noexcept {}
+        };
+        return Awaiter{ where, priority };
+    }
+
+    namespace TaskDetail {
+
+        // Shared by the tasks of one whenAll: the last one to finish resumes the coroutine awaiting them all
+        struct WhenAllCounter {
+            std::atomic<size_t> remaining;
+            std::coroutine_handle<> continuation;
+            std::exception_ptr exception;
+            std::atomic<bool> hasFailed{ false };
+
+            explicit WhenAllCounter(size_t count) : remaining(count + 1) {}
+
+            void fail(std::exception_ptr error) {
+                if (!hasFailed.exchange(true, std::memory_order_relaxed)) {
+                    exception = std::move(error);
+                }
+            }
+
+            void finishOne() {
+                if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    continuation.resume();
+                }
+            }
+        };
+
+        // Eager coroutine running one task of a whenAll, frees itself when done
+        struct WhenAllItem {
+            struct promise_type {
+                WhenAllItem get_return_object() noexcept { return {}; }
+                std::suspend_never initial_suspend() noexcept { return {}; }
+                std::suspend_never final_suspend() noexcept { return {}; }
+                void return_void() noexcept {}
+                void unhandled_exception() noexcept { std::terminate(); }
+            };
+        };
+
+        template<typename T, typename Slot>
+        WhenAllItem runWhenAllItem(Task<T> task, Slot* slot, WhenAllCounter* counter) {
+            try {
+                if constexpr (std::is_void_v<T>) {
+                    co_await task;
+                    slot->emplace();
+                }
+                else {
+                    slot->emplace(co_await task);
+                }
+            }
+            catch (...) {
+                counter->fail(std::current_exception());
+            }
+            counter->finishOne();
+        }
+
+        // Starts every task, then suspends until the counter runs out. The extra count held by the awaiter makes
+        // sure tasks that all finish while still being started don't resume the coroutine before it suspended
+        template<typename T, typename Slot>
+        struct WhenAllAwaiter {
+            std::vector<Task<T>>& tasks;
+            std::vector<Slot>& slots;
+            WhenAllCounter& counter;
+
+            bool await_ready() const noexcept { return tasks.empty(); }
+
+            bool await_suspend(std::coroutine_handle<> handle) {
+                counter.continuation = handle;
+                for (size_t i = 0; i < tasks.size(); i++) {
+                    runWhenAllItem(std::move(tasks[i]), &slots[i], &counter);
+                }
+                return counter.remaining.fetch_sub(1, std::memory_order_acq_rel) > 1;
+            }
+
+            void await_resume() const noexcept {}
+        };
+
+    }
+
+    /**
+     * @brief Await several tasks at once, they all start right away instead of one after the other
+     *
+     * The awaiting coroutine continues on the thread that finished the last task. If any task throws, the
+     * first exception is rethrown once all of them are done.
+     *
+     * @param tasks Tasks to run, e.g. one AssetTasks::loadTexture per texture of a material
+     * @return The results in the order of the tasks
+     */
+    template<typename T>
+    Task<std::conditional_t<std::is_void_v<T>, void, std::vector<T>>> whenAll(std::vector<Task<T>> tasks) {
+        using Slot = std::optional<std::conditional_t<std::is_void_v<T>, std::monostate, T>>;
+
+        std::vector<Slot> slots(tasks.size());
+        TaskDetail::WhenAllCounter counter(tasks.size());
+
+        co_await TaskDetail::WhenAllAwaiter<T, Slot>{ tasks, slots, counter };
+
+        if (counter.exception) {
+            std::rethrow_exception(counter.exception);
+        }
+
+        if constexpr (!std::is_void_v<T>) {
+            std::vector<T> results;
+            results.reserve(slots.size());
+            for (Slot& slot : slots) {
+                results.push_back(std::move(*slot));
+            }
+            co_return results;
+        }
+    }
+
+}
@@ -9,6 +9,8 @@
 //#include "../File Loaders/glTF/glTFLoader.h"
 //#include "../File Loaders/glTF/glTF2Loader.h"
 #include "../Logger/Log.h"
+#include "../Renderer/RenderThread.h"
+#include "../Jobs/JobSystem.h"
 #include <glad/glad.h>
 
 namespace Rapture
@@ -36,6 +38,33 @@ namespace Rapture
 
     bool Mesh::setMeshData(BufferLayout layout, const void* vertexData, size_t vertexDataSize, const void* indexData, size_t indexDataSize, size_t indexCount, unsigned int indexType)
     {
+        // VAOs aren't shared with the render thread's context, so they are created there. The result is handed back
+        // through the main thread's queue, m_meshBufferData is main thread state that frames are extracted from
+        if (RenderThread::isRunning() && !RenderThread::isRenderThread()) {
+            std::shared_ptr<Mesh> self = weak_from_this().lock();
+            if (!self) {
+                GE_CORE_ERROR("Mesh::setMeshData: Mesh isn't owned by a shared_ptr, can't fill it on the render thread");
+                return false;
+            }
+
+            const unsigned char* vertexBytes = static_cast<const unsigned char*>(vertexData);
+            const unsigned char* indexBytes = static_cast<const unsigned char*>(indexData);
+            RenderThread::submit([self, layout = std::move(layout),
+                vertices = std::vector<unsigned char>(vertexBytes, vertexBytes + vertexDataSize),
+                indices = std::vector<unsigned char>(indexBytes, indexBytes + indexDataSize),
+                indexCount, indexType]() {
+                MeshBufferData meshData = BufferPoolManager::getInstance().allocateMeshData(layout,
+                    vertices.data(), vertices.size(), indices.data(), indices.size(), indexCount, indexType);
+                if (meshData.vao == nullptr) {
+                    GE_CORE_ERROR("Failed to allocate mesh data");
+                    return;
+                }
+                JobSystem::scheduleOnMainThread([self, meshData = std::move(meshData)]() {
+                    self->m_meshBufferData = meshData;
+                });
+            });
+            return true;
+        }
 
         BufferPoolManager& bufferPoolManager = BufferPoolManager::getInstance();
         m_meshBufferData = bufferPoolManager.allocateMeshData(layout, vertexData, vertexDataSize, indexData, indexDataSize, indexCount, indexType);
@@ -55,6 +84,19 @@ namespace Rapture
         return true;
     }
 
+    bool Mesh::reserveMeshData(const BufferLayout& layout, size_t vertexDataSize, size_t indexDataSize, size_t indexCount, unsigned int indexType)
+    {
+        BufferPoolManager& bufferPoolManager = BufferPoolManager::getInstance();
+        m_meshBufferData = bufferPoolManager.reserveMeshData(layout, vertexDataSize, indexDataSize, indexCount, indexType);
+
+        if (m_meshBufferData.vao == nullptr) {
+            GE_CORE_ERROR("Failed to reserve mesh data");
+            return false;
+        }
+
+        return true;
+    }
+
     std::shared_ptr<Mesh> Mesh::createCube(float size)
     {
         return nullptr;
@@ -3,6 +3,7 @@
 
 #include <string>
 #include <vector>
+#include <memory>
 
 #include "../Buffers/VertexArray.h"
 #include "../Buffers/BufferPools.h"
@@ -11,7 +12,7 @@ namespace Rapture
 {
 
 
-	class Mesh
+	class Mesh : public std::enable_shared_from_this<Mesh>
 	{
 
 	public:
@@ -26,8 +27,13 @@ namespace Rapture
 		// getters
 		//std::shared_ptr<SubMesh> addSubMesh();
 
+        // While the render thread runs, the data is copied and the buffers are filled on it. The mesh gets its
+        // buffer data on the main thread a frame or so later and isn't drawn until then. It has to be owned by a shared_ptr
         bool setMeshData(BufferLayout layout, const void* vertexData, size_t vertexDataSize, const void* indexData, size_t indexDataSize, size_t indexCount, unsigned int indexType);
 
+        // Only reserves the pool ranges, the data is uploaded afterwards by the BufferUploadQueue
+        bool reserveMeshData(const BufferLayout& layout, size_t vertexDataSize, size_t indexDataSize, size_t indexCount, unsigned int indexType);
+
 		// Create a simple cube mesh for testing
 		static std::shared_ptr<Mesh> createCube(float size = 1.0f);
 
@@ -1,6 +1,7 @@
 #include "Framebuffer.h"
 
 #include "../logger/Log.h"
+#include "RenderThread.h"
 
 #include <glad/glad.h>
 
@@ -141,6 +142,13 @@ namespace Rapture
 
 	void Framebuffer::invalidate()
 	{
+		// Framebuffer objects aren't shared between contexts, one made on another thread can't be bound by the render thread
+		if (RenderThread::isRunning() && !RenderThread::isRenderThread())
+		{
+			GE_CORE_ERROR("Framebuffer: Has to be (re)created on the render thread while it runs");
+			return;
+		}
+
 		// Cleanup existing framebuffer if it exists
 		if (m_framebufferID)
 		{
@@ -272,6 +280,11 @@ namespace Rapture
 			GE_CORE_WARN("Attempted to resize framebuffer to invalid size: {0}, {1}", width, height);
 			return;
 		}
+		if (RenderThread::isRunning() && !RenderThread::isRenderThread())
+		{
+			GE_CORE_ERROR("Framebuffer: Resize through RenderThread::submit while the render thread runs");
+			return;
+		}
 		
 		m_specification.width = width;
 		m_specification.height = height;
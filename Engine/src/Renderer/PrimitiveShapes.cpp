@@ -16,15 +16,7 @@ namespace Rapture {
         auto mesh = std::make_shared<Mesh>();
         
         // Create a simple buffer layout with only position attribute
-        BufferLayout layout;
-        BufferAttribute posAttrib;
-        posAttrib.name = "POSITION";
-        posAttrib.componentType = GL_FLOAT;
-        posAttrib.type = "VEC3";
-        posAttrib.offset = 0;
-        layout.buffer_attribs.push_back(posAttrib);
-        layout.isInterleaved = true;
-        layout.vertexSize = 3 * sizeof(float); // Only position (x,y,z)
+        const BufferLayout& layout = VertexFormatP::layout();
         
         // Set the mesh data using our layout
         mesh->setMeshData(
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include "../Scenes/Components/BoundingBox.h"
+#include "../Buffers/BufferPools.h"
+#include "../Materials/MaterialUniformLayouts.h"
+
+namespace Rapture {
+
+    class Mesh;
+    class Material;
+
+    // One mesh draw, copied out of the registry. Meshes and materials are shared, so they stay alive
+    // while the packet waits for the GL thread even if the entity is destroyed meanwhile
+    struct RenderProxy {
+        std::shared_ptr<Mesh> mesh;
+        MeshBufferData meshData;                    // copied at extraction, the main thread may hand the mesh new buffer data meanwhile
+        std::shared_ptr<Material> material;
+        glm::mat4 modelMatrix = glm::mat4(1.0f);    // skinned meshes carry their animator's transform, the joints place the vertices
+        BoundingBox worldBoundingBox;
+        int32_t jointOffset = -1;                   // first matrix in the joint palette, -1 for rigid meshes
+        int32_t morphOffset = -1;                   // first vertex in the morph deltas, -1 without active targets
+        uint32_t morphBaseVertex = 0;
+        bool isDeformed = false;                    // skinned or morphed, the depth-only shader can't place it
+        bool showBoundingBox = false;
+    };
+
+    /**
+     * @brief Everything one frame of rendering needs, extracted from a scene at a sync point on the main thread
+     *
+     * Immutable once extracted, the render passes only read the packet and never the registry, so the scene can be
+     * updated and loaded into while the frame is drawn. Packets are recycled, their vectors keep their capacity
+     * and a steady frame allocates nothing.
+     */
+    struct RenderPacket {
+        uint64_t frameIndex = 0;
+
+        // Camera
+        glm::mat4 projectionMatrix = glm::mat4(1.0f);
+        glm::mat4 viewMatrix = glm::mat4(1.0f);
+        glm::vec3 cameraPosition = glm::vec3(0.0f);
+
+        // Active lights, at most MAX_LIGHTS
+        std::vector<LightData> lights;
+
+        // Visible meshes in draw order
+        std::vector<RenderProxy> proxies;
+
+        // Animation output of the last update, indexed by the proxies' offsets
+        std::vector<glm::mat4> jointPalette;
+        std::vector<glm::vec4> morphDeltas;
+
+        // Renderer settings at extraction time
+        bool isDepthPrepassEnabled = false;
+        glm::vec3 boundingBoxColor = glm::vec3(0.0f, 1.0f, 0.0f);
+
+        // Stats
+        uint32_t meshCount = 0;
+        uint32_t entitiesCulled = 0;
+
+        void clear() {
+            lights.clear();
+            proxies.clear();
+            jointPalette.clear();
+            morphDeltas.clear();
+            meshCount = 0;
+            entitiesCulled = 0;
+        }
+    };
+
+}
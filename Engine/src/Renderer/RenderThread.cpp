@@ -0,0 +1,201 @@
+#include "RenderThread.h"
+
+#include <chrono>
+#include <algorithm>
+
+#include <glad/glad.h>
+
+#include "../WindowContext/WindowContext.h"
+#include "../Buffers/BufferUploadQueue.h"
+#include "../Logger/Log.h"
+#include "../Debug/TracyProfiler.h"
+
+namespace Rapture {
+
+    WindowContext* RenderThread::s_window = nullptr;
+    std::thread RenderThread::s_thread;
+    std::thread::id RenderThread::s_threadId;
+    std::atomic<bool> RenderThread::s_isRunning(false);
+    uint32_t RenderThread::s_maxFramesInFlight = MAX_FRAMES_IN_FLIGHT;
+    RenderFrame RenderThread::s_recording;
+    uint64_t RenderThread::s_nextFrameIndex = 0;
+    std::mutex RenderThread::s_frameMutex;
+    std::condition_variable RenderThread::s_frameCondition;
+    std::deque<RenderFrame> RenderThread::s_queuedFrames;
+    std::vector<RenderFrame> RenderThread::s_freeFrames;
+    size_t RenderThread::s_framesInFlight = 0;
+    bool RenderThread::s_stopRequested = false;
+    RenderThreadStats RenderThread::s_stats;
+
+    void RenderThread::start(WindowContext* window, uint32_t maxFramesInFlight)
+    {
+        if (s_isRunning) {
+            GE_CORE_WARN("RenderThread: Already running");
+            return;
+        }
+        if (!window) {
+            GE_CORE_ERROR("RenderThread: Cannot start without a window");
+            return;
+        }
+
+        s_window = window;
+        s_maxFramesInFlight = std::clamp(maxFramesInFlight, 1u, MAX_FRAMES_IN_FLIGHT);
+        s_stopRequested = false;
+        s_framesInFlight = 0;
+        s_stats = RenderThreadStats();
+
+        // Everything the main thread did so far has to be done before the context changes threads
+        glFinish();
+        s_window->releaseContext();
+
+        s_isRunning = true;
+        s_thread = std::thread(&RenderThread::renderLoop);
+        s_threadId = s_thread.get_id();
+
+        s_window->makeResourceContextCurrent();
+
+        GE_CORE_INFO("RenderThread: Started with {0} frames in flight", s_maxFramesInFlight);
+    }
+
+    void RenderThread::stop()
+    {
+        if (!s_isRunning) {
+            return;
+        }
+
+        // What the main thread recorded since the last frame still gets replayed
+        if (!s_recording.commands.empty()) {
+            submitFrame();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(s_frameMutex);
+            s_stopRequested = true;
+        }
+        s_frameCondition.notify_all();
+        s_thread.join();
+
+        s_isRunning = false;
+        s_threadId = std::thread::id();
+        s_freeFrames.clear();
+        s_recording = RenderFrame();
+
+        // The main thread is the GL thread again
+        s_window->makeContextCurrent();
+        BufferUploadQueue::setGLThread();
+
+        GE_CORE_INFO("RenderThread: Stopped after {0} frames", s_stats.framesRendered);
+    }
+
+    void RenderThread::submit(std::function<void()> command)
+    {
+        if (!s_isRunning || isRenderThread()) {
+            command();
+            return;
+        }
+        s_recording.commands.push_back(std::move(command));
+    }
+
+    void RenderThread::submitFrame()
+    {
+        if (!s_isRunning) {
+            return;
+        }
+
+        RAPTURE_PROFILE_FUNCTION();
+
+        // Objects created in the main thread's shared context have to reach the driver before the commands use them
+        glFlush();
+
+        auto waitStart = std::chrono::high_resolution_clock::now();
+        {
+            std::unique_lock<std::mutex> lock(s_frameMutex);
+            s_frameCondition.wait(lock, [] { return s_framesInFlight < s_maxFramesInFlight; });
+            s_stats.mainThreadWaitMs = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - waitStart).count();
+
+            s_recording.index = s_nextFrameIndex++;
+            s_queuedFrames.push_back(std::move(s_recording));
+            s_framesInFlight++;
+
+            // Record the next frame into the storage of a finished one, its command vector is already grown
+            if (!s_freeFrames.empty()) {
+                s_recording = std::move(s_freeFrames.back());
+                s_freeFrames.pop_back();
+            }
+            else {
+                s_recording = RenderFrame();
+            }
+        }
+        s_frameCondition.notify_all();
+    }
+
+    RenderThreadStats RenderThread::getStats()
+    {
+        std::lock_guard<std::mutex> lock(s_frameMutex);
+        RenderThreadStats stats = s_stats;
+        stats.framesInFlight = s_framesInFlight;
+        return stats;
+    }
+
+    void RenderThread::renderLoop()
+    {
+        RAPTURE_PROFILE_THREAD("Render Thread");
+
+        s_window->makeContextCurrent();
+        BufferUploadQueue::setGLThread();
+
+        while (true) {
+            RenderFrame frame;
+            {
+                std::unique_lock<std::mutex> lock(s_frameMutex);
+                s_frameCondition.wait(lock, [] { return !s_queuedFrames.empty() || s_stopRequested; });
+                if (s_queuedFrames.empty()) {
+                    break;
+                }
+                frame = std::move(s_queuedFrames.front());
+                s_queuedFrames.pop_front();
+            }
+
+            auto renderStart = std::chrono::high_resolution_clock::now();
+            renderFrame(frame);
+            float renderMs = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - renderStart).count();
+
+            frame.commands.clear();
+            {
+                std::lock_guard<std::mutex> lock(s_frameMutex);
+                s_framesInFlight--;
+                s_stats.renderMs = renderMs;
+                s_stats.framesRendered++;
+                s_freeFrames.push_back(std::move(frame));
+            }
+            s_frameCondition.notify_all();
+        }
+
+        glFinish();
+        s_window->releaseContext();
+    }
+
+    void RenderThread::renderFrame(RenderFrame& frame)
+    {
+        RAPTURE_PROFILE_FUNCTION();
+
+        // Mesh data staged by the loaders, before the commands that may draw it
+        {
+            RAPTURE_PROFILE_SCOPE("Buffer Uploads");
+            RAPTURE_PROFILE_GPU_SCOPE("Buffer Uploads");
+            BufferUploadQueue::processUploads();
+        }
+
+        {
+            RAPTURE_PROFILE_SCOPE("Render Commands");
+            RAPTURE_PROFILE_GPU_SCOPE("Render Commands");
+            for (std::function<void()>& command : frame.commands) {
+                command();
+            }
+        }
+
+        s_window->swapBuffers();
+        TracyProfiler::collectGPUData();
+    }
+
+}
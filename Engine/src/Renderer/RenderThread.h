@@ -0,0 +1,92 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <cstdint>
+#include <functional>
+#include <condition_variable>
+
+namespace Rapture {
+
+    class WindowContext;
+
+    // Frames the main thread may run ahead of the GL thread, one keeps input latency lowest
+    constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 2;
+
+    // GL work recorded by the main thread for one frame, replayed in order on the render thread
+    struct RenderFrame {
+        uint64_t index = 0;
+        std::vector<std::function<void()>> commands;
+    };
+
+    // Timings of the last frame the render thread finished
+    struct RenderThreadStats {
+        float renderMs = 0.0f;          // replaying the commands, mesh uploads and the swap
+        float mainThreadWaitMs = 0.0f;  // the main thread blocked in submitFrame because the GL thread fell behind
+        uint64_t framesRendered = 0;
+        size_t framesInFlight = 0;
+    };
+
+    /**
+     * @brief Optional dedicated GL thread, so game logic of frame N+1 overlaps submitting frame N
+     *
+     * While running, the render thread owns the window's context: it drains the mesh upload queue, replays the
+     * commands recorded for a frame and swaps. The main thread keeps polling input and updating the layers,
+     * GL work goes through submit() and the frame is handed over with submitFrame(), which blocks once
+     * maxFramesInFlight frames are unfinished. Commands capture what they need by value, the main thread
+     * changes its state again while they wait. The main thread gets a context sharing objects with the window's,
+     * so creating textures, buffers and shaders there keeps working. Container objects, VAOs and framebuffers,
+     * aren't shared between contexts: they have to be created and resized on the render thread, through submit().
+     *
+     * Without a render thread submit() runs the command right away and nothing else changes.
+     */
+    class RenderThread {
+    public:
+        // Main thread only, hands the window's context to a new render thread
+        static void start(WindowContext* window, uint32_t maxFramesInFlight = MAX_FRAMES_IN_FLIGHT);
+
+        // Main thread only, renders the frames still queued and gives the window's context back
+        static void stop();
+
+        static bool isRunning() { return s_isRunning; }
+        static bool isRenderThread() { return std::this_thread::get_id() == s_threadId; }
+
+        // Record GL work for the frame being built. Runs right away when there is no render thread
+        // or when called on the render thread itself
+        static void submit(std::function<void()> command);
+
+        // Main thread only, hands the recorded frame to the render thread
+        static void submitFrame();
+
+        static RenderThreadStats getStats();
+
+    private:
+        static void renderLoop();
+        static void renderFrame(RenderFrame& frame);
+
+    private:
+        static WindowContext* s_window;
+        static std::thread s_thread;
+        static std::thread::id s_threadId;
+        static std::atomic<bool> s_isRunning;
+        static uint32_t s_maxFramesInFlight;
+
+        // Frame the main thread is recording, only touched by the main thread
+        static RenderFrame s_recording;
+        static uint64_t s_nextFrameIndex;
+
+        // Frames handed over and not finished yet, plus finished ones kept to reuse their command storage
+        static std::mutex s_frameMutex;
+        static std::condition_variable s_frameCondition;
+        static std::deque<RenderFrame> s_queuedFrames;
+        static std::vector<RenderFrame> s_freeFrames;
+        static size_t s_framesInFlight;
+        static bool s_stopRequested;
+
+        static RenderThreadStats s_stats;
+    };
+
+}
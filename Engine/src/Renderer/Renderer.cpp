@@ -11,6 +11,10 @@
 #include "Raycast.h"
 #include "PrimitiveShapes.h"
 #include "../Materials/MaterialLibrary.h"
+#include "../Shaders/OpenGLShaders/OpenGLShader.h"
+#include "../Scenes/Systems/AnimationSystem.h"
+#include "../Jobs/JobSystem.h"
+#include "RenderThread.h"
 #include <algorithm>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
@@ -42,8 +46,19 @@ namespace Rapture
 	bool Renderer::s_frustumCullingEnabled = true; // Enabled by default
 	uint32_t Renderer::s_entitiesCulled = 0;
 
+	// Depth pre-pass
+	bool Renderer::s_depthPrepassEnabled = false;
+	std::unique_ptr<Shader> Renderer::s_depthOnlyShader = nullptr;
+
 	std::vector<Rapture::Entity> Renderer::s_visibleEntities;
 
+	glm::mat4 Renderer::s_frameProjectionMatrix = glm::mat4(1.0f);
+	glm::mat4 Renderer::s_frameViewMatrix = glm::mat4(1.0f);
+
+	std::mutex Renderer::s_packetPoolMutex;
+	std::vector<std::unique_ptr<RenderPacket>> Renderer::s_freePackets;
+	uint64_t Renderer::s_frameIndex = 0;
+
 	void Renderer::init()
 	{
 		RAPTURE_PROFILE_FUNCTION();
@@ -76,6 +91,9 @@ namespace Rapture
 		
 		// Set the default bounding box color
 		setBoundingBoxColor(glm::vec3(0.0f, 1.0f, 0.0f)); // Default green
+
+		// Shader for the depth pre-pass, only reads positions
+		s_depthOnlyShader = std::make_unique<OpenGLShader>("depth_only_vs.glsl", "depth_only_fs.glsl");
 		
 
 		
@@ -105,14 +123,36 @@ namespace Rapture
 		// Reset uniform buffers
 		s_cameraUBO.reset();
 		s_lightsUBO.reset();
-		
 
+		s_depthOnlyShader.reset();
+
+		{
+			std::lock_guard<std::mutex> lock(s_packetPoolMutex);
+			s_freePackets.clear();
+		}
 	}
 
 	void Renderer::sumbitScene(const std::shared_ptr<Scene> s)
 	{
+		RAPTURE_PROFILE_FUNCTION();
 
-        RAPTURE_PROFILE_GPU_SCOPE("Renderer::SubmitScene");
+		std::shared_ptr<const RenderPacket> packet = extractFrame(s);
+		if (!packet) {
+			return;
+		}
+
+		// The packet is shared with the command, the GL thread drops it once the frame is drawn
+		RenderThread::submit([packet]() {
+			renderFrame(*packet);
+		});
+
+		// Picks against the bounding boxes culling just updated, on the thread that owns the scene
+        Raycast::onFrameEnd(s_visibleEntities);
+	}
+
+	std::shared_ptr<const RenderPacket> Renderer::extractFrame(const std::shared_ptr<Scene>& s)
+	{
+		RAPTURE_PROFILE_FUNCTION();
 
 		// Reset culling counter for this frame
 		s_entitiesCulled = 0;
@@ -137,49 +177,105 @@ namespace Rapture
 		// Skip if no camera
 		if (cameraEntity == entt::null) {
 			GE_RENDER_ERROR("No camera found in scene");
-			return;
+			return nullptr;
 		}
 
-		// Setup camera uniforms and get camera position for shaders
-		glm::vec3 camPos;
+		std::shared_ptr<RenderPacket> packet = acquirePacket();
+		packet->frameIndex = s_frameIndex++;
+		packet->isDepthPrepassEnabled = s_depthPrepassEnabled;
+		packet->boundingBoxColor = s_boundingBoxColor;
+		packet->meshCount = static_cast<uint32_t>(meshEntities.size());
+
 		{
-			RAPTURE_PROFILE_SCOPE("Camera Setup");
-			if (!setupCameraUniforms(s, cameraEntity, camPos)) {
-				return;
-			}
+			RAPTURE_PROFILE_SCOPE("Camera Extraction");
+			extractCamera(s, cameraEntity, *packet);
 		}
 
 		// Update frustum for culling
 		if (s_frustumCullingEnabled) {
 			RAPTURE_PROFILE_SCOPE("Frustum Update");
-			s_frustum.update(s_cachedProjectionMatrix, s_cachedViewMatrix);
+			s_frustum.update(packet->projectionMatrix, packet->viewMatrix);
+		}
+
+		// Both passes draw the same set, so it is culled once up front
+		cullMeshEntities(s, meshEntities);
+		packet->entitiesCulled = s_entitiesCulled;
+
+		{
+			RAPTURE_PROFILE_SCOPE("Lights Extraction");
+			extractLights(s, lightEntities, *packet);
+		}
+
+		extractProxies(s, meshEntities, *packet);
+
+		// Joint palettes and morph deltas written by the last animation update
+		AnimationSystem::extractBuffers(packet->jointPalette, packet->morphDeltas);
+
+		return packet;
+	}
+
+	void Renderer::renderFrame(const RenderPacket& packet)
+	{
+		RAPTURE_PROFILE_FUNCTION();
+        RAPTURE_PROFILE_GPU_SCOPE("Renderer::SubmitScene");
+
+		{
+			RAPTURE_PROFILE_SCOPE("Camera Setup");
+			setupCameraUniforms(packet);
 		}
 
-		// Setup lights - will be skipped if no changes detected
 		{
 			RAPTURE_PROFILE_SCOPE("Lights Setup");
-			setupLightsUniforms(s, lightEntities);
+			setupLightsUniforms(packet);
+		}
+
+		// One storage buffer each for every mesh's joint palette and morph deltas
+		{
+			RAPTURE_PROFILE_SCOPE("Animation Upload");
+			AnimationSystem::uploadBuffers(packet.jointPalette, packet.morphDeltas);
+		}
+
+		// Lay down depth first, the shading pass then only passes the nearest fragment
+		if (packet.isDepthPrepassEnabled) {
+			RAPTURE_PROFILE_SCOPE("Depth Pre-pass");
+			renderDepthPrepass(packet);
+			glDepthFunc(GL_LEQUAL);
 		}
 
 		// Render all meshes
 		{
 			RAPTURE_PROFILE_SCOPE("Mesh Rendering");
-			renderMeshes(s, meshEntities, camPos);
+			renderMeshes(packet);
 		}
 
-        Raycast::onFrameEnd(s_visibleEntities);
+		if (packet.isDepthPrepassEnabled) {
+			glDepthFunc(GL_LESS);
+		}
+	}
 
-        
-        /*
-		// Log culling stats occasionally
-		static int frameCounter = 0;
-		if (s_frustumCullingEnabled && ++frameCounter % 300 == 0) {
-			GE_RENDER_INFO("Frustum culling: {0} entities culled out of {1} ({2:.1f}%)",
-				s_entitiesCulled, meshEntities.size(),
-				meshEntities.size() > 0 ? (100.0f * s_entitiesCulled / meshEntities.size()) : 0.0f);
-			frameCounter = 0;
-		}
-        */
+	std::shared_ptr<RenderPacket> Renderer::acquirePacket()
+	{
+		std::unique_ptr<RenderPacket> packet;
+		{
+			std::lock_guard<std::mutex> lock(s_packetPoolMutex);
+			if (!s_freePackets.empty()) {
+				packet = std::move(s_freePackets.back());
+				s_freePackets.pop_back();
+			}
+		}
+		if (!packet) {
+			packet = std::make_unique<RenderPacket>();
+		}
+		return std::shared_ptr<RenderPacket>(packet.release(), &Renderer::releasePacket);
+	}
+
+	void Renderer::releasePacket(RenderPacket* packet)
+	{
+		// Cleared here, so the meshes and materials of the frame are released by whoever drew it last
+		packet->clear();
+
+		std::lock_guard<std::mutex> lock(s_packetPoolMutex);
+		s_freePackets.emplace_back(packet);
 	}
 
 	void Renderer::showBoundingBox(Entity entity, bool show)
@@ -265,6 +361,17 @@ namespace Rapture
 		return s_frustumCullingEnabled;
 	}
 
+	void Renderer::enableDepthPrepass(bool enable)
+	{
+		s_depthPrepassEnabled = enable;
+		GE_RENDER_INFO("Renderer: Depth pre-pass {0}", enable ? "enabled" : "disabled");
+	}
+
+	bool Renderer::isDepthPrepassEnabled()
+	{
+		return s_depthPrepassEnabled;
+	}
+
 	void Renderer::extractSceneData(const std::shared_ptr<Scene> s, 
 								  std::vector<entt::entity>& meshEntities,
 								  entt::entity& cameraEntity,
@@ -300,15 +407,148 @@ namespace Rapture
 		}
 	}
 
-	bool Renderer::setupCameraUniforms(const std::shared_ptr<Scene> s, entt::entity cameraEntity, glm::vec3& camPos)
+	void Renderer::extractCamera(const std::shared_ptr<Scene>& s, entt::entity cameraEntity, RenderPacket& packet)
 	{
-		RAPTURE_PROFILE_SCOPE("Camera Uniform Setup");
 		Entity camera_ent(cameraEntity, s.get());
 		CameraControllerComponent& controller_comp = camera_ent.getComponent<CameraControllerComponent>();
 
+		packet.projectionMatrix = controller_comp.camera.getProjectionMatrix();
+		packet.viewMatrix = controller_comp.camera.getViewMatrix();
+
+		// Set camera position for shader use
+		packet.cameraPosition = controller_comp.translation;
+		packet.cameraPosition.z = -packet.cameraPosition.z;
+
+		s_frameProjectionMatrix = packet.projectionMatrix;
+		s_frameViewMatrix = packet.viewMatrix;
+	}
+
+	void Renderer::extractLights(const std::shared_ptr<Scene>& s, const std::vector<entt::entity>& lightEntities, RenderPacket& packet)
+	{
+		// We'll update the lights every frame to ensure component data changes are reflected
+		// Caching the entity list for debug purposes only
+		s_cachedLightEntities = lightEntities;
+
+		for (auto entityID : lightEntities)
+		{
+			if (packet.lights.size() >= MAX_LIGHTS) break;
+			
+			Entity lightEntity(entityID, s.get());
+			TransformComponent& transform = lightEntity.getComponent<TransformComponent>();
+			LightComponent& light = lightEntity.getComponent<LightComponent>();
+			
+			if (!light.isActive) continue;
+			
+			// Fill light data
+			LightData& lightData = packet.lights.emplace_back();
+			
+			// Position and type
+			lightData.position = glm::vec4(transform.translation(), static_cast<float>(light.type));
+			
+			// Color and intensity
+			lightData.color = glm::vec4(light.color, light.intensity);
+			
+			// Direction (for directional/spot lights) and range
+			if (light.type == LightType::Directional || light.type == LightType::Spot)
+			{
+				// Convert Euler angles to direction vector
+				glm::vec3 euler = transform.rotation();
+				glm::mat4 rotMat = glm::rotate(glm::mat4(1.0f), euler.z, glm::vec3(0, 0, 1)) *
+								  glm::rotate(glm::mat4(1.0f), euler.y, glm::vec3(0, 1, 0)) *
+								  glm::rotate(glm::mat4(1.0f), euler.x, glm::vec3(1, 0, 0));
+				
+				glm::vec3 direction = glm::vec3(rotMat * glm::vec4(0, 0, -1, 0)); // Forward vector
+				lightData.direction = glm::vec4(direction, light.range);
+			}
+			else
+			{
+				lightData.direction = glm::vec4(0.0f, 0.0f, 0.0f, light.range);
+			}
+			
+			// Cone angles for spot lights
+			if (light.type == LightType::Spot)
+			{
+				lightData.coneAngles = glm::vec4(light.innerConeAngle, light.outerConeAngle, 0.0f, 0.0f);
+			}
+			else
+			{
+				lightData.coneAngles = glm::vec4(0.0f);
+			}
+		}
+	}
+
+	void Renderer::extractProxies(const std::shared_ptr<Scene>& s, const std::vector<entt::entity>& meshEntities, RenderPacket& packet)
+	{
+		RAPTURE_PROFILE_FUNCTION();
+
+		packet.proxies.reserve(meshEntities.size());
+
+		for (auto ent : meshEntities)
+		{
+			Entity mesh(ent, s.get());
+
+			auto* meshComp = mesh.tryGetComponent<MeshComponent>();
+			// Skip rendering if the mesh is still loading
+			if (!meshComp || meshComp->isLoading) {
+				continue;
+			}
+			if (!meshComp->mesh) {
+				GE_RENDER_ERROR("Null mesh encountered during rendering - entity ID: {0:x}", (uint32_t)ent);
+				continue;
+			}
+
+			auto* materialComp = mesh.tryGetComponent<MaterialComponent>();
+			if (!materialComp || !materialComp->material) {
+				GE_RENDER_WARN("Renderer: Entity has no valid material assigned");
+				continue;
+			}
+
+			// Meshes filled on the render thread have no buffers until the main thread is handed them
+			const MeshBufferData& meshData = meshComp->mesh->getMeshData();
+			if (!meshData.vao) {
+				continue;
+			}
+
+			RenderProxy& proxy = packet.proxies.emplace_back();
+			proxy.mesh = meshComp->mesh;
+			proxy.meshData = meshData;
+			proxy.material = materialComp->material;
+			proxy.modelMatrix = mesh.getComponent<TransformComponent>().transformMatrix();
+
+			// Skinned vertices are placed by the joints, the mesh node's transform doesn't apply (glTF spec),
+			// only the animator entity's one does
+			auto* skin = mesh.tryGetComponent<SkinComponent>();
+			auto* morph = mesh.tryGetComponent<MorphTargetComponent>();
+			if (skin) {
+				Entity animatorEntity(skin->animator, s.get());
+				auto* animator = animatorEntity.isValid() ? animatorEntity.tryGetComponent<AnimatorComponent>() : nullptr;
+				if (animator && animator->paletteOffset >= 0) {
+					proxy.modelMatrix = animatorEntity.getComponent<TransformComponent>().transformMatrix();
+					proxy.jointOffset = animator->paletteOffset;
+				}
+			}
+
+			// gl_VertexID includes the base vertex, so the shader needs it to find this mesh's deltas
+			if (morph && morph->deltaOffset >= 0) {
+				proxy.morphOffset = morph->deltaOffset;
+				proxy.morphBaseVertex = static_cast<uint32_t>(meshData.vertexOffsetInVertices);
+			}
+			proxy.isDeformed = skin || morph;
+
+			if (auto* boundingBoxComp = mesh.tryGetComponent<BoundingBoxComponent>()) {
+				proxy.worldBoundingBox = boundingBoxComp->worldBoundingBox;
+				proxy.showBoundingBox = boundingBoxComp->isVisible;
+			}
+		}
+	}
+
+	void Renderer::setupCameraUniforms(const RenderPacket& packet)
+	{
+		RAPTURE_PROFILE_SCOPE("Camera Uniform Setup");
+
 		// Get projection and view matrices
-		const glm::mat4& projMat = controller_comp.camera.getProjectionMatrix();
-		const glm::mat4& viewMat = controller_comp.camera.getViewMatrix();
+		const glm::mat4& projMat = packet.projectionMatrix;
+		const glm::mat4& viewMat = packet.viewMatrix;
 		
 		// Check if the matrices have changed to avoid unnecessary updates
 		bool matricesChanged = !s_cameraDataInitialized || 
@@ -342,25 +582,12 @@ namespace Rapture
 				s_cameraUBO->setData(&cameraData, sizeof(CameraUniform));
 			}
 		}
-		
-		// Set camera position for shader use
-		camPos = controller_comp.translation;
-		camPos.z = -camPos.z;
-		
-		return true;
 	}
 
-	void Renderer::setupLightsUniforms(const std::shared_ptr<Scene> s, const std::vector<entt::entity>& lightEntities)
+	void Renderer::setupLightsUniforms(const RenderPacket& packet)
 	{
 		RAPTURE_PROFILE_SCOPE("Lights Uniform Setup");
 		
-		// We'll update the lights every frame to ensure component data changes are reflected
-		// Caching the entity list for debug purposes only
-		s_cachedLightEntities = lightEntities;
-		
-		// Count active lights (up to MAX_LIGHTS)
-		uint32_t lightCount = 0;
-		
 		// Use persistent mapping if available
 		LightsUniform* lightsDataPtr = nullptr;
 		if (s_persistentLightsBufferPtr) {
@@ -373,60 +600,9 @@ namespace Rapture
 			memset(&lightsData, 0, sizeof(LightsUniform));
 			lightsDataPtr = &lightsData;
 		}
-		
-		// Collect light data
-		{
-			RAPTURE_PROFILE_SCOPE("Light Data Collection");
-			for (auto entityID : lightEntities)
-			{
-				if (lightCount >= MAX_LIGHTS) break;
-				
-				Entity lightEntity(entityID, s.get());
-				TransformComponent& transform = lightEntity.getComponent<TransformComponent>();
-				LightComponent& light = lightEntity.getComponent<LightComponent>();
-				
-				if (!light.isActive) continue;
-				
-				// Fill light data
-				LightData& lightData = lightsDataPtr->lights[lightCount];
-				
-				// Position and type
-				lightData.position = glm::vec4(transform.translation(), static_cast<float>(light.type));
-				
-				// Color and intensity
-				lightData.color = glm::vec4(light.color, light.intensity);
-				
-				// Direction (for directional/spot lights) and range
-				if (light.type == LightType::Directional || light.type == LightType::Spot)
-				{
-					// Convert Euler angles to direction vector
-					glm::vec3 euler = transform.rotation();
-					glm::mat4 rotMat = glm::rotate(glm::mat4(1.0f), euler.z, glm::vec3(0, 0, 1)) *
-									  glm::rotate(glm::mat4(1.0f), euler.y, glm::vec3(0, 1, 0)) *
-									  glm::rotate(glm::mat4(1.0f), euler.x, glm::vec3(1, 0, 0));
-					
-					glm::vec3 direction = glm::vec3(rotMat * glm::vec4(0, 0, -1, 0)); // Forward vector
-					lightData.direction = glm::vec4(direction, light.range);
-				}
-				else
-				{
-					lightData.direction = glm::vec4(0.0f, 0.0f, 0.0f, light.range);
-				}
-				
-				// Cone angles for spot lights
-				if (light.type == LightType::Spot)
-				{
-					lightData.coneAngles = glm::vec4(light.innerConeAngle, light.outerConeAngle, 0.0f, 0.0f);
-				}
-				else
-				{
-					lightData.coneAngles = glm::vec4(0.0f);
-				}
-				
-				lightCount++;
-			}
-		}
-		
+
+		uint32_t lightCount = static_cast<uint32_t>(std::min<size_t>(packet.lights.size(), MAX_LIGHTS));
+		std::copy(packet.lights.begin(), packet.lights.begin() + lightCount, lightsDataPtr->lights);
 		lightsDataPtr->lightCount = lightCount;
 		
 		// Cache the light count
@@ -441,185 +617,167 @@ namespace Rapture
 		}
 	}
 
-	bool Renderer::isEntityVisible(const std::shared_ptr<Scene>& s, entt::entity entity)
+	void Renderer::cullMeshEntities(const std::shared_ptr<Scene>& s, std::vector<entt::entity>& meshEntities)
 	{
+		RAPTURE_PROFILE_FUNCTION();
+
+		s_visibleEntities.reserve(meshEntities.size());
+
 		// If frustum culling is disabled, all entities are visible
 		if (!s_frustumCullingEnabled) {
-			return true;
+			for (auto ent : meshEntities) {
+				s_visibleEntities.emplace_back(ent, s.get());
+			}
+			return;
 		}
 
-		RAPTURE_PROFILE_SCOPE("Frustum Culling");
-		
-		// Get the entity as Entity class
-		Entity e(entity, s.get());
-		
-		// Check if the entity has a BoundingBoxComponent
-		if (!e.hasComponent<BoundingBoxComponent>()) {
-			// If there's no bounding box, we can't perform culling, so consider it visible
-			return true;
+		// The pools are fetched here on one thread, looking one up creates it if it doesn't exist yet
+		entt::registry& reg = s->getRegistry();
+		auto& boundingBoxes = reg.storage<BoundingBoxComponent>();
+		auto& transforms = reg.storage<TransformComponent>();
+
+		static std::vector<uint8_t> isVisible;
+		isVisible.assign(meshEntities.size(), 1);
+
+		// Each entity is tested by one task, which writes only that entity's bounding box
+		JobSystem::parallelForRange(meshEntities.size(), CULLING_BATCH_SIZE, [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; i++) {
+				entt::entity ent = meshEntities[i];
+
+				// If there's no bounding box, we can't perform culling, so consider it visible
+				if (!boundingBoxes.contains(ent)) {
+					continue;
+				}
+
+				BoundingBoxComponent& boundingBoxComp = boundingBoxes.get(ent);
+				if (boundingBoxComp.needsUpdate && transforms.contains(ent)) {
+					boundingBoxComp.worldBoundingBox = boundingBoxComp.localBoundingBox.transform(transforms.get(ent).transformMatrix());
+					boundingBoxComp.needsUpdate = false;
+				}
+
+				isVisible[i] = s_frustum.testBoundingBox(boundingBoxComp.worldBoundingBox) != FrustumResult::Outside;
+			}
+		});
+
+		// Compacted in place, so the draw order stays the same as without culling
+		size_t visibleCount = 0;
+		for (size_t i = 0; i < meshEntities.size(); i++) {
+			if (isVisible[i]) {
+				meshEntities[visibleCount++] = meshEntities[i];
+				s_visibleEntities.emplace_back(meshEntities[i], s.get());
+			}
 		}
-		
-		// Get the bounding box
-		auto& boundingBoxComp = e.getComponent<BoundingBoxComponent>();
-		
-		// Check if the bounding box needs to be updated
-		if (boundingBoxComp.needsUpdate && e.hasComponent<TransformComponent>()) {
-			RAPTURE_PROFILE_SCOPE("Bounding Box Update");
-			// Get transform and mesh components
-			auto& transform = e.getComponent<TransformComponent>();
-			
-			// Get local bounding box
-			const BoundingBox& localBox = boundingBoxComp.localBoundingBox;
-			
-			// Update the world bounding box based on the model matrix
-			boundingBoxComp.worldBoundingBox = localBox.transform(transform.transformMatrix());
-			boundingBoxComp.needsUpdate = false;
+		s_entitiesCulled = static_cast<uint32_t>(meshEntities.size() - visibleCount);
+		meshEntities.resize(visibleCount);
+	}
+
+	void Renderer::renderDepthPrepass(const RenderPacket& packet)
+	{
+		RAPTURE_PROFILE_GPU_SCOPE("Depth Pre-pass");
+
+		if (!s_depthOnlyShader || !s_depthOnlyShader->isValid()) {
+			return;
 		}
-		
-		// Test if the bounding box is visible in the frustum
+
+		glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+		s_depthOnlyShader->bind();
+
+		for (const RenderProxy& proxy : packet.proxies)
 		{
-			RAPTURE_PROFILE_SCOPE("Frustum Test");
-			FrustumResult result = s_frustum.testBoundingBox(boundingBoxComp.worldBoundingBox);
-			
-			// Count culled entities for stats
-			if (result == FrustumResult::Outside) {
-				s_entitiesCulled++;
-				return false;
+			// The depth-only shader doesn't deform, so skinned and morphed meshes lay down their depth in the shading pass
+			if (proxy.isDeformed) {
+				continue;
+			}
+
+			const MeshBufferData& meshdata = proxy.meshData;
+			const auto& vao = meshdata.getVAO(VertexStreamMode::PositionOnly);
+			if (!vao) {
+				continue;
 			}
+
+			vao->bind();
+			s_depthOnlyShader->setMat4("u_model", proxy.modelMatrix);
+			OpenGLRendererAPI::drawIndexed(meshdata.indexCount, meshdata.indexType, 
+				meshdata.indexAllocation->offsetBytes, meshdata.vertexOffsetInVertices);
+			vao->unbind();
 		}
-		
-		s_visibleEntities.push_back(e);
-		return true;
+
+		s_depthOnlyShader->unBind();
+		glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
 	}
 
-	void Renderer::renderMeshes(const std::shared_ptr<Scene> s, 
-							 const std::vector<entt::entity>& meshEntities, 
-							 const glm::vec3& camPos)
+	void Renderer::renderMeshes(const RenderPacket& packet)
 	{
 		
 		// Count for stats
 		int totalDrawCalls = 0;
-		int skippedMeshes = 0;
 		int boundingBoxesDrawn = 0;
-		int processedEntities = 0;
-		int culledEntities = 0;
 		
-		for (auto ent : meshEntities)
+		for (const RenderProxy& proxy : packet.proxies)
 		{
-			processedEntities++;
+			const auto& material = proxy.material;
+			const MeshBufferData& meshdata = proxy.meshData;
+			auto vao = meshdata.vao;
 			
-			// In EnTT, entity 0 is not null, but entt::null is FFFFFFFF
-			if ((uint32_t)ent == 0xFFFFFFFF) {
-				GE_RENDER_ERROR("Entity is null (0xFFFFFFFF), skipping");
-				skippedMeshes++;
-				continue;
+			// Resource binding
+			{
+				RAPTURE_PROFILE_SCOPE("Resource Binding");
+				// Bind the VAO
+				vao->bind();
+				// Bind the material (which also binds the shader)
+				material->bind();
 			}
 			
-			// Entity validation
+			// Per-object uniform setup
 			{
-				RAPTURE_PROFILE_SCOPE("Entity Validation");
-				Entity mesh(ent, s.get());
+				RAPTURE_PROFILE_SCOPE("Per-Object Uniforms");
+				Shader* shdr = material->getShader();
 				
-				if (!mesh.hasComponent<MeshComponent>()) {
-					GE_RENDER_ERROR("Entity doesn't have MeshComponent, skipping");
-					skippedMeshes++;
-					continue;
-				}
+				// Set the camera position uniform
+				shdr->setVec3("u_camPos", packet.cameraPosition);
+				shdr->setMat4("u_model", proxy.modelMatrix);
 
-				// Perform frustum culling
-				if (!isEntityVisible(s, ent)) {
-					culledEntities++;
-					skippedMeshes++;
-					continue;
-				}
-				
-				MeshComponent& meshComp = mesh.getComponent<MeshComponent>();
-				
-				// Skip rendering if the mesh is still loading
-				if (meshComp.isLoading) {
-					skippedMeshes++;
-					continue;
-				}
-				
-				auto meshe = meshComp.mesh;
-				
-				// Add proper null checking for mesh and vao
-				if (!meshe) {
-					GE_RENDER_ERROR("Null mesh encountered during rendering - entity ID: {0:x}", (uint32_t)ent);
-					skippedMeshes++;
-					continue;
+				if (proxy.jointOffset >= 0) {
+					shdr->setInt("u_jointOffset", proxy.jointOffset);
 				}
-				
-				MaterialComponent& mat = mesh.getComponent<MaterialComponent>();
-				auto& material = mat.material;
-				if (!material) {
-					GE_RENDER_WARN("Renderer: Entity has no valid material assigned");
-					skippedMeshes++;
-					continue;
+				if (proxy.morphOffset >= 0) {
+					shdr->setInt("u_morphOffset", proxy.morphOffset);
+					shdr->setInt("u_morphBaseVertex", static_cast<int>(proxy.morphBaseVertex));
 				}
-				
-				auto meshdata = meshComp.mesh->getMeshData();
-				auto vao = meshdata.vao;
-				
-				// Resource binding
-				{
-					RAPTURE_PROFILE_SCOPE("Resource Binding");
-					// Bind the VAO
-					vao->bind();
-					// Bind the material (which also binds the shader)
-					material->bind();
+			}
+			
+			// Draw call
+			{
+				RAPTURE_PROFILE_SCOPE("Draw Call");
+				OpenGLRendererAPI::drawIndexed(meshdata.indexCount, meshdata.indexType, 
+					meshdata.indexAllocation->offsetBytes, meshdata.vertexOffsetInVertices);
+				totalDrawCalls++;
+
+				// The shader is shared with rigid meshes, which must not pick up this offset
+				if (proxy.jointOffset >= 0) {
+					material->getShader()->setInt("u_jointOffset", -1);
 				}
-				
-				// Per-object uniform setup
-				{
-					RAPTURE_PROFILE_SCOPE("Per-Object Uniforms");
-					Shader* shdr = material->getShader();
-					
-					// Set the camera position uniform
-					shdr->setVec3("u_camPos", camPos);
-					
-					// Calculate combined transform with parent hierarchy
-					glm::mat4 modelMatrix = mesh.getComponent<TransformComponent>().transformMatrix();
-					shdr->setMat4("u_model", modelMatrix);
-				}
-				
-				// Draw call
-				{
-					RAPTURE_PROFILE_SCOPE("Draw Call");
-					OpenGLRendererAPI::drawIndexed(meshdata.indexCount, meshdata.indexType, 
-						meshdata.indexAllocation->offsetBytes, meshdata.vertexOffsetInVertices);
-					totalDrawCalls++;
+				if (proxy.morphOffset >= 0) {
+					material->getShader()->setInt("u_morphOffset", -1);
 				}
+			}
+			
+			// Resource unbinding
+			{
+				RAPTURE_PROFILE_SCOPE("Resource Unbinding");
+				// Unbind material after rendering this entity
+				material->unbind();
 				
-				// Resource unbinding
-				{
-					RAPTURE_PROFILE_SCOPE("Resource Unbinding");
-					// Unbind material after rendering this entity
-					material->unbind();
-					
-					// Unbind VAO too for clean state management
-					vao->unbind();
-				}
+				// Unbind VAO too for clean state management
+				vao->unbind();
+			}
 
-				// Draw bounding box if enabled for this entity
-				if (auto& boundingBoxComp = mesh.getComponent<BoundingBoxComponent>();
-					boundingBoxComp.isVisible) {
-					RAPTURE_PROFILE_SCOPE("Bounding Box Draw");
-                    RAPTURE_PROFILE_GPU_SCOPE("Bounding Box Draw");
-					// Bind the bounding box material
-					if (boundingBoxComp.s_visualizationMesh) {
-						boundingBoxComp.s_visualizationMaterial->bind();
-						auto meshdata = boundingBoxComp.s_visualizationMesh->getMeshData();
-                        meshdata.vao->bind();
-						// Draw the bounding box
-						drawBoundingBox(s, mesh);
-						meshdata.vao->unbind();
-						// Unbind the material
-						boundingBoxComp.s_visualizationMaterial->unbind();
-						
-						boundingBoxesDrawn++;
-					}
-				}
+			// Draw bounding box if enabled for this entity
+			if (proxy.showBoundingBox) {
+				RAPTURE_PROFILE_SCOPE("Bounding Box Draw");
+                RAPTURE_PROFILE_GPU_SCOPE("Bounding Box Draw");
+				drawBoundingBox(proxy.worldBoundingBox, packet.boundingBoxColor);
+				boundingBoxesDrawn++;
 			}
 		}
 		
@@ -627,24 +785,17 @@ namespace Rapture
 	}
 	
 	
-	void Renderer::drawBoundingBox(const std::shared_ptr<Scene> s, Entity entity)
+	void Renderer::drawBoundingBox(const BoundingBox& worldBoundingBox, const glm::vec3& color)
 	{
-		if (!entity || !entity.hasComponent<BoundingBoxComponent>()) {
-			GE_RENDER_ERROR("Entity missing BoundingBoxComponent in drawBoundingBox");
-			return;
-		}
-		
-		auto& boundingBoxComp = entity.getComponent<BoundingBoxComponent>();
-		
 		// Only draw if the bounding box is valid
-		if (!boundingBoxComp.worldBoundingBox.isValid()) {
+		if (!worldBoundingBox.isValid()) {
 			GE_RENDER_WARN("Invalid world bounding box in drawBoundingBox");
 			return;
 		}
 		
 		// Get the bounding box dimensions and center
-		glm::vec3 min = boundingBoxComp.worldBoundingBox.getMin();
-		glm::vec3 max = boundingBoxComp.worldBoundingBox.getMax();
+		glm::vec3 min = worldBoundingBox.getMin();
+		glm::vec3 max = worldBoundingBox.getMax();
 		
 		// Safety check for NaN or infinity values
 		if (glm::any(glm::isnan(min)) || glm::any(glm::isnan(max)) ||
@@ -669,7 +820,7 @@ namespace Rapture
 		}
 		
 		// Update material color to match the current bounding box color
-		BoundingBoxComponent::s_visualizationMaterial->setVec3("color", s_boundingBoxColor);
+		BoundingBoxComponent::s_visualizationMaterial->setVec3("color", color);
 		
 		// Set up transformation matrix directly
 		glm::mat4 modelMatrix = glm::translate(glm::mat4(1.0f), center) * 
@@ -686,7 +837,7 @@ namespace Rapture
 				vao->bind();
 
 				glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-				glDrawElements(GL_LINES, mesh->getMeshData().indexCount, GL_UNSIGNED_INT, (void*)mesh->getMeshData().indexAllocation->offsetBytes);
+				glDrawElements(GL_LINES, mesh->getMeshData().indexCount, mesh->getMeshData().indexType, (void*)mesh->getMeshData().indexAllocation->offsetBytes);
 				glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
 				
 				vao->unbind();
@@ -708,104 +859,104 @@ namespace Rapture
             GE_RENDER_ERROR("Cannot draw line: null material or mesh");
             return;
         }
-        
-        material->bind();
-        auto shader = material->getShader();
-        
-        // We need to manually set the projection and view matrices
-        // because primitive shapes don't go through the standard rendering pipeline
-        shader->setMat4("u_proj", s_cachedProjectionMatrix); 
-        shader->setMat4("u_view", s_cachedViewMatrix);
-        
-        // The line vertices are in world space, so we use identity model matrix
-        glm::mat4 modelMatrix = glm::mat4(1.0f);
-        shader->setMat4("u_model", modelMatrix);
-        
-        // Draw the line using GL_LINES
-        auto vao = mesh->getMeshData().vao;
-        if (vao) {
-            vao->bind();
-                glDrawElementsBaseVertex(GL_LINES, mesh->getMeshData().indexCount, GL_UNSIGNED_INT, (void*)mesh->getMeshData().indexAllocation->offsetBytes, mesh->getMeshData().vertexOffsetInVertices);
-            vao->unbind();
-        }
 
+        // Recorded with the camera of the last extracted frame, the line is in world space like the meshes
+        RenderThread::submit([meshData = mesh->getMeshData(), material, projection = s_frameProjectionMatrix, view = s_frameViewMatrix]() {
+            material->bind();
+            auto shader = material->getShader();
+            
+            // We need to manually set the projection and view matrices
+            // because primitive shapes don't go through the standard rendering pipeline
+            shader->setMat4("u_proj", projection); 
+            shader->setMat4("u_view", view);
+            
+            // The line vertices are in world space, so we use identity model matrix
+            glm::mat4 modelMatrix = glm::mat4(1.0f);
+            shader->setMat4("u_model", modelMatrix);
+            
+            // Draw the line using GL_LINES
+            auto vao = meshData.vao;
+            if (vao) {
+                vao->bind();
+                    glDrawElementsBaseVertex(GL_LINES, meshData.indexCount, meshData.indexType, (void*)meshData.indexAllocation->offsetBytes, meshData.vertexOffsetInVertices);
+                vao->unbind();
+            }
+        });
     }
 
     void Renderer::drawCube(const Cube& cube) {
         RAPTURE_PROFILE_FUNCTION();
         
-        // Bind the material
-        auto material = cube.getMaterial();
-        if (material) {
-            material->bind();
-            
-            // Create transformation matrix
-            glm::mat4 modelMatrix = glm::mat4(1.0f);
-            
-            // Apply translation, rotation, and scale
-            modelMatrix = glm::translate(modelMatrix, cube.getPosition());
-            
-            // Apply rotation (X, Y, Z order)
-            modelMatrix = glm::rotate(modelMatrix, glm::radians(cube.getRotation().x), glm::vec3(1.0f, 0.0f, 0.0f));
-            modelMatrix = glm::rotate(modelMatrix, glm::radians(cube.getRotation().y), glm::vec3(0.0f, 1.0f, 0.0f));
-            modelMatrix = glm::rotate(modelMatrix, glm::radians(cube.getRotation().z), glm::vec3(0.0f, 0.0f, 1.0f));
-            
-            modelMatrix = glm::scale(modelMatrix, cube.getScale());
-            
-            // Set the model matrix
-            material->getShader()->setMat4("u_model", modelMatrix);
-        }
+        // Create transformation matrix
+        glm::mat4 modelMatrix = glm::mat4(1.0f);
+        
+        // Apply translation, rotation, and scale
+        modelMatrix = glm::translate(modelMatrix, cube.getPosition());
         
-        // Draw the cube
-        auto mesh = cube.getMesh();
-        if (mesh) {
-            auto vao = mesh->getMeshData().vao;
+        // Apply rotation (X, Y, Z order)
+        modelMatrix = glm::rotate(modelMatrix, glm::radians(cube.getRotation().x), glm::vec3(1.0f, 0.0f, 0.0f));
+        modelMatrix = glm::rotate(modelMatrix, glm::radians(cube.getRotation().y), glm::vec3(0.0f, 1.0f, 0.0f));
+        modelMatrix = glm::rotate(modelMatrix, glm::radians(cube.getRotation().z), glm::vec3(0.0f, 0.0f, 1.0f));
+        
+        modelMatrix = glm::scale(modelMatrix, cube.getScale());
+
+        // The buffer data is copied while recording, the main thread may hand the mesh new buffers before this replays
+        std::shared_ptr<Mesh> cubeMesh = cube.getMesh();
+        RenderThread::submit([material = cube.getMaterial(), meshData = cubeMesh ? cubeMesh->getMeshData() : MeshBufferData(), modelMatrix, isFilled = cube.isFilled()]() {
+            // Bind the material
+            if (material) {
+                material->bind();
+                // Set the model matrix
+                material->getShader()->setMat4("u_model", modelMatrix);
+            }
+            
+            // Draw the cube
+            auto vao = meshData.vao;
             if (vao) {
                 vao->bind();
-                if (cube.isFilled()) {
-                    glDrawElements(GL_TRIANGLES, mesh->getMeshData().indexCount, GL_UNSIGNED_INT, (void*)mesh->getMeshData().indexAllocation->offsetBytes);
+                if (isFilled) {
+                    glDrawElements(GL_TRIANGLES, meshData.indexCount, meshData.indexType, (void*)meshData.indexAllocation->offsetBytes);
                 } else {
-                    glDrawElements(GL_LINES, mesh->getMeshData().indexCount, GL_UNSIGNED_INT, (void*)mesh->getMeshData().indexAllocation->offsetBytes);
+                    glDrawElements(GL_LINES, meshData.indexCount, meshData.indexType, (void*)meshData.indexAllocation->offsetBytes);
                 }
                 vao->unbind();
             }
-        }
+        });
     }
 
     void Renderer::drawQuad(const Quad& quad) {
         RAPTURE_PROFILE_FUNCTION();
         
-        // Bind the material
-        auto material = quad.getMaterial();
-        if (material) {
-            material->bind();
-            
-            // Create transformation matrix
-            glm::mat4 modelMatrix = glm::mat4(1.0f);
-            
-            // Apply translation, rotation, and scale
-            modelMatrix = glm::translate(modelMatrix, quad.getPosition());
-            
-            // Apply rotation (X, Y, Z order)
-            modelMatrix = glm::rotate(modelMatrix, glm::radians(quad.getRotation().x), glm::vec3(1.0f, 0.0f, 0.0f));
-            modelMatrix = glm::rotate(modelMatrix, glm::radians(quad.getRotation().y), glm::vec3(0.0f, 1.0f, 0.0f));
-            modelMatrix = glm::rotate(modelMatrix, glm::radians(quad.getRotation().z), glm::vec3(0.0f, 0.0f, 1.0f));
-            
-            modelMatrix = glm::scale(modelMatrix, quad.getScale());
-            
-            // Set the model matrix
-            material->getShader()->setMat4("u_model", modelMatrix);
-        }
+        // Create transformation matrix
+        glm::mat4 modelMatrix = glm::mat4(1.0f);
+        
+        // Apply translation, rotation, and scale
+        modelMatrix = glm::translate(modelMatrix, quad.getPosition());
+        
+        // Apply rotation (X, Y, Z order)
+        modelMatrix = glm::rotate(modelMatrix, glm::radians(quad.getRotation().x), glm::vec3(1.0f, 0.0f, 0.0f));
+        modelMatrix = glm::rotate(modelMatrix, glm::radians(quad.getRotation().y), glm::vec3(0.0f, 1.0f, 0.0f));
+        modelMatrix = glm::rotate(modelMatrix, glm::radians(quad.getRotation().z), glm::vec3(0.0f, 0.0f, 1.0f));
         
-        // Draw the quad
-        auto mesh = quad.getMesh();
-        if (mesh) {
-            auto vao = mesh->getMeshData().vao;
+        modelMatrix = glm::scale(modelMatrix, quad.getScale());
+
+        std::shared_ptr<Mesh> quadMesh = quad.getMesh();
+        RenderThread::submit([material = quad.getMaterial(), meshData = quadMesh ? quadMesh->getMeshData() : MeshBufferData(), modelMatrix]() {
+            // Bind the material
+            if (material) {
+                material->bind();
+                // Set the model matrix
+                material->getShader()->setMat4("u_model", modelMatrix);
+            }
+            
+            // Draw the quad
+            auto vao = meshData.vao;
             if (vao) {
                 vao->bind();
-                glDrawElements(GL_TRIANGLES, mesh->getMeshData().indexCount, GL_UNSIGNED_INT, (void*)mesh->getMeshData().indexAllocation->offsetBytes);
+                glDrawElements(GL_TRIANGLES, meshData.indexCount, meshData.indexType, (void*)meshData.indexAllocation->offsetBytes);
                 vao->unbind();
             }
-        }
+        });
     }
+
 }
\ No newline at end of file
@@ -7,7 +7,9 @@
 #include "../Mesh/Mesh.h"
 #include "../Materials/Material.h"
 #include "PrimitiveShapes.h"
+#include "RenderPacket.h"
 #include <memory>
+#include <mutex>
 #include <vector>
 #include <unordered_set>
 #include "Frustum.h"
@@ -17,6 +19,9 @@ namespace Rapture
 	// Forward declaration
 	class Mesh;
 
+	// Mesh entities one culling task tests, enough that claiming a batch costs little next to testing it
+	constexpr size_t CULLING_BATCH_SIZE = 256;
+
 	class Renderer
 	{
 	public:
@@ -26,7 +31,16 @@ namespace Rapture
 		// Shutdown the renderer and its subsystems
 		static void shutdown();
 
+		// Extract the scene into a frame packet and hand it to the GL thread (see RenderThread), then run the raycasts
+		// queued for this frame. Main thread only
 		static void sumbitScene(const std::shared_ptr<Scene> s);
+
+		// The sync point: cull the scene and copy everything the frame draws into a packet, main thread only.
+		// Returns nullptr if the scene has no camera
+		static std::shared_ptr<const RenderPacket> extractFrame(const std::shared_ptr<Scene>& s);
+
+		// Draw a packet, GL thread only. Reads nothing but the packet
+		static void renderFrame(const RenderPacket& packet);
 		
 		// Drawing functions that take shape objects as parameters
         static void drawLine(const Line& line);
@@ -58,6 +72,10 @@ namespace Rapture
 		static void toggleFrustumCulling();
 		static bool isFrustumCullingEnabled();
 
+		// Depth pre-pass, lays down depth with the position-only streams so the shading pass only shades visible pixels
+		static void enableDepthPrepass(bool enable = true);
+		static bool isDepthPrepassEnabled();
+
 	private:
 		// Extract scene entities for rendering
 		static void extractSceneData(const std::shared_ptr<Scene> s, 
@@ -65,31 +83,37 @@ namespace Rapture
 			entt::entity& cameraEntity,
 			std::vector<entt::entity>& lightEntities);
 
-		// Setup camera uniform buffer
-		static bool setupCameraUniforms(const std::shared_ptr<Scene> s, 
-			entt::entity cameraEntity, 
-			glm::vec3& camPos);
-			
-		// Setup lights uniform buffer
-		static void setupLightsUniforms(const std::shared_ptr<Scene> s, 
-			const std::vector<entt::entity>& lightEntities);
+		// Copy the camera, the active lights and the culled meshes into the packet
+		static void extractCamera(const std::shared_ptr<Scene>& s, entt::entity cameraEntity, RenderPacket& packet);
+		static void extractLights(const std::shared_ptr<Scene>& s, const std::vector<entt::entity>& lightEntities, RenderPacket& packet);
+		static void extractProxies(const std::shared_ptr<Scene>& s, const std::vector<entt::entity>& meshEntities, RenderPacket& packet);
+		
+		// Frustum cull the mesh entities in parallel on the JobSystem, only the visible ones are kept, in their order.
+		// Fills s_visibleEntities and s_entitiesCulled
+		static void cullMeshEntities(const std::shared_ptr<Scene>& s, std::vector<entt::entity>& meshEntities);
+
+		// Setup the camera and lights uniform buffers from the packet
+		static void setupCameraUniforms(const RenderPacket& packet);
+		static void setupLightsUniforms(const RenderPacket& packet);
 		
-		// Check if an entity is visible (frustum culling)
-		static bool isEntityVisible(const std::shared_ptr<Scene>& s, entt::entity entity);
+		// Write depth for the culled meshes, reading only the position stream
+		static void renderDepthPrepass(const RenderPacket& packet);
 		
-		// Render all meshes
-		static void renderMeshes(const std::shared_ptr<Scene> s, 
-			const std::vector<entt::entity>& meshEntities, 
-			const glm::vec3& camPos);
+		// Render the culled meshes
+		static void renderMeshes(const RenderPacket& packet);
 		
-		// Draw a bounding box for a specific entity
-		static void drawBoundingBox(const std::shared_ptr<Scene> s, Entity entity);
+		// Draw a world space bounding box as a wireframe cube
+		static void drawBoundingBox(const BoundingBox& worldBoundingBox, const glm::vec3& color);
+
+		// Packets come from a pool and go back to it once the GL thread drops them
+		static std::shared_ptr<RenderPacket> acquirePacket();
+		static void releasePacket(RenderPacket* packet);
 		
 		// Uniform buffers for camera and lights
 		static std::shared_ptr<UniformBuffer> s_cameraUBO;
 		static std::shared_ptr<UniformBuffer> s_lightsUBO;
 		
-		// Camera uniform caching
+		// Camera uniform caching (GL thread)
 		static bool s_cameraDataInitialized;
 		static glm::mat4 s_cachedProjectionMatrix;
 		static glm::mat4 s_cachedViewMatrix;
@@ -109,9 +133,22 @@ namespace Rapture
 		static Frustum s_frustum;
 		static bool s_frustumCullingEnabled;
 		static uint32_t s_entitiesCulled;
+
+		// Depth pre-pass
+		static bool s_depthPrepassEnabled;
+		static std::unique_ptr<Shader> s_depthOnlyShader;
 		
 		// Visible entities for the current frame
 		static std::vector<Rapture::Entity> s_visibleEntities;
+
+		// Camera of the last extracted frame, debug draws recorded after it use the same one (main thread)
+		static glm::mat4 s_frameProjectionMatrix;
+		static glm::mat4 s_frameViewMatrix;
+
+		// Frame packets
+		static std::mutex s_packetPoolMutex;
+		static std::vector<std::unique_ptr<RenderPacket>> s_freePackets;
+		static uint64_t s_frameIndex;
 	};
 
 } // namespace Rapture
\ No newline at end of file
@@ -9,6 +9,9 @@
 #include "../../Scenes/EntityNode.h"
 #include "Transforms.h"
 #include "BoundingBox.h"
+#include "../../Animation/Skeleton.h"
+#include "../../Animation/AnimationClip.h"
+#include "../../Animation/MorphTargets.h"
 #include "../../Debug/Profiler.h"
 
 #include <glm/glm.hpp>
@@ -19,6 +22,9 @@
 
 namespace Rapture {
 
+	// Components a background load can create must also be listed in StagingScene.cpp (MergedComponents),
+	// otherwise they are lost when the load is merged into the live scene
+
 
 	struct TransformComponent
 	{
@@ -135,6 +141,10 @@ namespace Rapture {
             materialName = material->getName();
 		}
 		
+		// Shares an existing material, e.g. between the copies of a prefab
+		MaterialComponent(std::shared_ptr<Material> materialPtr)
+			: material(materialPtr), materialName(materialPtr ? materialPtr->getName() : "") {}
+
 		MaterialComponent(const std::string& materialName)
 		{
 			// Use an existing material from the library
@@ -379,4 +389,63 @@ namespace Rapture {
               outerConeAngle(glm::radians(outerAngleDegrees)) {}
     };
 
+    // Plays clips on a skeleton, the AnimationSystem samples it every frame and writes its joint palette
+    struct AnimatorComponent
+    {
+        std::shared_ptr<const Skeleton> skeleton;
+        std::vector<std::shared_ptr<const AnimationClip>> clips;
+
+        int activeClip = 0;
+        float time = 0.0f;
+        float speed = 1.0f;
+        bool isPlaying = true;
+        bool isLooping = true;
+
+        // First matrix of this animator in the joint palette buffer, -1 until the system has written one
+        int32_t paletteOffset = -1;
+
+        AnimatorComponent() = default;
+
+        AnimatorComponent(std::shared_ptr<const Skeleton> skeleton, std::vector<std::shared_ptr<const AnimationClip>> clips)
+            : skeleton(std::move(skeleton)), clips(std::move(clips)) {}
+
+        const AnimationClip* getActiveClip() const
+        {
+            return activeClip >= 0 && activeClip < (int)clips.size() ? clips[activeClip].get() : nullptr;
+        }
+    };
+
+    // Marks a mesh as skinned, its vertices follow the joint palette of the animator entity
+    struct SkinComponent
+    {
+        entt::entity animator = entt::null;
+
+        SkinComponent() = default;
+        SkinComponent(entt::entity animator) : animator(animator) {}
+    };
+
+    // Blend shape weights of a mesh, the AnimationSystem blends the targets with non-zero weight every frame
+    struct MorphTargetComponent
+    {
+        std::shared_ptr<const MorphTargetSet> targets;      // null until the mesh has been decoded
+        std::vector<float> weights;
+
+        // First vertex of this mesh in the blended delta buffer, -1 while no target is active
+        int32_t deltaOffset = -1;
+
+        MorphTargetComponent() = default;
+        MorphTargetComponent(std::vector<float> weights) : weights(std::move(weights)) {}
+
+        // Set a weight by target name, false if the mesh has no such target
+        bool setWeight(const std::string& name, float weight)
+        {
+            int32_t target = targets ? targets->findTarget(name) : -1;
+            if (target < 0 || target >= (int32_t)weights.size()) {
+                return false;
+            }
+            weights[target] = weight;
+            return true;
+        }
+    };
+
 }
\ No newline at end of file
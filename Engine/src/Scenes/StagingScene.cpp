@@ -0,0 +1,218 @@
+#include "StagingScene.h"
+
+#include <utility>
+#include <algorithm>
+#include <cassert>
+
+#include "EntityNode.h"
+#include "Components/Components.h"
+#include "../Logger/Log.h"
+#include "../Debug/TracyProfiler.h"
+
+namespace Rapture {
+
+    std::mutex StagingScene::s_pendingMutex;
+    std::vector<std::function<void()>> StagingScene::s_pending;
+
+    namespace {
+
+        // Move one component type over, its pool in the live registry is grown once for the whole batch
+        template<typename T>
+        void moveComponents(entt::registry& staged, entt::registry& live, const std::vector<entt::entity>& remap)
+        {
+            auto& source = staged.storage<T>();
+            if (source.empty()) {
+                return;
+            }
+
+            auto& destination = live.storage<T>();
+            destination.reserve(destination.size() + source.size());
+            for (auto [handle, component] : source.each()) {
+                live.emplace<T>(remap[entt::to_entity(handle)], std::move(component));
+            }
+        }
+
+        template<typename... T>
+        struct ComponentList {
+            static void move(entt::registry& staged, entt::registry& live, const std::vector<entt::entity>& remap)
+            {
+                (moveComponents<T>(staged, live, remap), ...);
+            }
+
+            static bool contains(const entt::type_info& type)
+            {
+                return ((type == entt::type_id<T>()) || ...);
+            }
+        };
+
+        // Every component type a load can create. Types added here are moved as they are,
+        // ones that hold entity handles need remapping and are handled in merge() itself
+        using MergedComponents = ComponentList<TagComponent, TransformComponent, MeshComponent, MaterialComponent,
+            BoundingBoxComponent, LightComponent, AnimatorComponent, MorphTargetComponent>;
+        using RemappedComponents = ComponentList<SkinComponent, EntityNodeComponent>;
+
+    }
+
+    StagingScene::StagingScene(std::shared_ptr<Scene> targetScene)
+        : m_scene(std::make_shared<Scene>()), m_targetScene(std::move(targetScene))
+    {
+        if (!m_targetScene) {
+            GE_CORE_ERROR("StagingScene: Target scene is null");
+        }
+    }
+
+    Entity StagingScene::resolve(Entity entity) const
+    {
+        if (!m_isMerged || entity.getScene() != m_scene.get()) {
+            return entity;
+        }
+
+        auto index = entt::to_entity(static_cast<entt::entity>(entity));
+        if (index >= m_remap.size() || m_remap[index] == entt::null) {
+            return Entity();
+        }
+        return Entity(m_remap[index], m_targetScene.get());
+    }
+
+    void StagingScene::runWhenMerged(std::function<void(const StagingScene&)> change)
+    {
+        if (m_isMerged) {
+            change(*this);
+            return;
+        }
+        m_waitingChanges.push_back(std::move(change));
+    }
+
+    void StagingScene::submit(std::shared_ptr<StagingScene> staging, std::function<void()> onMerged)
+    {
+        runAtFrameBoundary([staging = std::move(staging), onMerged = std::move(onMerged)]() {
+            staging->merge();
+            if (onMerged) {
+                onMerged();
+            }
+        });
+    }
+
+    void StagingScene::runAtFrameBoundary(std::function<void()> change)
+    {
+        std::lock_guard<std::mutex> lock(s_pendingMutex);
+        s_pending.push_back(std::move(change));
+    }
+
+    void StagingScene::mergePending()
+    {
+        RAPTURE_PROFILE_FUNCTION();
+
+        std::vector<std::function<void()>> pending;
+        {
+            std::lock_guard<std::mutex> lock(s_pendingMutex);
+            if (s_pending.empty()) {
+                return;
+            }
+            pending.swap(s_pending);
+        }
+
+        for (std::function<void()>& change : pending) {
+            change();
+        }
+    }
+
+    void StagingScene::discardPending()
+    {
+        std::vector<std::function<void()>> pending;
+        {
+            std::lock_guard<std::mutex> lock(s_pendingMutex);
+            pending.swap(s_pending);
+        }
+        if (!pending.empty()) {
+            GE_CORE_INFO("StagingScene: Discarded {} loads that weren't merged", pending.size());
+        }
+    }
+
+    void StagingScene::merge()
+    {
+        RAPTURE_PROFILE_FUNCTION();
+
+        if (m_isMerged || !m_targetScene) {
+            return;
+        }
+
+        entt::registry& staged = m_scene->getRegistry();
+        entt::registry& live = m_targetScene->getRegistry();
+
+        std::vector<entt::entity> stagedHandles;
+        stagedHandles.reserve(staged.alive());
+        staged.each([&stagedHandles](entt::entity handle) { stagedHandles.push_back(handle); });
+
+        // Every live entity of the load is created in one go
+        std::vector<entt::entity> liveHandles(stagedHandles.size());
+        live.create(liveHandles.begin(), liveHandles.end());
+
+        size_t remapSize = 0;
+        for (entt::entity handle : stagedHandles) {
+            remapSize = std::max<size_t>(remapSize, entt::to_entity(handle) + 1);
+        }
+        m_remap.assign(remapSize, entt::null);
+        for (size_t i = 0; i < stagedHandles.size(); i++) {
+            m_remap[entt::to_entity(stagedHandles[i])] = liveHandles[i];
+        }
+
+        // A component type nobody listed would be dropped with the staging registry without a trace
+        for (auto [id, pool] : staged.storage()) {
+            if (!pool.empty() && !MergedComponents::contains(pool.type()) && !RemappedComponents::contains(pool.type())) {
+                GE_CORE_ERROR("StagingScene: {} staged '{}' components aren't merged, add the type to MergedComponents",
+                    pool.size(), std::string(pool.type().name()));
+                assert(false && "StagingScene: unmerged component type");
+            }
+        }
+
+        MergedComponents::move(staged, live, m_remap);
+
+        // Skins name their animator by handle
+        for (auto [handle, skinComp] : staged.storage<SkinComponent>().each()) {
+            // A staged handle means nothing in the live registry, an animator that wasn't merged leaves the skin without one
+            entt::entity animator = entt::null;
+            if (skinComp.animator != entt::null && entt::to_entity(skinComp.animator) < m_remap.size()) {
+                animator = m_remap[entt::to_entity(skinComp.animator)];
+            }
+            live.emplace<SkinComponent>(m_remap[entt::to_entity(handle)], animator);
+        }
+
+        // Nodes point at their entities, so the hierarchy is built again for the live handles
+        auto& stagedNodes = staged.storage<EntityNodeComponent>();
+        live.storage<EntityNodeComponent>().reserve(live.storage<EntityNodeComponent>().size() + stagedNodes.size());
+
+        std::vector<std::shared_ptr<EntityNode>> liveNodes(m_remap.size());
+        for (auto [handle, nodeComp] : stagedNodes.each()) {
+            entt::entity liveHandle = m_remap[entt::to_entity(handle)];
+            liveNodes[entt::to_entity(handle)] = live.emplace<EntityNodeComponent>(liveHandle, Entity(liveHandle, m_targetScene.get())).entity_node;
+        }
+
+        // Walking the children keeps their order, and unlinking the staged nodes on the way frees them with the registry
+        for (auto [handle, nodeComp] : stagedNodes.each()) {
+            if (!nodeComp.entity_node) {
+                continue;
+            }
+            std::shared_ptr<EntityNode>& parent = liveNodes[entt::to_entity(handle)];
+            for (const std::shared_ptr<EntityNode>& child : nodeComp.entity_node->getChildren()) {
+                auto childIndex = child->getEntity() ? entt::to_entity(static_cast<entt::entity>(*child->getEntity())) : m_remap.size();
+                if (childIndex < liveNodes.size() && liveNodes[childIndex]) {
+                    parent->addChild(liveNodes[childIndex]);
+                }
+                nodeComp.entity_node->removeChild(child);
+            }
+        }
+
+        staged.clear();
+        m_isMerged = true;
+
+        // Upload results that arrived while the load was still staged
+        for (std::function<void(const StagingScene&)>& change : m_waitingChanges) {
+            change(*this);
+        }
+        m_waitingChanges.clear();
+
+        GE_CORE_INFO("StagingScene: Merged {} entities", stagedHandles.size());
+    }
+
+}
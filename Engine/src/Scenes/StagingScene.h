@@ -0,0 +1,70 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <functional>
+
+#include "Scene.h"
+#include "Entity.h"
+
+namespace Rapture {
+
+    /**
+     * @brief Private scene a background load builds into, merged into a live scene in one pass at a frame boundary
+     *
+     * Only the loading thread touches the staging registry while it is built, so the loader creates entities
+     * and components without locks while the live scene is updated and rendered. Once the load is handed over
+     * with submit(), the main thread moves every staged entity into the live scene before the next layer update,
+     * remapping the hierarchy and skin links to the new handles. A large import appears in one frame or not at all.
+     */
+    class StagingScene {
+    public:
+        explicit StagingScene(std::shared_ptr<Scene> targetScene);
+
+        // Scene the load builds into
+        const std::shared_ptr<Scene>& getScene() const { return m_scene; }
+        const std::shared_ptr<Scene>& getTargetScene() const { return m_targetScene; }
+
+        // Main thread only
+        bool isMerged() const { return m_isMerged; }
+
+        // Main thread only. The live entity a staged one became, the entity itself before the merge
+        // and an invalid entity if it was destroyed before the merge
+        Entity resolve(Entity entity) const;
+
+        // Main thread only. Run a change to staged entities once they are live, right away if they already are.
+        // Used by upload callbacks, which can finish while the loader is still building the staging registry
+        void runWhenMerged(std::function<void(const StagingScene&)> change);
+
+        // Hand a finished load over, it is merged at the next frame boundary and onMerged runs right after
+        static void submit(std::shared_ptr<StagingScene> staging, std::function<void()> onMerged = nullptr);
+
+        // Queue another change to a live scene for the next frame boundary, e.g. cloning a prefab
+        static void runAtFrameBoundary(std::function<void()> change);
+
+        // Main thread, once per frame before the layers update
+        static void mergePending();
+
+        // Drop loads that haven't been merged yet, at shutdown
+        static void discardPending();
+
+    private:
+        // Move every staged entity into the target scene, the staging registry is empty afterwards
+        void merge();
+
+    private:
+        std::shared_ptr<Scene> m_scene;
+        std::shared_ptr<Scene> m_targetScene;
+
+        // Live handle of every staged entity, indexed by the staged entity's index (main thread only)
+        std::vector<entt::entity> m_remap;
+        std::vector<std::function<void(const StagingScene&)>> m_waitingChanges;
+        bool m_isMerged = false;
+
+        // Handed over loads and changes, drained in order at the next frame boundary
+        static std::mutex s_pendingMutex;
+        static std::vector<std::function<void()>> s_pending;
+    };
+
+}
@@ -0,0 +1,216 @@
+#include "AnimationSystem.h"
+
+#include <cmath>
+#include <algorithm>
+
+#include "../../Animation/SkinningMath.h"
+#include "../../Shaders/OpenGLUniforms/UniformBindingPointIndices.h"
+#include "../../Debug/TracyProfiler.h"
+#include "../../Logger/Log.h"
+#include "../../Jobs/JobSystem.h"
+
+namespace Rapture {
+
+    std::vector<AnimatorComponent*> AnimationSystem::s_animators;
+    std::vector<glm::mat4> AnimationSystem::s_palette;
+
+    std::unique_ptr<ShaderStorageBuffer> AnimationSystem::s_paletteBuffer = nullptr;
+    size_t AnimationSystem::s_paletteBufferCapacity = 0;
+
+    std::vector<MorphTargetComponent*> AnimationSystem::s_morphs;
+    std::vector<glm::vec4> AnimationSystem::s_morphDeltas;
+
+    std::unique_ptr<ShaderStorageBuffer> AnimationSystem::s_morphBuffer = nullptr;
+    size_t AnimationSystem::s_morphBufferCapacity = 0;
+
+    void AnimationSystem::init()
+    {
+        if (!JobSystem::isInitialized()) {
+            GE_CORE_WARN("AnimationSystem: JobSystem not initialized, animators are evaluated on the calling thread");
+        }
+
+        GE_CORE_INFO("AnimationSystem: Initialized");
+    }
+
+    void AnimationSystem::shutdown()
+    {
+        s_animators.clear();
+        s_palette.clear();
+        s_paletteBuffer.reset();
+        s_paletteBufferCapacity = 0;
+
+        s_morphs.clear();
+        s_morphDeltas.clear();
+        s_morphBuffer.reset();
+        s_morphBufferCapacity = 0;
+    }
+
+    void AnimationSystem::update(Scene* scene, float deltaSeconds)
+    {
+        RAPTURE_PROFILE_FUNCTION();
+
+        s_animators.clear();
+        s_morphs.clear();
+        if (!scene) {
+            s_palette.clear();
+            s_morphDeltas.clear();
+            return;
+        }
+
+        // Serial pass: advance the clocks and hand every animator its range of the palette
+        size_t matrixCount = 0;
+        auto view = scene->getRegistry().view<AnimatorComponent>();
+        for (auto entity : view) {
+            AnimatorComponent& animator = view.get<AnimatorComponent>(entity);
+            if (!animator.skeleton || animator.skeleton->getJointCount() == 0) {
+                animator.paletteOffset = -1;
+                continue;
+            }
+
+            advanceTime(animator, deltaSeconds);
+
+            animator.paletteOffset = static_cast<int32_t>(matrixCount);
+            matrixCount += animator.skeleton->getJointCount();
+            s_animators.push_back(&animator);
+        }
+
+        s_palette.resize(matrixCount);
+
+        // Morphed meshes only get a range while one of their weights is non-zero, a neutral face costs nothing
+        size_t morphedVertexCount = 0;
+        auto morphView = scene->getRegistry().view<MorphTargetComponent>();
+        for (auto entity : morphView) {
+            MorphTargetComponent& morph = morphView.get<MorphTargetComponent>(entity);
+            morph.deltaOffset = -1;
+            if (!morph.targets) {
+                continue;
+            }
+
+            size_t targetCount = std::min(morph.weights.size(), morph.targets->getTargetCount());
+            bool isActive = false;
+            for (size_t target = 0; target < targetCount && !isActive; target++) {
+                isActive = morph.weights[target] != 0.0f;
+            }
+            if (!isActive) {
+                continue;
+            }
+
+            morph.deltaOffset = static_cast<int32_t>(morphedVertexCount);
+            morphedVertexCount += morph.targets->vertexCount;
+            s_morphs.push_back(&morph);
+        }
+
+        s_morphDeltas.resize(morphedVertexCount * 2);
+
+        // Parallel pass: sample and build palettes, then blend the morphs. Batches write disjoint ranges so nothing is shared
+        size_t animatorBatches = (s_animators.size() + ANIMATION_BATCH_SIZE - 1) / ANIMATION_BATCH_SIZE;
+        JobSystem::parallelFor(animatorBatches + s_morphs.size(), [animatorBatches](size_t task) {
+            if (task >= animatorBatches) {
+                blendMorphTargets(*s_morphs[task - animatorBatches]);
+                return;
+            }
+
+            size_t begin = task * ANIMATION_BATCH_SIZE;
+            size_t end = std::min(begin + ANIMATION_BATCH_SIZE, s_animators.size());
+            for (size_t i = begin; i < end; i++) {
+                evaluateAnimator(*s_animators[i]);
+            }
+        });
+    }
+
+    void AnimationSystem::advanceTime(AnimatorComponent& animator, float deltaSeconds)
+    {
+        const AnimationClip* clip = animator.getActiveClip();
+        if (!clip || !animator.isPlaying) {
+            return;
+        }
+
+        float duration = clip->getDuration();
+        animator.time += deltaSeconds * animator.speed;
+        if (duration <= 0.0f) {
+            animator.time = 0.0f;
+            return;
+        }
+
+        if (animator.isLooping) {
+            animator.time = std::fmod(animator.time, duration);
+            if (animator.time < 0.0f) {
+                animator.time += duration;
+            }
+        }
+        else if (animator.time >= duration || animator.time <= 0.0f) {
+            animator.time = std::clamp(animator.time, 0.0f, duration);
+            animator.isPlaying = false;
+        }
+    }
+
+    void AnimationSystem::evaluateAnimator(const AnimatorComponent& animator)
+    {
+        const Skeleton& skeleton = *animator.skeleton;
+        size_t jointCount = skeleton.getJointCount();
+
+        // Scratch per thread, reused across animators and frames
+        thread_local std::vector<JointPose> pose;
+        thread_local std::vector<glm::mat4> modelSpace;
+        pose.resize(jointCount);
+        modelSpace.resize(jointCount);
+
+        if (const AnimationClip* clip = animator.getActiveClip()) {
+            clip->sample(animator.time, skeleton, pose.data());
+        }
+        else {
+            std::copy(skeleton.restPose.begin(), skeleton.restPose.end(), pose.begin());
+        }
+
+        SkinningMath::buildPalette(skeleton, pose.data(), modelSpace.data(), s_palette.data() + animator.paletteOffset);
+    }
+
+    void AnimationSystem::blendMorphTargets(const MorphTargetComponent& morph)
+    {
+        const MorphTargetSet& set = *morph.targets;
+        glm::vec4* deltas = s_morphDeltas.data() + static_cast<size_t>(morph.deltaOffset) * 2;
+        std::fill(deltas, deltas + static_cast<size_t>(set.vertexCount) * 2, glm::vec4(0.0f));
+
+        size_t targetCount = std::min(morph.weights.size(), set.getTargetCount());
+        for (size_t target = 0; target < targetCount; target++) {
+            if (morph.weights[target] != 0.0f) {
+                MorphTargetBlend::accumulate(set, target, morph.weights[target], deltas);
+            }
+        }
+    }
+
+    void AnimationSystem::extractBuffers(std::vector<glm::mat4>& palette, std::vector<glm::vec4>& morphDeltas)
+    {
+        RAPTURE_PROFILE_FUNCTION();
+
+        // Assigned, so a recycled packet reuses its storage
+        palette.assign(s_palette.begin(), s_palette.end());
+        morphDeltas.assign(s_morphDeltas.begin(), s_morphDeltas.end());
+    }
+
+    void AnimationSystem::uploadBuffers(const std::vector<glm::mat4>& palette, const std::vector<glm::vec4>& morphDeltas)
+    {
+        RAPTURE_PROFILE_FUNCTION();
+
+        if (!palette.empty()) {
+            uploadStorage(s_paletteBuffer, s_paletteBufferCapacity, palette.data(), palette.size() * sizeof(glm::mat4), "Joint Palette");
+            s_paletteBuffer->bindBase(JOINT_PALETTE_SSBO_BINDING_POINT_IDX);
+        }
+
+        if (!morphDeltas.empty()) {
+            uploadStorage(s_morphBuffer, s_morphBufferCapacity, morphDeltas.data(), morphDeltas.size() * sizeof(glm::vec4), "Morph Deltas");
+            s_morphBuffer->bindBase(MORPH_DELTAS_SSBO_BINDING_POINT_IDX);
+        }
+    }
+
+    void AnimationSystem::uploadStorage(std::unique_ptr<ShaderStorageBuffer>& buffer, size_t& capacity, const void* data, size_t bytes, const char* label)
+    {
+        if (!buffer || capacity < bytes) {
+            capacity = std::max(bytes, capacity * 2);
+            buffer = std::make_unique<ShaderStorageBuffer>(capacity, BufferUsage::Dynamic);
+            buffer->setDebugLabel(label);
+        }
+        buffer->setData(data, bytes);
+    }
+
+}
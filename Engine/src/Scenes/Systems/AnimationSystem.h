@@ -0,0 +1,60 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+
+#include "../Components/Components.h"
+#include "../Scene.h"
+#include "../../Buffers/OpenGLBuffers/StorageBuffers/OpenGLStorageBuffer.h"
+
+namespace Rapture {
+
+    // Animators handed to a worker at once, large enough to amortize the hand-off, small enough to balance
+    constexpr size_t ANIMATION_BATCH_SIZE = 16;
+
+    // Samples every animator, builds the joint palettes of all of them into one contiguous array and
+    // uploads that array as a single storage buffer the skinning vertex shaders index into.
+    // Morph targets are blended the same way, into one buffer of per-vertex deltas for every morphed mesh.
+    class AnimationSystem {
+    public:
+        // The parallel pass runs on the JobSystem, which has to be initialized first
+        static void init();
+        static void shutdown();
+
+        // Advance every animator of the scene, write its palette and blend the active morph targets, CPU only
+        static void update(Scene* scene, float deltaSeconds);
+
+        // Copy the palettes and morph deltas of the last update into a render packet, on the thread that updates
+        static void extractBuffers(std::vector<glm::mat4>& palette, std::vector<glm::vec4>& morphDeltas);
+
+        // Upload the palettes and morph deltas of a render packet and bind them for the vertex shaders, GL thread only
+        static void uploadBuffers(const std::vector<glm::mat4>& palette, const std::vector<glm::vec4>& morphDeltas);
+
+        static size_t getPaletteMatrixCount() { return s_palette.size(); }
+        static size_t getMorphedVertexCount() { return s_morphDeltas.size() / 2; }
+
+    private:
+        static void advanceTime(AnimatorComponent& animator, float deltaSeconds);
+        static void evaluateAnimator(const AnimatorComponent& animator);
+        static void blendMorphTargets(const MorphTargetComponent& morph);
+
+        // Upload data into a storage buffer that grows geometrically, so a few more instances don't reallocate every frame
+        static void uploadStorage(std::unique_ptr<ShaderStorageBuffer>& buffer, size_t& capacity, const void* data, size_t bytes, const char* label);
+
+    private:
+        // Animators of the current update and the palette they write into
+        static std::vector<AnimatorComponent*> s_animators;
+        static std::vector<glm::mat4> s_palette;
+
+        static std::unique_ptr<ShaderStorageBuffer> s_paletteBuffer;
+        static size_t s_paletteBufferCapacity;
+
+        // Morphed meshes of the current update and their blended deltas, a position and a normal delta per vertex
+        static std::vector<MorphTargetComponent*> s_morphs;
+        static std::vector<glm::vec4> s_morphDeltas;
+
+        static std::unique_ptr<ShaderStorageBuffer> s_morphBuffer;
+        static size_t s_morphBufferCapacity;
+    };
+
+}
@@ -1,5 +1,6 @@
 #include "BoundingBoxSystem.h"
 #include "../../Debug/TracyProfiler.h"
+#include "../../Buffers/VertexFormat.h"
 
 namespace Rapture {
 
@@ -43,6 +44,33 @@ namespace Rapture {
         return BoundingBox(min, max);
     }
 
+    BoundingBox BoundingBoxSystem::calculateFromPositions(const unsigned char* data, size_t count, size_t stride, unsigned int componentType, bool normalized) {
+        if (!data || count == 0 || stride == 0) {
+            return BoundingBox(); // Return invalid bounding box
+        }
+
+        RAPTURE_PROFILE_SCOPE("Calculate Bounding Box from Positions");
+
+        size_t componentSize = getComponentSize(componentType);
+
+        glm::vec3 min(std::numeric_limits<float>::max());
+        glm::vec3 max(std::numeric_limits<float>::lowest());
+
+        for (size_t i = 0; i < count; i++) {
+            const unsigned char* vertex = data + i * stride;
+            glm::vec3 position(
+                readComponentAsFloat(vertex, componentType, normalized),
+                readComponentAsFloat(vertex + componentSize, componentType, normalized),
+                readComponentAsFloat(vertex + 2 * componentSize, componentType, normalized)
+            );
+
+            min = glm::min(min, position);
+            max = glm::max(max, position);
+        }
+
+        return BoundingBox(min, max);
+    }
+
     void BoundingBoxSystem::updateBoundingBoxes(Scene* scene) {
         if (!scene) {
             return;
@@ -10,6 +10,10 @@ namespace Rapture {
     public:
         // Calculate bounding box from raw vertex data (for use during mesh loading)
         static BoundingBox calculateFromVertexData(const void* data, size_t dataSize, size_t stride, size_t positionOffset);
+
+        // Calculate bounding box from strided positions of any GL component type, dequantizing
+        // normalized and integer components (KHR_mesh_quantization) to floats on the fly
+        static BoundingBox calculateFromPositions(const unsigned char* data, size_t count, size_t stride, unsigned int componentType, bool normalized);
         
         // Update all bounding boxes in the scene
         static void updateBoundingBoxes(Scene* scene);
@@ -1,8 +1,10 @@
-#version 420 core
+#version 430 core
 
 layout(location = 0) in vec3 aPos;
 layout(location = 1) in vec3 aNormal;
 layout(location = 2) in vec2 aTexCoord0;
+layout(location = 4) in vec4 aJoints;
+layout(location = 5) in vec4 aWeights;
 
 precision highp float;
 
@@ -28,13 +30,46 @@ out vec2 texCoord;
 uniform mat4 u_model;
 uniform vec3 u_camPos;
 
+// Skinning matrices of every animator this frame, u_jointOffset is the first one of this mesh, -1 for rigid meshes
+layout (std430, binding=0) readonly buffer JointPalette
+{
+	mat4 u_jointMatrices[];
+};
+uniform int u_jointOffset = -1;
+
+// Blended morph target deltas of every morphed mesh this frame, a position and a normal delta per vertex.
+// u_morphOffset is the first vertex of this mesh, -1 while none of its targets is active
+layout (std430, binding=1) readonly buffer MorphDeltas
+{
+	vec4 u_morphDeltas[];
+};
+uniform int u_morphOffset = -1;
+uniform int u_morphBaseVertex = 0;
+
 
 
 void main()
 {
 
-	vertPos = vec3(u_model * vec4(aPos, 1.0));
-    normalInterp = mat3(u_model) * aNormal;
+	vec3 position = aPos;
+	vec3 normal = aNormal;
+	if (u_morphOffset >= 0) {
+		int delta = (u_morphOffset + gl_VertexID - u_morphBaseVertex) * 2;
+		position += u_morphDeltas[delta].xyz;
+		normal += u_morphDeltas[delta + 1].xyz;
+	}
+
+	mat4 model = u_model;
+	if (u_jointOffset >= 0) {
+		int base = u_jointOffset;
+		model = u_model * (aWeights.x * u_jointMatrices[base + int(aJoints.x)] +
+		                   aWeights.y * u_jointMatrices[base + int(aJoints.y)] +
+		                   aWeights.z * u_jointMatrices[base + int(aJoints.z)] +
+		                   aWeights.w * u_jointMatrices[base + int(aJoints.w)]);
+	}
+
+	vertPos = vec3(model * vec4(position, 1.0));
+    normalInterp = mat3(model) * normal;
 
     camPos = u_camPos;
     texCoord = aTexCoord0;
@@ -0,0 +1,19 @@
+#version 420 core
+
+// Only the position stream is bound, see VertexStreamMode::PositionOnly
+layout(location = 0) in vec3 aPos;
+
+precision highp float;
+
+layout (std140, binding=0) uniform BaseTransformMats
+{
+	mat4 u_proj;
+	mat4 u_view;
+};
+
+uniform mat4 u_model;
+
+void main()
+{
+	gl_Position = u_proj * u_view * u_model * vec4(aPos, 1.0);
+}
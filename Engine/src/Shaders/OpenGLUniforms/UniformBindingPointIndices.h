@@ -5,3 +5,7 @@
 #define PHONG_BINDING_POINT_IDX 3
 #define SOLID_BINDING_POINT_IDX 4
 #define SPECULAR_GLOSSINESS_BINDING_POINT_IDX 5
+
+// Shader storage buffer binding points, separate from the uniform buffer ones
+#define JOINT_PALETTE_SSBO_BINDING_POINT_IDX 0
+#define MORPH_DELTAS_SSBO_BINDING_POINT_IDX 1
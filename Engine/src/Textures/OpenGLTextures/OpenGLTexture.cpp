@@ -2,9 +2,17 @@
 #include "../../Logger/Log.h"
 #include "../../Debug/TracyProfiler.h"
 #include <stb_image.h>
+#include <cmath>
+#include <algorithm>
 
 namespace Rapture {
 
+// Number of levels glGenerateMipmap produces for a texture of this size
+static uint32_t calculateMipLevels(uint32_t width, uint32_t height)
+{
+    return static_cast<uint32_t>(std::floor(std::log2(std::max(width, height)))) + 1;
+}
+
 OpenGLTexture2D::OpenGLTexture2D(const std::string& path)
     : m_path(path)
 {
@@ -55,6 +63,7 @@ OpenGLTexture2D::OpenGLTexture2D(const std::string& path)
         
         glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, m_width, m_height, 0, dataFormat, GL_UNSIGNED_BYTE, data);
         glGenerateMipmap(GL_TEXTURE_2D);
+        trackMemory(calculateMipLevels(m_width, m_height));
         
         stbi_image_free(data);
     }
@@ -90,13 +99,17 @@ OpenGLTexture2D::OpenGLTexture2D(uint32_t width, uint32_t height, uint32_t chann
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
     
     glTexImage2D(GL_TEXTURE_2D, 0, m_internalFormat, m_width, m_height, 0, m_dataFormat, GL_UNSIGNED_BYTE, nullptr);
+    trackMemory(1);
     
     GE_CORE_INFO("Created blank texture ({0}x{1})", m_width, m_height);
 }
 
 OpenGLTexture2D::~OpenGLTexture2D()
 {
-    glDeleteTextures(1, &m_rendererID);
+    trackMemory(0);
+    if (m_rendererID != 0) {
+        glDeleteTextures(1, &m_rendererID);
+    }
 }
 
 void OpenGLTexture2D::bind(uint32_t slot) const
@@ -124,45 +137,122 @@ void OpenGLTexture2D::setData(void* data, uint32_t size)
     glBindTexture(GL_TEXTURE_2D, m_rendererID);
     glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, m_width, m_height, m_dataFormat, GL_UNSIGNED_BYTE, data);
     glGenerateMipmap(GL_TEXTURE_2D);
+    trackMemory(calculateMipLevels(m_width, m_height));
+}
+
+void OpenGLTexture2D::setData(void* data, uint32_t width, uint32_t height, uint32_t channels)
+{
+    RAPTURE_PROFILE_FUNCTION();
+
+    GLenum internalFormat = 0, dataFormat = 0;
+    if (channels == 4) {
+        internalFormat = GL_RGBA8;
+        dataFormat = GL_RGBA;
+    }
+    else if (channels == 3) {
+        internalFormat = GL_RGB8;
+        dataFormat = GL_RGB;
+    }
+    else {
+        GE_CORE_ERROR("OpenGLTexture2D: Unsupported format! Channels: {0}", channels);
+        return;
+    }
+
+    // The previous storage is reported as released before the size and format change
+    trackMemory(0);
 
+    if (m_rendererID == 0) {
+        // Parameters set while the texture had no storage are applied now
+        glGenTextures(1, &m_rendererID);
+        glBindTexture(GL_TEXTURE_2D, m_rendererID);
+
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, m_minFilter);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, m_magFilter);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, m_wrapS);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, m_wrapT);
+    }
+    else {
+        glBindTexture(GL_TEXTURE_2D, m_rendererID);
+    }
 
+    m_width = width;
+    m_height = height;
+    m_internalFormat = internalFormat;
+    m_dataFormat = dataFormat;
 
+    glTexImage2D(GL_TEXTURE_2D, 0, m_internalFormat, m_width, m_height, 0, m_dataFormat, GL_UNSIGNED_BYTE, data);
+    glGenerateMipmap(GL_TEXTURE_2D);
+    trackMemory(calculateMipLevels(m_width, m_height));
 }
 
 void OpenGLTexture2D::setMinFilter(TextureFilter filter)
 {
+    m_minFilter = convertFilterToGL(filter);
+    if (m_rendererID == 0) {
+        return;
+    }
     glBindTexture(GL_TEXTURE_2D, m_rendererID);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, convertFilterToGL(filter));
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, m_minFilter);
     glBindTexture(GL_TEXTURE_2D, 0);
 }
 
 void OpenGLTexture2D::setMagFilter(TextureFilter filter)
 {
-    glBindTexture(GL_TEXTURE_2D, m_rendererID);
     // Note: Mag filter can only be GL_NEAREST or GL_LINEAR
     GLenum glFilter = convertFilterToGL(filter);
     if (glFilter != GL_NEAREST && glFilter != GL_LINEAR) {
         GE_CORE_WARN("OpenGLTexture2D: Mag filter can only be Nearest or Linear. Using Linear instead.");
         glFilter = GL_LINEAR;
     }
+    m_magFilter = glFilter;
+    if (m_rendererID == 0) {
+        return;
+    }
+    glBindTexture(GL_TEXTURE_2D, m_rendererID);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, glFilter);
     glBindTexture(GL_TEXTURE_2D, 0);
 }
 
 void OpenGLTexture2D::setWrapS(TextureWrap wrap)
 {
+    m_wrapS = convertWrapToGL(wrap);
+    if (m_rendererID == 0) {
+        return;
+    }
     glBindTexture(GL_TEXTURE_2D, m_rendererID);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, convertWrapToGL(wrap));
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, m_wrapS);
     glBindTexture(GL_TEXTURE_2D, 0);
 }
 
 void OpenGLTexture2D::setWrapT(TextureWrap wrap)
 {
+    m_wrapT = convertWrapToGL(wrap);
+    if (m_rendererID == 0) {
+        return;
+    }
     glBindTexture(GL_TEXTURE_2D, m_rendererID);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, convertWrapToGL(wrap));
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, m_wrapT);
     glBindTexture(GL_TEXTURE_2D, 0);
 }
 
+void OpenGLTexture2D::trackMemory(uint32_t mipLevels)
+{
+    if (m_trackedMipLevels == mipLevels || m_internalFormat == 0) {
+        return;
+    }
+
+    std::string format = m_internalFormat == GL_RGBA8 ? "RGBA8" : "RGB8";
+    uint32_t bytesPerPixel = m_internalFormat == GL_RGBA8 ? 4 : 3;
+
+    if (m_trackedMipLevels > 0) {
+        TextureLibrary::removeTextureMemory(format, m_width, m_height, bytesPerPixel, m_trackedMipLevels);
+    }
+    if (mipLevels > 0) {
+        TextureLibrary::addTextureMemory(format, m_width, m_height, bytesPerPixel, mipLevels);
+    }
+    m_trackedMipLevels = mipLevels;
+}
+
 GLenum OpenGLTexture2D::convertFilterToGL(TextureFilter filter)
 {
     switch (filter) {
@@ -201,4 +291,9 @@ std::shared_ptr<Texture2D> Texture2D::create(uint32_t width, uint32_t height, ui
     return std::make_shared<OpenGLTexture2D>(width, height, channels);
 }
 
+std::shared_ptr<Texture2D> Texture2D::create()
+{
+    return std::make_shared<OpenGLTexture2D>();
+}
+
 } // namespace Rapture 
\ No newline at end of file
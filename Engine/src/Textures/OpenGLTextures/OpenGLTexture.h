@@ -9,6 +9,8 @@ class OpenGLTexture2D : public Texture2D {
 public:
     OpenGLTexture2D(const std::string& path);
     OpenGLTexture2D(uint32_t width, uint32_t height, uint32_t channels);
+    // No storage and no GL object until setData gives it pixels
+    OpenGLTexture2D() = default;
     virtual ~OpenGLTexture2D() override;
 
     virtual uint32_t getWidth() const override { return m_width; }
@@ -19,6 +21,7 @@ public:
     virtual void unbind() const override;
 
     virtual void setData(void* data, uint32_t size) override;
+    virtual void setData(void* data, uint32_t width, uint32_t height, uint32_t channels) override;
     
     // Implement texture parameter setters
     virtual void setMinFilter(TextureFilter filter) override;
@@ -31,6 +34,9 @@ private:
     GLenum convertFilterToGL(TextureFilter filter);
     GLenum convertWrapToGL(TextureWrap wrap);
 
+    // Reports the storage of this texture to the TextureLibrary memory stats, replacing the previous report
+    void trackMemory(uint32_t mipLevels);
+
 private:
     std::string m_path;
     uint32_t m_width = 0;
@@ -38,6 +44,13 @@ private:
     uint32_t m_rendererID = 0;
     GLenum m_internalFormat = GL_RGBA8;
     GLenum m_dataFormat = GL_RGBA;
+    uint32_t m_trackedMipLevels = 0;
+
+    // Sampling parameters, kept so a texture without storage can take them before it has a GL object
+    GLenum m_minFilter = GL_LINEAR;
+    GLenum m_magFilter = GL_LINEAR;
+    GLenum m_wrapS = GL_REPEAT;
+    GLenum m_wrapT = GL_REPEAT;
 };
 
 } // namespace Rapture
\ No newline at end of file
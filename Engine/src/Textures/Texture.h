@@ -4,8 +4,16 @@
 #include <memory>
 #include <unordered_map>
 #include <queue>
+#include <chrono>
 #include <mutex>
 #include <functional>
+#include <map>
+#include <vector>
+#include <deque>
+#include <atomic>
+
+#include "../Jobs/JobSystem.h"
+#include "../Jobs/BoundedQueue.h"
 
 namespace Rapture {
 
@@ -37,6 +45,13 @@ enum class TextureWrap {
     Repeat                  // GL_REPEAT
 };
 
+// Filtering and wrapping of a texture, the defaults match a newly created texture
+struct TextureSampler {
+    TextureFilter minFilter = TextureFilter::Linear;
+    TextureFilter magFilter = TextureFilter::Linear;
+    TextureWrap wrapS = TextureWrap::Repeat;
+    TextureWrap wrapT = TextureWrap::Repeat;
+};
 
 class Texture {
 public:
@@ -49,7 +64,7 @@ public:
     virtual void bind(uint32_t slot = 0) const = 0;
     virtual void unbind() const = 0;
     
-    // Texture parameter setters
+    // Texture parameter setters, GL thread only. Other threads go through TextureLibrary::setSampler
     virtual void setMinFilter(TextureFilter filter) = 0;
     virtual void setMagFilter(TextureFilter filter) = 0;
     virtual void setWrapS(TextureWrap wrap) = 0;
@@ -60,8 +75,14 @@ class Texture2D : public Texture {
 public:
     virtual void setData(void* data, uint32_t size) = 0;
 
+    // (Re)allocate the storage at the given size and fill it, GL thread only
+    virtual void setData(void* data, uint32_t width, uint32_t height, uint32_t channels) = 0;
+
     static std::shared_ptr<Texture2D> create(const std::string& path);
     static std::shared_ptr<Texture2D> create(uint32_t width, uint32_t height, uint32_t channels);
+
+    // Texture without storage, makes no GL calls so any thread can create it. Binds as no texture until it gets data
+    static std::shared_ptr<Texture2D> create();
 };
 
 struct TextureLoadRequest {
@@ -75,42 +96,114 @@ struct TextureLoadRequest {
     std::function<void(std::shared_ptr<Texture2D>)> callback = nullptr;
 };
 
+// Requests that fit in the lock-free decode queue, past that they wait in a locked overflow list
+constexpr size_t TEXTURE_DECODE_QUEUE_CAPACITY = 1024;
+
+// Texture decode pipeline, throughput counts the time at least one decode was running
+struct TextureDecodeStats {
+    size_t queueDepth = 0;              // requests waiting for a decode slot
+    size_t peakQueueDepth = 0;
+    size_t queueCapacity = 0;
+    size_t overflowDepth = 0;           // requests waiting because the queue was full
+    uint64_t overflowedRequests = 0;
+    size_t activeDecodes = 0;
+    size_t maxConcurrentDecodes = 0;
+    uint64_t texturesDecoded = 0;
+    uint64_t decodeFailures = 0;
+    uint64_t bytesDecoded = 0;          // pixels handed to the GL thread
+    float busySeconds = 0.0f;
+    float texturesPerSecond = 0.0f;
+    float megabytesPerSecond = 0.0f;
+};
+
+// Texture memory as reported by the texture backends, split by internal format and by mip level
+struct TextureMemoryStats {
+    std::map<std::string, size_t> bytesPerFormat;
+    std::vector<size_t> bytesPerMipLevel;     // index 0 is the base level
+    size_t totalBytes = 0;
+    size_t textureCount = 0;
+};
+
 class TextureLibrary {
 public:
-    static void init(unsigned int numThreads = 4);
+    // Textures decode as low priority jobs on the JobSystem, at most maxConcurrentDecodes at once.
+    // Idle slots cost nothing, the workers sleep until there is a job
+    static void init(unsigned int maxConcurrentDecodes = 4, size_t queueCapacity = TEXTURE_DECODE_QUEUE_CAPACITY);
     static void shutdown();
     
     static void add(const std::string& name, const std::shared_ptr<Texture2D>& texture);
     static void add(const std::shared_ptr<Texture2D>& texture);
     static std::shared_ptr<Texture2D> load(const std::string& filepath);
-    static std::shared_ptr<Texture2D> loadAsync(const std::string& filepath);
+    // Returns a placeholder right away and reads, probes and decodes the file on a job, callable from any thread.
+    // callback runs on the main thread once the pixels are uploaded, with nullptr if the texture can't be loaded.
+    // A texture already in the library calls it right away, even if another loadAsync of it is still uploading
+    static std::shared_ptr<Texture2D> loadAsync(const std::string& filepath,
+        std::function<void(std::shared_ptr<Texture2D>)> callback = nullptr);
     static std::shared_ptr<Texture2D> get(const std::string& name);
+
+    // Callable from any thread, the parameters are set on the GL thread in order with the texture's upload
+    static void setSampler(const std::shared_ptr<Texture>& texture, const TextureSampler& sampler);
     
     static bool getTextureDimensions(const std::string& path, int& width, int& height, int& channels);
 
+    // Memory tracking, called by the texture backends whenever storage is (re)allocated or released
+    static void addTextureMemory(const std::string& format, uint32_t width, uint32_t height, uint32_t bytesPerPixel, uint32_t mipLevels);
+    static void removeTextureMemory(const std::string& format, uint32_t width, uint32_t height, uint32_t bytesPerPixel, uint32_t mipLevels);
+    static TextureMemoryStats getMemoryStats();
+
+    static TextureDecodeStats getDecodeStats();
+
     // Multithreaded Operations
+    // Stops decoding and waits for the decode jobs, queued textures keep their placeholder
     static void shutdownWorkers();
 
-    static void processLoadingQueue();
-    
-
 private:
-    // Worker thread function for loading textures from disk
-    static void textureLoadThread();
+    // Job that decodes the oldest queued texture and hands the pixels to the main thread for upload.
+    // Each job schedules its successor while textures are queued, so a slot is one chain of jobs
+    static void decodeNextTexture();
+
+    // Probe and decode one request, then queue its upload or its failure callback on the main thread
+    static void decodeTexture(TextureLoadRequest& request);
+
+    // Start a decode chain if textures are queued and a slot is free
+    static void scheduleDecodes();
+    static bool hasQueuedTextures();
+
+    // Move overflowed requests into the queue while it has room, oldest first
+    static void refillFromOverflow();
+    static void trackDecodeJob(const JobHandle& job);
+
+    static void beginDecode();
+    static void endDecode(bool success, size_t bytes);
 
 private:
+    // Guarded by s_texturesMutex, loaders add textures from their worker threads
+    static std::mutex s_texturesMutex;
     static std::unordered_map<std::string, std::shared_ptr<Texture2D>> s_textures;
 
-        // Thread-safe queues
-    static std::mutex s_queueMutex;
-    static std::mutex s_completedMutex;
-    static std::queue<TextureLoadRequest> s_pendingTextures;
-    static std::queue<TextureLoadRequest> s_completedTextures;
-    
-        // Thread management
-    static std::vector<std::thread> s_workerThreads;
+    // Requests waiting for a decode slot, pushed and popped without locks
+    static std::unique_ptr<BoundedQueue<TextureLoadRequest>> s_pendingTextures;
+    static std::atomic<size_t> s_peakQueueDepth;
+
+    // Requests that didn't fit in the queue, new requests go here too until it is drained so the order is kept
+    static std::mutex s_overflowMutex;
+    static std::deque<TextureLoadRequest> s_overflowTextures;   // guarded by s_overflowMutex
+    static std::atomic<size_t> s_overflowCount;                 // size of s_overflowTextures, read without the lock
+
+    // Decode jobs on the JobSystem
+    static unsigned int s_maxDecodeJobs;
+    static std::atomic<size_t> s_decodeJobCount;    // chains running, at most s_maxDecodeJobs
+    static std::mutex s_decodeJobsMutex;
+    static std::vector<JobHandle> s_decodeJobs;     // guarded by s_decodeJobsMutex
     static std::atomic<bool> s_threadRunning;
 
+    static std::mutex s_decodeStatsMutex;
+    static TextureDecodeStats s_decodeStats;
+    static std::chrono::steady_clock::time_point s_busyStart;
+
+    static std::mutex s_memoryStatsMutex;
+    static TextureMemoryStats s_memoryStats;
+
 };
 
 
@@ -1,22 +1,35 @@
 #include "Texture.h"
 #include "../Logger/Log.h"
 #include "../Debug/TracyProfiler.h"
+#include "../Renderer/RenderThread.h"
 #include <filesystem>
+#include <algorithm>
+#include <cstring>
 #include <stb_image.h>
 
 namespace Rapture {
 
-std::mutex TextureLibrary::s_queueMutex;
-std::mutex TextureLibrary::s_completedMutex;
-std::queue<TextureLoadRequest> TextureLibrary::s_pendingTextures;
-std::queue<TextureLoadRequest> TextureLibrary::s_completedTextures;
-std::vector<std::thread> TextureLibrary::s_workerThreads;
+std::unique_ptr<BoundedQueue<TextureLoadRequest>> TextureLibrary::s_pendingTextures;
+std::atomic<size_t> TextureLibrary::s_peakQueueDepth(0);
+std::mutex TextureLibrary::s_overflowMutex;
+std::deque<TextureLoadRequest> TextureLibrary::s_overflowTextures;
+std::atomic<size_t> TextureLibrary::s_overflowCount(0);
+unsigned int TextureLibrary::s_maxDecodeJobs = 4;
+std::atomic<size_t> TextureLibrary::s_decodeJobCount(0);
+std::mutex TextureLibrary::s_decodeJobsMutex;
+std::vector<JobHandle> TextureLibrary::s_decodeJobs;
 std::atomic<bool> TextureLibrary::s_threadRunning(false);
+std::mutex TextureLibrary::s_decodeStatsMutex;
+TextureDecodeStats TextureLibrary::s_decodeStats;
+std::chrono::steady_clock::time_point TextureLibrary::s_busyStart;
+std::mutex TextureLibrary::s_memoryStatsMutex;
+TextureMemoryStats TextureLibrary::s_memoryStats;
 
 
+std::mutex TextureLibrary::s_texturesMutex;
 std::unordered_map<std::string, std::shared_ptr<Texture2D>> TextureLibrary::s_textures;
 
-void TextureLibrary::init(unsigned int numThreads)
+void TextureLibrary::init(unsigned int maxConcurrentDecodes, size_t queueCapacity)
 {
     RAPTURE_PROFILE_FUNCTION();
     GE_CORE_INFO("Initializing TextureLibrary");
@@ -25,13 +38,20 @@ void TextureLibrary::init(unsigned int numThreads)
         return;
     }
 
-    s_threadRunning = true;
+    // Decoding is background work, it shouldn't take every worker from the frame
+    s_maxDecodeJobs = std::max(1u, maxConcurrentDecodes);
 
-    unsigned int maxThreads = std::thread::hardware_concurrency();
-    s_workerThreads.resize(std::min(numThreads, maxThreads));
-    for (size_t i = 0; i < s_workerThreads.size(); ++i) {
-        s_workerThreads[i] = std::thread(&TextureLibrary::textureLoadThread);
+    // Kept after shutdown, a late loadAsync from a loader thread still finds a queue
+    if (!s_pendingTextures || s_pendingTextures->capacity() < queueCapacity) {
+        s_pendingTextures = std::make_unique<BoundedQueue<TextureLoadRequest>>(std::max<size_t>(queueCapacity, 1));
+    }
+    {
+        std::lock_guard<std::mutex> lock(s_decodeStatsMutex);
+        s_decodeStats = TextureDecodeStats();
     }
+    s_peakQueueDepth = 0;
+
+    s_threadRunning = true;
 }
 
 void TextureLibrary::shutdown()
@@ -43,20 +63,19 @@ void TextureLibrary::shutdown()
     shutdownWorkers();
     
     // Clear all queues to prevent any pending operations
-    {
-        std::lock_guard<std::mutex> lock(s_queueMutex);
-        while (!s_pendingTextures.empty()) {
-            s_pendingTextures.pop();
+    if (s_pendingTextures) {
+        TextureLoadRequest request;
+        while (s_pendingTextures->tryPop(request)) {
         }
     }
-    
     {
-        std::lock_guard<std::mutex> lock(s_completedMutex);
-        while (!s_completedTextures.empty()) {
-            s_completedTextures.pop();
-        }
+        std::lock_guard<std::mutex> lock(s_overflowMutex);
+        s_overflowTextures.clear();
+        s_overflowCount = 0;
     }
     
+    std::lock_guard<std::mutex> lock(s_texturesMutex);
+
     // Log texture count before clearing
     GE_CORE_INFO("TextureLibrary: Cleaning up {} textures", s_textures.size());
     
@@ -70,6 +89,7 @@ void TextureLibrary::add(const std::string& name, const std::shared_ptr<Texture2
 {
     RAPTURE_PROFILE_FUNCTION();
     
+    std::lock_guard<std::mutex> lock(s_texturesMutex);
     if (s_textures.find(name) != s_textures.end()) {
         GE_CORE_WARN("Texture '{0}' already exists in the library, overwriting", name);
     }
@@ -83,10 +103,13 @@ void TextureLibrary::add(const std::shared_ptr<Texture2D>& texture)
     // Use pointer address as a unique identifier if no name is provided
     // Check if a texture with the same renderer ID already exists
     uint32_t rendererID = texture->getRendererID();
-    for (const auto& [existingName, existingTexture] : s_textures) {
-        if (existingTexture->getRendererID() == rendererID) {
-            GE_CORE_INFO("Texture with renderer ID {0} already exists as '{1}', skipping addition", rendererID, existingName);
-            return;
+    {
+        std::lock_guard<std::mutex> lock(s_texturesMutex);
+        for (const auto& [existingName, existingTexture] : s_textures) {
+            if (existingTexture->getRendererID() == rendererID) {
+                GE_CORE_INFO("Texture with renderer ID {0} already exists as '{1}', skipping addition", rendererID, existingName);
+                return;
+            }
         }
     }
     
@@ -102,9 +125,12 @@ std::shared_ptr<Texture2D> TextureLibrary::load(const std::string& filepath)
     std::string filename = std::filesystem::path(filepath).filename().string();
     
     // Check if already loaded
-    auto it = s_textures.find(filename);
-    if (it != s_textures.end()) {
-        return it->second;
+    {
+        std::lock_guard<std::mutex> lock(s_texturesMutex);
+        auto it = s_textures.find(filename);
+        if (it != s_textures.end()) {
+            return it->second;
+        }
     }
     
     // Load the texture
@@ -118,59 +144,68 @@ std::shared_ptr<Texture2D> TextureLibrary::load(const std::string& filepath)
     return nullptr;
 }
 
-std::shared_ptr<Texture2D> TextureLibrary::loadAsync(const std::string &filepath)
+std::shared_ptr<Texture2D> TextureLibrary::loadAsync(const std::string &filepath,
+    std::function<void(std::shared_ptr<Texture2D>)> callback)
 {
     RAPTURE_PROFILE_FUNCTION();
     
     // Use filepath as name, but cleanup to get just the filename
     std::string filename = std::filesystem::path(filepath).filename().string();
     
-    // Check if already loaded
-    auto it = s_textures.find(filename);
-    if (it != s_textures.end()) {
-        return it->second;
+    // Look up and reserve the name in one step, so two threads loading the same file share one texture.
+    // The placeholder makes no GL calls, its storage is allocated once the decoder knows the size
+    std::shared_ptr<Texture2D> texture;
+    std::shared_ptr<Texture2D> existing;
+    {
+        std::lock_guard<std::mutex> lock(s_texturesMutex);
+        auto it = s_textures.find(filename);
+        if (it != s_textures.end()) {
+            existing = it->second;
+        }
+        else if (s_threadRunning) {
+            texture = Texture2D::create();
+            s_textures[filename] = texture;
+        }
     }
-
-    // Get texture dimensions
-    int width, height, channels;
-    if (!getTextureDimensions(filepath, width, height, channels)) {
-        GE_CORE_ERROR("TextureLibrary: Failed to get dimensions for '{0}'", filepath);
-        return nullptr;
+    if (existing) {
+        if (callback) {
+            callback(existing);
+        }
+        return existing;
     }
-    
-   // Create texture with correct dimensions but no data yet
-    auto texture = Texture2D::create(width, height, channels);
     if (!texture) {
-        GE_CORE_ERROR("TextureLibrary: Failed to create texture for '{0}'", filepath);
+        GE_CORE_ERROR("TextureLibrary: Not initialized, failed to load texture '{0}'", filepath);
+        if (callback) {
+            callback(nullptr);
+        }
         return nullptr;
     }
-    
-    // Add to library immediately with placeholder
-    add(filename, texture);
 
     // Queue the texture for async loading
     TextureLoadRequest request;
     request.path = filepath;
     request.name = filename;
-    request.width = width;
-    request.height = height;
-    request.channels = channels;
     request.texture = texture;
+    request.callback = std::move(callback);
 
-    // Add to pending queue
-    {
-        std::lock_guard<std::mutex> lock(s_queueMutex);
-        s_pendingTextures.push(request);
-    }
-    
-    // Start worker thread if not already running
-    if (!s_threadRunning) {
-        GE_CORE_ERROR("TextureLibrary: Thread not running, failed to load texture '{0}'", filepath);
-        return nullptr;
+    // A full queue means the decoders are far behind, the request waits in the overflow list and the
+    // caller moves on. Once anything overflowed, later requests line up behind it until the decoders drain it
+    if (s_overflowCount > 0 || !s_pendingTextures->tryPush(std::move(request))) {
+        {
+            std::lock_guard<std::mutex> lock(s_overflowMutex);
+            s_overflowTextures.push_back(std::move(request));
+            s_overflowCount = s_overflowTextures.size();
+        }
+        std::lock_guard<std::mutex> lock(s_decodeStatsMutex);
+        s_decodeStats.overflowedRequests++;
     }
 
-    s_workerThreads.emplace_back(&TextureLibrary::textureLoadThread);
+    size_t depth = s_pendingTextures->size();
+    size_t peak = s_peakQueueDepth.load(std::memory_order_relaxed);
+    while (depth > peak && !s_peakQueueDepth.compare_exchange_weak(peak, depth, std::memory_order_relaxed)) {
+    }
 
+    scheduleDecodes();
     
     return texture;
 }
@@ -179,6 +214,7 @@ std::shared_ptr<Texture2D> TextureLibrary::get(const std::string& name)
 {
     RAPTURE_PROFILE_FUNCTION();
     
+    std::lock_guard<std::mutex> lock(s_texturesMutex);
     auto it = s_textures.find(name);
     if (it != s_textures.end()) {
         return it->second;
@@ -188,113 +224,218 @@ std::shared_ptr<Texture2D> TextureLibrary::get(const std::string& name)
     return nullptr;
 }
 
+void TextureLibrary::setSampler(const std::shared_ptr<Texture>& texture, const TextureSampler& sampler)
+{
+    if (!texture) {
+        return;
+    }
+
+    // Goes through the main thread like the upload, so it is submitted to the render thread from the same thread
+    auto applySampler = [texture, sampler]() {
+        RenderThread::submit([texture, sampler]() {
+            texture->setMinFilter(sampler.minFilter);
+            texture->setMagFilter(sampler.magFilter);
+            texture->setWrapS(sampler.wrapS);
+            texture->setWrapT(sampler.wrapT);
+        });
+    };
+
+    if (JobSystem::isMainThread()) {
+        applySampler();
+    }
+    else {
+        JobSystem::scheduleOnMainThread(applySampler);
+    }
+}
+
 void TextureLibrary::shutdownWorkers()
 {
     RAPTURE_PROFILE_FUNCTION();
-    GE_CORE_INFO("TextureLibrary: Shutting down worker threads");
+    GE_CORE_INFO("TextureLibrary: Stopping texture decode jobs");
     
-    // Set the flag to false to signal threads to stop
+    // Set the flag to false to signal decode jobs to stop
     if (s_threadRunning.exchange(false)) {
-        // Wait for the thread to join if joinable
-        if (s_workerThreads.size() > 0 && s_workerThreads[0].joinable()) {
-            GE_CORE_INFO("TextureLibrary: Waiting for worker thread to join");
-            for (auto& thread : s_workerThreads) {
-                if (thread.joinable()) {
-                    thread.join();
-                }
+        // A running job may still schedule its successor, which returns right away, so repeat until none are left
+        while (true) {
+            std::vector<JobHandle> decodeJobs;
+            {
+                std::lock_guard<std::mutex> lock(s_decodeJobsMutex);
+                decodeJobs.swap(s_decodeJobs);
             }
-            s_workerThreads.clear();
-            GE_CORE_INFO("TextureLibrary: Worker threads joined successfully");
-        } else {
-            GE_CORE_WARN("TextureLibrary: Worker threads not joinable");
+            if (decodeJobs.empty()) {
+                break;
+            }
+            JobSystem::wait(decodeJobs);
         }
+        GE_CORE_INFO("TextureLibrary: Texture decode jobs stopped");
     } else {
-        GE_CORE_INFO("TextureLibrary: Worker threads already stopped");
+        GE_CORE_INFO("TextureLibrary: Texture decode jobs already stopped");
     }
 }
 
-void TextureLibrary::processLoadingQueue()
+void TextureLibrary::scheduleDecodes()
 {
-    std::vector<TextureLoadRequest> completedRequests;
+    // Pairs with the fence in decodeNextTexture: either this sees the slot a finishing chain gave up,
+    // or that chain sees the request just queued and starts a decode for it
+    std::atomic_thread_fence(std::memory_order_seq_cst);
 
-    {
-        std::lock_guard<std::mutex> lock(s_completedMutex);
-        while (!s_completedTextures.empty()) {
-            completedRequests.push_back(s_completedTextures.front());
-            s_completedTextures.pop();
+    size_t running = s_decodeJobCount.load();
+    do {
+        if (!s_threadRunning || !hasQueuedTextures() || running >= s_maxDecodeJobs) {
+            return;
         }
+    } while (!s_decodeJobCount.compare_exchange_weak(running, running + 1));
+
+    // The job runs inline when the JobSystem isn't running
+    trackDecodeJob(JobSystem::schedule(&TextureLibrary::decodeNextTexture, JobPriority::Low));
+}
+
+bool TextureLibrary::hasQueuedTextures()
+{
+    return !s_pendingTextures->empty() || s_overflowCount > 0;
+}
+
+void TextureLibrary::refillFromOverflow()
+{
+    std::lock_guard<std::mutex> lock(s_overflowMutex);
+    while (!s_overflowTextures.empty() && s_pendingTextures->tryPush(std::move(s_overflowTextures.front()))) {
+        s_overflowTextures.pop_front();
     }
+    s_overflowCount = s_overflowTextures.size();
+}
 
-    for (auto& request : completedRequests) {
-        if (request.texture && !request.data.empty()) {
-            request.texture->setData(request.data.data(), request.data.size());
-        }
+void TextureLibrary::trackDecodeJob(const JobHandle& job)
+{
+    std::lock_guard<std::mutex> lock(s_decodeJobsMutex);
+    s_decodeJobs.erase(std::remove_if(s_decodeJobs.begin(), s_decodeJobs.end(),
+        [](const JobHandle& decodeJob) { return decodeJob->isDone(); }), s_decodeJobs.end());
+    if (!job->isDone()) {
+        s_decodeJobs.push_back(job);
+    }
+}
 
-        if (request.callback) {
-            request.callback(request.texture);
-        }
+void TextureLibrary::decodeNextTexture()
+{
+    RAPTURE_PROFILE_FUNCTION();
+
+    // Get a request from the queue, the chain ends once the queue and the overflow list are empty
+    if (s_overflowCount > 0) {
+        refillFromOverflow();
+    }
+
+    TextureLoadRequest request;
+    if (!s_threadRunning || !s_pendingTextures->tryPop(request)) {
+        s_decodeJobCount--;
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        scheduleDecodes();
+        return;
     }
+
+    beginDecode();
+    decodeTexture(request);
+
+    // Keep the slot and let the next texture be its own job, so frame work queued meanwhile gets a worker first
+    trackDecodeJob(JobSystem::schedule(&TextureLibrary::decodeNextTexture, JobPriority::Low));
 }
 
-void TextureLibrary::textureLoadThread()
+void TextureLibrary::decodeTexture(TextureLoadRequest& request)
 {
-    GE_CORE_INFO("TextureLibrary: Texture loading thread started");
-    
-    while (s_threadRunning) {
-        TextureLoadRequest request;
-        bool hasRequest = false;
-        
-        // Check if shutdown was requested before accessing the mutex
-        if (!s_threadRunning) break;
-        
-        // Get a request from the queue
-        {
-            std::lock_guard<std::mutex> lock(s_queueMutex);
-            if (!s_pendingTextures.empty()) {
-                request = s_pendingTextures.front();
-                s_pendingTextures.pop();
-                hasRequest = true;
-            }
+    RAPTURE_PROFILE_FUNCTION();
+
+    // Probed here rather than in loadAsync, reading the header is file IO as well.
+    // One and two channel images are expanded to RGBA, the textures only take RGB and RGBA
+    unsigned char* data = nullptr;
+    int fileChannels = 0;
+    if (getTextureDimensions(request.path, request.width, request.height, fileChannels)) {
+        int desiredChannels = (fileChannels == 3 || fileChannels == 4) ? 0 : 4;
+        stbi_set_flip_vertically_on_load(0);
+        data = stbi_load(request.path.c_str(), &request.width, &request.height, &request.channels, desiredChannels);
+        if (desiredChannels != 0) {
+            request.channels = desiredChannels;
         }
+    }
+    
+    if (data) {
+        // Store the data in the request for later processing on main thread
+        size_t dataSize = (size_t)request.width * request.height * request.channels;
+        request.data.resize(dataSize);
+        std::memcpy(request.data.data(), data, dataSize);
         
-        // Check if shutdown was requested after acquiring a request
-        if (!s_threadRunning) break;
+        // Free stbi data
+        stbi_image_free(data);
+        endDecode(true, dataSize);
         
-        if (hasRequest) {
-            // Load image data but check shutdown flag regularly
-            stbi_set_flip_vertically_on_load(0);
-            unsigned char* data = stbi_load(request.path.c_str(), &request.width, &request.height, &request.channels, 0);
-            
-            // Check if shutdown was requested after loading
+        // GPU upload on the main thread
+        JobSystem::scheduleOnMainThread([request = std::move(request)]() mutable {
             if (!s_threadRunning) {
-                if (data) stbi_image_free(data);
-                break;
+                return;
+            }
+            if (request.texture && !request.data.empty()) {
+                // Replayed ahead of every draw recorded later when a render thread owns GL
+                RenderThread::submit([texture = request.texture, data = std::move(request.data),
+                    width = request.width, height = request.height, channels = request.channels]() mutable {
+                    texture->setData(data.data(), width, height, channels);
+                });
             }
-            
-            if (data) {
-                // Store the data in the request for later processing on main thread
-                size_t dataSize = request.width * request.height * request.channels;
-                request.data.resize(dataSize);
-                std::memcpy(request.data.data(), data, dataSize);
-                
-                // Free stbi data
-                stbi_image_free(data);
-                
-                // Queue for GPU upload on main thread
-                std::lock_guard<std::mutex> lock(s_completedMutex);
-                s_completedTextures.push(request);
-
-            } else {
-                GE_CORE_ERROR("TextureLibrary: Failed to load texture data '{0}'", request.path);
+            if (request.callback) {
+                request.callback(request.texture);
             }
-        } else {
-            // No work to do, sleep to avoid busy waiting
-            // Use shorter sleep durations to respond to shutdown quicker
-            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        });
+    } else {
+        GE_CORE_ERROR("TextureLibrary: Failed to load texture data '{0}'", request.path);
+        endDecode(false, 0);
+        if (request.callback) {
+            JobSystem::scheduleOnMainThread([callback = std::move(request.callback)]() {
+                callback(nullptr);
+            });
         }
     }
-    
-    GE_CORE_INFO("TextureLibrary: Texture loading thread stopped");
+}
+
+void TextureLibrary::beginDecode()
+{
+    std::lock_guard<std::mutex> lock(s_decodeStatsMutex);
+    if (s_decodeStats.activeDecodes++ == 0) {
+        s_busyStart = std::chrono::steady_clock::now();
+    }
+}
+
+void TextureLibrary::endDecode(bool success, size_t bytes)
+{
+    std::lock_guard<std::mutex> lock(s_decodeStatsMutex);
+    if (success) {
+        s_decodeStats.texturesDecoded++;
+        s_decodeStats.bytesDecoded += bytes;
+    }
+    else {
+        s_decodeStats.decodeFailures++;
+    }
+    if (--s_decodeStats.activeDecodes == 0) {
+        s_decodeStats.busySeconds += std::chrono::duration<float>(std::chrono::steady_clock::now() - s_busyStart).count();
+    }
+}
+
+TextureDecodeStats TextureLibrary::getDecodeStats()
+{
+    TextureDecodeStats stats;
+    {
+        std::lock_guard<std::mutex> lock(s_decodeStatsMutex);
+        stats = s_decodeStats;
+        if (stats.activeDecodes > 0) {
+            stats.busySeconds += std::chrono::duration<float>(std::chrono::steady_clock::now() - s_busyStart).count();
+        }
+    }
+
+    stats.queueDepth = s_pendingTextures ? s_pendingTextures->size() : 0;
+    stats.queueCapacity = s_pendingTextures ? s_pendingTextures->capacity() : 0;
+    stats.peakQueueDepth = s_peakQueueDepth.load(std::memory_order_relaxed);
+    stats.overflowDepth = s_overflowCount;
+    stats.maxConcurrentDecodes = s_maxDecodeJobs;
+    if (stats.busySeconds > 0.0f) {
+        stats.texturesPerSecond = stats.texturesDecoded / stats.busySeconds;
+        stats.megabytesPerSecond = stats.bytesDecoded / 1048576.0f / stats.busySeconds;
+    }
+    return stats;
 }
 
 bool TextureLibrary::getTextureDimensions(const std::string &path, int &width, int &height, int &channels)
@@ -309,4 +450,42 @@ bool TextureLibrary::getTextureDimensions(const std::string &path, int &width, i
     return false;
 }
 
-} // namespace Rapture 
\ No newline at end of file
+void TextureLibrary::addTextureMemory(const std::string& format, uint32_t width, uint32_t height, uint32_t bytesPerPixel, uint32_t mipLevels)
+{
+    std::lock_guard<std::mutex> lock(s_memoryStatsMutex);
+
+    if (s_memoryStats.bytesPerMipLevel.size() < mipLevels) {
+        s_memoryStats.bytesPerMipLevel.resize(mipLevels, 0);
+    }
+
+    for (uint32_t level = 0; level < mipLevels; ++level) {
+        size_t levelBytes = (size_t)std::max(1u, width >> level) * std::max(1u, height >> level) * bytesPerPixel;
+        s_memoryStats.bytesPerMipLevel[level] += levelBytes;
+        s_memoryStats.bytesPerFormat[format] += levelBytes;
+        s_memoryStats.totalBytes += levelBytes;
+    }
+    s_memoryStats.textureCount++;
+}
+
+void TextureLibrary::removeTextureMemory(const std::string& format, uint32_t width, uint32_t height, uint32_t bytesPerPixel, uint32_t mipLevels)
+{
+    std::lock_guard<std::mutex> lock(s_memoryStatsMutex);
+
+    for (uint32_t level = 0; level < mipLevels && level < s_memoryStats.bytesPerMipLevel.size(); ++level) {
+        size_t levelBytes = (size_t)std::max(1u, width >> level) * std::max(1u, height >> level) * bytesPerPixel;
+        s_memoryStats.bytesPerMipLevel[level] -= std::min(levelBytes, s_memoryStats.bytesPerMipLevel[level]);
+        s_memoryStats.bytesPerFormat[format] -= std::min(levelBytes, s_memoryStats.bytesPerFormat[format]);
+        s_memoryStats.totalBytes -= std::min(levelBytes, s_memoryStats.totalBytes);
+    }
+    if (s_memoryStats.textureCount > 0) {
+        s_memoryStats.textureCount--;
+    }
+}
+
+TextureMemoryStats TextureLibrary::getMemoryStats()
+{
+    std::lock_guard<std::mutex> lock(s_memoryStatsMutex);
+    return s_memoryStats;
+}
+
+} // namespace Rapture
@@ -11,6 +11,11 @@
 
 #include "../Materials/MaterialLibrary.h"
 #include "../Buffers/BufferPools.h"
+#include "../Buffers/BufferUploadQueue.h"
+#include "../Scenes/Systems/AnimationSystem.h"
+#include "../Jobs/JobSystem.h"
+#include "../File Loaders/ModelLoader.h"
+#include "../Scenes/StagingScene.h"
 
 namespace Rapture {
 
@@ -32,9 +37,13 @@ namespace Rapture {
 		// Initialize systems
 		{
 			RAPTURE_PROFILE_SCOPE("Systems Initialization");
+			// Workers first, everything below schedules onto them
+			JobSystem::init();
 			TextureLibrary::init(4);
 			Rapture::MaterialLibrary::init();
 			BufferPoolManager::init();
+			BufferUploadQueue::init();
+			AnimationSystem::init();
 			Renderer::init();
 			
 
@@ -49,6 +58,14 @@ namespace Rapture {
 		TracyProfiler::shutdown();
         TextureLibrary::shutdown();
         MaterialLibrary::shutdown();
+		AnimationSystem::shutdown();
+		// Running loads are cancelled before the workers go away, they may be throttled by the upload queue
+		if (ModelLoader::getInstance().isInitialized()) {
+			ModelLoader::getInstance().shutdown();
+		}
+		StagingScene::discardPending();
+		JobSystem::shutdown();
+		BufferUploadQueue::shutdown();
 		BufferPoolManager::shutdown();
 
 		// closes twice...
@@ -57,63 +74,147 @@ namespace Rapture {
 
 	void Application::Run(void)
 	{
+		if (m_useRenderThread) {
+			RenderThread::start(m_window.get(), m_maxFramesInFlight);
+		}
+
 		while (m_running)
 		{
-			// Begin frame profiling
-			RAPTURE_PROFILE_FUNCTION();
-            
-            // Start of frame
-            {
-                RAPTURE_PROFILE_SCOPE("Frame Start");
-                RAPTURE_PROFILE_GPU_SCOPE("Frame Start");
-                
-                TracyProfiler::beginFrame();
-            }
+			if (RenderThread::isRunning()) {
+				runPipelinedFrame();
+			}
+			else {
+				runFrame();
+			}
+		}
+
+		// Renders what is still queued and hands GL back before the libraries release their objects
+		RenderThread::stop();
+	}
+
+	void Application::setRenderThreadEnabled(bool enabled, uint32_t maxFramesInFlight)
+	{
+		if (RenderThread::isRunning()) {
+			GE_CORE_WARN("Application: The render thread mode can only be changed before Run");
+			return;
+		}
+		m_useRenderThread = enabled;
+		m_maxFramesInFlight = maxFramesInFlight;
+	}
+
+	void Application::runFrame(void)
+	{
+		// Begin frame profiling
+		RAPTURE_PROFILE_FUNCTION();
+        
+        // Start of frame
+        {
+            RAPTURE_PROFILE_SCOPE("Frame Start");
+            RAPTURE_PROFILE_GPU_SCOPE("Frame Start");
             
+            TracyProfiler::beginFrame();
+        }
+        
+        
+        // Update game state
+        {
+            RAPTURE_PROFILE_SCOPE("Game State Update");
             
-            // Update game state
+            // GL work handed over by the job system, e.g. uploads of decoded textures
             {
-                RAPTURE_PROFILE_SCOPE("Game State Update");
-                
-                // Process texture loading queue
-                {
-                    RAPTURE_PROFILE_SCOPE("Texture Loading");
-                    RAPTURE_PROFILE_GPU_SCOPE("Texture Loading");
-                    TextureLibrary::processLoadingQueue();
-                }
-                
-                // Update all layers
-                for (auto layer : m_layerStack)
-                {
-                    RAPTURE_PROFILE_SCOPE("Layer Update");
-                    layer->onUpdate((float)Timestep::deltaTimeMs().count());
-                }
-                
-                // Update timestep
-                {
-                    RAPTURE_PROFILE_SCOPE("Timestep Update");
-                    Timestep::onUpdate();
-                }
+                RAPTURE_PROFILE_SCOPE("Main Thread Jobs");
+                RAPTURE_PROFILE_GPU_SCOPE("Main Thread Jobs");
+                JobSystem::runMainThreadJobs();
             }
-            
-            // Rendering
+
+            // Upload mesh data staged by the loader threads, bounded per frame
             {
-                RAPTURE_PROFILE_SCOPE("Rendering");
-                RAPTURE_PROFILE_GPU_SCOPE("Rendering");
-                
-                m_window->onUpdate();
+                RAPTURE_PROFILE_SCOPE("Buffer Uploads");
+                RAPTURE_PROFILE_GPU_SCOPE("Buffer Uploads");
+                BufferUploadQueue::processUploads();
             }
-            
-            // End of frame
+
+            // Models finished by the loader threads enter their scenes here, before anything looks at them
             {
-                RAPTURE_PROFILE_SCOPE("Frame End");
-                RAPTURE_PROFILE_GPU_SCOPE("Frame End");
-                
-                // Very important - collect GPU data
-                TracyProfiler::collectGPUData();
-                
-                TracyProfiler::endFrame();
+                RAPTURE_PROFILE_SCOPE("Scene Merges");
+                StagingScene::mergePending();
             }
+            
+            updateLayers();
+        }
+        
+        // Rendering
+        {
+            RAPTURE_PROFILE_SCOPE("Rendering");
+            RAPTURE_PROFILE_GPU_SCOPE("Rendering");
+            
+            m_window->onUpdate();
+        }
+        
+        // End of frame
+        {
+            RAPTURE_PROFILE_SCOPE("Frame End");
+            RAPTURE_PROFILE_GPU_SCOPE("Frame End");
+            
+            // Very important - collect GPU data
+            TracyProfiler::collectGPUData();
+            
+            TracyProfiler::endFrame();
+        }
+	}
+
+	void Application::runPipelinedFrame(void)
+	{
+		// No GPU scopes here, the render thread owns the context they would be recorded in
+		RAPTURE_PROFILE_FUNCTION();
+
+		TracyProfiler::beginFrame();
+
+		// Input right before the update that reacts to it, the render thread is at most a frame or two behind
+		{
+			RAPTURE_PROFILE_SCOPE("Poll Events");
+			m_window->pollEvents();
+		}
+
+		{
+			RAPTURE_PROFILE_SCOPE("Game State Update");
+
+			// GL work in these goes through RenderThread::submit, mesh uploads run on the render thread
+			{
+				RAPTURE_PROFILE_SCOPE("Main Thread Jobs");
+				JobSystem::runMainThreadJobs();
+			}
+
+			{
+				RAPTURE_PROFILE_SCOPE("Scene Merges");
+				StagingScene::mergePending();
+			}
+
+			updateLayers();
+		}
+
+		// Blocks only while the render thread is maxFramesInFlight frames behind
+		{
+			RAPTURE_PROFILE_SCOPE("Submit Frame");
+			RenderThread::submitFrame();
+		}
+
+		TracyProfiler::endFrame();
+	}
+
+	void Application::updateLayers(void)
+	{
+		// Update all layers
+		for (auto layer : m_layerStack)
+		{
+			RAPTURE_PROFILE_SCOPE("Layer Update");
+			layer->onUpdate((float)Timestep::deltaTimeMs().count());
+		}
+		
+		// Update timestep
+		{
+			RAPTURE_PROFILE_SCOPE("Timestep Update");
+			Timestep::onUpdate();
 		}
 	}
 
@@ -4,6 +4,7 @@
 
 #include "WindowContext.h"
 #include "../Layers/LayerStack.h"
+#include "../Renderer/RenderThread.h"
 #include <memory>
 #include <string>
 
@@ -17,6 +18,11 @@ namespace Rapture {
 
 		void Run(void);
 
+		// Submit GL from a dedicated render thread, so rendering frame N overlaps updating frame N+1.
+		// Call before Run. Layers must then record their GL work through RenderThread::submit
+		void setRenderThreadEnabled(bool enabled, uint32_t maxFramesInFlight = MAX_FRAMES_IN_FLIGHT);
+		bool isRenderThreadEnabled() const { return m_useRenderThread; }
+
 		void onEvent(Event& e);
 
 		bool onWindowContextClose(void);
@@ -36,11 +42,24 @@ namespace Rapture {
 	protected:
 		std::string m_debugName;
 
+	private:
+
+		// One frame with everything on the main thread
+		void runFrame(void);
+
+		// One frame while the render thread owns GL: input, update, then hand the recorded commands over
+		void runPipelinedFrame(void);
+
+		void updateLayers(void);
+
 	private:
 
 		bool m_running = true;
 		bool m_isMinimized = false;
 
+		bool m_useRenderThread = false;
+		uint32_t m_maxFramesInFlight = MAX_FRAMES_IN_FLIGHT;
+
 		LayerStack m_layerStack;
 
 		std::unique_ptr<WindowContext> m_window;
@@ -2,6 +2,7 @@
 
 #include "../../logger/Log.h"
 #include "../../Debug/TracyProfiler.h"
+#include "../../Renderer/RenderThread.h"
 
 
 namespace Rapture {
@@ -61,6 +62,10 @@ namespace Rapture {
 
 	void OpenGLWindowContext::closeWindow()
 	{
+		if (m_resourceContext) {
+			glfwDestroyWindow(m_resourceContext);
+			m_resourceContext = nullptr;
+		}
 		glfwDestroyWindow(m_window);
 	}
 
@@ -96,6 +101,44 @@ namespace Rapture {
 		
 	}
 
+	void OpenGLWindowContext::pollEvents()
+	{
+		RAPTURE_PROFILE_FUNCTION();
+		glfwPollEvents();
+	}
+
+	void OpenGLWindowContext::swapBuffers()
+	{
+		RAPTURE_PROFILE_FUNCTION();
+		glfwSwapBuffers(m_window);
+	}
+
+	void OpenGLWindowContext::makeContextCurrent()
+	{
+		glfwMakeContextCurrent(m_window);
+	}
+
+	void OpenGLWindowContext::releaseContext()
+	{
+		glfwMakeContextCurrent(nullptr);
+	}
+
+	void OpenGLWindowContext::makeResourceContextCurrent()
+	{
+		if (!m_resourceContext) {
+			// Window creation is main thread only in GLFW, same as this call
+			glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+			m_resourceContext = glfwCreateWindow(1, 1, "Resource Context", nullptr, m_window);
+			glfwDefaultWindowHints();
+
+			if (!m_resourceContext) {
+				GE_CORE_ERROR("OpenGLWindowContext: Failed to create the shared resource context");
+				return;
+			}
+		}
+		glfwMakeContextCurrent(m_resourceContext);
+	}
+
 	void OpenGLWindowContext::setGLFWCallbacks()
 	{
 		glfwSetWindowCloseCallback(m_window, [](GLFWwindow* window)
@@ -120,6 +163,12 @@ namespace Rapture {
 	
 	void OpenGLWindowContext::setSwapMode(SwapMode mode)
 	{
+		// The swap interval belongs to the window's context, which a render thread may own
+		if (RenderThread::isRunning() && !RenderThread::isRenderThread()) {
+			RenderThread::submit([this, mode]() { setSwapMode(mode); });
+			return;
+		}
+
 		// Store the current mode
 		m_currentSwapMode = mode;
 		
@@ -18,6 +18,13 @@ namespace Rapture {
 
 		virtual void onUpdate(void) override;
 
+		virtual void pollEvents(void) override;
+		virtual void swapBuffers(void) override;
+
+		virtual void makeContextCurrent(void) override;
+		virtual void releaseContext(void) override;
+		virtual void makeResourceContextCurrent(void) override;
+
 		virtual void* getNativeWindowContext() override { return m_window; };
 		
 		// Swap mode control functions
@@ -31,6 +38,7 @@ namespace Rapture {
 
 	private:
 		GLFWwindow* m_window;
+		GLFWwindow* m_resourceContext = nullptr;	// hidden, shares objects with m_window
 		SwapMode m_currentSwapMode = SwapMode::Immediate;
 
 
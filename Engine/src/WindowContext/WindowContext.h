@@ -26,6 +26,19 @@ namespace Rapture {
 
 		virtual void onUpdate(void) = 0;
 
+		// The two halves of onUpdate, for when input and presenting run on different threads.
+		// pollEvents must be called on the main thread, swapBuffers on the thread the context is current on
+		virtual void pollEvents(void) = 0;
+		virtual void swapBuffers(void) = 0;
+
+		// Move the GL context between threads, the context can only be current on one thread at a time
+		virtual void makeContextCurrent(void) = 0;
+		virtual void releaseContext(void) = 0;
+
+		// Make a hidden context sharing objects with the window's current on the calling thread, created on first use.
+		// Lets the main thread keep creating textures and buffers while a render thread owns the window's context
+		virtual void makeResourceContextCurrent(void) = 0;
+
 		void setWindowEventCallback(const std::function<void(Event&)> callback) {
 			m_context_data.eventFnCallback = callback;
 		}
@@ -33,7 +46,7 @@ namespace Rapture {
 		virtual void* getNativeWindowContext() = 0;
 		
 		// Buffer swap control functions (implemented by derived classes)
-		virtual void setSwapMode(SwapMode mode) {}
+		virtual void setSwapMode(SwapMode /*mode*/) {}
 		virtual SwapMode getSwapMode() const { return static_cast<SwapMode>(0); } // Default implementation
 		virtual bool isTripleBufferingSupported() const { return false; }
 